@@ -6,3 +6,6 @@ TEMPLATE = subdirs
 SUBDIRS += \
     qgc_cli \
     agent \
+    loadgen \
+    bench \
+    agenttest \
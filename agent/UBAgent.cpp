@@ -1,5 +1,7 @@
 #include "UBAgent.h"
 #include "UBNetwork.h"
+#include "UBAvoidance.h"
+#include "UBScheduler.h"
 
 #include "UBConfig.h"
 
@@ -9,20 +11,92 @@
 #include "Vehicle.h"
 #include "TCPLink.h"
 #include "MissionManager.h"
+#include "StreamRateManager.h"
+#include "GeoFenceManager.h"
 #include "QGCApplication.h"
-
-UBAgent::UBAgent(QObject *parent) : QObject(parent),
-    m_mav(nullptr)
+#include "QGCClock.h"
+
+UBAgent::UBAgent(const SLinkOptions& options, QObject *parent) : QObject(parent),
+    m_vehicle_fence(-1),
+    m_neighbors(NEIGHBOR_CELL),
+    m_avoidance(new UBSeparationPolicy(SEPARATION_DIST, SEPARATION_HORIZON, MAX_SPEED)),
+    m_id(0),
+    m_hosted(false),
+    m_link_options(options),
+    m_link(nullptr),
+    m_mav(nullptr),
+    m_mav_id(0)
 {
-    m_net = new UBNetwork;
+    m_mission_stage = STAGE_IDLE;
+    m_mission_data.reset();
+
+    m_net = new UBNetwork(this);
     connect(m_net, SIGNAL(dataReady(quint8, QByteArray)), this, SLOT(dataReadyEvent(quint8, QByteArray)));
 
-    m_timer = new QTimer;
-    connect(m_timer, SIGNAL(timeout()), this, SLOT(missionTracker()));
+    setupScheduler();
 
     startAgent();
 }
 
+UBAgent::UBAgent(quint8 id, const SLinkOptions& options, QObject *parent) : QObject(parent),
+    m_vehicle_fence(-1),
+    m_neighbors(NEIGHBOR_CELL),
+    m_avoidance(new UBSeparationPolicy(SEPARATION_DIST, SEPARATION_HORIZON, MAX_SPEED)),
+    m_id(id),
+    m_hosted(true),
+    m_link_options(options),
+    m_link(nullptr),
+    m_mav(nullptr),
+    m_mav_id(0)
+{
+    m_mission_stage = STAGE_IDLE;
+    m_mission_data.reset();
+
+    m_net = new UBNetwork(this);
+    connect(m_net, SIGNAL(dataReady(quint8, QByteArray)), this, SLOT(dataReadyEvent(quint8, QByteArray)));
+
+    setupScheduler();
+}
+
+UBAgent::~UBAgent() {
+    delete m_avoidance;
+}
+
+void UBAgent::setupScheduler() {
+    m_scheduler = new UBScheduler(this);
+
+    // The follower reacts to the first position of its predecessor instead of waiting for the next tick
+    m_mission_action = m_scheduler->addAction("mission", [this]() {missionTracker();},
+                                              UBScheduler::EVENT_POSITION | UBScheduler::EVENT_NEIGHBOR | UBScheduler::EVENT_STATE,
+                                              MISSION_MIN_INTERVAL);
+
+    // The periodic broadcast keeps the neighbors' tables alive while the position does not change
+    m_broadcast_action = m_scheduler->addAction("broadcast", [this]() {broadcastPosition();},
+                                                UBScheduler::EVENT_POSITION,
+                                                BROADCAST_RATE);
+
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        m_stage_period[i] = MISSION_TRACK_RATE;
+    }
+}
+
+void UBAgent::setStage(int stage) {
+    m_mission_stage = EMissionStage(stage);
+    m_scheduler->setPeriod(m_mission_action, m_stage_period[stage]);
+}
+
+void UBAgent::setStagePeriod(int stage, int period) {
+    m_stage_period[stage] = period;
+    if (stage == m_mission_stage) {
+        m_scheduler->setPeriod(m_mission_action, period);
+    }
+}
+
+void UBAgent::setAvoidancePolicy(UBAvoidancePolicy* policy) {
+    delete m_avoidance;
+    m_avoidance = policy;
+}
+
 void UBAgent::startAgent() {
     QCommandLineParser parser;
     parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
@@ -34,10 +108,16 @@ void UBAgent::startAgent() {
 //    parser.process(*QCoreApplication::instance());
     parser.parse(QCoreApplication::arguments());
 
-    quint8 id = parser.value("I").toUInt();
+    m_id = parser.value("I").toUInt();
+
+    setupLink();
+    startTracking();
+}
+
+void UBAgent::setupLink() {
     LinkConfiguration* link = nullptr;
-    if (id) {
-        quint32 port = 10 * id + STL_PORT + 3;
+    if (m_id) {
+        quint32 port = 10 * m_id + STL_PORT + 3;
         TCPConfiguration* tcp = new TCPConfiguration(tr("TCP Port %1").arg(port));
         tcp->setAddress(QHostAddress::LocalHost);
         tcp->setPort(port);
@@ -51,31 +131,82 @@ void UBAgent::startAgent() {
         link = serial;
     }
 
+    // MAVLink 2 signing with the vehicle, which has to be set up with the same passphrase
+    if (!m_link_options.key.isEmpty()) {
+        link->setSigningKey(m_link_options.key);
+        link->setSigningLinkId(m_id);
+    }
+
     link->setDynamic();
     link->setAutoConnect();
+    m_link = link;
 
     LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
     linkManager->addConfiguration(link);
+
+    // The vehicle fails over to the redundant link when it is healthier than the priority link
+    if (m_link_options.redundant) {
+        quint16 port = m_link_options.redundant;
+        TCPConfiguration* tcp = new TCPConfiguration(tr("TCP Port %1").arg(port));
+        tcp->setAddress(QHostAddress::LocalHost);
+        tcp->setPort(port);
+
+        if (!m_link_options.key.isEmpty()) {
+            tcp->setSigningKey(m_link_options.key);
+            tcp->setSigningLinkId(m_id ^ 0x80);
+        }
+
+        tcp->setDynamic();
+        tcp->setAutoConnect();
+        linkManager->addConfiguration(tcp);
+    }
+
     linkManager->linkConfigurationsChanged();
 
     connect(qgcApp()->toolbox()->multiVehicleManager(), SIGNAL(vehicleAdded(Vehicle*)), this, SLOT(vehicleAddedEvent(Vehicle*)));
     connect(qgcApp()->toolbox()->multiVehicleManager(), SIGNAL(vehicleRemoved(Vehicle*)), this, SLOT(vehicleRemovedEvent(Vehicle*)));
+}
+
+void UBAgent::startTracking() {
+    m_net->connectToHost(QHostAddress::LocalHost, 10 * m_id + NET_PORT);
 
-    m_net->connectToHost(QHostAddress::LocalHost, 10 * id + NET_PORT);
-    m_timer->start(MISSION_TRACK_RATE);
+    // Timers belong to the agent's thread, so they are only started here
+    setStage(m_mission_stage);
+    m_scheduler->setPeriod(m_broadcast_action, MISSION_TRACK_RATE);
 }
 
 void UBAgent::setMAV(Vehicle* mav) {
-    if (m_mav) {
-        disconnect(m_mav, SIGNAL(armedChanged(bool)), this, SLOT(armedChangedEvent(bool)));
-        disconnect(m_mav, SIGNAL(flightModeChanged(QString)), this, SLOT(flightModeChangedEvent(QString)));
-    }
-
+    // A removed vehicle is never touched again, its connections go away when it is deleted
     m_mav = mav;
+    m_mav_id = mav ? mav->id() : 0;
+
+    m_fence.removeFence(m_vehicle_fence);
+    m_vehicle_fence = -1;
 
     if (m_mav) {
+        // The signals only wake up the mission logic, it reads the state from the vehicle's snapshot
         connect(m_mav, SIGNAL(armedChanged(bool)), this, SLOT(armedChangedEvent(bool)));
         connect(m_mav, SIGNAL(flightModeChanged(QString)), this, SLOT(flightModeChangedEvent(QString)));
+        connect(m_mav, SIGNAL(coordinateChanged(QGeoCoordinate)), this, SLOT(coordinateChangedEvent(QGeoCoordinate)));
+
+        // A fence of a vehicle the agent left behind is ignored, the connection to it stays until it is deleted
+        QPointer<Vehicle> guard(mav);
+        connect(mav->geoFenceManager(), &GeoFenceManager::loadComplete, this, [this, guard](const QGeoCoordinate& breachReturn, const QList<QGeoCoordinate>& polygon) {
+            if (guard && m_mav == guard) {
+                fenceLoadedEvent(breachReturn, polygon);
+            }
+        });
+
+        // The fence is read on the vehicle's thread and queued back to the agent's
+        vehicleCommand([this](Vehicle* mav) {
+            QList<QGeoCoordinate> polygon = mav->geoFenceManager()->polygon();
+            QPointer<Vehicle> guard(mav);
+            QTimer::singleShot(0, this, [this, guard, polygon]() {
+                if (guard && m_mav == guard) {
+                    fenceLoadedEvent(QGeoCoordinate(), polygon);
+                }
+            });
+        });
     }
 }
 
@@ -84,49 +215,128 @@ void UBAgent::vehicleAddedEvent(Vehicle* mav) {
         return;
     }
 
+    if (!m_hosted) {
+        adoptMAV(mav);
+        return;
+    }
+
+    // With many agents in one process every agent sees every vehicle, only take the one on our own link. The links of
+    // the vehicle are only read on its own thread, the answer is queued back to the agent's.
+    LinkConfiguration* config = m_link;
+    QTimer::singleShot(0, mav, [this, mav, config]() {
+        LinkInterface* link = mav->priorityLink();
+        if (link && link->getLinkConfiguration() == config) {
+            // The vehicle may be removed before the agent gets to it
+            QPointer<Vehicle> guard(mav);
+            QTimer::singleShot(0, this, [this, guard]() {
+                if (guard) {
+                    adoptMAV(guard);
+                }
+            });
+        }
+    });
+}
+
+void UBAgent::adoptMAV(Vehicle* mav) {
+    if (m_mav == mav) {
+        return;
+    }
+
     setMAV(mav);
-    m_net->setID(mav->id());
+    m_net->setID(m_mav_id);
+
+    bool redundant = m_link_options.redundant != 0;
+    vehicleCommand([redundant](Vehicle* mav) {
+        mav->setRedundantCommands(redundant);
+    });
+
+    // Position and status are all the agent reads from the vehicle, the broadcast needs a fresh position every period
+    vehicleCommand([this](Vehicle* mav) {
+        StreamRateManager* streams = mav->streamRateManager();
+        streams->subscribe(this, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, POSITION_STREAM_RATE);
+        streams->subscribe(this, MAVLINK_MSG_ID_SYS_STATUS, STATUS_STREAM_RATE);
+        streams->subscribe(this, MAVLINK_MSG_ID_GPS_RAW_INT, STATUS_STREAM_RATE);
+    });
 
     m_mission_data.reset();
-    m_mission_stage = STAGE_MISSION;
+    m_scheduler->resetStats();
+    setStage(STAGE_MISSION);
 
-    qInfo() << "New MAV connected with ID: " << m_mav->id();
+    qInfo() << "New MAV connected with ID: " << m_mav_id;
 }
 
 void UBAgent::vehicleRemovedEvent(Vehicle* mav) {
-    if (!mav || m_mav != mav) {
+    // mav is only compared, it may be deleted already. The guarded pointer is null when the own vehicle is gone first.
+    if (!mav || !m_mav_id || (m_mav && m_mav != mav)) {
         return;
     }
 
+    int id = m_mav_id;
     setMAV(nullptr);
     m_net->setID(0);
+    m_neighbors.clear();
 
     m_mission_data.reset();
-    m_mission_stage = STAGE_IDLE;
+    m_scheduler->logStats();
+    setStage(STAGE_IDLE);
 
-    qInfo() << "MAV disconnected with ID: " << mav->id();
+    qInfo() << "MAV disconnected with ID: " << id;
 }
 
 void UBAgent::armedChangedEvent(bool armed) {
     Q_UNUSED(armed);
+    m_scheduler->trigger(UBScheduler::EVENT_STATE);
 }
 
 void UBAgent::flightModeChangedEvent(QString mode) {
     qInfo() << mode;
+    m_scheduler->trigger(UBScheduler::EVENT_STATE);
+}
+
+void UBAgent::coordinateChangedEvent(QGeoCoordinate coordinate) {
+    Q_UNUSED(coordinate);
+    m_scheduler->trigger(UBScheduler::EVENT_POSITION);
+}
+
+void UBAgent::fenceLoadedEvent(QGeoCoordinate breachReturn, QList<QGeoCoordinate> polygon) {
+    Q_UNUSED(breachReturn);
+
+    m_fence.removeFence(m_vehicle_fence);
+    m_vehicle_fence = m_fence.addPolygon(polygon, UBGeoFence::FENCE_INCLUSION);
+}
+
+void UBAgent::vehicleCommand(std::function<void(Vehicle*)> command) {
+    Vehicle* mav = m_mav;
+    if (!mav) {
+        return;
+    }
+
+    QTimer::singleShot(0, mav, [mav, command]() {
+        command(mav);
+    });
 }
 
 void UBAgent::dataReadyEvent(quint8 srcID, QByteArray data) {
-    if(srcID != m_mav->id() - 1) {
+    if (!m_mav_id || srcID == m_mav_id) {
         return;
     }
 
-    m_mission_data.pos = QGeoCoordinate(data.mid(0, 25).toDouble(), data.mid(0 + 25, 25).toDouble(), data.mid(0 + 25 + 25).toDouble());
+    QGeoCoordinate pos(data.mid(0, 25).toDouble(), data.mid(0 + 25, 25).toDouble(), data.mid(0 + 25 + 25).toDouble());
+    m_neighbors.update(srcID, pos, QGCClock::instance()->currentMSecsSinceEpoch());
+
+    if (srcID == m_mav_id - 1) {
+        m_mission_data.pos = pos;
+
+        m_mission_data.time = QGCClock::instance()->currentMSecsSinceEpoch();
+        m_mission_data.stage = 1;
+    }
 
-    m_mission_data.tick = 0;
-    m_mission_data.stage = 1;
+    m_scheduler->trigger(UBScheduler::EVENT_NEIGHBOR);
 }
 
 void UBAgent::missionTracker() {
+    m_neighbors.expire(QGCClock::instance()->currentMSecsSinceEpoch(), NEIGHBOR_TIMEOUT);
+
     switch (m_mission_stage) {
     case STAGE_IDLE:
         stageIdle();
@@ -154,49 +364,75 @@ void UBAgent::stageTakeoff() {
 void UBAgent::stageLand() {
 }
 
-void UBAgent::stageMission() {
-//    if (!m_mav->guidedMode()) {
-//        return;
-//    }
+void UBAgent::broadcastPosition() {
+    Vehicle* mav = m_mav;
+    if (!mav) {
+        return;
+    }
 
-    QByteArray lat = QByteArray::number(m_mav->coordinate().latitude(), 'g', 25);
+    VehicleStateSnapshot state = mav->stateSnapshot();
+    if (!state.positionValid()) {
+        return;
+    }
+
+    QByteArray lat = QByteArray::number(state.latitude, 'g', 25);
     lat = lat.rightJustified(25, '0', true);
 
-    QByteArray lon = QByteArray::number(m_mav->coordinate().longitude(), 'g', 25);
+    QByteArray lon = QByteArray::number(state.longitude, 'g', 25);
     lon = lon.rightJustified(25, '0', true);
 
-    QByteArray alt = QByteArray::number(m_mav->altitudeRelative()->rawValue().toDouble(), 'g', 10);
+    QByteArray alt = QByteArray::number(state.altitudeRelative, 'g', 10);
     alt = alt.rightJustified(10, '0', true);
 
-    m_net->sendData(m_mav->id() + 1, lat + lon + alt);
+    // Every agent keeps track of all neighbors, the follower picks its predecessor out of the broadcasts
+    m_net->sendData(BROADCAST_ID, lat + lon + alt);
+}
+
+void UBAgent::stageMission() {
+//    if (!m_mav->guidedMode()) {
+//        return;
+//    }
+
+    Vehicle* mav = m_mav;
+    if (!mav) {
+        return;
+    }
+
+    // Position, altitude and armed state all come from one coherent copy
+    VehicleStateSnapshot state = mav->stateSnapshot();
+    if (!state.positionValid()) {
+        return;
+    }
 
     if (!m_mission_data.stage) {
         return;
     }
 
-    m_mission_data.tick++;
-    if (m_mission_data.tick > (10 * 1000 / MISSION_TRACK_RATE)) {
+    if (QGCClock::instance()->currentMSecsSinceEpoch() - m_mission_data.time > MISSION_TIMEOUT) {
         m_mission_data.reset();
         return;
     }
 
-    QGeoCoordinate pos = m_mav->coordinate();
-    pos.setAltitude(m_mav->altitudeRelative()->rawValue().toDouble());
+    QGeoCoordinate pos(state.latitude, state.longitude, state.altitudeRelative);
 
     if (m_mission_data.pos.distanceTo(pos) < 10) {
         return;
     }
 
     if (m_mission_data.pos.altitude() < POINT_ZONE) {
-        if (m_mav->armed()) {
-            m_mav->guidedModeLand();
+        if (state.armed) {
+            vehicleCommand([](Vehicle* mav) {
+                mav->guidedModeLand();
+            });
         }
 
         return;
     }
 
     if (pos.altitude() < POINT_ZONE) {
-        m_mav->guidedModeTakeoff();
+        vehicleCommand([](Vehicle* mav) {
+            mav->guidedModeTakeoff();
+        });
         return;
     }
 
@@ -207,6 +443,18 @@ void UBAgent::stageMission() {
         return;
     }
 
+    if (m_avoidance) {
+        _pos = m_avoidance->adjustTarget(pos, _pos, m_neighbors);
+    }
+
+    UBGeoFence::ECheckResult fence = m_fence.checkSegment(pos, _pos);
+    if (fence != UBGeoFence::CHECK_OK) {
+        qWarning() << "Guided target rejected by geofence: " << fence;
+        return;
+    }
+
 //    m_mav->guidedModeGotoLocation(_pos);
-    m_mav->missionManager()->writeArduPilotGuidedMissionItem(_pos, false);
+    vehicleCommand([_pos](Vehicle* mav) {
+        mav->missionManager()->writeArduPilotGuidedMissionItem(_pos, false);
+    });
 }
@@ -2,21 +2,55 @@
 #define UBAGENT_H
 
 #include <QObject>
+#include <QPointer>
 #include <QGeoCoordinate>
+#include <QVariant>
+
+#include <functional>
+
+#include "UBGeoFence.h"
+#include "UBNeighbors.h"
+
+class UBAvoidancePolicy;
+class UBScheduler;
 
-class QTimer;
 class Vehicle;
 class UBNetwork;
+class LinkConfiguration;
 
 class UBAgent : public QObject
 {
     Q_OBJECT
 public:
-    explicit UBAgent(QObject *parent = nullptr);
+    // Link settings from the command line, parsed once in main for all agents of the process
+    struct SLinkOptions {
+        SLinkOptions() : redundant(0) {}
+
+        QByteArray key;     // MAVLink 2 signing key, empty to not sign
+        quint16 redundant;  // Port of a second TCP link to the vehicle, 0 for none
+    };
+
+    explicit UBAgent(const SLinkOptions& options = SLinkOptions(), QObject *parent = nullptr);
+    // Host mode: the agent is set up by UBAgentHost instead of from the command line
+    UBAgent(quint8 id, const SLinkOptions& options, QObject *parent = nullptr);
+    ~UBAgent();
+
+    quint8 getID() const {return m_id;}
+
+    // Fallback period in ms of the mission logic while in stage, in addition to running on events
+    void setStagePeriod(int stage, int period);
+
+    // Takes ownership of the policy, nullptr sends guided targets unchanged
+    void setAvoidancePolicy(UBAvoidancePolicy* policy);
 
 public slots:
     void startAgent();
 
+    // Adds the link to the vehicle of this instance, must be called on the main thread
+    void setupLink();
+    // Connects to the network and starts tracking the mission, runs on the thread the agent lives on
+    void startTracking();
+
 protected slots:
     void setMAV(Vehicle* mav);
 
@@ -25,41 +59,73 @@ protected slots:
 
     void armedChangedEvent(bool armed);
     void flightModeChangedEvent(QString mode);
+    void coordinateChangedEvent(QGeoCoordinate coordinate);
+    void fenceLoadedEvent(QGeoCoordinate breachReturn, QList<QGeoCoordinate> polygon);
 
     void dataReadyEvent(quint8 srcID, QByteArray data);
     void missionTracker();
+    void broadcastPosition();
 
 protected:
+    // Takes the vehicle once it is known to be on the link of this agent
+    void adoptMAV(Vehicle* mav);
+
+    void setupScheduler();
+    void setStage(int stage);
+
     void stageIdle();
     void stageTakeoff();
     void stageMission();
     void stageLand();
 
+    // Vehicles live on the main thread, commands are queued to it since the agent may run on a worker thread
+    void vehicleCommand(std::function<void(Vehicle*)> command);
+
 protected:
     enum EMissionStage {
         STAGE_IDLE,
         STAGE_TAKEOFF,
         STAGE_MISSION,
         STAGE_LAND,
+        STAGE_COUNT,
     } m_mission_stage;
 
     struct SMissionData {
         int stage;
-        int tick;
+        qint64 time;
 
         QGeoCoordinate pos;
 
         void reset() {
             stage = 0;
-            tick = 0;
+            time = 0;
         }
     } m_mission_data;
 
-protected:    
-    Vehicle* m_mav;
+    // Guided targets are checked against these before they are sent, the vehicle's own fence polygon is kept in sync
+    UBGeoFence m_fence;
+    int m_vehicle_fence;
+
+    // Latest position of every other agent, from their broadcasts
+    UBNeighbors m_neighbors;
+    UBAvoidancePolicy* m_avoidance;
+
+protected:
+    quint8 m_id;
+    bool m_hosted;
+    SLinkOptions m_link_options;
+    LinkConfiguration* m_link;
+
+    // The vehicle is deleted on the main thread after it was removed, it is only reached through the guarded pointer
+    // and its ID is kept for when it is gone
+    QPointer<Vehicle> m_mav;
+    int m_mav_id;
     UBNetwork* m_net;
 
-    QTimer* m_timer;
+    UBScheduler* m_scheduler;
+    int m_mission_action;
+    int m_broadcast_action;
+    int m_stage_period[STAGE_COUNT];
 };
 
 #endif // UBAGENT_H
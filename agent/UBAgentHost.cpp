@@ -0,0 +1,97 @@
+#include "UBAgentHost.h"
+#include "UBAgent.h"
+
+#include <QThread>
+#include <QFile>
+
+#include "QGCApplication.h"
+#include "MultiVehicleManager.h"
+
+UBAgentHost::UBAgentHost(quint8 firstID, int count, int threads, const UBAgent::SLinkOptions& options, QObject *parent) : QObject(parent),
+    m_shared_memory(residentMemory()),
+    m_connected(0)
+{
+    m_startup.start();
+
+    // IDs past 255 would wrap around onto the first agents
+    Q_ASSERT(validIDs(firstID, count));
+    count = qBound(0, count, 256 - firstID);
+
+    threads = qBound(1, threads, qMax(1, count));
+    for (int i = 0; i < threads; i++) {
+        QThread* thread = new QThread(this);
+        thread->setObjectName(QString("Agents %1").arg(i));
+        m_threads.append(thread);
+    }
+
+    for (int i = 0; i < count; i++) {
+        UBAgent* agent = new UBAgent(firstID + i, options);
+
+        // Links are managed by the main thread, the agent itself then moves to a worker
+        agent->setupLink();
+
+        QThread* thread = m_threads[i % threads];
+        agent->moveToThread(thread);
+        connect(thread, SIGNAL(finished()), agent, SLOT(deleteLater()));
+
+        m_agents.append(agent);
+    }
+
+    for (int i = 0; i < m_threads.count(); i++) {
+        m_threads[i]->start();
+    }
+
+    for (int i = 0; i < m_agents.count(); i++) {
+        QMetaObject::invokeMethod(m_agents[i], "startTracking", Qt::QueuedConnection);
+    }
+
+    connect(qgcApp()->toolbox()->multiVehicleManager(), SIGNAL(vehicleAdded(Vehicle*)), this, SLOT(vehicleAddedEvent(Vehicle*)));
+
+    qInfo() << "Hosting" << count << "agents from ID" << firstID << "on" << threads << "threads";
+}
+
+UBAgentHost::~UBAgentHost() {
+    for (int i = 0; i < m_threads.count(); i++) {
+        m_threads[i]->quit();
+    }
+
+    for (int i = 0; i < m_threads.count(); i++) {
+        m_threads[i]->wait();
+    }
+}
+
+bool UBAgentHost::validIDs(int firstID, int count) {
+    return firstID >= 1 && count >= 1 && firstID + count - 1 <= 255;
+}
+
+void UBAgentHost::vehicleAddedEvent(Vehicle* mav) {
+    Q_UNUSED(mav);
+
+    m_connected++;
+    if (m_connected != m_agents.count()) {
+        return;
+    }
+
+    // Everything prior to the host starting is paid once instead of once per agent process
+    qint64 memory = residentMemory();
+    qInfo() << "All" << m_agents.count() << "agents connected";
+    qInfo() << "Shared memory (KB):" << m_shared_memory;
+    qInfo() << "Memory per agent (KB):" << (memory < 0 || m_shared_memory < 0 ? -1 : (memory - m_shared_memory) / m_agents.count());
+    qInfo() << "Startup per agent (ms):" << m_startup.elapsed() / m_agents.count();
+}
+
+qint64 UBAgentHost::residentMemory() {
+    QFile status("/proc/self/status");
+    if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return -1;
+    }
+
+    while (!status.atEnd()) {
+        QByteArray line = status.readLine();
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,43 @@
+#ifndef UBAGENTHOST_H
+#define UBAGENTHOST_H
+
+#include <QObject>
+#include <QList>
+#include <QElapsedTimer>
+
+#include "UBAgent.h"
+
+class QThread;
+class Vehicle;
+
+// Runs many agents in one process. The QGC application, toolbox and metadata are shared by all agents, each agent
+// still has its own link, vehicle and network socket. Agents are spread over a fixed pool of worker threads.
+class UBAgentHost : public QObject
+{
+    Q_OBJECT
+public:
+    UBAgentHost(quint8 firstID, int count, int threads, const UBAgent::SLinkOptions& options, QObject *parent = nullptr);
+    ~UBAgentHost();
+
+    int getAgentCount() const {return m_agents.count();}
+
+    // Hosted agents take the IDs firstID to firstID + count - 1, which have to fit 1 to 255. ID 0 is the serial agent.
+    static bool validIDs(int firstID, int count);
+
+protected slots:
+    void vehicleAddedEvent(Vehicle* mav);
+
+protected:
+    // Resident memory of the process in KB, -1 if not available on this platform
+    static qint64 residentMemory();
+
+protected:
+    QList<QThread*> m_threads;
+    QList<UBAgent*> m_agents;
+
+    QElapsedTimer m_startup;
+    qint64 m_shared_memory;
+    int m_connected;
+};
+
+#endif // UBAGENTHOST_H
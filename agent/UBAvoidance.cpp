@@ -0,0 +1,60 @@
+#include "UBAvoidance.h"
+#include "UBNeighbors.h"
+
+#include <QtMath>
+
+UBSeparationPolicy::UBSeparationPolicy(double separation, double horizon, double max_speed) :
+    m_separation(separation),
+    m_horizon(horizon),
+    m_max_speed(max_speed)
+{
+}
+
+QGeoCoordinate UBSeparationPolicy::adjustTarget(const QGeoCoordinate& position, const QGeoCoordinate& target, const UBNeighbors& neighbors) {
+    if (!target.isValid() || !neighbors.count()) {
+        return target;
+    }
+
+    // A neighbor further away than this can't get within the separation distance of the target within the horizon
+    quint8 ids[MAX_NEIGHBORS];
+    int count = neighbors.nearest(target, MAX_NEIGHBORS, ids, m_separation + m_horizon * m_max_speed);
+    if (!count) {
+        return target;
+    }
+
+    QPointF goal = neighbors.project(target);
+    QPointF self = neighbors.project(position);
+    QPointF push;
+
+    for (int i = 0; i < count; i++) {
+        const UBNeighbors::SNeighbor* neighbor = neighbors.get(ids[i]);
+        QPointF predicted = neighbor->position + neighbor->velocity * m_horizon;
+
+        QPointF away = goal - predicted;
+        double distance = qSqrt(QPointF::dotProduct(away, away));
+        if (distance >= m_separation) {
+            continue;
+        }
+
+        if (distance > 0) {
+            push += away * ((m_separation - distance) / distance);
+            continue;
+        }
+
+        // Target on top of the neighbor, back off towards where we are now
+        away = self - predicted;
+        distance = qSqrt(QPointF::dotProduct(away, away));
+        if (distance > 0) {
+            push += away * (m_separation / distance);
+        }
+    }
+
+    if (push.isNull()) {
+        return target;
+    }
+
+    QGeoCoordinate adjusted = neighbors.unproject(goal + push);
+    adjusted.setAltitude(target.altitude());
+
+    return adjusted;
+}
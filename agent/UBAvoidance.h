@@ -0,0 +1,35 @@
+#ifndef UBAVOIDANCE_H
+#define UBAVOIDANCE_H
+
+#include <QGeoCoordinate>
+
+class UBNeighbors;
+
+// Adjusts guided targets before they are sent to the vehicle, based on the latest neighbor states
+class UBAvoidancePolicy
+{
+public:
+    virtual ~UBAvoidancePolicy() {}
+
+    // Returns the target to send in place of target, target itself if no change is needed
+    virtual QGeoCoordinate adjustTarget(const QGeoCoordinate& position, const QGeoCoordinate& target, const UBNeighbors& neighbors) = 0;
+};
+
+// Keeps targets a minimum horizontal distance away from where the closest neighbors will be after horizon seconds.
+// Each neighbor too close pushes the target directly away from it.
+class UBSeparationPolicy : public UBAvoidancePolicy
+{
+public:
+    UBSeparationPolicy(double separation, double horizon, double max_speed);
+
+    QGeoCoordinate adjustTarget(const QGeoCoordinate& position, const QGeoCoordinate& target, const UBNeighbors& neighbors) override;
+
+protected:
+    double m_separation;
+    double m_horizon;
+    double m_max_speed;
+
+    static const int MAX_NEIGHBORS = 8;
+};
+
+#endif // UBAVOIDANCE_H
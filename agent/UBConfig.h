@@ -19,8 +19,26 @@
 #define TAKEOFF_ALT     5
 #define GPS_ACCURACY    5
 
-#define MISSION_TRACK_RATE  1000
+// Mission logic runs on vehicle and network events, at most every MISSION_MIN_INTERVAL ms, and at least every
+// MISSION_TRACK_RATE ms
+#define MISSION_TRACK_RATE      1000
+#define MISSION_MIN_INTERVAL    200
+#define MISSION_TIMEOUT         10000
+#define BROADCAST_RATE          100
+
+// Telemetry the agent subscribes to in Hz, the vehicle turns off the streams nobody uses
+#define POSITION_STREAM_RATE    10
+#define STATUS_STREAM_RATE      1
+
+#define NEIGHBOR_TIMEOUT    5000
+#define NEIGHBOR_CELL       20
+#define SEPARATION_DIST     5
+#define SEPARATION_HORIZON  2
+#define MAX_SPEED           10
 
 #define SAVE_RATE   5
 
+// Largest metrics scrape request header in bytes, longer requests are refused
+#define METRICS_MAX_REQUEST 8192
+
 #endif // UBCONFIG_H
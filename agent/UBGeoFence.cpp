@@ -0,0 +1,322 @@
+#include "UBGeoFence.h"
+
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <limits>
+
+#include "QGCGeo.h"
+
+UBGeoFence::UBGeoFence() :
+    m_next_id(0)
+{
+}
+
+void UBGeoFence::setOrigin(const QGeoCoordinate& origin) {
+    m_origin = origin;
+
+    for (int i = 0; i < m_circles.count(); i++) {
+        m_circles[i].center = project(m_circles[i].coordinate);
+    }
+
+    rebuild();
+}
+
+int UBGeoFence::addPolygon(const QList<QGeoCoordinate>& polygon, EFenceType type) {
+    if (polygon.count() < 3) {
+        return -1;
+    }
+
+    if (!m_origin.isValid()) {
+        m_origin = polygon.first();
+    }
+
+    m_polygons.append(SPolygon{m_next_id, type, polygon});
+    rebuild();
+
+    return m_next_id++;
+}
+
+int UBGeoFence::addCircle(const QGeoCoordinate& center, double radius, EFenceType type) {
+    if (!center.isValid() || radius <= 0) {
+        return -1;
+    }
+
+    if (!m_origin.isValid()) {
+        m_origin = center;
+    }
+
+    m_circles.append(SCircle{m_next_id, type, center, project(center), radius});
+
+    return m_next_id++;
+}
+
+bool UBGeoFence::moveCircle(int id, const QGeoCoordinate& center) {
+    for (int i = 0; i < m_circles.count(); i++) {
+        if (m_circles[i].id == id) {
+            m_circles[i].coordinate = center;
+            m_circles[i].center = project(center);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void UBGeoFence::removeFence(int id) {
+    for (int i = 0; i < m_circles.count(); i++) {
+        if (m_circles[i].id == id) {
+            m_circles.removeAt(i);
+            return;
+        }
+    }
+
+    for (int i = 0; i < m_polygons.count(); i++) {
+        if (m_polygons[i].id == id) {
+            m_polygons.removeAt(i);
+            rebuild();
+            return;
+        }
+    }
+}
+
+void UBGeoFence::clear() {
+    m_polygons.clear();
+    m_circles.clear();
+    m_edges.clear();
+    m_nodes.clear();
+}
+
+QPointF UBGeoFence::project(const QGeoCoordinate& coordinate) const {
+    if (coordinate == m_origin) {
+        return QPointF(0, 0);
+    }
+
+    double north, east, down;
+    convertGeoToNed(coordinate, m_origin, &north, &east, &down);
+
+    return QPointF(east, north);
+}
+
+void UBGeoFence::rebuild() {
+    m_edges.clear();
+    m_nodes.clear();
+
+    for (int i = 0; i < m_polygons.count(); i++) {
+        const QList<QGeoCoordinate>& coordinates = m_polygons[i].coordinates;
+
+        QPointF first = project(coordinates.first());
+        QPointF start = first;
+        for (int j = 1; j <= coordinates.count(); j++) {
+            QPointF end = j < coordinates.count() ? project(coordinates[j]) : first;
+            m_edges.append(SEdge{start, end, i});
+            start = end;
+        }
+    }
+
+    if (!m_edges.isEmpty()) {
+        m_nodes.reserve(2 * (m_edges.count() / LEAF_SIZE + 1));
+        buildNode(0, m_edges.count());
+    }
+}
+
+int UBGeoFence::buildNode(int first, int count) {
+    int index = m_nodes.count();
+    m_nodes.append(SNode());
+
+    SNode node;
+    node.min_x = node.min_y = std::numeric_limits<double>::max();
+    node.max_x = node.max_y = -std::numeric_limits<double>::max();
+    node.first = first;
+    node.count = count;
+    node.right = -1;
+
+    double center_min_x = std::numeric_limits<double>::max();
+    double center_min_y = std::numeric_limits<double>::max();
+    double center_max_x = -std::numeric_limits<double>::max();
+    double center_max_y = -std::numeric_limits<double>::max();
+
+    for (int i = first; i < first + count; i++) {
+        const SEdge& edge = m_edges[i];
+        node.min_x = qMin(node.min_x, qMin(edge.start.x(), edge.end.x()));
+        node.min_y = qMin(node.min_y, qMin(edge.start.y(), edge.end.y()));
+        node.max_x = qMax(node.max_x, qMax(edge.start.x(), edge.end.x()));
+        node.max_y = qMax(node.max_y, qMax(edge.start.y(), edge.end.y()));
+
+        QPointF center = (edge.start + edge.end) / 2;
+        center_min_x = qMin(center_min_x, center.x());
+        center_min_y = qMin(center_min_y, center.y());
+        center_max_x = qMax(center_max_x, center.x());
+        center_max_y = qMax(center_max_y, center.y());
+    }
+
+    if (count > LEAF_SIZE) {
+        // Median split of the edge centers along the longer axis keeps the tree balanced
+        bool split_x = center_max_x - center_min_x >= center_max_y - center_min_y;
+        int half = count / 2;
+        std::nth_element(m_edges.begin() + first, m_edges.begin() + first + half, m_edges.begin() + first + count,
+                         [split_x](const SEdge& a, const SEdge& b) {
+            return split_x ? a.start.x() + a.end.x() < b.start.x() + b.end.x() : a.start.y() + a.end.y() < b.start.y() + b.end.y();
+        });
+
+        node.count = 0;
+        buildNode(first, half);
+        node.right = buildNode(first + half, count - half);
+    }
+
+    m_nodes[index] = node;
+
+    return index;
+}
+
+UBGeoFence::ECheckResult UBGeoFence::checkPoint(const QGeoCoordinate& coordinate) const {
+    if (isEmpty()) {
+        return CHECK_OK;
+    }
+
+    QPointF point = project(coordinate);
+
+    for (int i = 0; i < m_circles.count(); i++) {
+        const SCircle& circle = m_circles[i];
+        QPointF offset = point - circle.center;
+        bool inside = QPointF::dotProduct(offset, offset) <= circle.radius * circle.radius;
+
+        if (circle.type == FENCE_INCLUSION && !inside) {
+            return CHECK_OUTSIDE_INCLUSION;
+        }
+        if (circle.type == FENCE_EXCLUSION && inside) {
+            return CHECK_INSIDE_EXCLUSION;
+        }
+    }
+
+    if (m_nodes.isEmpty()) {
+        return CHECK_OK;
+    }
+
+    // Even-odd crossing count of a ray towards +x, kept per polygon. Only nodes the ray passes through are visited.
+    QVarLengthArray<bool, 32> inside(m_polygons.count());
+    std::fill(inside.begin(), inside.end(), false);
+
+    int stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        int index = stack[--top];
+        const SNode& node = m_nodes[index];
+        if (point.y() < node.min_y || point.y() > node.max_y || point.x() > node.max_x) {
+            continue;
+        }
+
+        if (node.count == 0) {
+            stack[top++] = node.right;
+            stack[top++] = index + 1;
+            continue;
+        }
+
+        for (int i = node.first; i < node.first + node.count; i++) {
+            const SEdge& edge = m_edges[i];
+            if ((edge.start.y() > point.y()) != (edge.end.y() > point.y())) {
+                double x = edge.start.x() + (point.y() - edge.start.y()) * (edge.end.x() - edge.start.x()) / (edge.end.y() - edge.start.y());
+                if (point.x() < x) {
+                    inside[edge.polygon] = !inside[edge.polygon];
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < m_polygons.count(); i++) {
+        if (m_polygons[i].type == FENCE_INCLUSION && !inside[i]) {
+            return CHECK_OUTSIDE_INCLUSION;
+        }
+        if (m_polygons[i].type == FENCE_EXCLUSION && inside[i]) {
+            return CHECK_INSIDE_EXCLUSION;
+        }
+    }
+
+    return CHECK_OK;
+}
+
+UBGeoFence::ECheckResult UBGeoFence::checkSegment(const QGeoCoordinate& from, const QGeoCoordinate& to) const {
+    ECheckResult result = checkPoint(to);
+    if (result != CHECK_OK || checkPoint(from) != CHECK_OK) {
+        return result;
+    }
+
+    return crosses(project(from), project(to)) ? CHECK_CROSSES_FENCE : CHECK_OK;
+}
+
+bool UBGeoFence::crossesFence(const QGeoCoordinate& from, const QGeoCoordinate& to) const {
+    if (isEmpty()) {
+        return false;
+    }
+
+    return crosses(project(from), project(to));
+}
+
+bool UBGeoFence::crosses(const QPointF& from, const QPointF& to) const {
+    QPointF path = to - from;
+    double length = QPointF::dotProduct(path, path);
+
+    for (int i = 0; i < m_circles.count(); i++) {
+        const SCircle& circle = m_circles[i];
+        if (circle.type != FENCE_EXCLUSION) {
+            continue;
+        }
+
+        // Closest point of the path to the circle center
+        double t = length > 0 ? qBound(0.0, QPointF::dotProduct(circle.center - from, path) / length, 1.0) : 0;
+        QPointF offset = from + path * t - circle.center;
+        if (QPointF::dotProduct(offset, offset) < circle.radius * circle.radius) {
+            return true;
+        }
+    }
+
+    if (m_nodes.isEmpty()) {
+        return false;
+    }
+
+    double min_x = qMin(from.x(), to.x());
+    double min_y = qMin(from.y(), to.y());
+    double max_x = qMax(from.x(), to.x());
+    double max_y = qMax(from.y(), to.y());
+
+    int stack[STACK_SIZE];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        int index = stack[--top];
+        const SNode& node = m_nodes[index];
+        if (max_x < node.min_x || min_x > node.max_x || max_y < node.min_y || min_y > node.max_y) {
+            continue;
+        }
+
+        if (node.count == 0) {
+            stack[top++] = node.right;
+            stack[top++] = index + 1;
+            continue;
+        }
+
+        for (int i = node.first; i < node.first + node.count; i++) {
+            if (segmentsIntersect(from, to, m_edges[i].start, m_edges[i].end)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool UBGeoFence::segmentsIntersect(const QPointF& a, const QPointF& b, const QPointF& c, const QPointF& d) {
+    auto cross = [](const QPointF& o, const QPointF& p, const QPointF& q) {
+        return (p.x() - o.x()) * (q.y() - o.y()) - (p.y() - o.y()) * (q.x() - o.x());
+    };
+
+    double d1 = cross(c, d, a);
+    double d2 = cross(c, d, b);
+    double d3 = cross(a, b, c);
+    double d4 = cross(a, b, d);
+
+    return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+}
@@ -0,0 +1,109 @@
+#ifndef UBGEOFENCE_H
+#define UBGEOFENCE_H
+
+#include <QGeoCoordinate>
+#include <QPointF>
+#include <QVector>
+#include <QList>
+
+// Local geofence evaluation for guided targets. Polygon and circle fences are projected once into a tangent plane
+// (x east, y north) around the first fence added. All polygon edges are kept in a bounding volume hierarchy, so point
+// and segment queries only look at the edges close to the query instead of every vertex of every fence.
+//
+// An allowed point is inside every inclusion fence and outside every exclusion fence. Not thread safe, the owner
+// updates and queries the fences from one thread.
+class UBGeoFence
+{
+public:
+    enum EFenceType {
+        FENCE_INCLUSION,
+        FENCE_EXCLUSION,
+    };
+
+    enum ECheckResult {
+        CHECK_OK,
+        CHECK_OUTSIDE_INCLUSION,
+        CHECK_INSIDE_EXCLUSION,
+        CHECK_CROSSES_FENCE,
+    };
+
+    UBGeoFence();
+
+    // Tangent plane origin, set by the first fence if not set explicitly. Changing it reprojects all fences.
+    void setOrigin(const QGeoCoordinate& origin);
+    QGeoCoordinate getOrigin() const {return m_origin;}
+
+    // Fence ids are shared between polygons and circles, -1 if the fence is invalid
+    int addPolygon(const QList<QGeoCoordinate>& polygon, EFenceType type);
+    int addCircle(const QGeoCoordinate& center, double radius, EFenceType type);
+
+    // Circles can be moved without rebuilding the edge hierarchy, e.g. exclusion zones around other agents
+    bool moveCircle(int id, const QGeoCoordinate& center);
+
+    void removeFence(int id);
+    void clear();
+
+    bool isEmpty() const {return m_polygons.isEmpty() && m_circles.isEmpty();}
+
+    ECheckResult checkPoint(const QGeoCoordinate& point) const;
+
+    // Checks the target of a move. If the start is allowed the straight path must not cross any fence either. If the
+    // start is not allowed, e.g. after a breach, only the target is checked so the vehicle can move back.
+    ECheckResult checkSegment(const QGeoCoordinate& from, const QGeoCoordinate& to) const;
+
+    // True if the straight path crosses a polygon edge or enters an exclusion circle
+    bool crossesFence(const QGeoCoordinate& from, const QGeoCoordinate& to) const;
+
+protected:
+    struct SPolygon {
+        int id;
+        EFenceType type;
+        QList<QGeoCoordinate> coordinates;
+    };
+
+    struct SCircle {
+        int id;
+        EFenceType type;
+        QGeoCoordinate coordinate;
+        QPointF center;
+        double radius;
+    };
+
+    struct SEdge {
+        QPointF start;
+        QPointF end;
+        int polygon;    // Index into m_polygons
+    };
+
+    // Internal nodes have count 0, their left child follows them and right is the index of the right child. Leaves
+    // hold count edges starting at first.
+    struct SNode {
+        double min_x, min_y, max_x, max_y;
+        int first;
+        int count;
+        int right;
+    };
+
+    QPointF project(const QGeoCoordinate& coordinate) const;
+    bool crosses(const QPointF& from, const QPointF& to) const;
+
+    void rebuild();
+    int buildNode(int first, int count);
+
+    static bool segmentsIntersect(const QPointF& a, const QPointF& b, const QPointF& c, const QPointF& d);
+
+protected:
+    QGeoCoordinate m_origin;
+    int m_next_id;
+
+    QList<SPolygon> m_polygons;
+    QList<SCircle> m_circles;
+
+    QVector<SEdge> m_edges;
+    QVector<SNode> m_nodes;
+
+    static const int LEAF_SIZE = 4;
+    static const int STACK_SIZE = 64;
+};
+
+#endif // UBGEOFENCE_H
@@ -0,0 +1,153 @@
+#include "UBMetrics.h"
+#include "UBConfig.h"
+
+#include <QDebug>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include <stdio.h>
+
+#include "QGCClock.h"
+#include "QGCMetrics.h"
+
+UBMetrics::UBMetrics(QObject *parent) : QObject(parent),
+    m_timer(nullptr),
+    m_format(FORMAT_JSON),
+    m_server(nullptr),
+    m_telemetrySubscription(-1)
+{
+}
+
+UBMetrics::~UBMetrics() {
+    if (m_telemetrySubscription != -1) {
+        TelemetryChannelRegistry::instance()->unsubscribe(m_telemetrySubscription);
+    }
+
+    foreach (QGCMetricGauge* gauge, m_gauges) {
+        QGCMetrics::instance()->release(gauge);
+    }
+}
+
+bool UBMetrics::startExport(int period, EFormat format, const QString& path) {
+    bool opened;
+    if (path.isEmpty()) {
+        opened = m_file.open(stdout, QIODevice::WriteOnly);
+    } else {
+        m_file.setFileName(path);
+        opened = m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+
+    if (!opened) {
+        qWarning() << "Metrics export failed to open" << path << m_file.errorString();
+        return false;
+    }
+
+    m_format = format;
+    if (m_format == FORMAT_CSV) {
+        m_file.write(QGCMetrics::csvHeader());
+        m_file.flush();
+    }
+
+    m_timer = new QGCTimer(this);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(exportEvent()));
+    m_timer->start(period);
+
+    return true;
+}
+
+bool UBMetrics::listen(quint16 port) {
+    m_server = new QTcpServer(this);
+    connect(m_server, SIGNAL(newConnection()), this, SLOT(newConnectionEvent()));
+
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "Metrics server failed to listen on port" << port << m_server->errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void UBMetrics::exportTelemetry() {
+    if (m_telemetrySubscription != -1) {
+        return;
+    }
+
+    m_telemetrySubscription = TelemetryChannelRegistry::instance()->subscribe([this](const TelemetrySample* samples, int count) {
+        telemetryEvent(samples, count);
+    });
+}
+
+void UBMetrics::telemetryEvent(const TelemetrySample* samples, int count) {
+    QMutexLocker locker(&m_gaugeMutex);
+
+    for (int i = 0; i < count; i++) {
+        const TelemetrySample& sample = samples[i];
+        QPair<int, int> key(sample.vehicleId, sample.channel);
+
+        // The channel name is only looked up the first time a vehicle sends the channel
+        QGCMetricGauge* gauge = m_gauges.value(key);
+        if (!gauge) {
+            QGCMetricLabels labels;
+            labels << qMakePair(QStringLiteral("vehicle"), QString::number(sample.vehicleId));
+            labels << qMakePair(QStringLiteral("channel"), TelemetryChannelRegistry::instance()->name(sample.channel));
+            gauge = QGCMetrics::instance()->gauge("vehicle_telemetry", "Plot values of the vehicle by channel", labels);
+            m_gauges[key] = gauge;
+        }
+
+        gauge->set(sample.value);
+    }
+}
+
+void UBMetrics::exportEvent() {
+    qint64 time = QGCClock::instance()->currentMSecsSinceEpoch();
+
+    if (m_format == FORMAT_CSV) {
+        m_file.write(QGCMetrics::instance()->csvLines(time));
+    } else {
+        m_file.write(QGCMetrics::instance()->jsonLine(time));
+    }
+
+    m_file.flush();
+}
+
+void UBMetrics::newConnectionEvent() {
+    while (m_server->hasPendingConnections()) {
+        QTcpSocket* socket = m_server->nextPendingConnection();
+        m_requests[socket] = QByteArray();
+
+        // Qt would otherwise buffer whatever a client sends before the header ends
+        socket->setReadBufferSize(METRICS_MAX_REQUEST);
+        connect(socket, SIGNAL(readyRead()), this, SLOT(requestEvent()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+        connect(socket, &QObject::destroyed, this, [this, socket]() {m_requests.remove(socket);});
+    }
+}
+
+void UBMetrics::requestEvent() {
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket || !m_requests.contains(socket)) {
+        return;
+    }
+
+    // Any request gets the metrics once its header is complete
+    QByteArray& request = m_requests[socket];
+    request += socket->read(METRICS_MAX_REQUEST - request.size());
+    if (!request.contains("\r\n\r\n") && !request.contains("\n\n")) {
+        if (request.size() >= METRICS_MAX_REQUEST) {
+            m_requests.remove(socket);
+            socket->write("HTTP/1.0 431 Request Header Fields Too Large\r\n"
+                          "Connection: close\r\n\r\n");
+            socket->disconnectFromHost();
+        }
+        return;
+    }
+    m_requests.remove(socket);
+
+    QByteArray body = QGCMetrics::instance()->prometheusText();
+    socket->write("HTTP/1.0 200 OK\r\n"
+                  "Content-Type: text/plain; version=0.0.4\r\n"
+                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                  "Connection: close\r\n\r\n");
+    socket->write(body);
+    socket->disconnectFromHost();
+}
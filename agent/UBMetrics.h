@@ -0,0 +1,61 @@
+#ifndef UBMETRICS_H
+#define UBMETRICS_H
+
+#include <QObject>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+
+#include "TelemetryChannelRegistry.h"
+
+class QGCTimer;
+class QGCMetricGauge;
+class QTcpServer;
+class QTcpSocket;
+
+// Exports the QGCMetrics registry of the process, periodically as JSON or CSV lines to a file or stdout, and on
+// request in the Prometheus text format over HTTP on localhost.
+class UBMetrics : public QObject
+{
+    Q_OBJECT
+public:
+    enum EFormat {
+        FORMAT_JSON,
+        FORMAT_CSV,
+    };
+
+    explicit UBMetrics(QObject *parent = nullptr);
+    ~UBMetrics();
+
+    // Writes the metrics every period ms to path, stdout if path is empty
+    bool startExport(int period, EFormat format, const QString& path = QString());
+
+    // Serves the metrics to scrapes on localhost
+    bool listen(quint16 port);
+
+    // Mirrors the plot values of the vehicles from the telemetry channel registry into vehicle_telemetry gauges
+    void exportTelemetry();
+
+protected slots:
+    void exportEvent();
+    void newConnectionEvent();
+    void requestEvent();
+
+private:
+    QGCTimer* m_timer;
+    EFormat m_format;
+    QFile m_file;
+
+    QTcpServer* m_server;
+    QHash<QTcpSocket*, QByteArray> m_requests;
+
+    // Called on the vehicle threads
+    void telemetryEvent(const TelemetrySample* samples, int count);
+
+    int m_telemetrySubscription;
+    QMutex m_gaugeMutex;
+    QHash<QPair<int, int>, QGCMetricGauge*> m_gauges;
+};
+
+#endif // UBMETRICS_H
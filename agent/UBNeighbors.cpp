@@ -0,0 +1,220 @@
+#include "UBNeighbors.h"
+
+#include <QVarLengthArray>
+#include <QtMath>
+
+#include "QGCGeo.h"
+
+UBNeighbors::UBNeighbors(double cell_size) :
+    m_cell_size(cell_size),
+    m_count(0)
+{
+    clear();
+}
+
+void UBNeighbors::update(quint8 id, const QGeoCoordinate& coordinate, qint64 time) {
+    if (!coordinate.isValid()) {
+        return;
+    }
+
+    if (!m_origin.isValid()) {
+        m_origin = coordinate;
+    }
+
+    SNeighbor& neighbor = m_neighbors[id];
+    QPointF position = project(coordinate);
+
+    if (neighbor.valid) {
+        qint64 dt = time - neighbor.time;
+        if (dt > 0) {
+            neighbor.velocity = (position - neighbor.position) * (1000.0 / dt);
+        }
+
+        Cell from = cellOf(neighbor.position);
+        Cell to = cellOf(position);
+        if (from != to) {
+            removeCell(from, id);
+            insertCell(to, id);
+        }
+    } else {
+        neighbor.valid = true;
+        neighbor.velocity = QPointF();
+        insertCell(cellOf(position), id);
+        m_count++;
+    }
+
+    neighbor.coordinate = coordinate;
+    neighbor.position = position;
+    neighbor.time = time;
+}
+
+void UBNeighbors::remove(quint8 id) {
+    SNeighbor& neighbor = m_neighbors[id];
+    if (!neighbor.valid) {
+        return;
+    }
+
+    removeCell(cellOf(neighbor.position), id);
+    neighbor.valid = false;
+    m_count--;
+}
+
+void UBNeighbors::expire(qint64 now, qint64 timeout) {
+    for (int i = 0; i < 256; i++) {
+        if (m_neighbors[i].valid && now - m_neighbors[i].time > timeout) {
+            remove(i);
+        }
+    }
+}
+
+void UBNeighbors::clear() {
+    for (int i = 0; i < 256; i++) {
+        m_neighbors[i].id = i;
+        m_neighbors[i].valid = false;
+    }
+
+    m_count = 0;
+    m_grid.clear();
+}
+
+int UBNeighbors::nearest(const QGeoCoordinate& coordinate, int k, quint8* ids, double max_distance) const {
+    if (k <= 0 || !m_count || !coordinate.isValid()) {
+        return 0;
+    }
+
+    QPointF point = project(coordinate);
+    Cell center = cellOf(point);
+    double max_squared = max_distance * max_distance;
+
+    // Closest k so far, sorted by squared distance
+    QVarLengthArray<QPair<double, quint8>, 16> found;
+    int seen = 0;
+
+    for (int ring = 0; ; ring++) {
+        for (int x = center.first - ring; x <= center.first + ring; x++) {
+            // Only the border of the square, the inside was searched by previous rings
+            int step = (x == center.first - ring || x == center.first + ring) ? 1 : qMax(1, 2 * ring);
+            for (int y = center.second - ring; y <= center.second + ring; y += step) {
+                QHash<Cell, QVector<quint8> >::const_iterator iter = m_grid.constFind(Cell(x, y));
+                if (iter == m_grid.constEnd()) {
+                    continue;
+                }
+
+                const QVector<quint8>& cell = iter.value();
+                for (int i = 0; i < cell.count(); i++) {
+                    seen++;
+
+                    QPointF offset = m_neighbors[cell[i]].position - point;
+                    double squared = QPointF::dotProduct(offset, offset);
+                    if (squared > max_squared || (found.count() == k && squared >= found.last().first)) {
+                        continue;
+                    }
+
+                    if (found.count() < k) {
+                        found.append(qMakePair(squared, cell[i]));
+                    } else {
+                        found.last() = qMakePair(squared, cell[i]);
+                    }
+                    for (int j = found.count() - 1; j > 0 && found[j].first < found[j - 1].first; j--) {
+                        qSwap(found[j], found[j - 1]);
+                    }
+                }
+            }
+        }
+
+        // Anything in the next ring is at least ring cells away from the point
+        double reach = ring * m_cell_size;
+        if (seen == m_count || reach > max_distance || (found.count() == k && found.last().first <= reach * reach)) {
+            break;
+        }
+    }
+
+    for (int i = 0; i < found.count(); i++) {
+        ids[i] = found[i].second;
+    }
+
+    return found.count();
+}
+
+QVector<quint8> UBNeighbors::within(const QGeoCoordinate& coordinate, double radius) const {
+    QVector<quint8> ids;
+    if (!m_count || !coordinate.isValid()) {
+        return ids;
+    }
+
+    QPointF point = project(coordinate);
+    Cell low = cellOf(point - QPointF(radius, radius));
+    Cell high = cellOf(point + QPointF(radius, radius));
+
+    for (int x = low.first; x <= high.first; x++) {
+        for (int y = low.second; y <= high.second; y++) {
+            QHash<Cell, QVector<quint8> >::const_iterator iter = m_grid.constFind(Cell(x, y));
+            if (iter == m_grid.constEnd()) {
+                continue;
+            }
+
+            const QVector<quint8>& cell = iter.value();
+            for (int i = 0; i < cell.count(); i++) {
+                QPointF offset = m_neighbors[cell[i]].position - point;
+                if (QPointF::dotProduct(offset, offset) <= radius * radius) {
+                    ids.append(cell[i]);
+                }
+            }
+        }
+    }
+
+    return ids;
+}
+
+double UBNeighbors::closingSpeed(quint8 id, const QGeoCoordinate& coordinate, const QPointF& velocity) const {
+    const SNeighbor* neighbor = get(id);
+    if (!neighbor || !coordinate.isValid()) {
+        return 0;
+    }
+
+    QPointF offset = neighbor->position - project(coordinate);
+    double distance = qSqrt(QPointF::dotProduct(offset, offset));
+    if (distance <= 0) {
+        return 0;
+    }
+
+    return -QPointF::dotProduct(neighbor->velocity - velocity, offset) / distance;
+}
+
+QPointF UBNeighbors::project(const QGeoCoordinate& coordinate) const {
+    if (coordinate == m_origin) {
+        return QPointF(0, 0);
+    }
+
+    double north, east, down;
+    convertGeoToNed(coordinate, m_origin, &north, &east, &down);
+
+    return QPointF(east, north);
+}
+
+QGeoCoordinate UBNeighbors::unproject(const QPointF& position) const {
+    QGeoCoordinate coordinate;
+    convertNedToGeo(position.y(), position.x(), 0, m_origin, &coordinate);
+
+    return coordinate;
+}
+
+UBNeighbors::Cell UBNeighbors::cellOf(const QPointF& position) const {
+    return Cell(qFloor(position.x() / m_cell_size), qFloor(position.y() / m_cell_size));
+}
+
+void UBNeighbors::insertCell(const Cell& cell, quint8 id) {
+    m_grid[cell].append(id);
+}
+
+void UBNeighbors::removeCell(const Cell& cell, quint8 id) {
+    QHash<Cell, QVector<quint8> >::iterator iter = m_grid.find(cell);
+    if (iter == m_grid.end()) {
+        return;
+    }
+
+    iter.value().removeOne(id);
+    if (iter.value().isEmpty()) {
+        m_grid.erase(iter);
+    }
+}
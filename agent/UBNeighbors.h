@@ -0,0 +1,73 @@
+#ifndef UBNEIGHBORS_H
+#define UBNEIGHBORS_H
+
+#include <QGeoCoordinate>
+#include <QPointF>
+#include <QVector>
+#include <QHash>
+
+// Latest known state of every other agent, keyed by network ID. Positions are projected into a tangent plane (x east,
+// y north) around the first position received and bucketed into a uniform grid, so neighbor queries only look at the
+// cells around the query point. Velocities are estimated from consecutive position reports.
+//
+// Not thread safe, the owning agent updates and queries the table from its own thread.
+class UBNeighbors
+{
+public:
+    struct SNeighbor {
+        quint8 id;
+        bool valid;
+        QGeoCoordinate coordinate;
+        QPointF position;   // Meters east and north of the origin
+        QPointF velocity;   // Meters per second east and north
+        qint64 time;        // Time of the last report in ms
+    };
+
+    explicit UBNeighbors(double cell_size = 20);
+
+    // Adds or updates a neighbor, time is in ms and must not go backwards per neighbor
+    void update(quint8 id, const QGeoCoordinate& coordinate, qint64 time);
+    void remove(quint8 id);
+
+    // Drops neighbors which have not reported for more than timeout ms
+    void expire(qint64 now, qint64 timeout);
+
+    void clear();
+
+    int count() const {return m_count;}
+
+    // nullptr if the neighbor is not known
+    const SNeighbor* get(quint8 id) const {return m_neighbors[id].valid ? &m_neighbors[id] : nullptr;}
+
+    // Up to k neighbors closest to coordinate, closest first, within max_distance meters. ids must hold k entries.
+    // Returns the number found. Only the grid cells up to the k-th distance are searched.
+    int nearest(const QGeoCoordinate& coordinate, int k, quint8* ids, double max_distance = 1e9) const;
+
+    // All neighbors within radius meters of coordinate
+    QVector<quint8> within(const QGeoCoordinate& coordinate, double radius) const;
+
+    // Rate at which the distance to the neighbor shrinks in m/s, negative if it grows
+    double closingSpeed(quint8 id, const QGeoCoordinate& coordinate, const QPointF& velocity) const;
+
+    // Tangent plane used for positions and velocities
+    QPointF project(const QGeoCoordinate& coordinate) const;
+    QGeoCoordinate unproject(const QPointF& position) const;
+
+protected:
+    typedef QPair<int, int> Cell;
+
+    Cell cellOf(const QPointF& position) const;
+    void insertCell(const Cell& cell, quint8 id);
+    void removeCell(const Cell& cell, quint8 id);
+
+protected:
+    double m_cell_size;
+    QGeoCoordinate m_origin;
+
+    SNeighbor m_neighbors[256];
+    int m_count;
+
+    QHash<Cell, QVector<quint8> > m_grid;
+};
+
+#endif // UBNEIGHBORS_H
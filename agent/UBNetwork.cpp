@@ -5,7 +5,7 @@
 
 #include <QHostAddress>
 
-UBNetwork::UBNetwork(QTcpSocket *parent) : QTcpSocket(parent),
+UBNetwork::UBNetwork(QObject *parent) : QTcpSocket(parent),
     m_id(0)
 {
     connect(this, SIGNAL(readyRead()), this, SLOT(dataReadyEvent()));
@@ -7,7 +7,7 @@ class UBNetwork : public QTcpSocket
 {
     Q_OBJECT
 public:
-    explicit UBNetwork(QTcpSocket *parent = 0);
+    explicit UBNetwork(QObject *parent = 0);
 
 signals:
     void dataReady(quint8 srcID, QByteArray data);
@@ -0,0 +1,152 @@
+#include "UBScheduler.h"
+
+#include <QDebug>
+
+#include "QGCClock.h"
+
+UBScheduler::UBScheduler(QObject *parent) : QObject(parent)
+{
+}
+
+int UBScheduler::addAction(const QString& name, std::function<void()> action, int events, int min_interval) {
+    SAction entry;
+    entry.name = name;
+    entry.action = action;
+    entry.events = events;
+    entry.min_interval = min_interval;
+    entry.period = 0;
+    entry.last_run = -1;
+    entry.next_periodic = 0;
+    entry.deferred_since = -1;
+    entry.stats = SStats();
+
+    entry.periodic = new QGCTimer(this);
+    entry.periodic->setTimerType(Qt::PreciseTimer);
+    connect(entry.periodic, SIGNAL(timeout()), this, SLOT(periodicEvent()));
+
+    entry.deferred = new QGCTimer(this);
+    entry.deferred->setTimerType(Qt::PreciseTimer);
+    entry.deferred->setSingleShot(true);
+    connect(entry.deferred, SIGNAL(timeout()), this, SLOT(deferredEvent()));
+
+    m_actions.append(entry);
+
+    return m_actions.count() - 1;
+}
+
+void UBScheduler::setPeriod(int action, int period) {
+    SAction& entry = m_actions[action];
+    if (entry.period == period && (period <= 0 || entry.periodic->isActive())) {
+        return;
+    }
+
+    entry.period = period;
+    entry.periodic->stop();
+
+    if (period > 0) {
+        entry.next_periodic = QGCClock::instance()->elapsed() + period;
+        entry.periodic->start(period);
+    }
+}
+
+void UBScheduler::resetStats() {
+    for (int i = 0; i < m_actions.count(); i++) {
+        m_actions[i].stats = SStats();
+    }
+}
+
+void UBScheduler::trigger(int event) {
+    qint64 now = QGCClock::instance()->elapsed();
+
+    for (int i = 0; i < m_actions.count(); i++) {
+        if (m_actions[i].events & event) {
+            request(i, now);
+        }
+    }
+}
+
+void UBScheduler::request(int action, qint64 now) {
+    SAction& entry = m_actions[action];
+
+    qint64 wait = entry.last_run < 0 ? 0 : entry.last_run + entry.min_interval - now;
+    if (wait <= 0) {
+        entry.stats.event_runs++;
+        run(action, now);
+        return;
+    }
+
+    if (entry.deferred->isActive()) {
+        entry.stats.coalesced++;
+        return;
+    }
+
+    entry.deferred_since = now;
+    entry.deferred->start(wait);
+}
+
+void UBScheduler::run(int action, qint64 now) {
+    SAction& entry = m_actions[action];
+
+    if (entry.deferred_since >= 0) {
+        entry.stats.latency_max = qMax(entry.stats.latency_max, now - entry.deferred_since);
+        entry.deferred_since = -1;
+        entry.deferred->stop();
+    }
+
+    entry.last_run = now;
+    entry.action();
+}
+
+void UBScheduler::periodicEvent() {
+    int action = actionOf(sender());
+    if (action < 0) {
+        return;
+    }
+
+    SAction& entry = m_actions[action];
+    qint64 now = QGCClock::instance()->elapsed();
+
+    qint64 jitter = qAbs(now - entry.next_periodic);
+    entry.stats.jitter_total += jitter;
+    entry.stats.jitter_max = qMax(entry.stats.jitter_max, jitter);
+    entry.stats.periodic_runs++;
+
+    // Timers do not catch up on missed timeouts, the next one is one period from now
+    entry.next_periodic = now + entry.period;
+
+    run(action, now);
+}
+
+void UBScheduler::deferredEvent() {
+    int action = actionOf(sender());
+    if (action < 0) {
+        return;
+    }
+
+    m_actions[action].stats.deferred_runs++;
+    run(action, QGCClock::instance()->elapsed());
+}
+
+int UBScheduler::actionOf(QObject* timer) const {
+    for (int i = 0; i < m_actions.count(); i++) {
+        if (m_actions[i].periodic == timer || m_actions[i].deferred == timer) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void UBScheduler::logStats() {
+    for (int i = 0; i < m_actions.count(); i++) {
+        const SStats& stats = m_actions[i].stats;
+        qInfo() << "Action" << m_actions[i].name
+                << "| Event runs:" << stats.event_runs
+                << "Deferred runs:" << stats.deferred_runs
+                << "Periodic runs:" << stats.periodic_runs
+                << "Coalesced:" << stats.coalesced
+                << "| Latency max (ms):" << stats.latency_max
+                << "| Jitter mean (ms):" << stats.jitterMean()
+                << "max (ms):" << stats.jitter_max;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef UBSCHEDULER_H
+#define UBSCHEDULER_H
+
+#include <QObject>
+#include <QVector>
+
+#include <functional>
+
+class QGCTimer;
+
+// Runs agent actions when something happens instead of on a fixed tick. Each action lists the events it reacts to,
+// a minimum interval between runs and an optional period. An event inside the minimum interval is not dropped, a
+// single deferred run is scheduled for the end of the interval. Periodic runs keep track of how late they fire.
+class UBScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum EEvent {
+        EVENT_POSITION  = 1 << 0,   // New position of the vehicle
+        EVENT_NEIGHBOR  = 1 << 1,   // Packet from another agent
+        EVENT_STATE     = 1 << 2,   // Flight mode or armed state changed
+    };
+
+    struct SStats {
+        int event_runs;
+        int periodic_runs;
+        int deferred_runs;
+        int coalesced;          // Triggers folded into an already pending deferred run
+        qint64 jitter_total;    // Sum of the periodic run delays in ms
+        qint64 jitter_max;
+        qint64 latency_max;     // Longest time in ms from a trigger to the run it caused
+
+        double jitterMean() const {return periodic_runs ? double(jitter_total) / periodic_runs : 0;}
+    };
+
+    explicit UBScheduler(QObject *parent = nullptr);
+
+    // Returns the action ID
+    int addAction(const QString& name, std::function<void()> action, int events, int min_interval);
+
+    // Runs the action every period ms in addition to its events, 0 stops the periodic runs
+    void setPeriod(int action, int period);
+
+    const SStats& getStats(int action) const {return m_actions[action].stats;}
+    void resetStats();
+
+public slots:
+    void trigger(int event);
+    void logStats();
+
+protected slots:
+    void periodicEvent();
+    void deferredEvent();
+
+protected:
+    struct SAction {
+        QString name;
+        std::function<void()> action;
+        int events;
+        int min_interval;
+        int period;
+
+        QGCTimer* periodic;
+        QGCTimer* deferred;
+
+        qint64 last_run;
+        qint64 next_periodic;
+        qint64 deferred_since;
+
+        SStats stats;
+    };
+
+    void request(int action, qint64 now);
+    void run(int action, qint64 now);
+    int actionOf(QObject* timer) const;
+
+protected:
+    QVector<SAction> m_actions;
+};
+
+#endif // UBSCHEDULER_H
@@ -0,0 +1,39 @@
+#include "UBSimClock.h"
+
+#include <QHostAddress>
+#include <QDateTime>
+#include <QtEndian>
+
+#include "QGCClock.h"
+
+UBSimClock::UBSimClock(QGCClock* clock, QObject *parent) : QTcpSocket(parent),
+    m_clock(clock ? clock : QGCClock::instance())
+{
+    connect(this, SIGNAL(readyRead()), this, SLOT(dataReadyEvent()));
+}
+
+void UBSimClock::enableLockstep(QGCClock* clock) {
+    if (!clock) {
+        clock = QGCClock::instance();
+    }
+
+    clock->setLockstep(QDateTime::currentMSecsSinceEpoch());
+}
+
+void UBSimClock::connectToSim(quint16 port) {
+    connectToHost(QHostAddress::LocalHost, port);
+}
+
+void UBSimClock::dataReadyEvent() {
+    m_data += readAll();
+
+    int frames = m_data.size() / sizeof(qint64);
+    for (int i = 0; i < frames; i++) {
+        const uchar* frame = reinterpret_cast<const uchar*>(m_data.constData()) + i * sizeof(qint64);
+        m_clock->advanceTo(m_clock->startMSecsSinceEpoch() + qFromLittleEndian<qint64>(frame));
+
+        write(reinterpret_cast<const char*>(frame), sizeof(qint64));
+    }
+
+    m_data.remove(0, frames * sizeof(qint64));
+}
@@ -0,0 +1,32 @@
+#ifndef UBSIMCLOCK_H
+#define UBSIMCLOCK_H
+
+#include <QTcpSocket>
+
+class QGCClock;
+
+// Drives QGCClock in lockstep mode from an external simulation. The simulation sends its time in ms since the start of
+// the run as little endian 64 bit frames. Each frame advances the clock, which fires every timer due by then, and is
+// echoed back once done so the simulation knows it can take the next step.
+class UBSimClock : public QTcpSocket
+{
+    Q_OBJECT
+public:
+    // clock is the process wide QGCClock unless given
+    explicit UBSimClock(QGCClock* clock = nullptr, QObject *parent = nullptr);
+
+    // Puts the clock in lockstep mode, must be called before any timers are created. The run starts at the current
+    // wall time so timestamps stay plausible for logs and the vehicle.
+    static void enableLockstep(QGCClock* clock = nullptr);
+
+    void connectToSim(quint16 port);
+
+protected slots:
+    void dataReadyEvent();
+
+private:
+    QGCClock* m_clock;
+    QByteArray m_data;
+};
+
+#endif // UBSIMCLOCK_H
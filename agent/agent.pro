@@ -22,14 +22,28 @@ TEMPLATE = app
 HEADERS += \
     UBConfig.h \
     UBAgent.h \
+    UBAgentHost.h \
     UBPacket.h \
     UBNetwork.h \
+    UBGeoFence.h \
+    UBNeighbors.h \
+    UBAvoidance.h \
+    UBScheduler.h \
+    UBSimClock.h \
+    UBMetrics.h \
 
 SOURCES += \
     main.cc \
     UBAgent.cpp \
+    UBAgentHost.cpp \
     UBPacket.cpp \
     UBNetwork.cpp \
+    UBGeoFence.cpp \
+    UBNeighbors.cpp \
+    UBAvoidance.cpp \
+    UBScheduler.cpp \
+    UBSimClock.cpp \
+    UBMetrics.cpp \
 
 #
 # QGroundControl Library
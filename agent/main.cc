@@ -24,10 +24,16 @@
 #include <QUdpSocket>
 #include <QtPlugin>
 #include <QStringListModel>
+#include <QCommandLineParser>
+#include <QThread>
 #include "QGCApplication.h"
 #include "AppMessages.h"
 
 #include "UBAgent.h"
+#include "UBAgentHost.h"
+#include "UBSimClock.h"
+#include "UBMetrics.h"
+#include "MAVLinkSigning.h"
 
 #ifndef __mobile__
     #include "QGCSerialPortInfo.h"
@@ -208,11 +214,85 @@ int main(int argc, char *argv[])
 #endif
 #endif // QT_DEBUG
 
+    // --lockstep <port> runs on simulation time received from the port instead of the wall clock. This has to be known
+    // before QGCApplication starts the first timers.
+    quint16 lockstepPort = 0;
+    for (int i = 1; i < argc - 1; i++) {
+        if (QString(argv[i]) == QStringLiteral("--lockstep")) {
+            lockstepPort = QString(argv[i + 1]).toUShort();
+        }
+    }
+    if (lockstepPort) {
+        UBSimClock::enableLockstep();
+    }
+
     QGCApplication* app = new QGCApplication(argc, argv, runUnitTests);
     Q_CHECK_PTR(app);
 
-    UBAgent* agent = new UBAgent;
-    Q_CHECK_PTR(agent);
+    // -N <count> hosts count agents with consecutive IDs in this process, starting at the -I ID
+    QCommandLineParser parser;
+    parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
+    parser.addOptions({
+        {{"I", "instance"}, "Set instance (ID) of the agent", "id"},
+        {{"N", "count"}, "Number of agents to host in this process", "count"},
+        {{"T", "threads"}, "Number of worker threads for hosted agents", "threads"},
+        {"lockstep", "Run on simulation time from an external clock", "port"},
+        {"key", "Sign the MAVLink traffic with the vehicle using this passphrase", "passphrase"},
+        {"redundant", "Second link to the vehicle over TCP on this port, commands go out on both", "port"},
+        {"metrics", "Write the metrics every period seconds", "period"},
+        {"metrics-format", "Format of the written metrics, json or csv", "format"},
+        {"metrics-file", "File the metrics are written to instead of stdout", "path"},
+        {"metrics-port", "Serve the metrics in the Prometheus format on localhost", "port"},
+        {"metrics-telemetry", "Add the plot values of the vehicles to the metrics"},
+    });
+    parser.parse(QCoreApplication::arguments());
+
+    // The signing key is derived once for all agents
+    UBAgent::SLinkOptions linkOptions;
+    if (parser.isSet("key")) {
+        linkOptions.key = MAVLinkSigning::keyFromPassphrase(parser.value("key"));
+    }
+    linkOptions.redundant = parser.value("redundant").toUShort();
+
+    UBAgentHost* host = nullptr;
+    int agentCount = parser.value("N").toInt();
+    if (agentCount > 1) {
+        int firstID = parser.value("I").toInt();
+        if (!UBAgentHost::validIDs(firstID, agentCount)) {
+            qCritical() << "Agent IDs" << firstID << "to" << firstID + agentCount - 1 << "do not fit 1 to 255";
+            return -1;
+        }
+
+        int threads = parser.isSet("T") ? parser.value("T").toInt() : QThread::idealThreadCount();
+        host = new UBAgentHost(firstID, agentCount, threads, linkOptions);
+        Q_CHECK_PTR(host);
+    } else {
+        UBAgent* agent = new UBAgent(linkOptions);
+        Q_CHECK_PTR(agent);
+    }
+
+    if (lockstepPort) {
+        UBSimClock* simClock = new UBSimClock;
+        Q_CHECK_PTR(simClock);
+        simClock->connectToSim(lockstepPort);
+    }
+
+    // --metrics <period> writes latency and loss metrics of the links, vehicles and missions, --metrics-port serves them
+    if (parser.isSet("metrics") || parser.isSet("metrics-port")) {
+        UBMetrics* metrics = new UBMetrics;
+        Q_CHECK_PTR(metrics);
+
+        if (parser.isSet("metrics")) {
+            UBMetrics::EFormat format = parser.value("metrics-format") == QStringLiteral("csv") ? UBMetrics::FORMAT_CSV : UBMetrics::FORMAT_JSON;
+            metrics->startExport(qMax(1, int(parser.value("metrics").toDouble() * 1000)), format, parser.value("metrics-file"));
+        }
+        if (parser.isSet("metrics-port")) {
+            metrics->listen(parser.value("metrics-port").toUShort());
+        }
+        if (parser.isSet("metrics-telemetry")) {
+            metrics->exportTelemetry();
+        }
+    }
 
 #ifdef Q_OS_LINUX
 //    QApplication::setWindowIcon(QIcon(":/res/resources/icons/qgroundcontrol.ico"));
@@ -224,6 +304,8 @@ int main(int argc, char *argv[])
     // while we only have the main thread. That should prevent it from hitting the race condition later
     // on in the code.
     qRegisterMetaType<QList<QPair<QByteArray,QByteArray> > >();
+    // Fence polygons are queued to agents on worker threads
+    qRegisterMetaType<QList<QGeoCoordinate> >();
 
     app->_initCommon();
     //-- Initialize Cache System
@@ -258,6 +340,9 @@ int main(int argc, char *argv[])
         exitCode = app->exec();
     }
 
+    // Stops the worker threads, the hosted agents go with them
+    delete host;
+
     app->_shutdown();
     delete app;
     //-- Shutdown Cache System
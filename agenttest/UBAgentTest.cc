@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+#include "UBAgentTest.h"
+#include "UBAgent.h"
+#include "UBAgentHost.h"
+#include "UBSimClock.h"
+
+#include "QGCApplication.h"
+#include "MultiVehicleManager.h"
+#include "MockLink.h"
+#include "QGCClock.h"
+
+#include <QtTest>
+#include <QPointer>
+#include <QThread>
+#include <QTcpServer>
+#include <QDateTime>
+#include <QtEndian>
+
+/// Gives the tests access to the agents of a host
+class TestAgentHost : public UBAgentHost
+{
+public:
+    using UBAgentHost::UBAgentHost;
+
+    const QList<UBAgent*>& agents   (void) const { return m_agents; }
+    const QList<QThread*>& threads  (void) const { return m_threads; }
+};
+
+/// Hosted agent on a given link, which is not added to the LinkManager
+class TestAgent : public UBAgent
+{
+public:
+    TestAgent(quint8 id, LinkConfiguration* link)
+        : UBAgent(id, SLinkOptions())
+    {
+        m_link = link;
+    }
+
+    Vehicle*    mav         (void) const { return m_mav; }
+    void        addVehicle  (Vehicle* mav) { vehicleAddedEvent(mav); }
+};
+
+UBAgentTest::UBAgentTest(void)
+    : _mockLink(NULL)
+    , _vehicle(NULL)
+{
+
+}
+
+void UBAgentTest::init(void)
+{
+    _mockLink = NULL;
+    _vehicle = NULL;
+}
+
+void UBAgentTest::cleanup(void)
+{
+    if (_mockLink) {
+        LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+        QSignalSpy linkSpy(linkManager, SIGNAL(linkDeleted(LinkInterface*)));
+        linkManager->disconnectLink(_mockLink);
+        linkSpy.wait(1000);
+        _mockLink = NULL;
+        _vehicle = NULL;
+    }
+}
+
+void UBAgentTest::_connectMockLink(void)
+{
+    MultiVehicleManager* vehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+    QSignalSpy spyVehicle(vehicleManager, SIGNAL(parameterReadyVehicleAvailableChanged(bool)));
+
+    _mockLink = MockLink::startAPMArduCopterMockLink(false);
+    QCOMPARE(spyVehicle.wait(10000), true);
+    _vehicle = vehicleManager->activeVehicle();
+    QVERIFY(_vehicle);
+}
+
+void UBAgentTest::_hostIDs(void)
+{
+    QCOMPARE(UBAgentHost::validIDs(1, 255), true);
+    QCOMPARE(UBAgentHost::validIDs(200, 56), true);
+
+    // IDs past 255 would wrap around onto the first agents
+    QCOMPARE(UBAgentHost::validIDs(1, 256), false);
+    QCOMPARE(UBAgentHost::validIDs(200, 57), false);
+    QCOMPARE(UBAgentHost::validIDs(255 + 1, 1), false);
+
+    // ID 0 is the agent on the serial port
+    QCOMPARE(UBAgentHost::validIDs(0, 2), false);
+    QCOMPARE(UBAgentHost::validIDs(1, 0), false);
+}
+
+void UBAgentTest::_hostLifetime(void)
+{
+    TestAgentHost* host = new TestAgentHost(200, 4, 2, UBAgent::SLinkOptions());
+
+    QCOMPARE(host->getAgentCount(), 4);
+    QCOMPARE(host->threads().count(), 2);
+
+    // Agents are spread over the worker threads in turn
+    QList<QPointer<UBAgent> > agents;
+    for (int i = 0; i < host->agents().count(); i++) {
+        UBAgent* agent = host->agents()[i];
+        QCOMPARE(agent->getID(), (quint8)(200 + i));
+        QCOMPARE(agent->thread(), host->threads()[i % 2]);
+        agents.append(agent);
+    }
+
+    // Deleting the host stops the workers, the agents are deleted on them as they finish
+    delete host;
+    for (int i = 0; i < agents.count(); i++) {
+        QTRY_VERIFY(agents[i].isNull());
+    }
+}
+
+void UBAgentTest::_hostedVehicle(void)
+{
+    _connectMockLink();
+
+    TestAgent own(1, _vehicle->priorityLink()->getLinkConfiguration());
+    TestAgent other(2, NULL);
+
+    // Every hosted agent sees every vehicle, only the one on the vehicle's link takes it
+    own.addVehicle(_vehicle);
+    other.addVehicle(_vehicle);
+
+    QTRY_COMPARE(own.mav(), _vehicle);
+    QTest::qWait(100);
+    QVERIFY(!other.mav());
+}
+
+void UBAgentTest::_simClock(void)
+{
+    // A clock of the test's own, the process wide clock stays on the wall clock for the other tests
+    QGCClock clock;
+    qint64 wallTime = QDateTime::currentMSecsSinceEpoch();
+    UBSimClock::enableLockstep(&clock);
+
+    // The run starts at the wall time rather than at the epoch
+    QVERIFY(clock.lockstep());
+    QVERIFY(qAbs(clock.startMSecsSinceEpoch() - wallTime) < 1000);
+    QCOMPARE(clock.currentMSecsSinceEpoch(), clock.startMSecsSinceEpoch());
+
+    QList<qint64> firedAt;
+    QGCTimer timer(nullptr, &clock);
+    connect(&timer, &QGCTimer::timeout, [&firedAt, &clock]() {
+        firedAt.append(clock.elapsed());
+    });
+    timer.start(100);
+
+    QTcpServer sim;
+    QVERIFY(sim.listen(QHostAddress::LocalHost));
+    UBSimClock simClock(&clock);
+    simClock.connectToSim(sim.serverPort());
+    QVERIFY(sim.waitForNewConnection(5000));
+    QTcpSocket* simSocket = sim.nextPendingConnection();
+
+    // Frames are ms since the start of the run, each is echoed once its timers have fired
+    uchar frame[sizeof(qint64)];
+    qToLittleEndian<qint64>(250, frame);
+    simSocket->write(reinterpret_cast<const char*>(frame), sizeof(frame));
+    QTRY_COMPARE(simSocket->bytesAvailable(), (qint64)sizeof(frame));
+    QCOMPARE(simSocket->readAll(), QByteArray(reinterpret_cast<const char*>(frame), sizeof(frame)));
+
+    QCOMPARE(firedAt, QList<qint64>() << 100 << 200);
+    QCOMPARE(clock.elapsed(), (qint64)250);
+    QCOMPARE(clock.currentMSecsSinceEpoch(), clock.startMSecsSinceEpoch() + 250);
+}
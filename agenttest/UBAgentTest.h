@@ -0,0 +1,43 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+#ifndef UBAgentTest_H
+#define UBAgentTest_H
+
+#include <QObject>
+
+class MockLink;
+class Vehicle;
+
+/// Tests of the agent and of hosting many agents in one process, against MockLink vehicles
+class UBAgentTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    UBAgentTest(void);
+
+private slots:
+    void init(void);
+    void cleanup(void);
+
+    void _hostIDs(void);
+    void _hostLifetime(void);
+    void _hostedVehicle(void);
+    void _simClock(void);
+
+private:
+    void _connectMockLink(void);
+
+    MockLink*   _mockLink;
+    Vehicle*    _vehicle;
+};
+
+#endif
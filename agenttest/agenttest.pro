@@ -0,0 +1,48 @@
+QT -= gui
+QT += testlib
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+CONFIG += link_prl
+
+TARGET   = agenttest
+TEMPLATE = app
+
+# The agent is compiled in from its sources, without its main
+INCLUDEPATH += $$PWD/../agent
+
+HEADERS += \
+    UBAgentTest.h \
+    ../agent/UBConfig.h \
+    ../agent/UBAgent.h \
+    ../agent/UBAgentHost.h \
+    ../agent/UBPacket.h \
+    ../agent/UBNetwork.h \
+    ../agent/UBGeoFence.h \
+    ../agent/UBNeighbors.h \
+    ../agent/UBAvoidance.h \
+    ../agent/UBScheduler.h \
+    ../agent/UBSimClock.h \
+    ../agent/UBMetrics.h \
+
+SOURCES += \
+    main.cc \
+    UBAgentTest.cc \
+    ../agent/UBAgent.cpp \
+    ../agent/UBAgentHost.cpp \
+    ../agent/UBPacket.cpp \
+    ../agent/UBNetwork.cpp \
+    ../agent/UBGeoFence.cpp \
+    ../agent/UBNeighbors.cpp \
+    ../agent/UBAvoidance.cpp \
+    ../agent/UBScheduler.cpp \
+    ../agent/UBSimClock.cpp \
+    ../agent/UBMetrics.cpp \
+
+#
+# QGroundControl Library
+#
+include(../agent/qgc.pri)
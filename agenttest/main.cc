@@ -0,0 +1,76 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Tests of the agent
+ *
+ */
+
+#include <QtGlobal>
+#include <QtTest>
+#include "QGCApplication.h"
+#include "AppMessages.h"
+
+#include "UBAgentTest.h"
+
+#ifndef __mobile__
+    #include "QGCSerialPortInfo.h"
+#endif
+
+/* SDL does ugly things to main() */
+#ifdef main
+#undef main
+#endif
+
+#ifndef __mobile__
+    Q_DECLARE_METATYPE(QGCSerialPortInfo)
+#endif
+
+int main(int argc, char *argv[])
+{
+#ifdef Q_OS_UNIX
+    //Force writing to the console on UNIX/BSD devices
+    if (!qEnvironmentVariableIsSet("QT_LOGGING_TO_CONSOLE"))
+        qputenv("QT_LOGGING_TO_CONSOLE", "1");
+#endif
+
+    // install the message handler
+    AppMessages::installHandler();
+
+#ifndef NO_SERIAL_LINK
+    qRegisterMetaType<QSerialPort::SerialPortError>();
+#endif
+    qRegisterMetaType<QAbstractSocket::SocketError>();
+#ifndef __mobile__
+    qRegisterMetaType<QGCSerialPortInfo>();
+#endif
+    // Fence polygons are queued to agents on worker threads
+    qRegisterMetaType<QList<QGeoCoordinate> >();
+
+    // Run like the unit tests, with clean settings of their own and no auto connected links
+    QGCApplication* app = new QGCApplication(argc, argv, true);
+    Q_CHECK_PTR(app);
+
+    app->_initCommon();
+
+    if (!app->_initForUnitTests()) {
+        return -1;
+    }
+
+    // Every argument goes to QtTest, so the usual function selection and output options apply
+    UBAgentTest test;
+    int exitCode = QTest::qExec(&test, QCoreApplication::arguments());
+
+    app->_shutdown();
+    delete app;
+
+    return exitCode;
+}
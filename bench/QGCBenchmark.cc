@@ -0,0 +1,716 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+#include "QGCBenchmark.h"
+#include "QGCApplication.h"
+#include "MultiVehicleManager.h"
+#include "MAVLinkProtocol.h"
+#include "MAVLinkCRC.h"
+#include "MAVLinkSigning.h"
+#include "MockLink.h"
+#include "ParameterManager.h"
+#include "SurveyMissionItem.h"
+#include "QGCGeo.h"
+#include "UBPacket.h"
+
+#include <QtTest>
+#include <QFile>
+#include <QtMath>
+
+const char* QGCBenchmark::_tlogEnvVar = "BENCH_TLOG";
+const char* QGCBenchmark::_signingPassphrase = "bench";
+
+QGCBenchmark::QGCBenchmark(void)
+    : _mockLink(NULL)
+    , _vehicle(NULL)
+    , _offlineVehicle(NULL)
+    , _link(NULL)
+    , _mavlinkChannel(0)
+    , _nextComponentId(100)
+{
+
+}
+
+void QGCBenchmark::initTestCase(void)
+{
+    LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+
+    _mavlinkChannel = linkManager->_reserveMavlinkChannel();
+    QVERIFY(_mavlinkChannel != 0);
+    mavlink_set_proto_version(_mavlinkChannel, 2);
+
+    _mockLink = MockLink::startAPMArduCopterMockLink(false);
+
+    // Wait for the Vehicle to get created and its parameters loaded
+    QSignalSpy spyVehicle(qgcApp()->toolbox()->multiVehicleManager(), SIGNAL(parameterReadyVehicleAvailableChanged(bool)));
+    QCOMPARE(spyVehicle.wait(10000), true);
+    _vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    QVERIFY(_vehicle);
+    _link = _vehicle->priorityLink();
+    QVERIFY(_link);
+
+    _offlineVehicle = new Vehicle(MAV_AUTOPILOT_PX4, MAV_TYPE_QUADROTOR, qgcApp()->toolbox()->firmwarePluginManager(), this);
+
+    // Streams from a system without heartbeats are only parsed, the stack never creates a vehicle for them
+    _streams["parse only"] = _syntheticStream(_foreignSystemId, false);
+    _streams["synthetic"] = _syntheticStream(_vehicle->id(), true);
+
+    QString tlog = QString::fromLocal8Bit(qgetenv(_tlogEnvVar));
+    if (!tlog.isEmpty()) {
+        Stream_t stream = _tlogStream(tlog, _vehicle->id());
+        QVERIFY2(!stream.messages.isEmpty(), qPrintable(QString("No vehicle messages in %1").arg(tlog)));
+        _streams["tlog"] = stream;
+    }
+
+    foreach (const QString& name, _streams.keys()) {
+        qDebug() << "Stream" << name << "messages:" << _streams[name].messages.count() << "bytes:" << _streams[name].bytes.count();
+    }
+}
+
+void QGCBenchmark::cleanupTestCase(void)
+{
+    LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+
+    delete _offlineVehicle;
+    _offlineVehicle = NULL;
+
+    if (_mockLink) {
+        QSignalSpy linkSpy(linkManager, SIGNAL(linkDeleted(LinkInterface*)));
+        linkManager->disconnectLink(_mockLink);
+        linkSpy.wait(1000);
+        _mockLink = NULL;
+        _vehicle = NULL;
+        _link = NULL;
+    }
+
+    if (_mavlinkChannel) {
+        linkManager->_freeMavlinkChannel(_mavlinkChannel);
+        _mavlinkChannel = 0;
+    }
+}
+
+void QGCBenchmark::_addStreamRows(void)
+{
+    QTest::addColumn<QString>("stream");
+
+    // The tlog row is always there so result files keep the same rows, it is skipped without a log
+    QTest::newRow("parse only") << QString("parse only");
+    QTest::newRow("synthetic")  << QString("synthetic");
+    QTest::newRow("tlog")       << QString("tlog");
+}
+
+void QGCBenchmark::_appendMessage(Stream_t& stream, mavlink_message_t& message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int length = mavlink_msg_to_send_buffer(buffer, &message);
+
+    stream.messages.append(message);
+    stream.bytes.append((const char*)buffer, length);
+}
+
+/// Telemetry of a copter flying a circle, at the rates a typical stream configuration sends it
+QGCBenchmark::Stream_t QGCBenchmark::_syntheticStream(int systemId, bool heartbeats)
+{
+    Stream_t            stream;
+    mavlink_message_t   message;
+    const QGeoCoordinate home(47.3764, 8.5481, 500.0);
+    const int           ticks = _syntheticSeconds * _syntheticRate;
+
+    for (int i=0; i<ticks; i++) {
+        uint32_t        timeBootMs = i * 1000 / _syntheticRate;
+        double          heading = 360.0 * i / ticks;
+        double          yaw = qDegreesToRadians(heading);
+        QGeoCoordinate  coord = home.atDistanceAndAzimuth(50.0, heading);
+        int32_t         lat = coord.latitude() * 1e7;
+        int32_t         lon = coord.longitude() * 1e7;
+        int32_t         alt = coord.altitude() * 1000;
+        int16_t         vx = 500 * qCos(yaw + M_PI_2);
+        int16_t         vy = 500 * qSin(yaw + M_PI_2);
+
+        if (i % _syntheticRate == 0) {
+            if (heartbeats) {
+                mavlink_msg_heartbeat_pack_chan(systemId,
+                                                MAV_COMP_ID_AUTOPILOT1,
+                                                _mavlinkChannel,
+                                                &message,
+                                                MAV_TYPE_QUADROTOR,
+                                                MAV_AUTOPILOT_ARDUPILOTMEGA,
+                                                MAV_MODE_FLAG_CUSTOM_MODE_ENABLED,
+                                                0,                              // custom_mode
+                                                MAV_STATE_ACTIVE);
+                _appendMessage(stream, message);
+            }
+
+            mavlink_msg_sys_status_pack_chan(systemId,
+                                             MAV_COMP_ID_AUTOPILOT1,
+                                             _mavlinkChannel,
+                                             &message,
+                                             0, 0, 0,                           // sensors present, enabled, health
+                                             250,                               // load
+                                             12600,                             // voltage_battery
+                                             1000,                              // current_battery
+                                             80,                                // battery_remaining
+                                             0, 0, 0, 0, 0, 0);                 // drop rate and errors
+            _appendMessage(stream, message);
+        }
+
+        mavlink_msg_gps_raw_int_pack_chan(systemId,
+                                          MAV_COMP_ID_AUTOPILOT1,
+                                          _mavlinkChannel,
+                                          &message,
+                                          (uint64_t)timeBootMs * 1000,
+                                          GPS_FIX_TYPE_3D_FIX,
+                                          lat,
+                                          lon,
+                                          alt,
+                                          100,                                  // eph
+                                          100,                                  // epv
+                                          500,                                  // vel
+                                          heading * 100,                        // cog
+                                          12);                                  // satellites_visible
+        _appendMessage(stream, message);
+
+        mavlink_msg_global_position_int_pack_chan(systemId,
+                                                  MAV_COMP_ID_AUTOPILOT1,
+                                                  _mavlinkChannel,
+                                                  &message,
+                                                  timeBootMs,
+                                                  lat,
+                                                  lon,
+                                                  alt,
+                                                  20000,                        // relative_alt
+                                                  vx,
+                                                  vy,
+                                                  0,                            // vz
+                                                  heading * 100);
+        _appendMessage(stream, message);
+
+        mavlink_msg_attitude_pack_chan(systemId,
+                                       MAV_COMP_ID_AUTOPILOT1,
+                                       _mavlinkChannel,
+                                       &message,
+                                       timeBootMs,
+                                       0.05f,                                   // roll
+                                       -0.05f,                                  // pitch
+                                       yaw,
+                                       0.0f, 0.0f, 0.1f);                       // roll, pitch and yaw speed
+        _appendMessage(stream, message);
+
+        mavlink_msg_vfr_hud_pack_chan(systemId,
+                                      MAV_COMP_ID_AUTOPILOT1,
+                                      _mavlinkChannel,
+                                      &message,
+                                      5.0f,                                     // airspeed
+                                      5.0f,                                     // groundspeed
+                                      heading,
+                                      50,                                       // throttle
+                                      coord.altitude(),
+                                      0.0f);                                    // climb
+        _appendMessage(stream, message);
+    }
+
+    return stream;
+}
+
+/// Loads the messages of the first vehicle in a tlog and re-addresses them to the given system, so they replay
+/// against the vehicle under test.
+QGCBenchmark::Stream_t QGCBenchmark::_tlogStream(const QString& filename, int systemId)
+{
+    Stream_t stream;
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Unable to open tlog" << filename << file.errorString();
+        return stream;
+    }
+    QByteArray data = file.readAll();
+
+    mavlink_message_t   message;
+    mavlink_status_t    status;
+    int                 sourceSystemId = -1;
+    int                 position = 0;
+
+    mavlink_reset_channel_status(_mavlinkChannel);
+
+    // Every record is an 8 byte big endian timestamp followed by one message. After a corrupt record the parser
+    // skips over the next timestamp as garbage and picks up with the following message.
+    while (position + (int)sizeof(quint64) < data.size()) {
+        position += sizeof(quint64);
+
+        bool found = false;
+        while (!found && position < data.size()) {
+            found = mavlink_parse_char(_mavlinkChannel, (uint8_t)data[position++], &message, &status) == MAVLINK_FRAMING_OK;
+        }
+        if (!found) {
+            break;
+        }
+
+        if (sourceSystemId < 0 && message.msgid == MAVLINK_MSG_ID_HEARTBEAT && mavlink_msg_heartbeat_get_type(&message) != MAV_TYPE_GCS) {
+            sourceSystemId = message.sysid;
+        }
+        if (message.sysid != sourceSystemId) {
+            continue;
+        }
+
+        const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(message.msgid);
+        if (!entry) {
+            continue;
+        }
+
+        mavlink_finalize_message_chan(&message, systemId, message.compid, _mavlinkChannel, entry->msg_len, message.len, entry->crc_extra);
+        _appendMessage(stream, message);
+    }
+
+    return stream;
+}
+
+void QGCBenchmark::_receiveBytes_data(void)
+{
+    _addStreamRows();
+}
+
+void QGCBenchmark::_receiveBytes(void)
+{
+    QFETCH(QString, stream);
+
+    if (!_streams.contains(stream)) {
+        QSKIP("No tlog given in BENCH_TLOG");
+    }
+
+    MAVLinkProtocol*    mavlink = qgcApp()->toolbox()->mavlinkProtocol();
+    QByteArray          bytes = _streams[stream].bytes;
+
+    QBENCHMARK {
+        mavlink->receiveBytes(_link, bytes);
+    }
+}
+
+void QGCBenchmark::_vehicleDispatch_data(void)
+{
+    _addStreamRows();
+}
+
+void QGCBenchmark::_vehicleDispatch(void)
+{
+    QFETCH(QString, stream);
+
+    if (!_streams.contains(stream)) {
+        QSKIP("No tlog given in BENCH_TLOG");
+    }
+
+    const QVector<mavlink_message_t>& messages = _streams[stream].messages;
+
+    QBENCHMARK {
+        for (int i=0; i<messages.count(); i++) {
+            _vehicle->_mavlinkMessageReceived(_link, messages[i]);
+        }
+    }
+}
+
+/// The search mavlink_helpers.h does without MAVLINK_GET_MSG_ENTRY, as the baseline for MAVLinkMessageTable
+const mavlink_msg_entry_t* QGCBenchmark::_bisectMessageEntry(uint32_t msgid)
+{
+    static const mavlink_msg_entry_t rgEntries[] = MAVLINK_MESSAGE_CRCS;
+
+    uint32_t low = 0;
+    uint32_t high = sizeof(rgEntries) / sizeof(rgEntries[0]);
+    while (low < high) {
+        uint32_t mid = (low + 1 + high) / 2;
+        if (msgid < rgEntries[mid].msgid) {
+            high = mid - 1;
+            continue;
+        }
+        if (msgid > rgEntries[mid].msgid) {
+            low = mid;
+            continue;
+        }
+        low = mid;
+        break;
+    }
+    return rgEntries[low].msgid == msgid ? &rgEntries[low] : NULL;
+}
+
+void QGCBenchmark::_messageEntry_data(void)
+{
+    QTest::addColumn<bool>("bisect");
+
+    QTest::newRow("table")      << false;
+    QTest::newRow("bisection")  << true;
+}
+
+/// Lookup of every message id of all streams, in stream order, plus the ids of the whole dialect so the sparse ones
+/// above MAVLinkMessageTable::denseCount are in the mix
+void QGCBenchmark::_messageEntry(void)
+{
+    QFETCH(bool, bisect);
+
+    static const mavlink_msg_entry_t rgEntries[] = MAVLINK_MESSAGE_CRCS;
+    QVector<uint32_t> msgids;
+
+    foreach (const Stream_t& stream, _streams) {
+        for (int i=0; i<stream.messages.count(); i++) {
+            msgids.append(stream.messages[i].msgid);
+        }
+    }
+    for (size_t i=0; i<sizeof(rgEntries)/sizeof(rgEntries[0]); i++) {
+        msgids.append(rgEntries[i].msgid);
+    }
+
+    uint32_t crcSum = 0;
+    if (bisect) {
+        QBENCHMARK {
+            for (int i=0; i<msgids.count(); i++) {
+                crcSum += _bisectMessageEntry(msgids[i])->crc_extra;
+            }
+        }
+    } else {
+        QBENCHMARK {
+            for (int i=0; i<msgids.count(); i++) {
+                crcSum += mavlink_get_msg_entry(msgids[i])->crc_extra;
+            }
+        }
+    }
+    QVERIFY(crcSum > 0);
+}
+
+void QGCBenchmark::_crc_data(void)
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("reference");
+
+    // A small message, the largest frame and a bulk buffer
+    QTest::newRow("64 byte at a time")      << 64                       << true;
+    QTest::newRow("64 slice-by-8")          << 64                       << false;
+    QTest::newRow("280 byte at a time")     << MAVLINK_MAX_PACKET_LEN   << true;
+    QTest::newRow("280 slice-by-8")         << MAVLINK_MAX_PACKET_LEN   << false;
+    QTest::newRow("64k byte at a time")     << 65536                    << true;
+    QTest::newRow("64k slice-by-8")         << 65536                    << false;
+}
+
+void QGCBenchmark::_crc(void)
+{
+    QFETCH(int, size);
+    QFETCH(bool, reference);
+
+    QByteArray      bytes(size, 0);
+    const uint8_t*  data = (const uint8_t*)bytes.constData();
+    uint16_t        crc = X25_INIT_CRC;
+
+    for (int i=0; i<size; i++) {
+        bytes[i] = (char)(i * 31);
+    }
+
+    if (reference) {
+        QBENCHMARK {
+            crc = MAVLinkCRC::accumulateReference(crc, data, size);
+        }
+    } else {
+        QBENCHMARK {
+            crc = MAVLinkCRC::accumulate(crc, data, size);
+        }
+    }
+    Q_UNUSED(crc);
+    QCOMPARE(MAVLinkCRC::accumulate(X25_INIT_CRC, data, size), MAVLinkCRC::accumulateReference(X25_INIT_CRC, data, size));
+}
+
+/// The messages of a stream finalized again on a MAVLink 2 channel, signed when signing is given
+QGCBenchmark::Stream_t QGCBenchmark::_signedStream(const Stream_t& source, mavlink_signing_t* signing)
+{
+    LinkManager*        linkManager = qgcApp()->toolbox()->linkManager();
+    int                 channel = linkManager->_reserveMavlinkChannel();
+    mavlink_status_t*   status = mavlink_get_channel_status(channel);
+    Stream_t            stream;
+
+    mavlink_set_proto_version(channel, 2);
+    status->signing = signing;
+
+    for (int i=0; i<source.messages.count(); i++) {
+        mavlink_message_t           message = source.messages[i];
+        const mavlink_msg_entry_t*  entry = mavlink_get_msg_entry(message.msgid);
+
+        mavlink_finalize_message_chan(&message, message.sysid, message.compid, channel, entry->msg_len, message.len, entry->crc_extra);
+        _appendMessage(stream, message);
+    }
+
+    status->signing = NULL;
+    linkManager->_freeMavlinkChannel(channel);
+
+    return stream;
+}
+
+/// @return false: the SHA extensions are wanted but the CPU does not have them
+bool QGCBenchmark::_setSHA256Hardware(bool hardware)
+{
+    if (hardware && !MAVLinkSHA256::hardwareAvailable()) {
+        return false;
+    }
+    MAVLinkSHA256::setHardwareEnabled(hardware);
+    return true;
+}
+
+void QGCBenchmark::_signedParse_data(void)
+{
+    QTest::addColumn<bool>("sign");
+    QTest::addColumn<bool>("hardware");
+
+    QTest::newRow("unsigned")               << false    << false;
+    QTest::newRow("signed portable")        << true     << false;
+    QTest::newRow("signed SHA extensions")  << true     << true;
+}
+
+/// Parsing of the synthetic stream with and without signature checks, the difference is the per frame cost of signing
+void QGCBenchmark::_signedParse(void)
+{
+    QFETCH(bool, sign);
+    QFETCH(bool, hardware);
+
+    if (!_setSHA256Hardware(hardware)) {
+        QSKIP("No SHA extensions on this CPU");
+    }
+
+    QByteArray          key = MAVLinkSigning::keyFromPassphrase(_signingPassphrase);
+    mavlink_signing_t   sendSigning;
+    mavlink_signing_t   receiveSigning;
+
+    MAVLinkSigning::initSigning(&sendSigning, key, 0);
+    MAVLinkSigning::initSigning(&receiveSigning, key, 0);
+    Stream_t stream = _signedStream(_streams["synthetic"], sign ? &sendSigning : NULL);
+
+    LinkManager*                linkManager = qgcApp()->toolbox()->linkManager();
+    int                         channel = linkManager->_reserveMavlinkChannel();
+    mavlink_status_t*           status = mavlink_get_channel_status(channel);
+    mavlink_signing_streams_t   signingStreams;
+
+    if (sign) {
+        status->signing = &receiveSigning;
+        status->signing_streams = &signingStreams;
+    }
+
+    int decoded = 0;
+    QBENCHMARK {
+        // Every pass replays the same timestamps, which only a fresh stream table accepts
+        memset(&signingStreams, 0, sizeof(signingStreams));
+        decoded = 0;
+
+        mavlink_message_t   message;
+        mavlink_status_t    messageStatus;
+        for (int i=0; i<stream.bytes.size(); i++) {
+            if (mavlink_parse_char(channel, (uint8_t)stream.bytes[i], &message, &messageStatus) == MAVLINK_FRAMING_OK) {
+                decoded++;
+            }
+        }
+    }
+
+    status->signing = NULL;
+    status->signing_streams = NULL;
+    linkManager->_freeMavlinkChannel(channel);
+    _setSHA256Hardware(true);
+
+    QCOMPARE(decoded, stream.messages.count());
+}
+
+void QGCBenchmark::_verifySignatures_data(void)
+{
+    QTest::addColumn<bool>("hardware");
+
+    QTest::newRow("portable")       << false;
+    QTest::newRow("SHA extensions") << true;
+}
+
+/// Signature checks of already framed messages, one at a time as the parser does them
+void QGCBenchmark::_verifySignatures(void)
+{
+    QFETCH(bool, hardware);
+
+    if (!_setSHA256Hardware(hardware)) {
+        QSKIP("No SHA extensions on this CPU");
+    }
+
+    QByteArray          key = MAVLinkSigning::keyFromPassphrase(_signingPassphrase);
+    mavlink_signing_t   sendSigning;
+    mavlink_signing_t   receiveSigning;
+
+    MAVLinkSigning::initSigning(&sendSigning, key, 0);
+    MAVLinkSigning::initSigning(&receiveSigning, key, 0);
+
+    const QVector<mavlink_message_t>    messages = _signedStream(_streams["synthetic"], &sendSigning).messages;
+    mavlink_signing_streams_t*          signingStreams = MAVLinkSigning::streams();
+    mavlink_signing_streams_t           savedStreams = *signingStreams;
+    int                                 goodCount = 0;
+
+    QBENCHMARK {
+        memset(signingStreams, 0, sizeof(*signingStreams));
+        goodCount = 0;
+        for (int i=0; i<messages.count(); i++) {
+            if (mavlink_signature_check(&receiveSigning, signingStreams, &messages[i])) {
+                goodCount++;
+            }
+        }
+    }
+
+    *signingStreams = savedStreams;
+    _setSHA256Hardware(true);
+
+    QCOMPARE(goodCount, messages.count());
+}
+
+void QGCBenchmark::_parameterLoad_data(void)
+{
+    QTest::addColumn<int>("count");
+
+    QTest::newRow("1000")   << 1000;
+    QTest::newRow("5000")   << 5000;
+    QTest::newRow("20000")  << 20000;
+}
+
+/// Initial load of a whole parameter set. Every load goes to a component the manager has not seen yet, so the Facts
+/// are created from scratch each time.
+void QGCBenchmark::_parameterLoad(void)
+{
+    QFETCH(int, count);
+
+    ParameterManager*   parameterManager = _vehicle->parameterManager();
+    QStringList         names;
+
+    for (int i=0; i<count; i++) {
+        names.append(QString("BENCH_%1").arg(i, 5, 10, QChar('0')));
+    }
+
+    QBENCHMARK_ONCE {
+        int componentId = _nextComponentId++;
+        QVERIFY(componentId <= 255);
+
+        for (int i=0; i<count; i++) {
+            parameterManager->_parameterUpdate(_vehicle->id(), componentId, names[i], count, i, MAV_PARAM_TYPE_REAL32, QVariant((float)i));
+        }
+    }
+}
+
+/// Update of every parameter the vehicle already has, as when the autopilot streams its whole set again
+void QGCBenchmark::_parameterRefresh(void)
+{
+    ParameterManager*   parameterManager = _vehicle->parameterManager();
+    int                 componentId = _vehicle->defaultComponentId();
+    int                 count = parameterManager->_paramCountMap[componentId];
+    QMap<int, QString>  names = parameterManager->_mapParameterId2Name[componentId];
+    QList<int>          indices = names.keys();
+    QList<int>          mavTypes;
+    QVariantList        values;
+
+    QVERIFY(count > 0);
+
+    for (int i=0; i<indices.count(); i++) {
+        Fact* fact = parameterManager->getParameter(componentId, names[indices[i]]);
+        mavTypes.append(parameterManager->_factTypeToMavType(fact->type()));
+        values.append(fact->rawValue());
+    }
+
+    QBENCHMARK {
+        for (int i=0; i<indices.count(); i++) {
+            parameterManager->_parameterUpdate(_vehicle->id(), componentId, names[indices[i]], count, indices[i], mavTypes[i], values[i]);
+        }
+    }
+}
+
+void QGCBenchmark::_packetize_data(void)
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("empty")  << 0;
+    QTest::newRow("64")     << 64;
+    QTest::newRow("1024")   << 1024;
+}
+
+void QGCBenchmark::_packetize(void)
+{
+    QFETCH(int, size);
+
+    UBPacket packet;
+    packet.setSrcID(1);
+    packet.setDesID(2);
+    packet.setPayload(QByteArray(size, 'x'));
+
+    QByteArray bytes;
+    QBENCHMARK {
+        bytes = packet.packetize();
+    }
+    QCOMPARE(bytes.size(), size + 2);
+}
+
+void QGCBenchmark::_depacketize_data(void)
+{
+    _packetize_data();
+}
+
+void QGCBenchmark::_depacketize(void)
+{
+    QFETCH(int, size);
+
+    UBPacket source;
+    source.setSrcID(1);
+    source.setDesID(2);
+    source.setPayload(QByteArray(size, 'x'));
+    QByteArray bytes = source.packetize();
+
+    UBPacket packet;
+    QBENCHMARK {
+        packet.depacketize(bytes);
+    }
+    QCOMPARE(packet.getPayload().size(), size);
+}
+
+void QGCBenchmark::_generateGrid_data(void)
+{
+    QTest::addColumn<int>("vertices");
+    QTest::addColumn<double>("radius");
+    QTest::addColumn<double>("spacing");
+
+    QTest::newRow("square 1 km, 25 m")  << 4   << 707.0    << 25.0;
+    QTest::newRow("octagon 1 km, 10 m") << 8   << 500.0    << 10.0;
+    QTest::newRow("circle 2 km, 25 m")  << 64  << 1000.0   << 25.0;
+}
+
+void QGCBenchmark::_generateGrid(void)
+{
+    QFETCH(int, vertices);
+    QFETCH(double, radius);
+    QFETCH(double, spacing);
+
+    SurveyMissionItem       survey(_offlineVehicle);
+    const QGeoCoordinate    center(47.3764, 8.5481);
+
+    survey.manualGrid()->setRawValue(true);
+    survey.gridSpacing()->setRawValue(spacing);
+    for (int i=0; i<vertices; i++) {
+        survey.mapPolygon()->appendVertex(center.atDistanceAndAzimuth(radius, 360.0 * i / vertices));
+    }
+
+    QBENCHMARK {
+        survey._generateGrid();
+    }
+    QVERIFY(survey.gridPoints().count() > 0);
+}
+
+void QGCBenchmark::_convertGeoToNed(void)
+{
+    const QGeoCoordinate    origin(47.3764, 8.5481, 0.0);
+    QVector<QGeoCoordinate> coords;
+
+    for (int i=0; i<10000; i++) {
+        coords.append(origin.atDistanceAndAzimuth(i % 1000, (i * 37) % 360, i % 100));
+    }
+
+    double x, y, z;
+    QBENCHMARK {
+        for (int i=0; i<coords.count(); i++) {
+            convertGeoToNed(coords[i], origin, &x, &y, &z);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+#ifndef QGCBenchmark_H
+#define QGCBenchmark_H
+
+#include <QObject>
+#include <QMap>
+#include <QVector>
+#include <QGeoCoordinate>
+
+#include "QGCMAVLink.h"
+
+class LinkInterface;
+class MockLink;
+class Vehicle;
+
+/// Micro benchmarks of the hot paths of the vehicle stack, run with QBENCHMARK. Streams are synthetic, or a recorded
+/// tlog given by the BENCH_TLOG environment variable. Use the QtTest output options (e.g. -o results.csv,csv or
+/// -o results.xml,xml) for machine readable results.
+class QGCBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    QGCBenchmark(void);
+
+private slots:
+    void initTestCase(void);
+    void cleanupTestCase(void);
+
+    void _receiveBytes_data(void);
+    void _receiveBytes(void);
+    void _vehicleDispatch_data(void);
+    void _vehicleDispatch(void);
+    void _messageEntry_data(void);
+    void _messageEntry(void);
+    void _crc_data(void);
+    void _crc(void);
+    void _signedParse_data(void);
+    void _signedParse(void);
+    void _verifySignatures_data(void);
+    void _verifySignatures(void);
+    void _parameterLoad_data(void);
+    void _parameterLoad(void);
+    void _parameterRefresh(void);
+    void _packetize_data(void);
+    void _packetize(void);
+    void _depacketize_data(void);
+    void _depacketize(void);
+    void _generateGrid_data(void);
+    void _generateGrid(void);
+    void _convertGeoToNed(void);
+
+private:
+    /// Messages of a stream along with their wire format
+    typedef struct {
+        QVector<mavlink_message_t>  messages;
+        QByteArray                  bytes;
+    } Stream_t;
+
+    void _addStreamRows(void);
+    void _appendMessage(Stream_t& stream, mavlink_message_t& message);
+    Stream_t _syntheticStream(int systemId, bool heartbeats);
+    Stream_t _tlogStream(const QString& filename, int systemId);
+
+    Stream_t _signedStream(const Stream_t& source, mavlink_signing_t* signing);
+    bool _setSHA256Hardware(bool hardware);
+
+    static const mavlink_msg_entry_t* _bisectMessageEntry(uint32_t msgid);
+
+    MockLink*       _mockLink;
+    Vehicle*        _vehicle;
+    Vehicle*        _offlineVehicle;
+    LinkInterface*  _link;
+    int             _mavlinkChannel;    ///< Channel used to pack and decode the benchmark streams
+    int             _nextComponentId;   ///< Fresh component for every full parameter load
+
+    QMap<QString, Stream_t> _streams;
+
+    static const int    _syntheticSeconds = 10;     ///< Length of the synthetic streams
+    static const int    _syntheticRate = 10;        ///< Telemetry rate of the synthetic streams in Hz
+    static const int    _foreignSystemId = 200;     ///< System id of a vehicle the stack never saw
+    static const char*  _tlogEnvVar;
+    static const char*  _signingPassphrase;
+};
+
+#endif
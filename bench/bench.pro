@@ -0,0 +1,29 @@
+QT -= gui
+QT += testlib
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+CONFIG += link_prl
+
+TARGET   = bench
+TEMPLATE = app
+
+# UBPacket is compiled in from the agent sources
+INCLUDEPATH += $$PWD/../agent
+
+HEADERS += \
+    QGCBenchmark.h \
+    ../agent/UBPacket.h \
+
+SOURCES += \
+    main.cc \
+    QGCBenchmark.cc \
+    ../agent/UBPacket.cpp \
+
+#
+# QGroundControl Library
+#
+include(../agent/qgc.pri)
@@ -0,0 +1,326 @@
+#include "UBLoadGen.h"
+#include "UBConfig.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QFile>
+#include <QCoreApplication>
+#include <QHostAddress>
+#include <QtMath>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include "QGCApplication.h"
+#include "MultiVehicleManager.h"
+
+#define RTT_BUCKET_USECS 10
+#define RTT_BUCKETS 100000
+
+UBLoadGen::UBLoadGen(const SSettings& settings, QObject *parent) : QObject(parent),
+    m_settings(settings),
+    m_ingest_messages(0),
+    m_ingest_bytes(0),
+    m_socket_bytes(0),
+    m_round_trips(RTT_BUCKETS + 1, 0),
+    m_interval_round_trips(RTT_BUCKETS + 1, 0)
+{
+    m_elapsed.start();
+
+    if (m_settings.in_process) {
+        connect(qgcApp()->toolbox()->mavlinkProtocol(), SIGNAL(messageReceived(LinkInterface*, mavlink_message_t)), this, SLOT(messageReceivedEvent(LinkInterface*, mavlink_message_t)));
+    }
+
+    for (int i = 0; i < m_settings.count; i++) {
+        setupVehicle(m_settings.first_id + i);
+    }
+
+    m_start = sample();
+    m_last = m_start;
+
+    m_report_timer = new QTimer(this);
+    connect(m_report_timer, SIGNAL(timeout()), this, SLOT(reportEvent()));
+    m_report_timer->start(m_settings.report_period);
+
+    if (m_settings.duration > 0) {
+        QTimer::singleShot(m_settings.duration, this, SLOT(durationEvent()));
+    }
+
+    const MockConfiguration::TrafficProfile& traffic = m_settings.traffic;
+    qInfo() << "Simulating" << m_settings.count << "vehicles from ID" << m_settings.first_id << (m_settings.in_process ? "in process" : "over TCP")
+            << "| Telemetry (Hz):" << traffic.telemetryRate
+            << "Ping (Hz):" << traffic.pingRate
+            << "Loss (%):" << traffic.lossPercent
+            << "Latency (ms):" << traffic.latencyMsecs
+            << "Params:" << traffic.paramCount;
+}
+
+UBLoadGen::~UBLoadGen() {
+    // In process links belong to LinkManager, the detached ones are ours
+    for (int i = 0; i < m_vehicles.count(); i++) {
+        if (m_vehicles[i].server) {
+            delete m_vehicles[i].link;
+        }
+    }
+}
+
+void UBLoadGen::setupVehicle(quint8 id) {
+    MockConfiguration* config = new MockConfiguration(tr("Load Vehicle %1").arg(id));
+    config->setFirmwareType(m_settings.firmware);
+    config->setVehicleType(MAV_TYPE_QUADROTOR);
+    config->setDynamic(true);
+
+    MockConfiguration::TrafficProfile traffic = m_settings.traffic;
+    traffic.systemId = id;
+    config->setTrafficProfile(traffic);
+
+    SVehicle vehicle;
+    vehicle.server = nullptr;
+    vehicle.socket = nullptr;
+
+    if (m_settings.in_process) {
+        LinkManager* linkManager = qgcApp()->toolbox()->linkManager();
+        SharedLinkConfigurationPointer shared = linkManager->addConfiguration(config);
+        vehicle.link = qobject_cast<MockLink*>(linkManager->createConnectedLink(shared));
+    } else {
+        SharedLinkConfigurationPointer shared(config);
+        vehicle.link = new MockLink(shared);
+        connect(vehicle.link, SIGNAL(bytesReceived(LinkInterface*, QByteArray)), this, SLOT(linkBytesEvent(LinkInterface*, QByteArray)));
+        vehicle.link->startDetached();
+
+        // Same port the agent with this ID expects its SITL instance on
+        quint16 port = 10 * id + STL_PORT + 3;
+        vehicle.server = new QTcpServer(this);
+        connect(vehicle.server, SIGNAL(newConnection()), this, SLOT(newConnectionEvent()));
+        if (!vehicle.server->listen(QHostAddress::LocalHost, port)) {
+            qWarning() << "Vehicle" << id << "can not listen on port" << port << ":" << vehicle.server->errorString();
+        }
+
+        m_index[vehicle.server] = m_vehicles.count();
+    }
+
+    Q_CHECK_PTR(vehicle.link);
+    m_index[vehicle.link] = m_vehicles.count();
+    m_vehicles.append(vehicle);
+}
+
+void UBLoadGen::newConnectionEvent() {
+    int index = m_index.value(sender(), -1);
+    if (index < 0) {
+        return;
+    }
+
+    SVehicle& vehicle = m_vehicles[index];
+    QTcpSocket* socket = vehicle.server->nextPendingConnection();
+    if (!socket) {
+        return;
+    }
+
+    // A reconnecting agent replaces the previous client
+    if (vehicle.socket) {
+        m_index.remove(vehicle.socket);
+        vehicle.socket->disconnect(this);
+        vehicle.socket->deleteLater();
+    }
+
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(socket, SIGNAL(readyRead()), this, SLOT(socketDataEvent()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(socketDisconnectedEvent()));
+    connect(socket, SIGNAL(bytesWritten(qint64)), this, SLOT(socketBytesWrittenEvent(qint64)));
+
+    vehicle.socket = socket;
+    m_index[socket] = index;
+}
+
+void UBLoadGen::socketDataEvent() {
+    int index = m_index.value(sender(), -1);
+    if (index < 0) {
+        return;
+    }
+
+    QByteArray data = m_vehicles[index].socket->readAll();
+    m_vehicles[index].link->writeBytesSafe(data.constData(), data.size());
+}
+
+void UBLoadGen::socketDisconnectedEvent() {
+    int index = m_index.value(sender(), -1);
+    if (index < 0) {
+        return;
+    }
+
+    SVehicle& vehicle = m_vehicles[index];
+    m_index.remove(vehicle.socket);
+    vehicle.socket->deleteLater();
+    vehicle.socket = nullptr;
+}
+
+void UBLoadGen::socketBytesWrittenEvent(qint64 bytes) {
+    m_socket_bytes += bytes;
+}
+
+void UBLoadGen::linkBytesEvent(LinkInterface* link, QByteArray data) {
+    int index = m_index.value(link, -1);
+    if (index < 0) {
+        return;
+    }
+
+    // Without a client the vehicle still runs, like SITL does before the agent connects
+    QTcpSocket* socket = m_vehicles[index].socket;
+    if (socket) {
+        socket->write(data);
+    }
+}
+
+void UBLoadGen::messageReceivedEvent(LinkInterface* link, mavlink_message_t message) {
+    if (!m_index.contains(link)) {
+        return;
+    }
+
+    m_ingest_messages++;
+    m_ingest_bytes += message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+}
+
+void UBLoadGen::reportEvent() {
+    SSample now = sample();
+    log("Interval", m_last, now, m_interval_round_trips);
+
+    m_interval_round_trips.fill(0);
+    m_last = now;
+}
+
+void UBLoadGen::durationEvent() {
+    logSummary();
+    QCoreApplication::quit();
+}
+
+void UBLoadGen::logSummary() {
+    log("Summary", m_start, sample(), m_round_trips);
+}
+
+UBLoadGen::SSample UBLoadGen::sample() {
+    SSample sample;
+    sample.time = m_elapsed.elapsed();
+    sample.cpu = cpuTime(0);
+    sample.target_cpu = m_settings.target_pid ? cpuTime(m_settings.target_pid) : -1;
+    sample.messages_sent = 0;
+    sample.bytes_sent = 0;
+    sample.messages_dropped = 0;
+    sample.pings_sent = 0;
+    sample.ping_replies = 0;
+    sample.ingest_messages = m_ingest_messages;
+    sample.ingest_bytes = m_ingest_bytes;
+    sample.socket_bytes = m_socket_bytes;
+
+    for (int i = 0; i < m_vehicles.count(); i++) {
+        MockLink::TrafficStats stats = m_vehicles[i].link->trafficStats();
+        sample.messages_sent += stats.messagesSent;
+        sample.bytes_sent += stats.bytesSent;
+        sample.messages_dropped += stats.messagesDropped;
+        sample.pings_sent += stats.pingsSent;
+        sample.ping_replies += stats.pingReplies;
+
+        QVector<qint64> round_trips = m_vehicles[i].link->takePingRoundTrips();
+        for (int j = 0; j < round_trips.count(); j++) {
+            int bucket = qBound<qint64>(0, round_trips[j] / RTT_BUCKET_USECS, RTT_BUCKETS);
+            m_round_trips[bucket]++;
+            m_interval_round_trips[bucket]++;
+        }
+    }
+
+    return sample;
+}
+
+void UBLoadGen::log(const QString& title, const SSample& from, const SSample& to, const QVector<quint64>& round_trips) {
+    double seconds = qMax<qint64>(1, to.time - from.time) / 1000.0;
+    int count = qMax(1, m_vehicles.count());
+
+    // CPU is given in percent of one core
+    double cpu = from.cpu < 0 || to.cpu < 0 ? -1 : (to.cpu - from.cpu) / (10.0 * seconds * count);
+    double target_cpu = from.target_cpu < 0 || to.target_cpu < 0 ? -1 : (to.target_cpu - from.target_cpu) / (10.0 * seconds * count);
+
+    qint64 backlog = 0;
+    for (int i = 0; i < m_vehicles.count(); i++) {
+        if (m_vehicles[i].socket) {
+            backlog += m_vehicles[i].socket->bytesToWrite();
+        }
+    }
+
+    qInfo().noquote() << title << "| Vehicles:" << m_vehicles.count() << "connected:" << connectedCount();
+    qInfo() << "Sent msg/s:" << (to.messages_sent - from.messages_sent) / seconds
+            << "KB/s:" << (to.bytes_sent - from.bytes_sent) / (1024 * seconds)
+            << "dropped:" << to.messages_dropped - from.messages_dropped;
+    if (m_settings.in_process) {
+        qInfo() << "Ingest msg/s:" << (to.ingest_messages - from.ingest_messages) / seconds
+                << "KB/s:" << (to.ingest_bytes - from.ingest_bytes) / (1024 * seconds);
+    } else {
+        qInfo() << "Written to sockets KB/s:" << (to.socket_bytes - from.socket_bytes) / (1024 * seconds)
+                << "backlog (KB):" << backlog / 1024;
+    }
+    qInfo() << "CPU per vehicle (%):" << cpu
+            << "target process (%):" << target_cpu;
+    qInfo() << "Ping RTT (ms) p50:" << percentile(round_trips, 0.5)
+            << "p99:" << percentile(round_trips, 0.99)
+            << "max:" << percentile(round_trips, 1)
+            << "| Replies:" << to.ping_replies - from.ping_replies << "of" << to.pings_sent - from.pings_sent;
+}
+
+int UBLoadGen::connectedCount() const {
+    if (m_settings.in_process) {
+        return qgcApp()->toolbox()->multiVehicleManager()->vehicles()->count();
+    }
+
+    int connected = 0;
+    for (int i = 0; i < m_vehicles.count(); i++) {
+        if (m_vehicles[i].socket) {
+            connected++;
+        }
+    }
+
+    return connected;
+}
+
+qint64 UBLoadGen::cpuTime(qint64 pid) {
+#ifdef Q_OS_LINUX
+    QFile stat(pid ? QString("/proc/%1/stat").arg(pid) : QString("/proc/self/stat"));
+    if (!stat.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // The command name may contain spaces, so fields are counted from its closing parenthesis. utime and stime are
+    // fields 14 and 15 of the file.
+    QByteArray line = stat.readAll();
+    QList<QByteArray> fields = line.mid(line.lastIndexOf(')') + 2).split(' ');
+    if (fields.count() < 13) {
+        return -1;
+    }
+
+    return (fields[11].toLongLong() + fields[12].toLongLong()) * 1000 / sysconf(_SC_CLK_TCK);
+#else
+    Q_UNUSED(pid);
+    return -1;
+#endif
+}
+
+double UBLoadGen::percentile(const QVector<quint64>& histogram, double fraction) {
+    quint64 total = 0;
+    for (int i = 0; i < histogram.count(); i++) {
+        total += histogram[i];
+    }
+
+    if (!total) {
+        return -1;
+    }
+
+    quint64 rank = qMax<quint64>(1, qCeil(fraction * total));
+    quint64 seen = 0;
+    for (int i = 0; i < histogram.count(); i++) {
+        seen += histogram[i];
+        if (seen >= rank) {
+            return i * RTT_BUCKET_USECS / 1000.0;
+        }
+    }
+
+    return (histogram.count() - 1) * RTT_BUCKET_USECS / 1000.0;
+}
@@ -0,0 +1,106 @@
+#ifndef UBLOADGEN_H
+#define UBLOADGEN_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include "MockLink.h"
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+
+// Simulates a swarm of vehicles with MockLink for capacity planning of the agent stack. In TCP mode every vehicle
+// listens on the port the agent with the same ID connects to, exactly like SITL does. In in-process mode the vehicles
+// are handed to the LinkManager of this process, so the QGC vehicle stack ingests them without any sockets in between.
+// Throughput, CPU per vehicle and the ping round trip through the GCS are reported periodically and at the end.
+class UBLoadGen : public QObject
+{
+    Q_OBJECT
+public:
+    struct SSettings {
+        quint8 first_id;
+        int count;
+        bool in_process;
+        MAV_AUTOPILOT firmware;
+        MockConfiguration::TrafficProfile traffic;
+        qint64 target_pid;      // Process under test whose CPU is reported as well, 0 for none
+        int report_period;      // ms
+        int duration;           // ms, 0 to run until stopped
+    };
+
+    explicit UBLoadGen(const SSettings& settings, QObject *parent = nullptr);
+    ~UBLoadGen();
+
+public slots:
+    void logSummary();
+
+protected slots:
+    void newConnectionEvent();
+    void socketDataEvent();
+    void socketDisconnectedEvent();
+    void socketBytesWrittenEvent(qint64 bytes);
+    void linkBytesEvent(LinkInterface* link, QByteArray data);
+    void messageReceivedEvent(LinkInterface* link, mavlink_message_t message);
+    void reportEvent();
+    void durationEvent();
+
+protected:
+    struct SVehicle {
+        MockLink* link;
+        QTcpServer* server;
+        QTcpSocket* socket;
+    };
+
+    // Totals over all vehicles, the counters are never reset so intervals are differences of two samples
+    struct SSample {
+        qint64 time;
+        qint64 cpu;
+        qint64 target_cpu;
+        quint64 messages_sent;
+        quint64 bytes_sent;
+        quint64 messages_dropped;
+        quint64 pings_sent;
+        quint64 ping_replies;
+        quint64 ingest_messages;
+        quint64 ingest_bytes;
+        quint64 socket_bytes;
+    };
+
+    void setupVehicle(quint8 id);
+    SSample sample();
+    void log(const QString& title, const SSample& from, const SSample& to, const QVector<quint64>& round_trips);
+    int connectedCount() const;
+
+    // CPU time in ms used by a process so far, pid 0 for this process, -1 if not available on this platform
+    static qint64 cpuTime(qint64 pid);
+
+    // Round trip time in ms below which the given fraction of the histogram lies
+    static double percentile(const QVector<quint64>& histogram, double fraction);
+
+protected:
+    SSettings m_settings;
+
+    QVector<SVehicle> m_vehicles;
+    QHash<QObject*, int> m_index;   // Vehicle index of every link, server and socket
+
+    // In process, bytes and messages MAVLinkProtocol parsed
+    quint64 m_ingest_messages;
+    quint64 m_ingest_bytes;
+
+    // In TCP mode, bytes the sockets handed to the OS. What the agent actually reads is only known on its side.
+    quint64 m_socket_bytes;
+
+    // Ping round trips in 10 us buckets, the last bucket collects everything slower
+    QVector<quint64> m_round_trips;
+    QVector<quint64> m_interval_round_trips;
+
+    QTimer* m_report_timer;
+    QElapsedTimer m_elapsed;
+    SSample m_start;
+    SSample m_last;
+};
+
+#endif // UBLOADGEN_H
@@ -0,0 +1,26 @@
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+CONFIG += link_prl
+
+TARGET   = loadgen
+TEMPLATE = app
+
+# Ports are shared with the agent
+INCLUDEPATH += $$PWD/../agent
+
+HEADERS += \
+    UBLoadGen.h \
+
+SOURCES += \
+    main.cc \
+    UBLoadGen.cpp \
+
+#
+# QGroundControl Library
+#
+include(../agent/qgc.pri)
@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Headless swarm load generator
+ *
+ */
+
+#include <QtGlobal>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include "QGCApplication.h"
+#include "AppMessages.h"
+
+#include "UBLoadGen.h"
+
+#ifndef __mobile__
+    #include "QGCSerialPortInfo.h"
+#endif
+
+/* SDL does ugly things to main() */
+#ifdef main
+#undef main
+#endif
+
+#ifndef __mobile__
+    Q_DECLARE_METATYPE(QGCSerialPortInfo)
+#endif
+
+int main(int argc, char *argv[])
+{
+#ifdef Q_OS_UNIX
+    //Force writing to the console on UNIX/BSD devices
+    if (!qEnvironmentVariableIsSet("QT_LOGGING_TO_CONSOLE"))
+        qputenv("QT_LOGGING_TO_CONSOLE", "1");
+#endif
+
+    // install the message handler
+    AppMessages::installHandler();
+
+#ifndef NO_SERIAL_LINK
+    qRegisterMetaType<QSerialPort::SerialPortError>();
+#endif
+    qRegisterMetaType<QAbstractSocket::SocketError>();
+#ifndef __mobile__
+    qRegisterMetaType<QGCSerialPortInfo>();
+#endif
+
+    QGCApplication* app = new QGCApplication(argc, argv, false);
+    Q_CHECK_PTR(app);
+
+    // The agents connect to vehicles on 10 * ID + STL_PORT + 3, so "-I 1 -N 50" here serves "agent -I 1 -N 50". ID 255 is
+    // left to the GCS.
+    QCommandLineParser parser;
+    parser.setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
+    parser.addOptions({
+        {{"I", "instance"}, "ID of the first vehicle", "id", "1"},
+        {{"N", "count"}, "Number of vehicles to simulate", "count", "1"},
+        {"inprocess", "Feed the vehicles to the vehicle stack of this process instead of serving them over TCP"},
+        {"firmware", "Firmware to simulate, apm or px4", "firmware", "apm"},
+        {"rate", "Position and attitude updates per second per vehicle", "hz", "10"},
+        {"ping", "Ping requests per second per vehicle", "hz", "1"},
+        {"loss", "Percentage of messages dropped", "percent", "0"},
+        {"latency", "Latency added to every message", "ms", "0"},
+        {"params", "Parameter count per vehicle, padded with synthetic parameters", "count", "0"},
+        {"pid", "Also report the CPU of this process, the one under test", "pid", "0"},
+        {"report", "Report period", "s", "5"},
+        {"duration", "Stop after this long and print a summary, 0 to run until killed", "s", "0"},
+    });
+    parser.parse(QCoreApplication::arguments());
+
+    UBLoadGen::SSettings settings;
+    settings.first_id = qBound(1, parser.value("I").toInt(), 254);
+    settings.count = qBound(1, parser.value("N").toInt(), 255 - settings.first_id);
+    settings.in_process = parser.isSet("inprocess");
+    settings.firmware = parser.value("firmware") == "px4" ? MAV_AUTOPILOT_PX4 : MAV_AUTOPILOT_ARDUPILOTMEGA;
+    settings.traffic.telemetryRate = parser.value("rate").toInt();
+    settings.traffic.pingRate = parser.value("ping").toInt();
+    settings.traffic.lossPercent = qBound(0, parser.value("loss").toInt(), 100);
+    settings.traffic.latencyMsecs = parser.value("latency").toInt();
+    settings.traffic.paramCount = parser.value("params").toInt();
+    settings.target_pid = parser.value("pid").toLongLong();
+    settings.report_period = qMax(1, parser.value("report").toInt()) * 1000;
+    settings.duration = parser.value("duration").toInt() * 1000;
+
+    app->_initCommon();
+
+    int exitCode = 0;
+    if (!app->_initForNormalAppBoot()) {
+        return -1;
+    }
+
+    UBLoadGen* loadGen = new UBLoadGen(settings);
+    Q_CHECK_PTR(loadGen);
+
+    exitCode = app->exec();
+
+    // Detached links still need the toolbox to release their mavlink channels
+    delete loadGen;
+
+    app->_shutdown();
+    delete app;
+
+    return exitCode;
+}
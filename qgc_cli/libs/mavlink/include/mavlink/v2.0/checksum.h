@@ -54,7 +54,7 @@ static inline void crc_init(uint16_t* crcAccum)
         *crcAccum = X25_INIT_CRC;
 }
 
-
+#ifndef HAVE_CRC_ACCUMULATE_BUFFER
 /**
  * @brief Calculates the X.25 checksum on a byte buffer
  *
@@ -71,8 +71,9 @@ static inline uint16_t crc_calculate(const uint8_t* pBuffer, uint16_t length)
         }
         return crcTmp;
 }
+#endif
 
-
+#ifndef HAVE_CRC_ACCUMULATE_BUFFER
 /**
  * @brief Accumulate the X.25 CRC by adding an array of bytes
  *
@@ -89,6 +90,7 @@ static inline void crc_accumulate_buffer(uint16_t *crcAccum, const char *pBuffer
                 crc_accumulate(*p++, crcAccum);
         }
 }
+#endif
 
 #if defined(MAVLINK_USE_CXX_NAMESPACE) || defined(__cplusplus)
 }
@@ -19,8 +19,6 @@ message(Qt version $$[QT_VERSION])
 
 include(QGCCommon.pri)
 
-DEFINES += MAVLINK_COMM_NUM_BUFFERS=4
-
 DEFINES += MAV_DATA_STREAM_RAW_SENSORS_RATE=1
 DEFINES += MAV_DATA_STREAM_EXTENDED_STATUS_RATE=1
 DEFINES += MAV_DATA_STREAM_RC_CHANNELS_RATE=1
@@ -439,21 +437,37 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory  { APMFirmwarePlugin {
 #        src/MissionManager/SimpleMissionItemTest.h \
 #        src/MissionManager/SpeedSectionTest.h \
 #        src/MissionManager/SurveyMissionItemTest.h \
+#        src/MissionManager/CoveragePartitionerTest.h \
 #        src/MissionManager/VisualMissionItemTest.h \
 #        src/qgcunittest/FileDialogTest.h \
 #        src/qgcunittest/FileManagerTest.h \
 #        src/qgcunittest/FlightGearTest.h \
 #        src/qgcunittest/GeoTest.h \
 #        src/qgcunittest/LinkManagerTest.h \
+#        src/qgcunittest/LinkHealthTest.h \
+#        src/qgcunittest/LinkStatisticsTest.h \
+#        src/qgcunittest/MAVLinkChannelPoolTest.h \
+#        src/qgcunittest/MAVLinkCRCTest.h \
+#        src/qgcunittest/MAVLinkSigningTest.h \
+#        src/qgcunittest/MAVLinkMessageTableTest.h \
+#        src/qgcunittest/MAVLinkSequenceTrackerTest.h \
+#        src/qgcunittest/MAVLinkDuplicateFilterTest.h \
 #        src/qgcunittest/MainWindowTest.h \
 #        src/qgcunittest/MavlinkLogTest.h \
 #        src/qgcunittest/MessageBoxTest.h \
 #        src/qgcunittest/MultiSignalSpy.h \
+#        src/qgcunittest/QGCMetricsTest.h \
+#        src/qgcunittest/QGCClockTest.h \
 #        src/qgcunittest/RadioConfigTest.h \
 #        src/qgcunittest/TCPLinkTest.h \
 #        src/qgcunittest/TCPLoopBackServer.h \
 #        src/qgcunittest/UnitTest.h \
 #        src/Vehicle/SendMavCommandTest.h \
+#        src/Vehicle/StreamRateManagerTest.h \
+#        src/Vehicle/TelemetryChannelRegistryTest.h \
+#        src/Vehicle/VehicleTelemetryStoreTest.h \
+#        src/Vehicle/VehicleStateSnapshotTest.h \
+#        src/Settings/SettingsStoreTest.h \
 
     SOURCES += \
 #        src/AnalyzeView/LogDownloadTest.cc \
@@ -475,22 +489,38 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory  { APMFirmwarePlugin {
 #        src/MissionManager/SimpleMissionItemTest.cc \
 #        src/MissionManager/SpeedSectionTest.cc \
 #        src/MissionManager/SurveyMissionItemTest.cc \
+#        src/MissionManager/CoveragePartitionerTest.cc \
 #        src/MissionManager/VisualMissionItemTest.cc \
 #        src/qgcunittest/FileDialogTest.cc \
 #        src/qgcunittest/FileManagerTest.cc \
 #        src/qgcunittest/FlightGearTest.cc \
 #        src/qgcunittest/GeoTest.cc \
 #        src/qgcunittest/LinkManagerTest.cc \
+#        src/qgcunittest/LinkHealthTest.cc \
+#        src/qgcunittest/LinkStatisticsTest.cc \
+#        src/qgcunittest/MAVLinkChannelPoolTest.cc \
+#        src/qgcunittest/MAVLinkCRCTest.cc \
+#        src/qgcunittest/MAVLinkSigningTest.cc \
+#        src/qgcunittest/MAVLinkMessageTableTest.cc \
+#        src/qgcunittest/MAVLinkSequenceTrackerTest.cc \
+#        src/qgcunittest/MAVLinkDuplicateFilterTest.cc \
 #        src/qgcunittest/MainWindowTest.cc \
 #        src/qgcunittest/MavlinkLogTest.cc \
 #        src/qgcunittest/MessageBoxTest.cc \
 #        src/qgcunittest/MultiSignalSpy.cc \
+#        src/qgcunittest/QGCMetricsTest.cc \
+#        src/qgcunittest/QGCClockTest.cc \
 #        src/qgcunittest/RadioConfigTest.cc \
 #        src/qgcunittest/TCPLinkTest.cc \
 #        src/qgcunittest/TCPLoopBackServer.cc \
 #        src/qgcunittest/UnitTest.cc \
 #        src/qgcunittest/UnitTestList.cc \
 #        src/Vehicle/SendMavCommandTest.cc \
+#        src/Vehicle/StreamRateManagerTest.cc \
+#        src/Vehicle/TelemetryChannelRegistryTest.cc \
+#        src/Vehicle/VehicleTelemetryStoreTest.cc \
+#        src/Vehicle/VehicleStateSnapshotTest.cc \
+#        src/Settings/SettingsStoreTest.cc \
 } } } } } }
 
 # Main QGC Headers and Source files
@@ -512,6 +542,7 @@ HEADERS += \
     src/MG.h \
     src/MissionManager/CameraSection.h \
     src/MissionManager/ComplexMissionItem.h \
+    src/MissionManager/CoveragePartitioner.h \
     src/MissionManager/FixedWingLandingComplexItem.h \
     src/MissionManager/GeoFenceController.h \
     src/MissionManager/GeoFenceManager.h \
@@ -532,11 +563,13 @@ HEADERS += \
     src/MissionManager/Section.h \
     src/MissionManager/SpeedSection.h \
     src/MissionManager/SurveyMissionItem.h \
+    src/MissionManager/TransectOrderSolver.h \
     src/MissionManager/VisualMissionItem.h \
 #    src/PositionManager/PositionManager.h \
 #    src/PositionManager/SimulatedPosition.h \
     src/QGC.h \
     src/QGCApplication.h \
+    src/QGCClock.h \
 #    src/QGCComboBox.h \
     src/QGCConfig.h \
 #    src/QGCDockWidget.h \
@@ -544,6 +577,7 @@ HEADERS += \
     src/QGCGeo.h \
     src/QGCLoggingCategory.h \
 #    src/QGCMapPalette.h \
+    src/QGCMetrics.h \
 #    src/QGCPalette.h \
     src/QGCQGeoCoordinate.h \
 #    src/QGCQmlWidgetHolder.h \
@@ -568,6 +602,7 @@ HEADERS += \
     src/Settings/RTKSettings.h \
     src/Settings/SettingsGroup.h \
     src/Settings/SettingsManager.h \
+    src/Settings/SettingsStore.h \
     src/Settings/UnitsSettings.h \
     src/Settings/VideoSettings.h \
     src/Vehicle/MAVLinkLogManager.h \
@@ -576,7 +611,16 @@ HEADERS += \
     src/comm/LinkConfiguration.h \
     src/comm/LinkInterface.h \
     src/comm/LinkManager.h \
+    src/comm/LinkHealth.h \
+    src/comm/LinkStatistics.h \
     src/comm/MAVLinkProtocol.h \
+    src/comm/MAVLinkChannelPool.h \
+    src/comm/MAVLinkCRC.h \
+    src/comm/MAVLinkSHA256.h \
+    src/comm/MAVLinkSigning.h \
+    src/comm/MAVLinkMessageTable.h \
+    src/comm/MAVLinkSequenceTracker.h \
+    src/comm/MAVLinkDuplicateFilter.h \
     src/comm/ProtocolInterface.h \
     src/comm/QGCMAVLink.h \
     src/comm/TCPLink.h \
@@ -591,12 +635,11 @@ HEADERS += \
 	src/Joystick/JoystickAndroid.h \
 }
 
-DebugBuild {
+# MockLink is also used by the load generator, so it is part of every build
 HEADERS += \
-#    src/comm/MockLink.h \
-#    src/comm/MockLinkFileServer.h \
-#    src/comm/MockLinkMissionItemHandler.h \
-}
+    src/comm/MockLink.h \
+    src/comm/MockLinkFileServer.h \
+    src/comm/MockLinkMissionItemHandler.h \
 
 WindowsBuild {
     PRECOMPILED_HEADER += src/stable_headers.h
@@ -691,6 +734,7 @@ SOURCES += \
 #    src/LogCompressor.cc \
     src/MissionManager/CameraSection.cc \
     src/MissionManager/ComplexMissionItem.cc \
+    src/MissionManager/CoveragePartitioner.cc \
     src/MissionManager/FixedWingLandingComplexItem.cc \
     src/MissionManager/GeoFenceController.cc \
     src/MissionManager/GeoFenceManager.cc \
@@ -710,17 +754,20 @@ SOURCES += \
     src/MissionManager/SimpleMissionItem.cc \
     src/MissionManager/SpeedSection.cc \
     src/MissionManager/SurveyMissionItem.cc \
+    src/MissionManager/TransectOrderSolver.cc \
     src/MissionManager/VisualMissionItem.cc \
 #    src/PositionManager/PositionManager.cpp \
 #    src/PositionManager/SimulatedPosition.cc \
     src/QGC.cc \
     src/QGCApplication.cc \
+    src/QGCClock.cc \
 #    src/QGCComboBox.cc \
 #    src/QGCDockWidget.cc \
     src/QGCFileDownload.cc \
     src/QGCGeo.cc \
     src/QGCLoggingCategory.cc \
 #    src/QGCMapPalette.cc \
+    src/QGCMetrics.cc \
 #    src/QGCPalette.cc \
     src/QGCQGeoCoordinate.cc \
 #    src/QGCQmlWidgetHolder.cpp \
@@ -744,6 +791,7 @@ SOURCES += \
     src/Settings/RTKSettings.cc \
     src/Settings/SettingsGroup.cc \
     src/Settings/SettingsManager.cc \
+    src/Settings/SettingsStore.cc \
     src/Settings/UnitsSettings.cc \
     src/Settings/VideoSettings.cc \
     src/Vehicle/MAVLinkLogManager.cc \
@@ -752,7 +800,16 @@ SOURCES += \
     src/comm/LinkConfiguration.cc \
     src/comm/LinkInterface.cc \
     src/comm/LinkManager.cc \
+    src/comm/LinkHealth.cc \
+    src/comm/LinkStatistics.cc \
     src/comm/MAVLinkProtocol.cc \
+    src/comm/MAVLinkChannelPool.cc \
+    src/comm/MAVLinkCRC.cc \
+    src/comm/MAVLinkSHA256.cc \
+    src/comm/MAVLinkSigning.cc \
+    src/comm/MAVLinkMessageTable.cc \
+    src/comm/MAVLinkSequenceTracker.cc \
+    src/comm/MAVLinkDuplicateFilter.cc \
     src/comm/QGCMAVLink.cc \
     src/comm/TCPLink.cc \
 #    src/comm/UDPLink.cc \
@@ -761,12 +818,10 @@ SOURCES += \
     src/uas/UASMessageHandler.cc \
 #    src/AnalyzeView/LogDownloadController.cc \
 
-DebugBuild {
 SOURCES += \
-#    src/comm/MockLink.cc \
-#    src/comm/MockLinkFileServer.cc \
-#    src/comm/MockLinkMissionItemHandler.cc \
-}
+    src/comm/MockLink.cc \
+    src/comm/MockLinkFileServer.cc \
+    src/comm/MockLinkMissionItemHandler.cc \
 
 !NoSerialBuild {
 SOURCES += \
@@ -852,7 +907,11 @@ HEADERS+= \
     src/FirmwarePlugin/FirmwarePluginManager.h \
     src/Vehicle/MultiVehicleManager.h \
     src/Vehicle/GPSRTKFactGroup.h \
+    src/Vehicle/StreamRateManager.h \
     src/Vehicle/Vehicle.h \
+    src/Vehicle/TelemetryChannelRegistry.h \
+    src/Vehicle/VehicleStateSnapshot.h \
+    src/Vehicle/VehicleTelemetryStore.h \
     src/VehicleSetup/VehicleComponent.h \
 
 !MobileBuild {
@@ -877,7 +936,10 @@ SOURCES += \
     src/FirmwarePlugin/FirmwarePluginManager.cc \
     src/Vehicle/MultiVehicleManager.cc \
     src/Vehicle/GPSRTKFactGroup.cc \
+    src/Vehicle/StreamRateManager.cc \
     src/Vehicle/Vehicle.cc \
+    src/Vehicle/TelemetryChannelRegistry.cc \
+    src/Vehicle/VehicleTelemetryStore.cc \
     src/VehicleSetup/VehicleComponent.cc \
 
 !MobileBuild {
@@ -14,8 +14,8 @@
 
 #include "RadioComponentController.h"
 #include "QGCApplication.h"
+#include "SettingsStore.h"
 
-#include <QSettings>
 
 QGC_LOGGING_CATEGORY(RadioComponentControllerLog, "RadioComponentControllerLog")
 QGC_LOGGING_CATEGORY(RadioComponentControllerVerboseLog, "RadioComponentControllerVerboseLog")
@@ -875,11 +875,7 @@ void RadioComponentController::_rcCalSave(void)
 
 void RadioComponentController::_loadSettings(void)
 {
-    QSettings settings;
-    
-    settings.beginGroup(_settingsGroup);
-    _transmitterMode = settings.value(_settingsKeyTransmitterMode, 2).toInt();
-    settings.endGroup();
+    _transmitterMode = SettingsStore::instance()->value(_settingsGroup, _settingsKeyTransmitterMode, 2).toInt();
     
     if (_transmitterMode != 1 || _transmitterMode != 2) {
         _transmitterMode = 2;
@@ -888,11 +884,7 @@ void RadioComponentController::_loadSettings(void)
 
 void RadioComponentController::_storeSettings(void)
 {
-    QSettings settings;
-    
-    settings.beginGroup(_settingsGroup);
-    settings.setValue(_settingsKeyTransmitterMode, _transmitterMode);
-    settings.endGroup();
+    SettingsStore::instance()->setValue(_settingsGroup, _settingsKeyTransmitterMode, _transmitterMode);
 }
 
 void RadioComponentController::_setHelpImage(const char* imageFile)
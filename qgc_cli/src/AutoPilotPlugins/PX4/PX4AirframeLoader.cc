@@ -15,6 +15,7 @@
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 #include "AirframeComponentAirframes.h"
+#include "SettingsStore.h"
 
 #include <QFile>
 #include <QFileInfo>
@@ -34,8 +35,7 @@ PX4AirframeLoader::PX4AirframeLoader(AutoPilotPlugin* autopilot, UASInterface* u
 
 QString PX4AirframeLoader::aiframeMetaDataFile(void)
 {
-    QSettings settings;
-    QDir parameterDir = QFileInfo(settings.fileName()).dir();
+    QDir parameterDir = QFileInfo(SettingsStore::instance()->fileName()).dir();
     return parameterDir.filePath("PX4AirframeFactMetaData.xml");
 }
 
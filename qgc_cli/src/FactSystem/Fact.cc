@@ -12,11 +12,14 @@
 ///     @author Don Gagne <don@thegagnes.com>
 
 #include "Fact.h"
+#include "FactGroup.h"
 #include "QGCMAVLink.h"
 
 #include <QtQml>
 #include <QQmlEngine>
 
+#include <limits>
+
 Fact::Fact(QObject* parent)
     : QObject(parent)
     , _componentId(-1)
@@ -25,6 +28,8 @@ Fact::Fact(QObject* parent)
     , _metaData(NULL)
     , _sendValueChangedSignals(true)
     , _deferredValueChangeSignal(false)
+    , _group(NULL)
+    , _groupBit(-1)
 {    
     FactMetaData* metaData = new FactMetaData(_type, this);
     setMetaData(metaData);
@@ -42,6 +47,8 @@ Fact::Fact(int componentId, QString name, FactMetaData::ValueType_t type, QObjec
     , _metaData(NULL)
     , _sendValueChangedSignals(true)
     , _deferredValueChangeSignal(false)
+    , _group(NULL)
+    , _groupBit(-1)
 {
     FactMetaData* metaData = new FactMetaData(_type, this);
     setMetaData(metaData);
@@ -50,6 +57,8 @@ Fact::Fact(int componentId, QString name, FactMetaData::ValueType_t type, QObjec
 
 Fact::Fact(const Fact& other, QObject* parent)
     : QObject(parent)
+    , _group(NULL)
+    , _groupBit(-1)
 {
     *this = other;
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
@@ -109,6 +118,95 @@ void Fact::setRawValue(const QVariant& value)
     }
 }
 
+void Fact::setRawDouble(double value)
+{
+    if (_metaData) {
+        switch (_metaData->type()) {
+        case FactMetaData::valueTypeDouble:
+        case FactMetaData::valueTypeElapsedTimeInSeconds:
+            if (_rawValue.userType() == QMetaType::Double) {
+                double current = *static_cast<const double*>(_rawValue.constData());
+                if (current != value && !(qIsNaN(current) && qIsNaN(value))) {
+                    _rawValue.setValue(value);
+                    _typedRawValueChanged();
+                }
+                return;
+            }
+            break;
+        case FactMetaData::valueTypeFloat:
+            if (_rawValue.userType() == QMetaType::Float) {
+                float current = *static_cast<const float*>(_rawValue.constData());
+                float typedValue = (float)value;
+                if (current != typedValue && !(qIsNaN(current) && qIsNaN(typedValue))) {
+                    _rawValue.setValue(typedValue);
+                    _typedRawValueChanged();
+                }
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    setRawValue(value);
+}
+
+void Fact::setRawInt(qint64 value)
+{
+    if (_metaData) {
+        // Values the type of the Fact can not hold go through setRawValue, like any other conversion
+        qint64 min = 0;
+        qint64 max = -1;
+
+        switch (_metaData->type()) {
+        case FactMetaData::valueTypeInt8:
+            min = std::numeric_limits<qint8>::min();
+            max = std::numeric_limits<qint8>::max();
+            break;
+        case FactMetaData::valueTypeInt16:
+            min = std::numeric_limits<qint16>::min();
+            max = std::numeric_limits<qint16>::max();
+            break;
+        case FactMetaData::valueTypeInt32:
+            min = std::numeric_limits<qint32>::min();
+            max = std::numeric_limits<qint32>::max();
+            break;
+        case FactMetaData::valueTypeUint8:
+            max = std::numeric_limits<quint8>::max();
+            break;
+        case FactMetaData::valueTypeUint16:
+            max = std::numeric_limits<quint16>::max();
+            break;
+        case FactMetaData::valueTypeUint32:
+            max = std::numeric_limits<quint32>::max();
+            break;
+        default:
+            break;
+        }
+
+        if (value >= min && value <= max) {
+            if (min < 0 && _rawValue.userType() == QMetaType::Int) {
+                int typedValue = (int)value;
+                if (*static_cast<const int*>(_rawValue.constData()) != typedValue) {
+                    _rawValue.setValue(typedValue);
+                    _typedRawValueChanged();
+                }
+                return;
+            } else if (min == 0 && _rawValue.userType() == QMetaType::UInt) {
+                uint typedValue = (uint)value;
+                if (*static_cast<const uint*>(_rawValue.constData()) != typedValue) {
+                    _rawValue.setValue(typedValue);
+                    _typedRawValueChanged();
+                }
+                return;
+            }
+        }
+    }
+
+    setRawValue(QVariant((qlonglong)value));
+}
+
 void Fact::setCookedValue(const QVariant& value)
 {
     if (_metaData) {
@@ -545,6 +643,28 @@ void Fact::_sendValueChangedSignal(QVariant value)
     }
 }
 
+void Fact::_typedRawValueChanged(void)
+{
+    if (_group) {
+        _group->_markDirty(_groupBit);
+    } else {
+        _sendRawValueChangedSignals();
+    }
+}
+
+/// Sends the signals setRawValue would have sent for the current value. The cooked value is only translated when
+/// valueChanged goes out right away.
+void Fact::_sendRawValueChangedSignals(void)
+{
+    if (_sendValueChangedSignals) {
+        _sendValueChangedSignal(cookedValue());
+    } else {
+        _deferredValueChangeSignal = true;
+    }
+    emit _containerRawValueChanged(rawValue());
+    emit rawValueChanged(_rawValue);
+}
+
 void Fact::sendDeferredValueChangedSignal(void)
 {
     if (_deferredValueChangeSignal) {
@@ -21,10 +21,14 @@
 #include <QVariant>
 #include <QDebug>
 
+class FactGroup;
+
 /// @brief A Fact is used to hold a single value within the system.
 class Fact : public QObject
 {
     Q_OBJECT
+
+    friend class FactGroup;
     
 public:
     Fact(QObject* parent = NULL);
@@ -115,6 +119,12 @@ public:
     void setEnumIndex       (int index);
     void setEnumStringValue (const QString& value);
 
+    /// Typed setters for high rate updates such as MAVLink telemetry. When the value already has the type of the Fact
+    /// there is no QVariant conversion and the compare is unboxed, otherwise they fall back to setRawValue. The change
+    /// signals of a Fact in a FactGroup are deferred until FactGroup::flushDirtyFacts or the next group update.
+    void setRawDouble       (double value);
+    void setRawInt          (qint64 value);
+
     // The following methods allow you to defer sending of the valueChanged signals in order to implement
     // rate limited signalling for ui performance. Used by FactGroup for example.
 
@@ -162,6 +172,8 @@ signals:
 protected:
     QString _variantToString(const QVariant& variant, int decimalPlaces) const;
     void _sendValueChangedSignal(QVariant value);
+    void _typedRawValueChanged(void);
+    void _sendRawValueChangedSignals(void);
 
     QString                     _name;
     int                         _componentId;
@@ -170,6 +182,8 @@ protected:
     FactMetaData*               _metaData;
     bool                        _sendValueChangedSignals;
     bool                        _deferredValueChangeSignal;
+    FactGroup*                  _group;                     ///< Group which defers the signals of the typed setters, NULL: signal immediately
+    int                         _groupBit;                  ///< Dirty bit of this Fact in _group
 };
 
 #endif
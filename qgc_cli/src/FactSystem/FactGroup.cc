@@ -17,12 +17,14 @@
 #include <QDebug>
 #include <QFile>
 #include <QQmlEngine>
+#include <QtAlgorithms>
 
 QGC_LOGGING_CATEGORY(FactGroupLog, "FactGroupLog")
 
 FactGroup::FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject* parent)
     : QObject(parent)
     , _updateRateMSecs(updateRateMsecs)
+    , _dirtyFacts(0)
 {
     if (_updateRateMSecs > 0) {
         connect(&_updateTimer, &QTimer::timeout, this, &FactGroup::_updateAllValues);
@@ -89,6 +91,12 @@ void FactGroup::_addFact(Fact* fact, const QString& name)
         fact->setMetaData(_nameToFactMetaDataMap[name]);
     }
     _nameToFactMap[name] = fact;
+
+    if (_dirtyBitFacts.count() < _maxDirtyFacts) {
+        fact->_group = this;
+        fact->_groupBit = _dirtyBitFacts.count();
+        _dirtyBitFacts.append(fact);
+    }
 }
 
 void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
@@ -101,8 +109,32 @@ void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
     _nameToFactGroupMap[name] = factGroup;
 }
 
+void FactGroup::flushDirtyFacts(void)
+{
+    _flushDirtyFacts();
+
+    foreach(FactGroup* factGroup, _nameToFactGroupMap) {
+        factGroup->flushDirtyFacts();
+    }
+}
+
+void FactGroup::_flushDirtyFacts(void)
+{
+    // Signal handlers may set Facts of this group again, those are left for the next flush
+    quint64 dirtyFacts = _dirtyFacts;
+    _dirtyFacts = 0;
+
+    while (dirtyFacts) {
+        int bit = qCountTrailingZeroBits(dirtyFacts);
+        dirtyFacts &= dirtyFacts - 1;
+        _dirtyBitFacts[bit]->_sendRawValueChangedSignals();
+    }
+}
+
 void FactGroup::_updateAllValues(void)
 {
+    _flushDirtyFacts();
+
     foreach(Fact* fact, _nameToFactMap) {
         fact->sendDeferredValueChangedSignal();
     }
@@ -16,6 +16,7 @@
 
 #include <QStringList>
 #include <QMap>
+#include <QVector>
 #include <QTimer>
 
 Q_DECLARE_LOGGING_CATEGORY(VehicleLog)
@@ -24,6 +25,8 @@ Q_DECLARE_LOGGING_CATEGORY(VehicleLog)
 class FactGroup : public QObject
 {
     Q_OBJECT
+
+    friend class Fact;
     
 public:
     FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject* parent = NULL);
@@ -39,6 +42,10 @@ public:
 
     QStringList factNames(void) const { return _nameToFactMap.keys(); }
     QStringList factGroupNames(void) const { return _nameToFactGroupMap.keys(); }
+
+    /// Sends the change signals deferred by Fact::setRawDouble/setRawInt, for this group and all child groups. Called
+    /// once per message by the MAVLink handlers and on every update of the group.
+    void flushDirtyFacts(void);
     
 protected:
     void _addFact(Fact* fact, const QString& name);
@@ -51,11 +58,17 @@ private slots:
 
 private:
     void _loadMetaData(const QString& filename);
+    void _markDirty(int bit) { _dirtyFacts |= Q_UINT64_C(1) << bit; }
+    void _flushDirtyFacts(void);
 
     QMap<QString, Fact*>            _nameToFactMap;
     QMap<QString, FactGroup*>       _nameToFactGroupMap;
     QMap<QString, FactMetaData*>    _nameToFactMetaDataMap;
 
+    static const int    _maxDirtyFacts = 64;    ///< Facts past this count signal immediately
+    QVector<Fact*>      _dirtyBitFacts;         ///< Fact of each bit in _dirtyFacts
+    quint64             _dirtyFacts;            ///< Facts with deferred change signals
+
     QTimer _updateTimer;
 };
 
@@ -111,3 +111,52 @@ void FactSystemTestBase::_qmlUpdate_test(void)
     delete widget;
 }
 
+/// Test the typed setters, with signals deferred by the FactGroup and immediate ones for a standalone Fact
+void FactSystemTestBase::_typedSetter_test(void)
+{
+    Vehicle*    vehicle = qgcApp()->toolbox()->multiVehicleManager()->activeVehicle();
+    Fact*       groupFact = vehicle->altitudeRelative();
+    QSignalSpy  groupSpy(groupFact, SIGNAL(rawValueChanged(QVariant)));
+
+    // Updates are coalesced until the group is flushed
+    groupFact->setRawDouble(12.5);
+    groupFact->setRawDouble(13.5);
+    QCOMPARE(groupFact->rawValue().toDouble(), 13.5);
+    QCOMPARE(groupSpy.count(), 0);
+    vehicle->flushDirtyFacts();
+    QCOMPARE(groupSpy.count(), 1);
+    QCOMPARE(groupSpy[0][0].toDouble(), 13.5);
+
+    // Same value does not signal
+    groupFact->setRawDouble(13.5);
+    vehicle->flushDirtyFacts();
+    QCOMPARE(groupSpy.count(), 1);
+
+    Fact        fact(0, "test", FactMetaData::valueTypeInt32);
+    QSignalSpy  spy(&fact, SIGNAL(rawValueChanged(QVariant)));
+
+    fact.setRawInt(5);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(fact.rawValue().type(), QVariant::Int);
+    QCOMPARE(fact.rawValue().toInt(), 5);
+    fact.setRawInt(5);
+    QCOMPARE(spy.count(), 1);
+
+    // Mismatched type goes through the regular conversion
+    fact.setRawDouble(7.0);
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(fact.rawValue().type(), QVariant::Int);
+    QCOMPARE(fact.rawValue().toInt(), 7);
+
+    // Values the type can not hold are not truncated, they get the same conversion as through setRawValue
+    Fact unsignedFact(0, "test", FactMetaData::valueTypeUint8);
+    Fact unsignedReference(0, "test", FactMetaData::valueTypeUint8);
+    unsignedFact.setRawInt(-1);
+    unsignedReference.setRawValue(QVariant((qlonglong)-1));
+    QCOMPARE(unsignedFact.rawValue(), unsignedReference.rawValue());
+
+    Fact wideReference(0, "test", FactMetaData::valueTypeInt32);
+    fact.setRawInt(Q_INT64_C(0x100000007));
+    wideReference.setRawValue(QVariant((qlonglong)Q_INT64_C(0x100000007)));
+    QCOMPARE(fact.rawValue(), wideReference.rawValue());
+}
@@ -34,6 +34,7 @@ protected:
     void _parameter_specific_component_id_test(void);
     void _qml_test(void);
     void _qmlUpdate_test(void);
+    void _typedSetter_test(void);
     
     AutoPilotPlugin*                _plugin;
 };
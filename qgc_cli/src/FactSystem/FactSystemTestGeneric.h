@@ -34,6 +34,7 @@ private slots:
     void parameter_specific_component_id_test(void) { _parameter_specific_component_id_test(); }
     void qml_test(void) { _qml_test(); }
     void qmlUpdate_test(void) { _qmlUpdate_test(); }
+    void typedSetter_test(void) { _typedSetter_test(); }
 };
 
 #endif
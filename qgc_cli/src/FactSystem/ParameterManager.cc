@@ -19,6 +19,7 @@
 #include "FirmwarePlugin.h"
 #include "UAS.h"
 #include "JsonHelper.h"
+#include "SettingsStore.h"
 
 #include <QEasingCurve>
 #include <QFile>
@@ -62,6 +63,8 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
     , _disableAllRetries(false)
     , _indexBatchQueueActive(false)
     , _totalParamCount(0)
+    , _initialLoadStartTime(-1)
+    , _metricInitialLoad(NULL)
 {
     _versionParam = vehicle->firmwarePlugin()->getVersionParam();
 
@@ -71,19 +74,20 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
     }
 
     _mavlink = qgcApp()->toolbox()->mavlinkProtocol();
+    _metricInitialLoad = QGCMetrics::instance()->histogram("parameter_initial_load_ms", "Time from the first parameter list request to a complete parameter set");
 
     _initialRequestTimeoutTimer.setSingleShot(true);
     _initialRequestTimeoutTimer.setInterval(5000);
-    connect(&_initialRequestTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_initialRequestTimeout);
+    connect(&_initialRequestTimeoutTimer, &QGCTimer::timeout, this, &ParameterManager::_initialRequestTimeout);
 
     _waitingParamTimeoutTimer.setSingleShot(true);
     _waitingParamTimeoutTimer.setInterval(3000);
-    connect(&_waitingParamTimeoutTimer, &QTimer::timeout, this, &ParameterManager::_waitingParamTimeout);
+    connect(&_waitingParamTimeoutTimer, &QGCTimer::timeout, this, &ParameterManager::_waitingParamTimeout);
 
     connect(_vehicle->uas(), &UASInterface::parameterUpdate, this, &ParameterManager::_parameterUpdate);
 
     // Ensure the cache directory exists
-    QFileInfo(QSettings().fileName()).dir().mkdir("ParamCache");
+    QFileInfo(SettingsStore::instance()->fileName()).dir().mkdir("ParamCache");
 
     refreshAllParameters();
 }
@@ -91,6 +95,7 @@ ParameterManager::ParameterManager(Vehicle* vehicle)
 ParameterManager::~ParameterManager()
 {
     delete _parameterMetaData;
+    QGCMetrics::instance()->release(_metricInitialLoad);
 }
 
 /// Called whenever a parameter is updated or first seen.
@@ -397,6 +402,9 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
 
     if (!_initialLoadComplete) {
         _initialRequestTimeoutTimer.start();
+        if (_initialLoadStartTime < 0) {
+            _initialLoadStartTime = QGCClock::instance()->elapsed();
+        }
     }
 
     // Reset index wait lists
@@ -754,7 +762,7 @@ void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
 
 QDir ParameterManager::parameterCacheDir()
 {
-    const QString spath(QFileInfo(QSettings().fileName()).dir().absolutePath());
+    const QString spath(QFileInfo(SettingsStore::instance()->fileName()).dir().absolutePath());
     return spath + QDir::separator() + "ParamCache";
 }
 
@@ -1036,6 +1044,9 @@ void ParameterManager::_checkInitialLoadComplete(void)
 
     // We aren't waiting for any more initial parameter updates, initial parameter loading is complete
     _initialLoadComplete = true;
+    if (_metricInitialLoad && _initialLoadStartTime >= 0) {
+        _metricInitialLoad->record(QGCClock::instance()->elapsed() - _initialLoadStartTime);
+    }
 
     qCDebug(ParameterManagerLog) << _logVehiclePrefix() << "Initial load complete";
 
@@ -1096,8 +1107,7 @@ QString ParameterManager::parameterMetaDataFile(Vehicle* vehicle, MAV_AUTOPILOT
     FirmwarePlugin* plugin = qgcApp()->toolbox()->firmwarePluginManager()->firmwarePluginForAutopilot(firmwareType, MAV_TYPE_QUADROTOR);
 
     // Cached files are stored in settings location
-    QSettings settings;
-    QDir cacheDir = QFileInfo(settings.fileName()).dir();
+    QDir cacheDir = QFileInfo(SettingsStore::instance()->fileName()).dir();
 
     // First look for a direct cache hit
     int cacheMinorVersion, cacheMajorVersion;
@@ -1219,8 +1229,7 @@ void ParameterManager::cacheMetaDataFile(const QString& metaDataFile, MAV_AUTOPI
     if (cacheNewFile) {
         // Cached files are stored in settings location. Copy from current file to cache naming.
 
-        QSettings settings;
-        QDir cacheDir = QFileInfo(settings.fileName()).dir();
+        QDir cacheDir = QFileInfo(SettingsStore::instance()->fileName()).dir();
         QFile cacheFile(cacheDir.filePath(QString("%1.%2.%3.xml").arg(_cachedMetaDataFilePrefix).arg(firmwareType).arg(newMajorVersion)));
         qCDebug(ParameterManagerLog) << "ParameterManager::cacheMetaDataFile caching file:" << cacheFile.fileName();
         QFile newFile(metaDataFile);
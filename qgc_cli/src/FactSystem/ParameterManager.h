@@ -24,6 +24,8 @@
 #include "AutoPilotPlugin.h"
 #include "QGCMAVLink.h"
 #include "Vehicle.h"
+#include "QGCClock.h"
+#include "QGCMetrics.h"
 
 /// @file
 ///     @author Don Gagne <don@thegagnes.com>
@@ -35,6 +37,8 @@ Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose2Log)
 class ParameterManager : public QObject
 {
     Q_OBJECT
+
+    friend class QGCBenchmark;
     
 public:
     /// @param uas Uas which this set of facts is associated with
@@ -196,9 +200,12 @@ private:
     QMap<int, QList<int> >          _failedReadParamIndexMap;   ///< Key: Component id, Value: failed parameter index
 
     int _totalParamCount;   ///< Number of parameters across all components
+
+    qint64              _initialLoadStartTime;  ///< QGCClock::elapsed of the first request for all parameters, -1 before
+    QGCMetricHistogram* _metricInitialLoad;     ///< Shared by all vehicles
     
-    QTimer _initialRequestTimeoutTimer;
-    QTimer _waitingParamTimeoutTimer;
+    QGCTimer _initialRequestTimeoutTimer;
+    QGCTimer _waitingParamTimeoutTimer;
     
     QMutex _dataMutex;
     
@@ -11,8 +11,7 @@
 #include "SettingsFact.h"
 //#include "QGCCorePlugin.h"
 #include "QGCApplication.h"
-
-#include <QSettings>
+#include "SettingsStore.h"
 
 SettingsFact::SettingsFact(QObject* parent)
     : Fact(parent)
@@ -25,11 +24,7 @@ SettingsFact::SettingsFact(QString settingGroup, FactMetaData* metaData, QObject
     , _settingGroup(settingGroup)
     , _visible(true)
 {
-    QSettings settings;
-
-    if (!_settingGroup.isEmpty()) {
-        settings.beginGroup(_settingGroup);
-    }
+    SettingsStore* settings = SettingsStore::instance();
 
     // Allow core plugin a chance to override the default value
 //    _visible = qgcApp()->toolbox()->corePlugin()->adjustSettingMetaData(*metaData);
@@ -39,11 +34,11 @@ SettingsFact::SettingsFact(QString settingGroup, FactMetaData* metaData, QObject
     if (_visible) {
         QVariant typedValue;
         QString errorString;
-        metaData->convertAndValidateRaw(settings.value(_name, rawDefaultValue), true /* conertOnly */, typedValue, errorString);
+        metaData->convertAndValidateRaw(settings->value(_settingGroup, _name, rawDefaultValue), true /* conertOnly */, typedValue, errorString);
         _rawValue = typedValue;
     } else {
         // Setting is not visible, force to default value always
-        settings.setValue(_name, rawDefaultValue);
+        settings->setValue(_settingGroup, _name, rawDefaultValue);
         _rawValue = rawDefaultValue;
     }
 
@@ -67,11 +62,5 @@ const SettingsFact& SettingsFact::operator=(const SettingsFact& other)
 
 void SettingsFact::_rawValueChanged(QVariant value)
 {
-    QSettings settings;
-
-    if (!_settingGroup.isEmpty()) {
-        settings.beginGroup(_settingGroup);
-    }
-
-    settings.setValue(_name, value);
+    SettingsStore::instance()->setValue(_settingGroup, _name, value);
 }
@@ -621,6 +621,7 @@ void APMFirmwarePlugin::initializeVehicle(Vehicle* vehicle)
 //        vehicle->requestDataStream(MAV_DATA_STREAM_EXTRA2,          10);
 //        vehicle->requestDataStream(MAV_DATA_STREAM_EXTRA3,          3);
 
+        // Defaults until components subscribe to what they use, see Vehicle::streamRateManager
         vehicle->requestDataStream(MAV_DATA_STREAM_RAW_SENSORS,     MAV_DATA_STREAM_RAW_SENSORS_RATE);
         vehicle->requestDataStream(MAV_DATA_STREAM_EXTENDED_STATUS, MAV_DATA_STREAM_EXTENDED_STATUS_RATE);
         vehicle->requestDataStream(MAV_DATA_STREAM_RC_CHANNELS,     MAV_DATA_STREAM_RC_CHANNELS_RATE);
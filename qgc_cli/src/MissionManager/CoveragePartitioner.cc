@@ -0,0 +1,349 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CoveragePartitioner.h"
+#include "QGCMapPolygon.h"
+#include "SurveyMissionItem.h"
+#include "MissionItem.h"
+#include "QGCGeo.h"
+
+#include <QtConcurrent>
+#include <QtMath>
+#include <QPolygonF>
+
+#include <algorithm>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(CoveragePartitionerLog, "CoveragePartitionerLog")
+
+CoveragePartitioner::CoveragePartitioner(void)
+    : _sweepAngle(qQNaN())
+{
+
+}
+
+/// Sutherland-Hodgman clip of the polygon against a single half plane. Works for concave polygons as well, in which
+/// case disjoint pieces are joined by zero width edges which do not contribute to the area. Only good for the area,
+/// _splitHalfPlane returns the pieces.
+///     @param axis Unit vector of the sweep direction
+///     @param offset Position of the clip line along axis
+///     @param keepBelow true: keep the part with position <= offset, false: keep position >= offset
+QVector<QPointF> CoveragePartitioner::_clipHalfPlane(const QVector<QPointF>& polygon, const QPointF& axis, double offset, bool keepBelow)
+{
+    QVector<QPointF> result;
+    int count = polygon.count();
+    if (count == 0) {
+        return result;
+    }
+    result.reserve(count + 2);
+
+    auto signedDistance = [&](const QPointF& point) {
+        double distance = (point.x() * axis.x()) + (point.y() * axis.y()) - offset;
+        return keepBelow ? -distance : distance;
+    };
+
+    for (int i=0; i<count; i++) {
+        const QPointF& current = polygon[i];
+        const QPointF& next = polygon[(i + 1) % count];
+        double currentDistance = signedDistance(current);
+        double nextDistance = signedDistance(next);
+
+        if (currentDistance >= 0) {
+            result.append(current);
+        }
+        if ((currentDistance >= 0) != (nextDistance >= 0)) {
+            double t = currentDistance / (currentDistance - nextDistance);
+            result.append(current + ((next - current) * t));
+        }
+    }
+
+    return result;
+}
+
+/// Clips the polygon against a single half plane into separate pieces. The boundary inside the half plane falls apart
+/// into chains from where it enters to where it leaves. Sorted along the clip line, the crossings pair up into the
+/// segments of the line inside the polygon, each from the exit of one chain to the entry of another, which closes the
+/// chains into pieces.
+///     @param axis Unit vector of the sweep direction
+///     @param offset Position of the clip line along axis
+///     @param keepBelow true: keep the part with position <= offset, false: keep position >= offset
+QList<QVector<QPointF> > CoveragePartitioner::_splitHalfPlane(const QVector<QPointF>& polygon, const QPointF& axis, double offset, bool keepBelow)
+{
+    QList<QVector<QPointF> > pieces;
+    int count = polygon.count();
+
+    QVector<double> distances(count);
+    int firstOutside = -1;
+    for (int i=0; i<count; i++) {
+        double distance = (polygon[i].x() * axis.x()) + (polygon[i].y() * axis.y()) - offset;
+        distances[i] = keepBelow ? -distance : distance;
+        if (distances[i] < 0 && firstOutside == -1) {
+            firstOutside = i;
+        }
+    }
+
+    if (firstOutside == -1) {
+        pieces.append(polygon);
+        return pieces;
+    }
+
+    struct Chain {
+        QVector<QPointF>    points;
+        int                 next;   ///< Chain the piece goes on with after this one
+    };
+    struct Crossing {
+        double  position;           ///< Along the clip line
+        int     chain;
+        bool    entry;
+    };
+
+    QPointF             along(-axis.y(), axis.x());
+    QVector<Chain>      chains;
+    QVector<Crossing>   crossings;
+
+    // Starting outside, every chain is complete by the time the walk gets back there
+    for (int k=0; k<count; k++) {
+        int i = (firstOutside + k) % count;
+        int j = (i + 1) % count;
+
+        if (distances[i] >= 0) {
+            chains.last().points.append(polygon[i]);
+        }
+        if ((distances[i] >= 0) != (distances[j] >= 0)) {
+            double  t = distances[i] / (distances[i] - distances[j]);
+            QPointF crossing = polygon[i] + ((polygon[j] - polygon[i]) * t);
+            double  position = (crossing.x() * along.x()) + (crossing.y() * along.y());
+
+            if (distances[j] >= 0) {
+                chains.append(Chain{ QVector<QPointF>() << crossing, -1 });
+                crossings.append(Crossing{ position, chains.count() - 1, true });
+            } else {
+                chains.last().points.append(crossing);
+                crossings.append(Crossing{ position, chains.count() - 1, false });
+            }
+        }
+    }
+
+    std::sort(crossings.begin(), crossings.end(), [](const Crossing& a, const Crossing& b) {
+        if (a.position != b.position) {
+            return a.position < b.position;
+        }
+        if (a.chain != b.chain) {
+            return a.chain < b.chain;
+        }
+        return a.entry < b.entry;
+    });
+
+    for (int i=0; i+1<crossings.count(); i+=2) {
+        const Crossing& first = crossings[i];
+        const Crossing& second = crossings[i + 1];
+        if (first.entry == second.entry) {
+            // Only degenerate input, such as a self intersecting polygon, gets here
+            qCWarning(CoveragePartitionerLog) << "Unpaired clip line crossings, keeping the polygon in one piece";
+            pieces.append(_clipHalfPlane(polygon, axis, offset, keepBelow));
+            return pieces;
+        }
+        if (first.entry) {
+            chains[second.chain].next = first.chain;
+        } else {
+            chains[first.chain].next = second.chain;
+        }
+    }
+
+    QVector<bool> visited(chains.count(), false);
+    for (int i=0; i<chains.count(); i++) {
+        QVector<QPointF> piece;
+        for (int chain=i; chain != -1 && !visited[chain]; chain=chains[chain].next) {
+            visited[chain] = true;
+            piece += chains[chain].points;
+        }
+        // Vertices touching the clip line from outside leave pieces without area
+        if (_area(piece) > _minPieceArea) {
+            pieces.append(piece);
+        }
+    }
+
+    return pieces;
+}
+
+double CoveragePartitioner::_area(const QVector<QPointF>& polygon)
+{
+    double area = 0;
+    for (int i=0; i<polygon.count(); i++) {
+        const QPointF& current = polygon[i];
+        const QPointF& next = polygon[(i + 1) % polygon.count()];
+        area += (current.x() * next.y()) - (next.x() * current.y());
+    }
+    return 0.5 * qAbs(area);
+}
+
+double CoveragePartitioner::_areaBelow(const QVector<QPointF>& polygon, const QPointF& axis, double offset)
+{
+    return _area(_clipHalfPlane(polygon, axis, offset, true /* keepBelow */));
+}
+
+QList<CoveragePartitioner::Partition> CoveragePartitioner::partition(const QGCMapPolygon& polygon, const QList<Agent>& agents) const
+{
+    return partition(polygon.coordinateList(), agents);
+}
+
+QList<CoveragePartitioner::Partition> CoveragePartitioner::partition(const QList<QGeoCoordinate>& polygon, const QList<Agent>& agents) const
+{
+    QList<Partition> partitions;
+
+    if (polygon.count() < 3 || agents.count() == 0) {
+        return partitions;
+    }
+
+    // Convert polygon to a local tangent plane. x is east, y is north.
+    QGeoCoordinate tangentOrigin = polygon.first();
+    QVector<QPointF> planePolygon;
+    planePolygon.reserve(polygon.count());
+    for (int i=0; i<polygon.count(); i++) {
+        double north = 0, east = 0, down;
+        if (i != 0) {
+            convertGeoToNed(polygon[i], tangentOrigin, &north, &east, &down);
+        }
+        planePolygon.append(QPointF(east, north));
+    }
+
+    QPointF axis;
+    if (qIsNaN(_sweepAngle)) {
+        QRectF bounds = QPolygonF(planePolygon).boundingRect();
+        axis = bounds.width() >= bounds.height() ? QPointF(1, 0) : QPointF(0, 1);
+    } else {
+        double radians = qDegreesToRadians(_sweepAngle);
+        axis = QPointF(qSin(radians), qCos(radians));
+    }
+
+    double minOffset = std::numeric_limits<double>::max();
+    double maxOffset = -std::numeric_limits<double>::max();
+    for (int i=0; i<planePolygon.count(); i++) {
+        double offset = (planePolygon[i].x() * axis.x()) + (planePolygon[i].y() * axis.y());
+        minOffset = qMin(minOffset, offset);
+        maxOffset = qMax(maxOffset, offset);
+    }
+
+    // Strips are assigned in the order of the agent start positions along the sweep axis
+    QVector<QPair<double, int>> agentOrder;
+    double totalCapacity = 0;
+    for (int i=0; i<agents.count(); i++) {
+        double north = 0, east = 0, down;
+        if (agents[i].start.isValid() && agents[i].start != tangentOrigin) {
+            convertGeoToNed(agents[i].start, tangentOrigin, &north, &east, &down);
+        }
+        agentOrder.append(qMakePair((east * axis.x()) + (north * axis.y()), i));
+        totalCapacity += qMax(0.0, agents[i].capacity);
+    }
+    std::sort(agentOrder.begin(), agentOrder.end());
+
+    double totalArea = _area(planePolygon);
+    if (totalCapacity <= 0 || totalArea <= 0) {
+        qCWarning(CoveragePartitionerLog) << "Invalid partition input: capacity:area" << totalCapacity << totalArea;
+        return partitions;
+    }
+
+    // Each cut position is found independently by bisection on the monotonic area below function
+    struct CutSearch {
+        double targetArea;
+        double offset;
+    };
+    QVector<CutSearch> cuts(agents.count() + 1);
+    double cumulativeCapacity = 0;
+    for (int i=0; i<agentOrder.count(); i++) {
+        cuts[i].targetArea = totalArea * (cumulativeCapacity / totalCapacity);
+        cumulativeCapacity += qMax(0.0, agents[agentOrder[i].second].capacity);
+    }
+    cuts.first().offset = minOffset;
+    cuts.last().offset = maxOffset;
+
+    QVector<CutSearch*> innerCuts;
+    for (int i=1; i<cuts.count()-1; i++) {
+        innerCuts.append(&cuts[i]);
+    }
+    QtConcurrent::blockingMap(innerCuts, [&](CutSearch* cut) {
+        double low = minOffset;
+        double high = maxOffset;
+        for (int i=0; i<_cutSearchIterations; i++) {
+            double middle = (low + high) / 2.0;
+            if (_areaBelow(planePolygon, axis, middle) < cut->targetArea) {
+                low = middle;
+            } else {
+                high = middle;
+            }
+        }
+        cut->offset = (low + high) / 2.0;
+    });
+
+    for (int i=0; i<agents.count(); i++) {
+        partitions.append(Partition{ i, QList<QList<QGeoCoordinate> >(), 0 });
+    }
+
+    for (int i=0; i<agentOrder.count(); i++) {
+        Partition& agentPartition = partitions[agentOrder[i].second];
+        if (agents[agentPartition.agentIndex].capacity <= 0) {
+            continue;
+        }
+
+        foreach (const QVector<QPointF>& above, _splitHalfPlane(planePolygon, axis, cuts[i].offset, false /* keepBelow */)) {
+            foreach (const QVector<QPointF>& piece, _splitHalfPlane(above, axis, cuts[i + 1].offset, true /* keepBelow */)) {
+                QList<QGeoCoordinate> piecePolygon;
+                for (int j=0; j<piece.count(); j++) {
+                    if ((j != 0 && piece[j] == piece[j - 1]) || (j == piece.count() - 1 && piece[j] == piece.first())) {
+                        continue;
+                    }
+                    QGeoCoordinate coord;
+                    convertNedToGeo(piece[j].y(), piece[j].x(), 0, tangentOrigin, &coord);
+                    piecePolygon.append(coord);
+                }
+                if (piecePolygon.count() >= 3) {
+                    agentPartition.polygons.append(piecePolygon);
+                    agentPartition.area += _area(piece);
+                }
+            }
+        }
+        qCDebug(CoveragePartitionerLog) << "Partition agent:area:pieces" << agentPartition.agentIndex << agentPartition.area << agentPartition.polygons.count();
+    }
+
+    return partitions;
+}
+
+QList<MissionItem*> CoveragePartitioner::missionItems(const Partition& partition, const QGeoCoordinate& home, Vehicle* vehicle, double altitude, double gridSpacing, double gridAngle, QObject* missionItemParent)
+{
+    QList<MissionItem*> items;
+
+    if (partition.polygons.isEmpty()) {
+        return items;
+    }
+
+    // Planned home position
+    items.append(new MissionItem(0,
+                                 MAV_CMD_NAV_WAYPOINT,
+                                 MAV_FRAME_GLOBAL,
+                                 0, 0, 0, 0,            // param 1-4 unused
+                                 home.latitude(),
+                                 home.longitude(),
+                                 home.altitude(),
+                                 true,                  // autoContinue
+                                 false,                 // isCurrentItem
+                                 missionItemParent));
+
+    foreach (const QList<QGeoCoordinate>& polygon, partition.polygons) {
+        SurveyMissionItem survey(vehicle);
+        survey.setSequenceNumber(items.count());
+        survey.gridAltitude()->setRawValue(altitude);
+        survey.gridAltitudeRelative()->setRawValue(true);
+        survey.gridSpacing()->setRawValue(gridSpacing);
+        survey.gridAngle()->setRawValue(gridAngle);
+        survey.mapPolygon()->setPath(polygon);
+        survey.appendMissionItems(items, missionItemParent);
+    }
+
+    return items;
+}
@@ -0,0 +1,78 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QGeoCoordinate>
+#include <QPointF>
+#include <QVector>
+#include <QList>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(CoveragePartitionerLog)
+
+class QGCMapPolygon;
+class MissionItem;
+class Vehicle;
+
+/// Splits a survey area between multiple vehicles. The polygon is cut into parallel strips along a sweep direction such
+/// that each strip's area is proportional to the capacity of the vehicle it is assigned to. Strips are handed out in the
+/// order of the vehicle start positions along the sweep direction so vehicles don't have to cross each other's area.
+/// The cut positions are independent of each other and are searched for in parallel on the global thread pool.
+class CoveragePartitioner
+{
+public:
+    CoveragePartitioner(void);
+
+    struct Agent {
+        QGeoCoordinate  start;      ///< Current or planned start position of the vehicle
+        double          capacity;   ///< Relative amount of work the vehicle can do (e.g. remaining flight time), must be >= 0
+    };
+
+    struct Partition {
+        int                             agentIndex; ///< Index into the agent list passed to partition
+        QList<QList<QGeoCoordinate> >   polygons;   ///< Pieces of the strip to cover, more than one where the strip cuts
+                                                    ///< a concave area apart. Empty if the agent has no capacity.
+        double                          area;       ///< Area of the pieces in square meters
+    };
+
+    /// Sets the sweep direction in degrees from north. Default is NaN, which sweeps along the longest side of the
+    /// bounding box of the polygon.
+    void setSweepAngle(double sweepAngle) { _sweepAngle = sweepAngle; }
+
+    /// Partitions the polygon between the agents
+    /// @return One partition per agent, in the same order as agents. Empty list if the polygon is invalid.
+    QList<Partition> partition(const QList<QGeoCoordinate>& polygon, const QList<Agent>& agents) const;
+    QList<Partition> partition(const QGCMapPolygon& polygon, const QList<Agent>& agents) const;
+
+    /// Builds a complete mission for a partition which can be passed directly to MissionManager::writeMissionItems:
+    /// planned home position at sequence 0 followed by a survey of each piece of the partition. Must be called from the
+    /// thread which owns the vehicle.
+    ///     @param partition Partition to survey
+    ///     @param home Planned home position
+    ///     @param vehicle Vehicle the mission is for
+    ///     @param altitude Survey altitude, relative to home
+    ///     @param gridSpacing Distance between transects in meters
+    ///     @param gridAngle Transect angle in degrees from north
+    ///     @param missionItemParent Parent object for newly created MissionItem objects
+    static QList<MissionItem*> missionItems(const Partition& partition, const QGeoCoordinate& home, Vehicle* vehicle, double altitude, double gridSpacing, double gridAngle, QObject* missionItemParent);
+
+private:
+    static QVector<QPointF>         _clipHalfPlane  (const QVector<QPointF>& polygon, const QPointF& axis, double offset, bool keepBelow);
+    static QList<QVector<QPointF> > _splitHalfPlane (const QVector<QPointF>& polygon, const QPointF& axis, double offset, bool keepBelow);
+    static double           _area           (const QVector<QPointF>& polygon);
+    static double           _areaBelow      (const QVector<QPointF>& polygon, const QPointF& axis, double offset);
+
+    double _sweepAngle;
+
+    static const int _cutSearchIterations = 60;
+
+    static constexpr double _minPieceArea = 1e-6;   ///< Square meters, pieces below are rounding left overs
+};
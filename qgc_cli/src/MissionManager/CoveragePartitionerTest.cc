@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CoveragePartitionerTest.h"
+#include "QGCApplication.h"
+#include "QGCGeo.h"
+#include "MissionItem.h"
+#include "Vehicle.h"
+
+static const QGeoCoordinate _origin(47.6, -122.1);
+
+/// U opening north: a 400m x 100m bar with two 100m x 200m arms, the notch between them is 200m wide
+const double CoveragePartitionerTest::_uArea = (400.0 * 100.0) + (2 * 100.0 * 200.0);
+
+QGeoCoordinate CoveragePartitionerTest::_geo(double east, double north)
+{
+    QGeoCoordinate coord;
+    convertNedToGeo(north, east, 0, _origin, &coord);
+    return coord;
+}
+
+QPointF CoveragePartitionerTest::_plane(const QGeoCoordinate& coord)
+{
+    double north, east, down;
+    convertGeoToNed(coord, _origin, &north, &east, &down);
+    return QPointF(east, north);
+}
+
+QList<QGeoCoordinate> CoveragePartitionerTest::_uShape(void)
+{
+    return QList<QGeoCoordinate>() << _geo(0, 0) << _geo(400, 0) << _geo(400, 300) << _geo(300, 300)
+                                   << _geo(300, 100) << _geo(100, 100) << _geo(100, 300) << _geo(0, 300);
+}
+
+void CoveragePartitionerTest::_testAreaBalance(void)
+{
+    QList<QGeoCoordinate> rectangle;
+    rectangle << _geo(0, 0) << _geo(600, 0) << _geo(600, 200) << _geo(0, 200);
+
+    QList<CoveragePartitioner::Agent> agents;
+    agents << CoveragePartitioner::Agent{ _geo(0, 0), 1 } << CoveragePartitioner::Agent{ _geo(300, 0), 2 } << CoveragePartitioner::Agent{ _geo(600, 0), 1 };
+
+    CoveragePartitioner partitioner;
+    QList<CoveragePartitioner::Partition> partitions = partitioner.partition(rectangle, agents);
+    QCOMPARE(partitions.count(), agents.count());
+
+    // Areas follow the capacities and together cover the rectangle
+    double totalArea = 0;
+    for (int i=0; i<partitions.count(); i++) {
+        QCOMPARE(partitions[i].agentIndex, i);
+        QCOMPARE(partitions[i].polygons.count(), 1);
+        QVERIFY(qAbs(partitions[i].area - (600.0 * 200.0 * agents[i].capacity / 4.0)) < 10.0);
+        totalArea += partitions[i].area;
+    }
+    QVERIFY(qAbs(totalArea - (600.0 * 200.0)) < 10.0);
+}
+
+void CoveragePartitionerTest::_testStartOrder(void)
+{
+    QList<QGeoCoordinate> rectangle;
+    rectangle << _geo(0, 0) << _geo(600, 0) << _geo(600, 200) << _geo(0, 200);
+
+    // The agent listed first starts in the east, so it gets the eastern strip
+    QList<CoveragePartitioner::Agent> agents;
+    agents << CoveragePartitioner::Agent{ _geo(700, 100), 1 } << CoveragePartitioner::Agent{ _geo(-100, 100), 1 };
+
+    CoveragePartitioner partitioner;
+    QList<CoveragePartitioner::Partition> partitions = partitioner.partition(rectangle, agents);
+    QCOMPARE(partitions.count(), 2);
+
+    foreach (const QGeoCoordinate& coord, partitions[0].polygons.first()) {
+        QVERIFY(_plane(coord).x() > 300.0 - 0.1);
+    }
+    foreach (const QGeoCoordinate& coord, partitions[1].polygons.first()) {
+        QVERIFY(_plane(coord).x() < 300.0 + 0.1);
+    }
+}
+
+void CoveragePartitionerTest::_testZeroCapacity(void)
+{
+    QList<CoveragePartitioner::Agent> agents;
+    agents << CoveragePartitioner::Agent{ _geo(0, -100), 1 } << CoveragePartitioner::Agent{ _geo(0, 400), 0 };
+
+    CoveragePartitioner partitioner;
+    partitioner.setSweepAngle(0);
+    QList<CoveragePartitioner::Partition> partitions = partitioner.partition(_uShape(), agents);
+    QCOMPARE(partitions.count(), 2);
+
+    QVERIFY(qAbs(partitions[0].area - _uArea) < 10.0);
+    QCOMPARE(partitions[1].polygons.count(), 0);
+    QCOMPARE(partitions[1].area, 0.0);
+
+    // No agent with capacity, nothing to partition
+    agents[0].capacity = 0;
+    QCOMPARE(partitioner.partition(_uShape(), agents).count(), 0);
+}
+
+void CoveragePartitionerTest::_testConcave(void)
+{
+    // The southern agent takes 3/4 of the area, which puts the cut through the arms at 200m
+    QList<CoveragePartitioner::Agent> agents;
+    agents << CoveragePartitioner::Agent{ _geo(200, -100), 3 } << CoveragePartitioner::Agent{ _geo(200, 400), 1 };
+
+    CoveragePartitioner partitioner;
+    partitioner.setSweepAngle(0);
+    QList<CoveragePartitioner::Partition> partitions = partitioner.partition(_uShape(), agents);
+    QCOMPARE(partitions.count(), 2);
+
+    QCOMPARE(partitions[0].polygons.count(), 1);
+    QVERIFY(qAbs(partitions[0].area - (_uArea * 3.0 / 4.0)) < 10.0);
+
+    // The strip across the arms comes apart into one piece per arm, with nothing in the notch
+    const CoveragePartitioner::Partition& arms = partitions[1];
+    QCOMPARE(arms.polygons.count(), 2);
+    QVERIFY(qAbs(arms.area - (_uArea / 4.0)) < 10.0);
+    foreach (const QList<QGeoCoordinate>& polygon, arms.polygons) {
+        QCOMPARE(polygon.count(), 4);
+        foreach (const QGeoCoordinate& coord, polygon) {
+            QPointF point = _plane(coord);
+            QVERIFY(point.x() < 100.1 || point.x() > 299.9);
+            QVERIFY(point.y() > 199.9);
+        }
+    }
+
+    // One survey per arm, with no transects across the notch
+    Vehicle* offlineVehicle = new Vehicle(MAV_AUTOPILOT_PX4, MAV_TYPE_QUADROTOR, qgcApp()->toolbox()->firmwarePluginManager(), this);
+    QList<MissionItem*> items = CoveragePartitioner::missionItems(arms, _origin, offlineVehicle, 50, 20, 0, this);
+    QVERIFY(items.count() > 2);
+    for (int i=0; i<items.count(); i++) {
+        QCOMPARE(items[i]->sequenceNumber(), i);
+        if (i != 0 && items[i]->command() == MAV_CMD_NAV_WAYPOINT) {
+            double east = _plane(items[i]->coordinate()).x();
+            QVERIFY(east < 100.1 || east > 299.9);
+        }
+    }
+    qDeleteAll(items);
+    delete offlineVehicle;
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "CoveragePartitioner.h"
+
+/// Unit test for CoveragePartitioner
+class CoveragePartitionerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testAreaBalance(void);
+    void _testStartOrder(void);
+    void _testZeroCapacity(void);
+    void _testConcave(void);
+
+private:
+    QGeoCoordinate          _geo    (double east, double north);
+    QPointF                 _plane  (const QGeoCoordinate& coord);
+    QList<QGeoCoordinate>   _uShape (void);
+
+    static const double _uArea;
+};
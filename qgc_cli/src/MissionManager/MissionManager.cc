@@ -32,19 +32,37 @@ MissionManager::MissionManager(Vehicle* vehicle)
     , _currentMissionIndex(-1)
     , _lastCurrentIndex(-1)
     , _cachedLastCurrentIndex(-1)
+    , _transactionMetric(TransactionMetricRead)
+    , _transactionStartTime(0)
 {
     connect(_vehicle, &Vehicle::mavlinkMessageReceived, this, &MissionManager::_mavlinkMessageReceived);
     
-    _ackTimeoutTimer = new QTimer(this);
+    _ackTimeoutTimer = new QGCTimer(this);
     _ackTimeoutTimer->setSingleShot(true);
     _ackTimeoutTimer->setInterval(_ackTimeoutMilliseconds);
     
-    connect(_ackTimeoutTimer, &QTimer::timeout, this, &MissionManager::_ackTimeout);
+    connect(_ackTimeoutTimer, &QGCTimer::timeout, this, &MissionManager::_ackTimeout);
+
+    const char* rgTransactionNames[TransactionMetricCount] = { "read", "write", "guided", "remove_all" };
+    for (int i=0; i<TransactionMetricCount; i++) {
+        QGCMetricLabels labels = { { QStringLiteral("transaction"), rgTransactionNames[i] } };
+        _rgMetricTransactionTime[i] = QGCMetrics::instance()->histogram("mission_transaction_ms", "Time from the start of a mission transaction to its end", labels);
+        _rgMetricTransactionFailures[i] = QGCMetrics::instance()->counter("mission_transaction_failures_total", "Mission transactions which failed", labels);
+    }
 }
 
 MissionManager::~MissionManager()
 {
+    for (int i=0; i<TransactionMetricCount; i++) {
+        QGCMetrics::instance()->release(_rgMetricTransactionTime[i]);
+        QGCMetrics::instance()->release(_rgMetricTransactionFailures[i]);
+    }
+}
 
+void MissionManager::_startTransactionTime(TransactionMetric_t metric)
+{
+    _transactionMetric = metric;
+    _transactionStartTime = QGCClock::instance()->elapsed();
 }
 
 void MissionManager::_writeMissionItemsWorker(void)
@@ -62,6 +80,7 @@ void MissionManager::_writeMissionItemsWorker(void)
     }
 
     _transactionInProgress = TransactionWrite;
+    _startTransactionTime(TransactionMetricWrite);
     _retryCount = 0;
     emit inProgressChanged(true);
     _writeMissionCount();
@@ -135,36 +154,46 @@ void MissionManager::writeArduPilotGuidedMissionItem(const QGeoCoordinate& gotoC
     }
 
     _transactionInProgress = TransactionWrite;
+    _startTransactionTime(TransactionMetricGuided);
+
+    memset(&_guidedMissionItem, 8, sizeof(_guidedMissionItem));
+    _guidedMissionItem.target_system =     _vehicle->id();
+    _guidedMissionItem.target_component =  _vehicle->defaultComponentId();
+    _guidedMissionItem.seq =               0;
+    _guidedMissionItem.command =           MAV_CMD_NAV_WAYPOINT;
+    _guidedMissionItem.param1 =            0;
+    _guidedMissionItem.param2 =            0;
+    _guidedMissionItem.param3 =            0;
+    _guidedMissionItem.param4 =            0;
+    _guidedMissionItem.x =                 gotoCoord.latitude();
+    _guidedMissionItem.y =                 gotoCoord.longitude();
+    _guidedMissionItem.z =                 gotoCoord.altitude();
+    _guidedMissionItem.frame =             MAV_FRAME_GLOBAL_RELATIVE_ALT;
+    _guidedMissionItem.current =           altChangeOnly ? 3 : 2;
+    _guidedMissionItem.autocontinue =      true;
 
-    mavlink_message_t       messageOut;
-    mavlink_mission_item_t  missionItem;
-
-    memset(&missionItem, 8, sizeof(missionItem));
-    missionItem.target_system =     _vehicle->id();
-    missionItem.target_component =  _vehicle->defaultComponentId();
-    missionItem.seq =               0;
-    missionItem.command =           MAV_CMD_NAV_WAYPOINT;
-    missionItem.param1 =            0;
-    missionItem.param2 =            0;
-    missionItem.param3 =            0;
-    missionItem.param4 =            0;
-    missionItem.x =                 gotoCoord.latitude();
-    missionItem.y =                 gotoCoord.longitude();
-    missionItem.z =                 gotoCoord.altitude();
-    missionItem.frame =             MAV_FRAME_GLOBAL_RELATIVE_ALT;
-    missionItem.current =           altChangeOnly ? 3 : 2;
-    missionItem.autocontinue =      true;
+    _retryCount = 0;
+    _writeGuidedMissionItem();
+    emit inProgressChanged(true);
+}
+
+/// Sends the guided target on the priority link, retries also go out on the other healthy links when the vehicle sends
+/// redundant commands
+void MissionManager::_writeGuidedMissionItem(void)
+{
+    mavlink_message_t messageOut;
 
     _dedicatedLink = _vehicle->priorityLink();
-    mavlink_msg_mission_item_encode_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
-                                         qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
-                                         _dedicatedLink->mavlinkChannel(),
-                                         &messageOut,
-                                         &missionItem);
+    foreach (LinkInterface* link, _vehicle->commandLinks(_retryCount > 0)) {
+        mavlink_msg_mission_item_encode_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
+                                             qgcApp()->toolbox()->mavlinkProtocol()->getComponentId(),
+                                             link->mavlinkChannel(),
+                                             &messageOut,
+                                             &_guidedMissionItem);
 
-    _vehicle->sendMessageOnLink(_dedicatedLink, messageOut);
+        _vehicle->sendMessageOnLink(link, messageOut);
+    }
     _startAckTimeout(AckGuidedItem);
-    emit inProgressChanged(true);
 }
 
 void MissionManager::loadFromVehicle(void)
@@ -182,6 +211,7 @@ void MissionManager::loadFromVehicle(void)
 
     _retryCount = 0;
     _transactionInProgress = TransactionRead;
+    _startTransactionTime(TransactionMetricRead);
     emit inProgressChanged(true);
     _requestList();
 }
@@ -281,7 +311,16 @@ void MissionManager::_ackTimeout(void)
         }
         break;
     case AckGuidedItem:
-        // MISSION_REQUEST is expected, or MISSION_ACK to end sequence
+        // MISSION_ACK expected
+        if (_retryCount > _maxRetryCount) {
+            _sendError(VehicleError, QStringLiteral("Guided item write failed, maximum retries exceeded."));
+            _finishTransaction(false);
+        } else {
+            _retryCount++;
+            qCDebug(MissionManagerLog) << "Retrying guided MISSION_ITEM retry Count" << _retryCount;
+            _writeGuidedMissionItem();
+        }
+        break;
     default:
         _sendError(AckTimeoutError, QString("Vehicle did not respond to mission item communication: %1").arg(_ackTypeToString(_expectedAck)));
         _expectedAck = AckNone;
@@ -632,6 +671,11 @@ void MissionManager::_handleMissionAck(const mavlink_message_t& message)
 
     switch (savedExpectedAck) {
     case AckNone:
+        if (missionAck.type == MAV_MISSION_ACCEPTED) {
+            // Late ack of a message which was sent again, the transaction already finished
+            qCDebug(MissionManagerLog) << "_handleMissionAck ignoring duplicate ack";
+            break;
+        }
         // State machine is idle. Vehicle is confused.
         _sendError(VehicleError, QString("Vehicle sent unexpected MISSION_ACK message, error: %1").arg(_missionResultToString((MAV_MISSION_RESULT)missionAck.type)));
         break;
@@ -863,6 +907,11 @@ void MissionManager::_finishTransaction(bool success)
         _transactionInProgress = TransactionNone;
         qDebug() << "inProgressChanged";
         emit inProgressChanged(false);
+
+        _rgMetricTransactionTime[_transactionMetric]->record(QGCClock::instance()->elapsed() - _transactionStartTime);
+        if (!success) {
+            _rgMetricTransactionFailures[_transactionMetric]->add();
+        }
     }
 
     switch (currentTransactionType) {
@@ -987,6 +1036,7 @@ void MissionManager::removeAll(void)
     emit lastCurrentIndexChanged(-1);
 
     _transactionInProgress = TransactionRemoveAll;
+    _startTransactionTime(TransactionMetricRemoveAll);
     _retryCount = 0;
     emit inProgressChanged(true);
 
@@ -21,6 +21,8 @@
 #include "QGCMAVLink.h"
 #include "QGCLoggingCategory.h"
 #include "LinkInterface.h"
+#include "QGCClock.h"
+#include "QGCMetrics.h"
 
 class Vehicle;
 
@@ -114,6 +116,15 @@ private:
         TransactionRemoveAll
     } TransactionType_t;
 
+    /// Transactions timed separately, guided items are writes of their own
+    typedef enum {
+        TransactionMetricRead,
+        TransactionMetricWrite,
+        TransactionMetricGuided,
+        TransactionMetricRemoveAll,
+        TransactionMetricCount
+    } TransactionMetric_t;
+
     void _startAckTimeout(AckType_t ack);
     bool _checkForExpectedAck(AckType_t receivedAck);
     void _readTransactionComplete(void);
@@ -136,12 +147,14 @@ private:
     void _clearAndDeleteWriteMissionItems(void);
     QString _lastMissionReqestString(MAV_MISSION_RESULT result);
     void _removeAllWorker(void);
+    void _writeGuidedMissionItem(void);
+    void _startTransactionTime(TransactionMetric_t metric);
 
 private:
     Vehicle*            _vehicle;
     LinkInterface*      _dedicatedLink;
     
-    QTimer*             _ackTimeoutTimer;
+    QGCTimer*           _ackTimeoutTimer;
     AckType_t           _expectedAck;
     int                 _retryCount;
     
@@ -150,6 +163,7 @@ private:
     QList<int>          _itemIndicesToWrite;    ///< List of mission items which still need to be written to vehicle
     QList<int>          _itemIndicesToRead;     ///< List of mission items which still need to be requested from vehicle
     int                 _lastMissionRequest;    ///< Index of item last requested by MISSION_REQUEST
+    mavlink_mission_item_t _guidedMissionItem;  ///< Guided target being written, kept for retries
     
     QMutex _dataMutex;
     
@@ -158,6 +172,11 @@ private:
     int                 _currentMissionIndex;
     int                 _lastCurrentIndex;
     int                 _cachedLastCurrentIndex;
+
+    TransactionMetric_t _transactionMetric;     ///< Metric of the transaction in progress
+    qint64              _transactionStartTime;  ///< QGCClock::elapsed the transaction in progress started at
+    QGCMetricHistogram* _rgMetricTransactionTime[TransactionMetricCount];       ///< Shared by all vehicles
+    QGCMetricCounter*   _rgMetricTransactionFailures[TransactionMetricCount];   ///< Shared by all vehicles
 };
 
 #endif
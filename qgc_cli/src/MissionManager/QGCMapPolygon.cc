@@ -24,6 +24,7 @@ QGCMapPolygon::QGCMapPolygon(QObject* newCoordParent, QObject* parent)
     , _dirty(false)
     , _centerDrag(false)
     , _ignoreCenterUpdates(false)
+    , _indexValid(0)
 {
     connect(&_polygonModel, &QmlObjectListModel::dirtyChanged, this, &QGCMapPolygon::_polygonModelDirtyChanged);
     connect(&_polygonModel, &QmlObjectListModel::countChanged, this, &QGCMapPolygon::_polygonModelCountChanged);
@@ -32,6 +33,8 @@ QGCMapPolygon::QGCMapPolygon(QObject* newCoordParent, QObject* parent)
 
 void QGCMapPolygon::clear(void)
 {
+    _invalidateContainsIndex();
+
     // Bug workaround, see below
     while (_polygonPath.count() > 1) {
         _polygonPath.takeLast();
@@ -54,6 +57,7 @@ void QGCMapPolygon::clear(void)
 void QGCMapPolygon::adjustVertex(int vertexIndex, const QGeoCoordinate coordinate)
 {
     _polygonPath[vertexIndex] = QVariant::fromValue(coordinate);
+    _invalidateContainsIndex();
     if (!_centerDrag) {
         // When dragging center we don't signal path changed until add vertices are updated
         emit pathChanged();
@@ -104,31 +108,148 @@ QPointF QGCMapPolygon::_pointFFromCoord(const QGeoCoordinate& coordinate) const
     return QPointF();
 }
 
-QPolygonF QGCMapPolygon::_toPolygonF(void) const
+void QGCMapPolygon::_invalidateContainsIndex(void)
 {
-    QPolygonF polygon;
+    _indexValid.storeRelease(0);
+}
 
-    if (_polygonPath.count() > 2) {
-        for (int i=0; i<_polygonPath.count(); i++) {
-            polygon.append(_pointFFromCoord(_polygonPath[i].value<QGeoCoordinate>()));
+const QGCMapPolygon::ContainsIndex& QGCMapPolygon::_containsIndex(void) const
+{
+    if (!_indexValid.loadAcquire()) {
+        QMutexLocker locker(&_indexMutex);
+        if (!_indexValid.load()) {
+            _buildContainsIndex();
+            _indexValid.storeRelease(1);
         }
     }
+    return _index;
+}
+
+void QGCMapPolygon::_buildContainsIndex(void) const
+{
+    int count = _polygonPath.count();
+
+    _index.points.resize(count);
+    _index.slabStart.clear();
+    _index.slabEdges.clear();
+    _index.bounds = QRectF();
+    _index.slabHeight = 1;
+
+    if (count == 0) {
+        _index.tangentOrigin = QGeoCoordinate();
+        return;
+    }
+
+    _index.tangentOrigin = _polygonPath[0].value<QGeoCoordinate>();
+    _index.points[0] = QPointF(0, 0);
+    for (int i=1; i<count; i++) {
+        _index.points[i] = _pointFFromCoord(_polygonPath[i].value<QGeoCoordinate>());
+    }
+    _index.bounds = QPolygonF(_index.points).boundingRect();
 
-    return polygon;
+    int slabCount = qBound(1, count, _maxSlabs);
+    if (_index.bounds.height() > 0) {
+        _index.slabHeight = _index.bounds.height() / slabCount;
+    }
+
+    auto slabRange = [&](int edge, int* firstSlab, int* lastSlab) {
+        double y1 = _index.points[edge].y();
+        double y2 = _index.points[(edge + 1) % count].y();
+        *firstSlab = qMin(slabCount - 1, (int)((qMin(y1, y2) - _index.bounds.top()) / _index.slabHeight));
+        *lastSlab = qMin(slabCount - 1, (int)((qMax(y1, y2) - _index.bounds.top()) / _index.slabHeight));
+    };
+
+    // Two passes to lay out the slab buckets contiguously: count edges per slab, then fill
+    _index.slabStart.fill(0, slabCount + 1);
+    for (int edge=0; edge<count; edge++) {
+        int firstSlab, lastSlab;
+        slabRange(edge, &firstSlab, &lastSlab);
+        for (int slab=firstSlab; slab<=lastSlab; slab++) {
+            _index.slabStart[slab + 1]++;
+        }
+    }
+    for (int slab=0; slab<slabCount; slab++) {
+        _index.slabStart[slab + 1] += _index.slabStart[slab];
+    }
+
+    QVector<int> fillOffset = _index.slabStart;
+    _index.slabEdges.resize(_index.slabStart[slabCount]);
+    for (int edge=0; edge<count; edge++) {
+        int firstSlab, lastSlab;
+        slabRange(edge, &firstSlab, &lastSlab);
+        for (int slab=firstSlab; slab<=lastSlab; slab++) {
+            _index.slabEdges[fillOffset[slab]++] = edge;
+        }
+    }
 }
 
-bool QGCMapPolygon::containsCoordinate(const QGeoCoordinate& coordinate) const
+bool QGCMapPolygon::_indexContains(const ContainsIndex& index, const QGeoCoordinate& coordinate) const
 {
-    if (_polygonPath.count() > 2) {
-        return _toPolygonF().containsPoint(_pointFFromCoord(coordinate), Qt::OddEvenFill);
-    } else {
+    int count = index.points.count();
+    if (count < 3) {
+        return false;
+    }
+
+    QPointF point(0, 0);
+    if (coordinate != index.tangentOrigin) {
+        double north, east, down;
+        convertGeoToNed(coordinate, index.tangentOrigin, &north, &east, &down);
+        point = QPointF(east, -north);
+    }
+
+    const QRectF& bounds = index.bounds;
+    if (!(point.x() >= bounds.left() && point.x() <= bounds.right() && point.y() >= bounds.top() && point.y() <= bounds.bottom())) {
         return false;
     }
+
+    // Even-odd crossing test against the edges of the slab only. Any edge crossing the horizontal line through the
+    // point overlaps the point's slab.
+    int slab = qMin(index.slabStart.count() - 2, (int)((point.y() - bounds.top()) / index.slabHeight));
+    bool inside = false;
+    for (int i=index.slabStart[slab]; i<index.slabStart[slab + 1]; i++) {
+        int edge = index.slabEdges[i];
+        const QPointF& start = index.points[edge];
+        const QPointF& end = index.points[(edge + 1) % count];
+        if ((start.y() > point.y()) != (end.y() > point.y())) {
+            double crossingX = start.x() + ((point.y() - start.y()) * (end.x() - start.x()) / (end.y() - start.y()));
+            if (point.x() < crossingX) {
+                inside = !inside;
+            }
+        }
+    }
+
+    return inside;
+}
+
+bool QGCMapPolygon::containsCoordinate(const QGeoCoordinate& coordinate) const
+{
+    return _indexContains(_containsIndex(), coordinate);
+}
+
+QVector<bool> QGCMapPolygon::containsCoordinates(const QList<QGeoCoordinate>& coordinates) const
+{
+    QVector<bool> results(coordinates.count());
+
+    const ContainsIndex& index = _containsIndex();
+    for (int i=0; i<coordinates.count(); i++) {
+        results[i] = _indexContains(index, coordinates[i]);
+    }
+
+    return results;
+}
+
+void QGCMapPolygon::containsCoordinates(const QGeoCoordinate* coordinates, int count, bool* results) const
+{
+    const ContainsIndex& index = _containsIndex();
+    for (int i=0; i<count; i++) {
+        results[i] = _indexContains(index, coordinates[i]);
+    }
 }
 
 void QGCMapPolygon::setPath(const QList<QGeoCoordinate>& path)
 {
     _polygonPath.clear();
+    _invalidateContainsIndex();
     _polygonModel.clearAndDeleteContents();
     foreach(const QGeoCoordinate& coord, path) {
         _polygonPath.append(QVariant::fromValue(coord));
@@ -142,6 +263,7 @@ void QGCMapPolygon::setPath(const QList<QGeoCoordinate>& path)
 void QGCMapPolygon::setPath(const QVariantList& path)
 {
     _polygonPath = path;
+    _invalidateContainsIndex();
 
     _polygonModel.clearAndDeleteContents();
     for (int i=0; i<_polygonPath.count(); i++) {
@@ -174,7 +296,9 @@ bool QGCMapPolygon::loadFromJson(const QJsonObject& json, bool required, QString
         return true;
     }
 
-    if (!JsonHelper::loadGeoCoordinateArray(json[jsonPolygonKey], false /* altitudeRequired */, _polygonPath, errorString)) {
+    bool loaded = JsonHelper::loadGeoCoordinateArray(json[jsonPolygonKey], false /* altitudeRequired */, _polygonPath, errorString);
+    _invalidateContainsIndex();
+    if (!loaded) {
         return false;
     }
 
@@ -218,6 +342,7 @@ void QGCMapPolygon::splitPolygonSegment(int vertexIndex)
     } else {
         _polygonModel.insert(nextIndex, new QGCQGeoCoordinate(newVertex, this));
         _polygonPath.insert(nextIndex, QVariant::fromValue(newVertex));
+        _invalidateContainsIndex();
         emit pathChanged();
     }
 }
@@ -225,6 +350,7 @@ void QGCMapPolygon::splitPolygonSegment(int vertexIndex)
 void QGCMapPolygon::appendVertex(const QGeoCoordinate& coordinate)
 {
     _polygonPath.append(QVariant::fromValue(coordinate));
+    _invalidateContainsIndex();
     _polygonModel.append(new QGCQGeoCoordinate(coordinate, _newCoordParent));
     emit pathChanged();
 }
@@ -252,6 +378,7 @@ void QGCMapPolygon::removeVertex(int vertexIndex)
     coordObj->deleteLater();
 
     _polygonPath.removeAt(vertexIndex);
+    _invalidateContainsIndex();
     emit pathChanged();
 
     _updateCenter();
@@ -269,11 +396,11 @@ void QGCMapPolygon::_updateCenter(void)
 
         if (_polygonPath.count() > 2) {            
             QPointF centroid(0, 0);
-            QPolygonF polygonF = _toPolygonF();
-            for (int i=0; i<polygonF.count(); i++) {
-                centroid += polygonF[i];
+            const QVector<QPointF>& points = _containsIndex().points;
+            for (int i=0; i<points.count(); i++) {
+                centroid += points[i];
             }
-            center = _coordFromPointF(QPointF(centroid.x() / polygonF.count(), centroid.y() / polygonF.count()));
+            center = _coordFromPointF(QPointF(centroid.x() / points.count(), centroid.y() / points.count()));
         }
 
         _center = center;
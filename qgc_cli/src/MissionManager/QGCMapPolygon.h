@@ -14,6 +14,9 @@
 #include <QGeoCoordinate>
 #include <QVariantList>
 #include <QPolygon>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInt>
 
 #include "QmlObjectListModel.h"
 
@@ -45,9 +48,21 @@ public:
     /// Splits the segment comprised of vertextIndex -> vertexIndex + 1
     Q_INVOKABLE void splitPolygonSegment(int vertexIndex);
 
-    /// Returns true if the specified coordinate is within the polygon
+    /// Returns true if the specified coordinate is within the polygon. The planar projection of the polygon and its
+    /// edge index are cached after the first query, so repeated queries don't allocate and only test the edges near
+    /// the coordinate. Queries may come from other threads as long as the path isn't changed at the same time.
     Q_INVOKABLE bool containsCoordinate(const QGeoCoordinate& coordinate) const;
 
+    /// Batch version of containsCoordinate
+    /// @return One entry per coordinate, true if it is within the polygon
+    QVector<bool> containsCoordinates(const QList<QGeoCoordinate>& coordinates) const;
+
+    /// Batch version of containsCoordinate which writes into a caller provided buffer
+    ///     @param coordinates Coordinates to test
+    ///     @param count Number of coordinates
+    ///     @param results Receives count results
+    void containsCoordinates(const QGeoCoordinate* coordinates, int count, bool* results) const;
+
     /// Returns the path in a list of QGeoCoordinate's format
     QList<QGeoCoordinate> coordinateList(void) const;
 
@@ -95,10 +110,26 @@ private slots:
     void _updateCenter(void);
 
 private:
-    QPolygonF _toPolygonF(void) const;
     QGeoCoordinate _coordFromPointF(const QPointF& point) const;
     QPointF _pointFFromCoord(const QGeoCoordinate& coordinate) const;
 
+    /// Polygon projected to the tangent plane at the first vertex, with the edges bucketed into horizontal slabs of
+    /// equal height. An edge is in every slab its y extent overlaps, so a crossing test only needs the edges of the
+    /// slab which contains the point.
+    struct ContainsIndex {
+        QGeoCoordinate      tangentOrigin;
+        QVector<QPointF>    points;     ///< Same coordinate space as _pointFFromCoord
+        QRectF              bounds;
+        double              slabHeight;
+        QVector<int>        slabStart;  ///< Offset into slabEdges of each slab, plus an end offset
+        QVector<int>        slabEdges;  ///< Edge i runs from points[i] to points[(i + 1) % count]
+    };
+
+    const ContainsIndex&    _containsIndex      (void) const;
+    void                    _buildContainsIndex (void) const;
+    void                    _invalidateContainsIndex(void);
+    bool                    _indexContains      (const ContainsIndex& index, const QGeoCoordinate& coordinate) const;
+
     QObject*            _newCoordParent;
     QVariantList        _polygonPath;
     QmlObjectListModel  _polygonModel;
@@ -106,6 +137,12 @@ private:
     QGeoCoordinate      _center;
     bool                _centerDrag;
     bool                _ignoreCenterUpdates;
+
+    mutable ContainsIndex   _index;
+    mutable QAtomicInt      _indexValid;
+    mutable QMutex          _indexMutex;        ///< Serializes lazy index builds from concurrent queries
+
+    static const int _maxSlabs = 1024;
 };
 
 #endif
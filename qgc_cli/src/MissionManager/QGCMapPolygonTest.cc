@@ -197,3 +197,47 @@ void QGCMapPolygonTest::_testVertexManipulation(void)
     QCOMPARE(polyList.count(), 0);
     QCOMPARE(_pathModel->count(), 0);
 }
+
+void QGCMapPolygonTest::_testContainsCoordinate(void)
+{
+    QGeoCoordinate center(47.633, -122.089);
+    QGeoCoordinate northOutside(47.637, -122.089);
+    QGeoCoordinate eastOutside(47.633, -122.080);
+
+    QVERIFY(!_mapPolygon->containsCoordinate(center));
+
+    _mapPolygon->setPath(_polyPoints);
+    QVERIFY(_mapPolygon->containsCoordinate(center));
+    QVERIFY(!_mapPolygon->containsCoordinate(northOutside));
+    QVERIFY(!_mapPolygon->containsCoordinate(eastOutside));
+
+    // Cached index must follow vertex changes
+    QGeoCoordinate northEast = _polyPoints[1];
+    northEast.setLatitude(northOutside.latitude() + 0.001);
+    _mapPolygon->adjustVertex(1, northEast);
+    _mapPolygon->adjustVertex(0, QGeoCoordinate(northOutside.latitude() + 0.001, _polyPoints[0].longitude()));
+    QVERIFY(_mapPolygon->containsCoordinate(northOutside));
+    QVERIFY(!_mapPolygon->containsCoordinate(eastOutside));
+
+    // Concave polygon: the notch is outside
+    QList<QGeoCoordinate> concave;
+    concave << QGeoCoordinate(47.630, -122.095) << QGeoCoordinate(47.636, -122.095) << QGeoCoordinate(47.636, -122.091) <<
+               QGeoCoordinate(47.632, -122.091) << QGeoCoordinate(47.632, -122.085) << QGeoCoordinate(47.630, -122.085);
+    _mapPolygon->setPath(concave);
+
+    QList<QGeoCoordinate> coords;
+    coords << QGeoCoordinate(47.634, -122.093) << QGeoCoordinate(47.634, -122.088) << QGeoCoordinate(47.631, -122.088) <<
+              QGeoCoordinate(47.640, -122.093);
+    QVector<bool> results = _mapPolygon->containsCoordinates(coords);
+    QCOMPARE(results.count(), coords.count());
+    QCOMPARE(results[0], true);
+    QCOMPARE(results[1], false);
+    QCOMPARE(results[2], true);
+    QCOMPARE(results[3], false);
+    for (int i=0; i<coords.count(); i++) {
+        QCOMPARE(_mapPolygon->containsCoordinate(coords[i]), results[i]);
+    }
+
+    _mapPolygon->clear();
+    QVERIFY(!_mapPolygon->containsCoordinate(coords[0]));
+}
@@ -29,6 +29,7 @@ protected:
 private slots:
     void _testDirty(void);
     void _testVertexManipulation(void);
+    void _testContainsCoordinate(void);
 
 private:
     enum {
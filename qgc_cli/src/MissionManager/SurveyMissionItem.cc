@@ -18,6 +18,9 @@
 #include "AppSettings.h"
 
 #include <QPolygonF>
+#include <QtConcurrent>
+
+#include <algorithm>
 
 QGC_LOGGING_CATEGORY(SurveyMissionItemLog, "SurveyMissionItemLog")
 
@@ -48,6 +51,7 @@ const char* SurveyMissionItem::_jsonManualGridKey =                 "manualGrid"
 const char* SurveyMissionItem::_jsonCameraOrientationLandscapeKey = "orientationLandscape";
 const char* SurveyMissionItem::_jsonFixedValueIsAltitudeKey =       "fixedValueIsAltitude";
 const char* SurveyMissionItem::_jsonRefly90DegreesKey =             "refly90Degrees";
+const char* SurveyMissionItem::_jsonOptimizeTransectOrderKey =      "optimizeTransectOrder";
 
 const char* SurveyMissionItem::settingsGroup =                  "Survey";
 const char* SurveyMissionItem::manualGridName =                 "ManualGrid";
@@ -83,6 +87,8 @@ SurveyMissionItem::SurveyMissionItem(Vehicle* vehicle, QObject* parent)
     , _refly90Degrees(false)
     , _additionalFlightDelaySeconds(0)
     , _cameraMinTriggerInterval(0)
+    , _optimizeTransectOrder(false)
+    , _transectDistanceSaved(0)
     , _ignoreRecalc(false)
     , _surveyDistance(0.0)
     , _cameraShots(0)
@@ -125,14 +131,19 @@ SurveyMissionItem::SurveyMissionItem(Vehicle* vehicle, QObject* parent)
         _gridAltitudeFact.setRawValue(qgcApp()->toolbox()->settingsManager()->appSettings()->defaultMissionItemAltitude()->rawValue());
     }
 
-    connect(&_gridSpacingFact,                  &Fact::valueChanged,                        this, &SurveyMissionItem::_generateGrid);
-    connect(&_gridAngleFact,                    &Fact::valueChanged,                        this, &SurveyMissionItem::_generateGrid);
-    connect(&_gridEntryLocationFact,            &Fact::valueChanged,                        this, &SurveyMissionItem::_generateGrid);
-    connect(&_turnaroundDistFact,               &Fact::valueChanged,                        this, &SurveyMissionItem::_generateGrid);
-    connect(&_cameraTriggerDistanceFact,        &Fact::valueChanged,                        this, &SurveyMissionItem::_generateGrid);
-    connect(&_cameraTriggerInTurnaroundFact,    &Fact::valueChanged,                        this, &SurveyMissionItem::_generateGrid);
-    connect(&_hoverAndCaptureFact,              &Fact::valueChanged,                        this, &SurveyMissionItem::_generateGrid);
-    connect(this,                               &SurveyMissionItem::refly90DegreesChanged,  this, &SurveyMissionItem::_generateGrid);
+    _generateGridTimer.setSingleShot(true);
+    _generateGridTimer.setInterval(0);
+    connect(&_generateGridTimer, &QTimer::timeout, this, &SurveyMissionItem::_generateGrid);
+
+    connect(&_gridSpacingFact,                  &Fact::valueChanged,                        this, &SurveyMissionItem::_requestGenerateGrid);
+    connect(&_gridAngleFact,                    &Fact::valueChanged,                        this, &SurveyMissionItem::_requestGenerateGrid);
+    connect(&_gridEntryLocationFact,            &Fact::valueChanged,                        this, &SurveyMissionItem::_requestGenerateGrid);
+    connect(&_turnaroundDistFact,               &Fact::valueChanged,                        this, &SurveyMissionItem::_requestGenerateGrid);
+    connect(&_cameraTriggerDistanceFact,        &Fact::valueChanged,                        this, &SurveyMissionItem::_requestGenerateGrid);
+    connect(&_cameraTriggerInTurnaroundFact,    &Fact::valueChanged,                        this, &SurveyMissionItem::_requestGenerateGrid);
+    connect(&_hoverAndCaptureFact,              &Fact::valueChanged,                        this, &SurveyMissionItem::_requestGenerateGrid);
+    connect(this,                               &SurveyMissionItem::refly90DegreesChanged,  this, &SurveyMissionItem::_requestGenerateGrid);
+    connect(this,                               &SurveyMissionItem::optimizeTransectOrderChanged, this, &SurveyMissionItem::_requestGenerateGrid);
 
     connect(&_gridAltitudeFact,                 &Fact::valueChanged, this, &SurveyMissionItem::_updateCoordinateAltitude);
 
@@ -152,7 +163,34 @@ SurveyMissionItem::SurveyMissionItem(Vehicle* vehicle, QObject* parent)
     connect(&_cameraTriggerDistanceFact, &Fact::valueChanged, this, &SurveyMissionItem::timeBetweenShotsChanged);
 
     connect(&_mapPolygon, &QGCMapPolygon::dirtyChanged, this, &SurveyMissionItem::_polygonDirtyChanged);
-    connect(&_mapPolygon, &QGCMapPolygon::pathChanged,  this, &SurveyMissionItem::_generateGrid);
+    connect(&_mapPolygon, &QGCMapPolygon::pathChanged,  this, &SurveyMissionItem::_requestGenerateGrid);
+}
+
+void SurveyMissionItem::setGridRegenerateDelay(int msecs)
+{
+    _generateGridTimer.setInterval(qMax(0, msecs));
+    if (msecs <= 0) {
+        flushGridRegenerate();
+    }
+}
+
+void SurveyMissionItem::flushGridRegenerate(void)
+{
+    if (_generateGridTimer.isActive()) {
+        _generateGridTimer.stop();
+        _generateGrid();
+    }
+}
+
+/// Regeneration request from a parameter or polygon change. With no regenerate delay the grid is rebuilt immediately,
+/// otherwise changes arriving within the delay window are coalesced into a single rebuild.
+void SurveyMissionItem::_requestGenerateGrid(void)
+{
+    if (_generateGridTimer.interval() == 0) {
+        _generateGrid();
+    } else {
+        _generateGridTimer.start();
+    }
 }
 
 void SurveyMissionItem::_setSurveyDistance(double surveyDistance)
@@ -229,6 +267,7 @@ void SurveyMissionItem::save(QJsonArray&  missionItems)
     saveObject[_jsonFixedValueIsAltitudeKey] =                  _fixedValueIsAltitudeFact.rawValue().toBool();
     saveObject[_jsonHoverAndCaptureKey] =                       _hoverAndCaptureFact.rawValue().toBool();
     saveObject[_jsonRefly90DegreesKey] =                        _refly90Degrees;
+    saveObject[_jsonOptimizeTransectOrderKey] =                 _optimizeTransectOrder;
     saveObject[_jsonCameraTriggerDistanceKey] =                 _cameraTriggerDistanceFact.rawValue().toDouble();
     saveObject[_jsonCameraTriggerInTurnaroundKey] =             _cameraTriggerInTurnaroundFact.rawValue().toBool();
 
@@ -311,6 +350,7 @@ bool SurveyMissionItem::load(const QJsonObject& complexObject, int sequenceNumbe
         { _jsonFixedValueIsAltitudeKey,                 QJsonValue::Bool,   true },
         { _jsonHoverAndCaptureKey,                      QJsonValue::Bool,   false },
         { _jsonRefly90DegreesKey,                       QJsonValue::Bool,   false },
+        { _jsonOptimizeTransectOrderKey,                QJsonValue::Bool,   false },
         { _jsonCameraTriggerInTurnaroundKey,            QJsonValue::Bool,   false },    // Should really be required, but it was missing from initial code due to bug
     };
     if (!JsonHelper::validateKeys(v2Object, mainKeyInfoList, errorString)) {
@@ -337,6 +377,7 @@ bool SurveyMissionItem::load(const QJsonObject& complexObject, int sequenceNumbe
     _cameraTriggerInTurnaroundFact.setRawValue  (v2Object[_jsonCameraTriggerInTurnaroundKey].toBool(true));
 
     _refly90Degrees = v2Object[_jsonRefly90DegreesKey].toBool(false);
+    _optimizeTransectOrder = v2Object[_jsonOptimizeTransectOrderKey].toBool(false);
 
     QList<JsonHelper::KeyValidateInfo> gridKeyInfoList = {
         { _jsonGridAltitudeKey,                 QJsonValue::Double, true },
@@ -459,17 +500,39 @@ void SurveyMissionItem::_convertTransectToGeo(const QList<QList<QPointF>>& trans
 {
     transectSegmentsGeo.clear();
 
-    for (int i=0; i<transectSegmentsNED.count(); i++) {
-        QList<QGeoCoordinate>   transectCoords;
-        const QList<QPointF>&   transectPoints = transectSegmentsNED[i];
-
+    auto convertTransect = [tangentOrigin](const QList<QPointF>& transectPoints) {
+        QList<QGeoCoordinate> transectCoords;
+        transectCoords.reserve(transectPoints.count());
         for (int j=0; j<transectPoints.count(); j++) {
             QGeoCoordinate coord;
             const QPointF& point = transectPoints[j];
             convertNedToGeo(point.y(), point.x(), 0, tangentOrigin, &coord);
             transectCoords.append(coord);
         }
-        transectSegmentsGeo.append(transectCoords);
+        return transectCoords;
+    };
+
+    if (transectSegmentsNED.count() < _parallelTransectThreshold) {
+        for (int i=0; i<transectSegmentsNED.count(); i++) {
+            transectSegmentsGeo.append(convertTransect(transectSegmentsNED[i]));
+        }
+        return;
+    }
+
+    // Large grids: convert each transect on the global thread pool. Order is preserved since each job writes to its own slot.
+    struct ConvertJob {
+        const QList<QPointF>*   ned;
+        QList<QGeoCoordinate>   geo;
+    };
+    QVector<ConvertJob> jobs(transectSegmentsNED.count());
+    for (int i=0; i<transectSegmentsNED.count(); i++) {
+        jobs[i].ned = &transectSegmentsNED[i];
+    }
+    QtConcurrent::blockingMap(jobs, [&convertTransect](ConvertJob& job) { job.geo = convertTransect(*job.ned); });
+
+    transectSegmentsGeo.reserve(jobs.count());
+    for (int i=0; i<jobs.count(); i++) {
+        transectSegmentsGeo.append(jobs[i].geo);
     }
 }
 
@@ -680,6 +743,8 @@ void SurveyMissionItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
 
 void SurveyMissionItem::_generateGrid(void)
 {
+    _generateGridTimer.stop();
+
     if (_ignoreRecalc) {
         return;
     }
@@ -730,6 +795,11 @@ void SurveyMissionItem::_generateGrid(void)
     cameraShots += _gridGenerator(polygonPoints, transectSegments, false /* refly */);
     _convertTransectToGeo(transectSegments, tangentOrigin, _transectSegments);
     _adjustTransectsToEntryPointLocation(_transectSegments);
+    double transectDistanceSaved = 0;
+    if (_optimizeTransectOrder) {
+        // Entry point stays as selected by the entry location, the remaining transects are reordered
+        transectDistanceSaved += _transectOrderSolver.solve(_transectSegments);
+    }
     _appendGridPointsFromTransects(_transectSegments);
     if (_refly90Degrees) {
         QVariantList reflyPointsGeo;
@@ -737,9 +807,14 @@ void SurveyMissionItem::_generateGrid(void)
         transectSegments.clear();
         cameraShots += _gridGenerator(polygonPoints, transectSegments, true /* refly */);
         _convertTransectToGeo(transectSegments, tangentOrigin, _reflyTransectSegments);
-        _optimizeTransectsForShortestDistance(_transectSegments.last().last(), _reflyTransectSegments);
+        if (_optimizeTransectOrder) {
+            transectDistanceSaved += _transectOrderSolver.solve(_reflyTransectSegments, _transectSegments.last().last());
+        } else {
+            _optimizeTransectsForShortestDistance(_transectSegments.last().last(), _reflyTransectSegments);
+        }
         _appendGridPointsFromTransects(_reflyTransectSegments);
     }
+    _setTransectDistanceSaved(transectDistanceSaved);
 
     // Calc survey distance
     double surveyDistance = 0.0;
@@ -870,31 +945,121 @@ void SurveyMissionItem::_intersectLinesWithRect(const QList<QLineF>& lineList, c
     }
 }
 
+/// Intersects a set of parallel lines with the polygon using a single scanline sweep. Polygon edges are sorted once by their
+/// offset along the line normal and kept in an active edge list while the lines are walked in offset order. This makes the cost
+/// O((lines + edges) log edges) instead of intersecting every line with every edge.
+///     @param lineList Lines to intersect, all lines must be parallel
+///     @param polygon Closed polygon (first point repeated as last point)
+///     @param resultLines Intersected lines, in the same order as lineList. Lines which miss the polygon are dropped.
 void SurveyMissionItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines)
 {
     resultLines.clear();
+
+    if (lineList.isEmpty() || polygon.count() < 2) {
+        return;
+    }
+
+    // Project everything on to the normal of the (shared) line direction. A line is then a single offset value.
+    const QLineF& firstLine = lineList.first();
+    double lineLength = firstLine.length();
+    if (qFuzzyIsNull(lineLength)) {
+        return;
+    }
+    double dirX = firstLine.dx() / lineLength;
+    double dirY = firstLine.dy() / lineLength;
+    double normalX = -dirY;
+    double normalY = dirX;
+
+    QVector<double> vertexOffsets(polygon.count());
+    for (int i=0; i<polygon.count(); i++) {
+        vertexOffsets[i] = (polygon[i].x() * normalX) + (polygon[i].y() * normalY);
+    }
+
+    struct ScanEdge {
+        int     index;
+        double  minOffset;
+        double  maxOffset;
+    };
+    QVector<ScanEdge> edges;
+    edges.reserve(polygon.count() - 1);
+    for (int i=0; i<polygon.count()-1; i++) {
+        // Edges parallel to the lines can't produce a single intersection point, neighbouring edges pick up their end points
+        if (vertexOffsets[i] != vertexOffsets[i+1]) {
+            edges.append({ i, qMin(vertexOffsets[i], vertexOffsets[i+1]), qMax(vertexOffsets[i], vertexOffsets[i+1]) });
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const ScanEdge& a, const ScanEdge& b) { return a.minOffset < b.minOffset; });
+
+    QVector<QPair<double, int>> scanOrder;
+    scanOrder.reserve(lineList.count());
     for (int i=0; i<lineList.count(); i++) {
-        int foundCount = 0;
-        QLineF intersectLine;
         const QLineF& line = lineList[i];
+        scanOrder.append(qMakePair((line.x1() * normalX) + (line.y1() * normalY), i));
+    }
+    std::sort(scanOrder.begin(), scanOrder.end());
 
-        for (int j=0; j<polygon.count()-1; j++) {
-            QPointF intersectPoint;
-            QLineF polygonLine = QLineF(polygon[j], polygon[j+1]);
-            if (line.intersect(polygonLine, &intersectPoint) == QLineF::BoundedIntersection) {
-                if (foundCount == 0) {
-                    foundCount++;
-                    intersectLine.setP1(intersectPoint);
-                } else {
-                    foundCount++;
-                    intersectLine.setP2(intersectPoint);
-                    break;
-                }
+    QVector<QLineF>         clippedLines(lineList.count());
+    QVector<bool>           clipped(lineList.count(), false);
+    QVector<const ScanEdge*> activeEdges;
+    QVector<QPair<int, QPointF>> hits;
+    int nextEdge = 0;
+
+    for (int i=0; i<scanOrder.count(); i++) {
+        double offset = scanOrder[i].first;
+        const QLineF& line = lineList[scanOrder[i].second];
+
+        while (nextEdge < edges.count() && edges[nextEdge].minOffset <= offset) {
+            activeEdges.append(&edges[nextEdge++]);
+        }
+
+        hits.clear();
+        for (int j=0; j<activeEdges.count(); ) {
+            const ScanEdge* edge = activeEdges[j];
+            if (edge->maxOffset < offset) {
+                // Lines are walked in increasing offset, so this edge can never be hit again
+                activeEdges[j] = activeEdges.last();
+                activeEdges.removeLast();
+                continue;
+            }
+
+            const QPointF& p1 = polygon[edge->index];
+            const QPointF& p2 = polygon[edge->index + 1];
+            double t = (offset - vertexOffsets[edge->index]) / (vertexOffsets[edge->index + 1] - vertexOffsets[edge->index]);
+            hits.append(qMakePair(edge->index, p1 + ((p2 - p1) * t)));
+            j++;
+        }
+
+        // Match the previous behavior of using the first two edges in polygon order, skipping the duplicate hit
+        // which occurs when the line passes exactly through a shared vertex.
+        std::sort(hits.begin(), hits.end(), [](const QPair<int, QPointF>& a, const QPair<int, QPointF>& b) { return a.first < b.first; });
+        double lineStart = (line.x1() * dirX) + (line.y1() * dirY);
+        double lineEnd = (line.x2() * dirX) + (line.y2() * dirY);
+        int foundCount = 0;
+        QLineF intersectLine;
+        for (int j=0; j<hits.count() && foundCount < 2; j++) {
+            const QPointF& intersectPoint = hits[j].second;
+            double along = (intersectPoint.x() * dirX) + (intersectPoint.y() * dirY);
+            if (along < qMin(lineStart, lineEnd) || along > qMax(lineStart, lineEnd)) {
+                continue;
+            }
+            if (foundCount == 0) {
+                intersectLine.setP1(intersectPoint);
+                foundCount++;
+            } else if (intersectPoint != intersectLine.p1()) {
+                intersectLine.setP2(intersectPoint);
+                foundCount++;
             }
         }
 
         if (foundCount == 2) {
-            resultLines += intersectLine;
+            clippedLines[scanOrder[i].second] = intersectLine;
+            clipped[scanOrder[i].second] = true;
+        }
+    }
+
+    for (int i=0; i<clippedLines.count(); i++) {
+        if (clipped[i]) {
+            resultLines += clippedLines[i];
         }
     }
 }
@@ -1077,15 +1242,19 @@ int SurveyMissionItem::_gridGenerator(const QList<QPointF>& polygonPoints,  QLis
         }
     }
 
-    // Turn into a path
-    for (int i=0; i<resultLines.count(); i++) {
+    // Turn into a path. Transect parameters are captured up front so the transects can be built off the main thread.
+    bool    hasTurnaround =         _hasTurnaround();
+    double  turnaroundDistance =    _turnaroundDistance();
+    bool    hoverAndCapture =       _triggerCamera() && _hoverAndCaptureEnabled();
+    double  triggerDistance =       _triggerDistance();
+
+    auto buildTransect = [=](const QLineF& line, bool reverse) {
         QLineF          transectLine;
         QList<QPointF>  transectPoints;
-        const QLineF&   line = resultLines[i];
 
-        float turnaroundPosition = _turnaroundDistance() / line.length();
+        float turnaroundPosition = turnaroundDistance / line.length();
 
-        if (i & 1) {
+        if (reverse) {
             transectLine = QLineF(line.p2(), line.p1());
         } else {
             transectLine = QLineF(line.p1(), line.p2());
@@ -1093,7 +1262,7 @@ int SurveyMissionItem::_gridGenerator(const QList<QPointF>& polygonPoints,  QLis
 
         // Build the points along the transect
 
-        if (_hasTurnaround()) {
+        if (hasTurnaround) {
             transectPoints.append(transectLine.pointAt(-turnaroundPosition));
         }
 
@@ -1101,11 +1270,10 @@ int SurveyMissionItem::_gridGenerator(const QList<QPointF>& polygonPoints,  QLis
         transectPoints.append(transectLine.p1());
 
         // For hover and capture we need points for each camera location
-        if (_triggerCamera() && _hoverAndCaptureEnabled()) {
-            if (_triggerDistance() < transectLine.length()) {
-                int innerPoints = floor(transectLine.length() / _triggerDistance());
-                qCDebug(SurveyMissionItemLog) << "innerPoints" << innerPoints;
-                float transectPositionIncrement = _triggerDistance() / transectLine.length();
+        if (hoverAndCapture) {
+            if (triggerDistance < transectLine.length()) {
+                int innerPoints = floor(transectLine.length() / triggerDistance);
+                float transectPositionIncrement = triggerDistance / transectLine.length();
                 for (int i=0; i<innerPoints; i++) {
                     transectPoints.append(transectLine.pointAt(transectPositionIncrement * (i + 1)));
                 }
@@ -1115,11 +1283,33 @@ int SurveyMissionItem::_gridGenerator(const QList<QPointF>& polygonPoints,  QLis
         // Polygon exit point
         transectPoints.append(transectLine.p2());
 
-        if (_hasTurnaround()) {
+        if (hasTurnaround) {
             transectPoints.append(transectLine.pointAt(1 + turnaroundPosition));
         }
 
-        transectSegments.append(transectPoints);
+        return transectPoints;
+    };
+
+    if (resultLines.count() < _parallelTransectThreshold) {
+        for (int i=0; i<resultLines.count(); i++) {
+            transectSegments.append(buildTransect(resultLines[i], i & 1));
+        }
+    } else {
+        struct TransectJob {
+            QLineF          line;
+            bool            reverse;
+            QList<QPointF>  points;
+        };
+        QVector<TransectJob> jobs(resultLines.count());
+        for (int i=0; i<resultLines.count(); i++) {
+            jobs[i].line = resultLines[i];
+            jobs[i].reverse = i & 1;
+        }
+        QtConcurrent::blockingMap(jobs, [&buildTransect](TransectJob& job) { job.points = buildTransect(job.line, job.reverse); });
+        transectSegments.reserve(jobs.count());
+        for (int i=0; i<jobs.count(); i++) {
+            transectSegments.append(jobs[i].points);
+        }
     }
 
     return cameraShots;
@@ -1300,6 +1490,8 @@ bool SurveyMissionItem::_appendMissionItemsWorker(QList<MissionItem*>& items, QO
 
 void SurveyMissionItem::appendMissionItems(QList<MissionItem*>& items, QObject* missionItemParent)
 {
+    flushGridRegenerate();
+
     int seqNum = _sequenceNumber;
 
     if (!_appendMissionItemsWorker(items, missionItemParent, seqNum, _refly90Degrees, false /* buildRefly */)) {
@@ -1388,6 +1580,29 @@ void SurveyMissionItem::setRefly90Degrees(bool refly90Degrees)
     }
 }
 
+void SurveyMissionItem::setOptimizeTransectOrder(bool optimizeTransectOrder)
+{
+    if (optimizeTransectOrder != _optimizeTransectOrder) {
+        _optimizeTransectOrder = optimizeTransectOrder;
+        setDirty(true);
+        emit optimizeTransectOrderChanged(optimizeTransectOrder);
+    }
+}
+
+void SurveyMissionItem::setTransectOrderSolverLimits(int timeBudgetMsecs, quint32 seed)
+{
+    _transectOrderSolver.setTimeBudget(timeBudgetMsecs);
+    _transectOrderSolver.setSeed(seed);
+}
+
+void SurveyMissionItem::_setTransectDistanceSaved(double transectDistanceSaved)
+{
+    if (!qFuzzyCompare(_transectDistanceSaved, transectDistanceSaved)) {
+        _transectDistanceSaved = transectDistanceSaved;
+        emit transectDistanceSavedChanged(_transectDistanceSaved);
+    }
+}
+
 void SurveyMissionItem::_polygonDirtyChanged(bool dirty)
 {
     if (dirty) {
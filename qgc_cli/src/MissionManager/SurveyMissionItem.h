@@ -16,6 +16,9 @@
 #include "SettingsFact.h"
 #include "QGCLoggingCategory.h"
 #include "QGCMapPolygon.h"
+#include "TransectOrderSolver.h"
+
+#include <QTimer>
 
 Q_DECLARE_LOGGING_CATEGORY(SurveyMissionItemLog)
 
@@ -23,6 +26,8 @@ class SurveyMissionItem : public ComplexMissionItem
 {
     Q_OBJECT
 
+    friend class QGCBenchmark;
+
 public:
     SurveyMissionItem(Vehicle* vehicle, QObject* parent = NULL);
 
@@ -52,6 +57,8 @@ public:
     Q_PROPERTY(bool                 hoverAndCaptureAllowed      READ hoverAndCaptureAllowed         CONSTANT)
     Q_PROPERTY(bool                 refly90Degrees              READ refly90Degrees WRITE setRefly90Degrees NOTIFY refly90DegreesChanged)
     Q_PROPERTY(double               cameraMinTriggerInterval    MEMBER _cameraMinTriggerInterval    NOTIFY cameraMinTriggerIntervalChanged)
+    Q_PROPERTY(bool                 optimizeTransectOrder       READ optimizeTransectOrder WRITE setOptimizeTransectOrder NOTIFY optimizeTransectOrderChanged)
+    Q_PROPERTY(double               transectDistanceSaved       READ transectDistanceSaved          NOTIFY transectDistanceSavedChanged)
 
     Q_PROPERTY(double               timeBetweenShots            READ timeBetweenShots               NOTIFY timeBetweenShotsChanged)
     Q_PROPERTY(QVariantList         gridPoints                  READ gridPoints                     NOTIFY gridPointsChanged)
@@ -89,9 +96,27 @@ public:
     double          timeBetweenShots        (void) const;
     bool            hoverAndCaptureAllowed  (void) const;
     bool            refly90Degrees          (void) const { return _refly90Degrees; }
+    bool            optimizeTransectOrder   (void) const { return _optimizeTransectOrder; }
+    double          transectDistanceSaved   (void) const { return _transectDistanceSaved; }
     QGCMapPolygon*  mapPolygon              (void) { return &_mapPolygon; }
 
     void setRefly90Degrees(bool refly90Degrees);
+    void setOptimizeTransectOrder(bool optimizeTransectOrder);
+
+    /// Time budget and random seed used by the transect order solver when optimizeTransectOrder is set
+    void setTransectOrderSolverLimits(int timeBudgetMsecs, quint32 seed);
+
+    /// Sets the delay used to coalesce grid regeneration across rapid parameter changes.
+    ///     @param msecs Delay in milliseconds, 0 regenerates synchronously on every change (default)
+    void setGridRegenerateDelay(int msecs);
+
+    /// Regenerates the grid now if a delayed regeneration is pending
+    void flushGridRegenerate(void);
+
+    /// Transects for the survey in flight order, including turnaround and hover and capture points.
+    /// Usable headless to plan coverage without going through the mission item list.
+    const QList<QList<QGeoCoordinate>>& transectSegments        (void) const { return _transectSegments; }
+    const QList<QList<QGeoCoordinate>>& reflyTransectSegments   (void) const { return _reflyTransectSegments; }
 
     // Overrides from ComplexMissionItem
 
@@ -175,11 +200,14 @@ signals:
     void cameraOrientationFixedChanged      (bool cameraOrientationFixed);
     void refly90DegreesChanged              (bool refly90Degrees);
     void cameraMinTriggerIntervalChanged    (double cameraMinTriggerInterval);
+    void optimizeTransectOrderChanged       (bool optimizeTransectOrder);
+    void transectDistanceSavedChanged       (double transectDistanceSaved);
 
 private slots:
     void _setDirty(void);
     void _polygonDirtyChanged(bool dirty);
     void _clearInternal(void);
+    void _requestGenerateGrid(void);
 
 private:
     enum CameraTriggerCode {
@@ -222,6 +250,7 @@ private:
     void _adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects);
     bool _gridAngleIsNorthSouthTransects();
     double _clampGridAngle90(double gridAngle);
+    void _setTransectDistanceSaved(double transectDistanceSaved);
 
     int                             _sequenceNumber;
     bool                            _dirty;
@@ -236,6 +265,9 @@ private:
     bool                            _refly90Degrees;
     double                          _additionalFlightDelaySeconds;
     double                          _cameraMinTriggerInterval;
+    bool                            _optimizeTransectOrder;
+    double                          _transectDistanceSaved;     ///< Connecting distance saved by the transect order solver
+    TransectOrderSolver             _transectOrderSolver;
 
     bool            _ignoreRecalc;
     double          _surveyDistance;
@@ -243,6 +275,7 @@ private:
     double          _coveredArea;
     double          _timeBetweenShots;
     double          _cruiseSpeed;
+    QTimer          _generateGridTimer;
 
     QMap<QString, FactMetaData*> _metaDataMap;
 
@@ -293,8 +326,10 @@ private:
     static const char* _jsonCameraOrientationLandscapeKey;
     static const char* _jsonFixedValueIsAltitudeKey;
     static const char* _jsonRefly90DegreesKey;
+    static const char* _jsonOptimizeTransectOrderKey;
 
     static const int _hoverAndCaptureDelaySeconds = 1;
+    static const int _parallelTransectThreshold = 64;   ///< Transect count above which transects are built on the thread pool
 };
 
 #endif
@@ -251,3 +251,56 @@ void SurveyMissionItemTest::_testEntryLocation(void)
         rgSeenEntryCoords.clear();
     }
 }
+
+void SurveyMissionItemTest::_testGridRegenerateDelay(void)
+{
+    QGCMapPolygon* mapPolygon = _surveyItem->mapPolygon();
+
+    for (int i=0; i<_polyPoints.count(); i++) {
+        QGeoCoordinate& vertex = _polyPoints[i];
+        mapPolygon->appendVertex(vertex);
+    }
+    QVERIFY(_surveyItem->transectSegments().count() > 0);
+
+    _surveyItem->setGridRegenerateDelay(50);
+    _multiSpy->clearAllSignals();
+
+    // Rapid changes should be coalesced into a single regeneration
+    for (int i=0; i<10; i++) {
+        _surveyItem->gridAngle()->setRawValue(i * 5);
+    }
+    QVERIFY(_multiSpy->checkNoSignalByMask(gridPointsChangedMask));
+
+    QVERIFY(_multiSpy->waitForSignalByIndex(gridPointsChangedIndex, 1000));
+    _multiSpy->clearAllSignals();
+
+    // Flushing a pending regeneration happens synchronously
+    _surveyItem->gridAngle()->setRawValue(90);
+    QVERIFY(_multiSpy->checkNoSignalByMask(gridPointsChangedMask));
+    _surveyItem->flushGridRegenerate();
+    QVERIFY(_multiSpy->checkSignalByMask(gridPointsChangedMask));
+}
+
+void SurveyMissionItemTest::_testOptimizeTransectOrder(void)
+{
+    QGCMapPolygon* mapPolygon = _surveyItem->mapPolygon();
+
+    for (int i=0; i<_polyPoints.count(); i++) {
+        QGeoCoordinate& vertex = _polyPoints[i];
+        mapPolygon->appendVertex(vertex);
+    }
+    _surveyItem->gridSpacing()->setRawValue(5);
+
+    QGeoCoordinate entryCoordinate = _surveyItem->coordinate();
+    int transectCount = _surveyItem->transectSegments().count();
+    double originalDistance = _surveyItem->complexDistance();
+
+    _surveyItem->setTransectOrderSolverLimits(1000, 42);
+    _surveyItem->setOptimizeTransectOrder(true);
+
+    // Entry point and transect count must not change, flight distance can only get shorter
+    QCOMPARE(_surveyItem->coordinate(), entryCoordinate);
+    QCOMPARE(_surveyItem->transectSegments().count(), transectCount);
+    QVERIFY(_surveyItem->transectDistanceSaved() >= 0);
+    QVERIFY(_surveyItem->complexDistance() <= originalDistance + 0.001);
+}
@@ -36,6 +36,8 @@ private slots:
     void _testCameraTrigger(void);
     void _testGridAngle(void);
     void _testEntryLocation(void);
+    void _testGridRegenerateDelay(void);
+    void _testOptimizeTransectOrder(void);
 
 private:
     double _clampGridAngle180(double gridAngle);
@@ -0,0 +1,338 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TransectOrderSolver.h"
+#include "QGCGeo.h"
+
+#include <QtMath>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+QGC_LOGGING_CATEGORY(TransectOrderSolverLog, "TransectOrderSolverLog")
+
+// Used to mark a missing end point, for example the point prior to the first transect when there is no start point.
+// Distances to a missing point are zero.
+static const QPointF _noPoint(qQNaN(), qQNaN());
+
+// Improvements smaller than this (meters) are ignored to prevent cycling on floating point noise
+static const double _improvementEpsilon = 1e-6;
+
+static double _distance(const QPointF& from, const QPointF& to)
+{
+    if (qIsNaN(from.x()) || qIsNaN(to.x())) {
+        return 0;
+    }
+    return qSqrt(((to.x() - from.x()) * (to.x() - from.x())) + ((to.y() - from.y()) * (to.y() - from.y())));
+}
+
+static QPointF _toPlane(const QGeoCoordinate& coord, const QGeoCoordinate& origin)
+{
+    if (coord == origin) {
+        // This avoids a nan calculation that comes out of convertGeoToNed
+        return QPointF(0, 0);
+    }
+    double north, east, down;
+    convertGeoToNed(coord, origin, &north, &east, &down);
+    return QPointF(east, north);
+}
+
+TransectOrderSolver::TransectOrderSolver(void)
+    : _timeBudgetMsecs(50)
+    , _seed(1)
+    , _restarts(8)
+    , _originalDistance(0)
+    , _solvedDistance(0)
+    , _hasStart(false)
+    , _firstMovable(0)
+{
+
+}
+
+QPointF TransectOrderSolver::_entry(const Tour& tour, int position) const
+{
+    int transect = tour.order[position];
+    return tour.reversed[position] ? _lastPoints[transect] : _firstPoints[transect];
+}
+
+QPointF TransectOrderSolver::_exit(const Tour& tour, int position) const
+{
+    int transect = tour.order[position];
+    return tour.reversed[position] ? _firstPoints[transect] : _lastPoints[transect];
+}
+
+double TransectOrderSolver::_tourCost(const Tour& tour) const
+{
+    double cost = 0;
+    for (int i=0; i<tour.order.count(); i++) {
+        QPointF previous = i == 0 ? (_hasStart ? _start : _noPoint) : _exit(tour, i - 1);
+        cost += _distance(previous, _entry(tour, i));
+    }
+    return cost;
+}
+
+void TransectOrderSolver::_nearestNeighbor(Tour& tour) const
+{
+    int transectCount = _firstPoints.count();
+    QVector<bool> used(transectCount, false);
+
+    tour.order.clear();
+    tour.reversed.clear();
+
+    QPointF current = _start;
+    if (!_hasStart) {
+        // First transect is pinned as specified
+        tour.order.append(0);
+        tour.reversed.append(false);
+        used[0] = true;
+        current = _lastPoints[0];
+    }
+
+    while (tour.order.count() < transectCount) {
+        int     bestTransect = -1;
+        bool    bestReversed = false;
+        double  bestDistance = std::numeric_limits<double>::max();
+
+        for (int i=0; i<transectCount; i++) {
+            if (used[i]) {
+                continue;
+            }
+            double distance = _distance(current, _firstPoints[i]);
+            if (distance < bestDistance) {
+                bestTransect = i;
+                bestReversed = false;
+                bestDistance = distance;
+            }
+            distance = _distance(current, _lastPoints[i]);
+            if (distance < bestDistance) {
+                bestTransect = i;
+                bestReversed = true;
+                bestDistance = distance;
+            }
+        }
+
+        used[bestTransect] = true;
+        tour.order.append(bestTransect);
+        tour.reversed.append(bestReversed);
+        current = bestReversed ? _firstPoints[bestTransect] : _lastPoints[bestTransect];
+    }
+}
+
+/// 2-opt move: reverse the run of transects between two positions, which also flips the direction each one is flown.
+/// @return true: tour was improved
+bool TransectOrderSolver::_twoOpt(Tour& tour) const
+{
+    bool improved = false;
+    int count = tour.order.count();
+
+    for (int i=_firstMovable; i<count-1; i++) {
+        if (_timeExpired()) {
+            break;
+        }
+        for (int j=i+1; j<count; j++) {
+            QPointF previous = i == 0 ? (_hasStart ? _start : _noPoint) : _exit(tour, i - 1);
+            QPointF next = j == count - 1 ? _noPoint : _entry(tour, j + 1);
+
+            double before = _distance(previous, _entry(tour, i)) + _distance(_exit(tour, j), next);
+            double after = _distance(previous, _exit(tour, j)) + _distance(_entry(tour, i), next);
+
+            if (after < before - _improvementEpsilon) {
+                std::reverse(tour.order.begin() + i, tour.order.begin() + j + 1);
+                std::reverse(tour.reversed.begin() + i, tour.reversed.begin() + j + 1);
+                for (int k=i; k<=j; k++) {
+                    tour.reversed[k] = !tour.reversed[k];
+                }
+                improved = true;
+            }
+        }
+    }
+
+    return improved;
+}
+
+/// Or-opt move: relocate a chain of up to three consecutive transects to another position, in either direction.
+/// @return true: tour was improved
+bool TransectOrderSolver::_orOpt(Tour& tour) const
+{
+    bool improved = false;
+    int count = tour.order.count();
+
+    for (int chainLength=1; chainLength<=3; chainLength++) {
+        for (int i=_firstMovable; i+chainLength<=count; i++) {
+            if (_timeExpired()) {
+                return improved;
+            }
+
+            int     chainEnd = i + chainLength - 1;
+            QPointF chainEntry = _entry(tour, i);
+            QPointF chainExit = _exit(tour, chainEnd);
+            QPointF previous = i == 0 ? (_hasStart ? _start : _noPoint) : _exit(tour, i - 1);
+            QPointF next = chainEnd == count - 1 ? _noPoint : _entry(tour, chainEnd + 1);
+            double  removeGain = _distance(previous, chainEntry) + _distance(chainExit, next) - _distance(previous, next);
+
+            int     bestGap = -1;
+            bool    bestReverse = false;
+            double  bestDelta = -_improvementEpsilon;
+
+            // Gap g is the insertion point in front of position g, count being the end of the tour
+            for (int gap=_firstMovable; gap<=count; gap++) {
+                if (gap >= i && gap <= chainEnd + 1) {
+                    continue;
+                }
+                QPointF gapPrevious = gap == 0 ? (_hasStart ? _start : _noPoint) : _exit(tour, gap - 1);
+                QPointF gapNext = gap == count ? _noPoint : _entry(tour, gap);
+                double  base = _distance(gapPrevious, gapNext);
+
+                double forwardDelta = _distance(gapPrevious, chainEntry) + _distance(chainExit, gapNext) - base - removeGain;
+                double reverseDelta = _distance(gapPrevious, chainExit) + _distance(chainEntry, gapNext) - base - removeGain;
+
+                if (forwardDelta < bestDelta) {
+                    bestDelta = forwardDelta;
+                    bestGap = gap;
+                    bestReverse = false;
+                }
+                if (reverseDelta < bestDelta) {
+                    bestDelta = reverseDelta;
+                    bestGap = gap;
+                    bestReverse = true;
+                }
+            }
+
+            if (bestGap != -1) {
+                QVector<int>    chainOrder = tour.order.mid(i, chainLength);
+                QVector<bool>   chainReversed = tour.reversed.mid(i, chainLength);
+                if (bestReverse) {
+                    std::reverse(chainOrder.begin(), chainOrder.end());
+                    std::reverse(chainReversed.begin(), chainReversed.end());
+                    for (int k=0; k<chainReversed.count(); k++) {
+                        chainReversed[k] = !chainReversed[k];
+                    }
+                }
+
+                tour.order.remove(i, chainLength);
+                tour.reversed.remove(i, chainLength);
+                int insertPosition = bestGap > i ? bestGap - chainLength : bestGap;
+                for (int k=0; k<chainLength; k++) {
+                    tour.order.insert(insertPosition + k, chainOrder[k]);
+                    tour.reversed.insert(insertPosition + k, chainReversed[k]);
+                }
+                improved = true;
+            }
+        }
+    }
+
+    return improved;
+}
+
+void TransectOrderSolver::_localSearch(Tour& tour) const
+{
+    bool improved = true;
+    while (improved && !_timeExpired()) {
+        improved = _twoOpt(tour);
+        improved |= _orOpt(tour);
+    }
+}
+
+bool TransectOrderSolver::_timeExpired(void) const
+{
+    return _timer.hasExpired(_timeBudgetMsecs);
+}
+
+double TransectOrderSolver::solve(QList<QList<QGeoCoordinate>>& transects, const QGeoCoordinate& startCoord)
+{
+    _timer.start();
+    _originalDistance = _solvedDistance = 0;
+
+    int transectCount = transects.count();
+    if (transectCount == 0) {
+        return 0;
+    }
+
+    // Work in a local tangent plane, transects are small enough that the planar distance matches the geodesic one
+    _hasStart = startCoord.isValid();
+    QGeoCoordinate tangentOrigin = _hasStart ? startCoord : transects.first().first();
+    _start = _hasStart ? _toPlane(startCoord, tangentOrigin) : _noPoint;
+    _firstMovable = _hasStart ? 0 : 1;
+
+    _firstPoints.resize(transectCount);
+    _lastPoints.resize(transectCount);
+    for (int i=0; i<transectCount; i++) {
+        _firstPoints[i] = _toPlane(transects[i].first(), tangentOrigin);
+        _lastPoints[i] = _toPlane(transects[i].last(), tangentOrigin);
+    }
+
+    Tour original;
+    for (int i=0; i<transectCount; i++) {
+        original.order.append(i);
+        original.reversed.append(false);
+    }
+    _originalDistance = _tourCost(original);
+
+    Tour best = original;
+    double bestCost = _originalDistance;
+
+    Tour candidate;
+    _nearestNeighbor(candidate);
+    _localSearch(candidate);
+    double candidateCost = _tourCost(candidate);
+    if (candidateCost < bestCost) {
+        best = candidate;
+        bestCost = candidateCost;
+    }
+
+    // Perturb the best tour with a random segment reversal plus relocation and re-optimize. The random sequence is
+    // seeded so results are repeatable.
+    std::mt19937 generator(_seed);
+    int movableCount = transectCount - _firstMovable;
+    for (int restart=0; restart<_restarts && movableCount > 3 && !_timeExpired(); restart++) {
+        candidate = best;
+
+        std::uniform_int_distribution<int> positionDistribution(_firstMovable, transectCount - 1);
+        int first = positionDistribution(generator);
+        int second = positionDistribution(generator);
+        if (first > second) {
+            std::swap(first, second);
+        }
+        std::reverse(candidate.order.begin() + first, candidate.order.begin() + second + 1);
+        std::reverse(candidate.reversed.begin() + first, candidate.reversed.begin() + second + 1);
+
+        int from = positionDistribution(generator);
+        int to = positionDistribution(generator);
+        int moveTransect = candidate.order[from];
+        bool moveReversed = candidate.reversed[from];
+        candidate.order.remove(from);
+        candidate.reversed.remove(from);
+        candidate.order.insert(to, moveTransect);
+        candidate.reversed.insert(to, !moveReversed);
+
+        _localSearch(candidate);
+        candidateCost = _tourCost(candidate);
+        if (candidateCost < bestCost - _improvementEpsilon) {
+            best = candidate;
+            bestCost = candidateCost;
+        }
+    }
+
+    QList<QList<QGeoCoordinate>> orderedTransects;
+    orderedTransects.reserve(transectCount);
+    for (int i=0; i<transectCount; i++) {
+        QList<QGeoCoordinate> transect = transects[best.order[i]];
+        if (best.reversed[i]) {
+            std::reverse(transect.begin(), transect.end());
+        }
+        orderedTransects.append(transect);
+    }
+    transects = orderedTransects;
+
+    _solvedDistance = bestCost;
+    qCDebug(TransectOrderSolverLog) << "solve transects:original:solved:msecs" << transectCount << _originalDistance << _solvedDistance << _timer.elapsed();
+
+    return _originalDistance - _solvedDistance;
+}
@@ -0,0 +1,79 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QGeoCoordinate>
+#include <QPointF>
+#include <QVector>
+#include <QList>
+#include <QElapsedTimer>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(TransectOrderSolverLog)
+
+/// Orders a set of transects to minimize the distance flown between them. Each transect can be flown in either
+/// direction. The ordering is built with a nearest neighbor pass from the start point and then improved with 2-opt
+/// and Or-opt local search, followed by seeded random restarts while the time budget allows.
+///
+/// Only the connecting distance between transects is optimized since the distance flown along a transect is fixed.
+class TransectOrderSolver
+{
+public:
+    TransectOrderSolver(void);
+
+    /// Maximum wall time to spend improving the order
+    void setTimeBudget  (int msecs)     { _timeBudgetMsecs = msecs; }
+    /// Seed for the random restarts. The same seed and inputs generate the same order when the time budget isn't hit.
+    void setSeed        (quint32 seed)  { _seed = seed; }
+    /// Number of perturb and re-optimize rounds after the initial local search
+    void setRestarts    (int restarts)  { _restarts = restarts; }
+
+    /// Reorders and reorients the transects in place.
+    ///     @param transects Transects to reorder
+    ///     @param startCoord Point the vehicle starts from. If invalid the first transect, as specified, stays first.
+    /// @return Connecting distance saved in meters
+    double solve(QList<QList<QGeoCoordinate>>& transects, const QGeoCoordinate& startCoord = QGeoCoordinate());
+
+    /// Connecting distance prior to the last solve
+    double originalDistance (void) const { return _originalDistance; }
+    /// Connecting distance after the last solve
+    double solvedDistance   (void) const { return _solvedDistance; }
+
+private:
+    struct Tour {
+        QVector<int>    order;      ///< Transect index at each position
+        QVector<bool>   reversed;   ///< true: transect at this position is flown last to first point
+    };
+
+    QPointF _entry      (const Tour& tour, int position) const;
+    QPointF _exit       (const Tour& tour, int position) const;
+    double  _link       (const Tour& tour, int fromPosition, int toPosition) const;
+    double  _tourCost   (const Tour& tour) const;
+    void    _nearestNeighbor(Tour& tour) const;
+    bool    _twoOpt     (Tour& tour) const;
+    bool    _orOpt      (Tour& tour) const;
+    void    _localSearch(Tour& tour) const;
+    bool    _timeExpired(void) const;
+
+    int             _timeBudgetMsecs;
+    quint32         _seed;
+    int             _restarts;
+    double          _originalDistance;
+    double          _solvedDistance;
+
+    // Per solve state
+    QVector<QPointF>    _firstPoints;
+    QVector<QPointF>    _lastPoints;
+    bool                _hasStart;
+    QPointF             _start;
+    int                 _firstMovable;  ///< First tour position which can be moved
+    QElapsedTimer       _timer;
+};
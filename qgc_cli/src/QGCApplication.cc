@@ -79,6 +79,7 @@
 #include "QGCMapPolygon.h"
 #include "ParameterManager.h"
 #include "SettingsManager.h"
+#include "SettingsStore.h"
 //#include "QGCCorePlugin.h"
 
 #ifndef NO_SERIAL_LINK
@@ -115,9 +116,6 @@ const char* QGCApplication::_settingsVersionKey             = "SettingsVersion";
 const char* QGCApplication::_darkStyleFile          = ":/res/styles/style-dark.css";
 const char* QGCApplication::_lightStyleFile         = ":/res/styles/style-light.css";
 
-// Mavlink status structures for entire app
-mavlink_status_t m_mavlink_status[MAVLINK_COMM_NUM_BUFFERS];
-
 // Qml Singleton factories
 
 static QObject* screenToolsControllerSingletonFactory(QQmlEngine*, QJSEngine*)
@@ -231,12 +229,14 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
     // Parse command line options
 
     bool fClearSettingsOptions = false; // Clear stored settings
+    bool fSettingsReadOnly = false;     // Never write settings to disk
     bool logging = false;               // Turn on logging
     QString loggingOptions;
 
     CmdLineOpt_t rgCmdLineOptions[] = {
-        { "--clear-settings",   &fClearSettingsOptions, NULL },
-        { "--logging",          &logging,               &loggingOptions },
+        { "--clear-settings",       &fClearSettingsOptions, NULL },
+        { "--settings-readonly",    &fSettingsReadOnly,     NULL },
+        { "--logging",              &logging,               &loggingOptions },
 //        { "--fake-mobile",      &_fakeMobile,           NULL },
     #ifdef QT_DEBUG
 //        { "--test-high-dpi",    &_testHighDPI,          NULL },
@@ -246,6 +246,15 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
 
     ParseCmdLineOptions(argc, argv, rgCmdLineOptions, sizeof(rgCmdLineOptions)/sizeof(rgCmdLineOptions[0]), false);
 
+    // Agents are started with -I <id>. Each instance gets its own settings namespace so processes running side by
+    // side don't contend for the same settings file.
+    QString settingsInstance;
+    for (int i=1; i<argc-1; i++) {
+        if (strcmp(argv[i], "-I") == 0 || strcmp(argv[i], "--instance") == 0) {
+            settingsInstance = QString(argv[i + 1]);
+        }
+    }
+
     // Set up timer for delayed missing fact display
     _missingParamsDelayedDisplayTimer.setSingleShot(true);
     _missingParamsDelayedDisplayTimer.setInterval(_missingParamsDelayedDisplayTimerTimeout);
@@ -283,7 +292,9 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
         fClearSettingsOptions = true;
     }
 
-    if (fClearSettingsOptions) {
+    if (fSettingsReadOnly) {
+        // Settings file is left untouched in read only mode
+    } else if (fClearSettingsOptions) {
         // User requested settings to be cleared on command line
         settings.clear();
 
@@ -295,7 +306,7 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
         // Determine if upgrade message for settings version bump is required. Check and clear must happen before toolbox is started since
         // that will write some settings.
         if (settings.contains(_settingsVersionKey)) {
-            if (settings.value(_settingsVersionKey).toInt() != QGC_SETTINGS_VERSION) {
+            if (!fSettingsReadOnly && settings.value(_settingsVersionKey).toInt() != QGC_SETTINGS_VERSION) {
                 settings.clear();
                 _settingsUpgraded = true;
             }
@@ -305,7 +316,23 @@ QGCApplication::QGCApplication(int &argc, char* argv[], bool unitTesting)
             _settingsUpgraded = true;
         }
     }
-    settings.setValue(_settingsVersionKey, QGC_SETTINGS_VERSION);
+    if (!fSettingsReadOnly && settings.value(_settingsVersionKey).toInt() != QGC_SETTINGS_VERSION) {
+        settings.setValue(_settingsVersionKey, QGC_SETTINGS_VERSION);
+    }
+    // The store reads the file next, everything above has to be on disk by then
+    settings.sync();
+
+    SettingsStore* settingsStore = SettingsStore::instance();
+    settingsStore->setInstance(settingsInstance);
+    settingsStore->setReadOnly(fSettingsReadOnly);
+    if (fClearSettingsOptions && !settingsInstance.isEmpty() && !fSettingsReadOnly) {
+        QFile::remove(settingsStore->fileName());
+    }
+    if (_runningUnitTests) {
+        // Unit tests expect settings changes to be on disk right away
+        settingsStore->setFlushDelay(0);
+    }
+    qCDebug(SettingsStoreLog) << "Settings instance:readOnly" << settingsStore->fileName() << settingsStore->readOnly();
 
     // Set up our logging filters
     QGCLoggingCategoryRegister::instance()->setFilterRulesFromSettings(loggingOptions);
@@ -342,6 +369,8 @@ void QGCApplication::_shutdown(void)
     shutdownVideoStreaming();
 */
     delete _toolbox;
+
+    SettingsStore::instance()->flush();
 }
 
 QGCApplication::~QGCApplication()
@@ -351,8 +380,6 @@ QGCApplication::~QGCApplication()
 
 void QGCApplication::_initCommon(void)
 {
-    QSettings settings;
-
     // Register our Qml objects
 
 //    qmlRegisterType<QGCPalette>     ("QGroundControl.Palette", 1, 0, "QGCPalette");
@@ -402,8 +429,6 @@ void QGCApplication::_initCommon(void)
 
 bool QGCApplication::_initForNormalAppBoot(void)
 {
-    QSettings settings;
-
     _loadCurrentStyleSheet();
 
 /*
@@ -442,7 +467,7 @@ bool QGCApplication::_initForNormalAppBoot(void)
 //                    "Your old map cache sets have been reset.");
 //    }
 
-    settings.sync();
+    SettingsStore::instance()->flush();
     return true;
 }
 
@@ -451,6 +476,7 @@ bool QGCApplication::_initForUnitTests(void)
     return true;
 }
 
+// The delete all settings key is checked on the shared file before the settings store is loaded, so it bypasses the store
 void QGCApplication::deleteAllSettingsNextBoot(void)
 {
     QSettings settings;
@@ -0,0 +1,206 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCClock.h"
+
+#include <QDateTime>
+#include <QThread>
+
+QGCClock::QGCClock(void)
+    : _lockstep(false)
+    , _startMsecs(0)
+    , _now(0)
+    , _nextSequence(0)
+    , _firing(NULL)
+{
+    _elapsedTimer.start();
+}
+
+QGCClock* QGCClock::instance(void)
+{
+    static QGCClock clock;
+    return &clock;
+}
+
+void QGCClock::setLockstep(qint64 startMsecs)
+{
+    _lockstep = true;
+    _startMsecs = startMsecs;
+    _now.store(startMsecs);
+}
+
+qint64 QGCClock::currentMSecsSinceEpoch(void) const
+{
+    return _lockstep ? _now.load() : QDateTime::currentMSecsSinceEpoch();
+}
+
+qint64 QGCClock::elapsed(void) const
+{
+    return _lockstep ? _now.load() - _startMsecs : _elapsedTimer.elapsed();
+}
+
+qint64 QGCClock::elapsedUSecs(void) const
+{
+    return _lockstep ? (_now.load() - _startMsecs) * 1000 : _elapsedTimer.nsecsElapsed() / 1000;
+}
+
+qint64 QGCClock::wallElapsedUSecs(void) const
+{
+    return _elapsedTimer.nsecsElapsed() / 1000;
+}
+
+void QGCClock::_schedule(QGCTimer* timer, qint64 deadline)
+{
+    QMutexLocker locker(&_mutex);
+
+    if (timer->_scheduled) {
+        _scheduled.remove(timer->_key);
+    }
+    timer->_deadline = deadline;
+    timer->_key = Key(deadline, _nextSequence++);
+    timer->_scheduled = true;
+    _scheduled.insert(timer->_key, timer);
+}
+
+void QGCClock::_unschedule(QGCTimer* timer)
+{
+    QMutexLocker locker(&_mutex);
+
+    if (timer->_scheduled) {
+        _scheduled.remove(timer->_key);
+        timer->_scheduled = false;
+    }
+}
+
+void QGCClock::_fired(QGCTimer* timer)
+{
+    QMutexLocker locker(&_mutex);
+
+    if (_firing == timer) {
+        _firing = NULL;
+        _firingDone.wakeAll();
+    }
+}
+
+void QGCClock::advanceTo(qint64 msecs)
+{
+    if (!_lockstep) {
+        return;
+    }
+
+    forever {
+        QMutexLocker locker(&_mutex);
+
+        if (_scheduled.isEmpty() || _scheduled.firstKey().first > msecs) {
+            break;
+        }
+
+        qint64      deadline = _scheduled.firstKey().first;
+        QGCTimer*   timer = _scheduled.take(_scheduled.firstKey());
+        timer->_scheduled = false;
+        if (deadline > _now.load()) {
+            _now.store(deadline);
+        }
+
+        // The timer can't be destroyed while the mutex is held, its destructor unschedules it first
+        if (timer->thread() == QThread::currentThread()) {
+            locker.unlock();
+            timer->_fire();
+        } else if (!timer->thread()->isFinished()) {
+            // Posted rather than a blocking call, so the wait ends as well when the timer is destroyed before its
+            // thread gets to the event
+            _firing = timer;
+            QMetaObject::invokeMethod(timer, "_fire", Qt::QueuedConnection);
+            while (_firing) {
+                _firingDone.wait(&_mutex);
+            }
+        }
+    }
+
+    if (msecs > _now.load()) {
+        _now.store(msecs);
+    }
+}
+
+QGCTimer::QGCTimer(QObject* parent, QGCClock* clock)
+    : QObject(parent)
+    , _clock(clock ? clock : QGCClock::instance())
+    , _timer(NULL)
+    , _interval(0)
+    , _singleShot(false)
+    , _scheduled(false)
+    , _deadline(0)
+{
+    if (!_clock->lockstep()) {
+        _timer = new QTimer(this);
+        connect(_timer, &QTimer::timeout, this, &QGCTimer::timeout);
+    }
+}
+
+QGCTimer::~QGCTimer()
+{
+    if (!_timer) {
+        _clock->_unschedule(this);
+        // Releases advanceTo when the posted fire is discarded with the timer
+        _clock->_fired(this);
+    }
+}
+
+bool QGCTimer::isActive(void) const
+{
+    if (_timer) {
+        return _timer->isActive();
+    }
+
+    QMutexLocker locker(&_clock->_mutex);
+    return _scheduled;
+}
+
+void QGCTimer::start(int msecs)
+{
+    _interval = msecs;
+    start();
+}
+
+void QGCTimer::start(void)
+{
+    if (_timer) {
+        _timer->setSingleShot(_singleShot);
+        _timer->start(_interval);
+        return;
+    }
+
+    _clock->_schedule(this, _clock->currentMSecsSinceEpoch() + _interval);
+}
+
+void QGCTimer::stop(void)
+{
+    if (_timer) {
+        _timer->stop();
+    } else {
+        _clock->_unschedule(this);
+    }
+}
+
+void QGCTimer::_fire(void)
+{
+    if (!_singleShot) {
+        // Next deadline is based on the previous one, not on when the handler ran, so periods don't drift. The handler
+        // may still stop or restart the timer.
+        qint64 deadline;
+        {
+            QMutexLocker locker(&_clock->_mutex);
+            deadline = _deadline + qMax(1, _interval);
+        }
+        _clock->_schedule(this, deadline);
+    }
+
+    emit timeout();
+    _clock->_fired(this);
+}
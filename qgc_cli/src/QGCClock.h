@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QMap>
+#include <QPair>
+#include <QAtomicInteger>
+
+class QGCTimer;
+
+/// Process wide time source for the vehicle and link code. By default it is the wall clock. In lockstep mode time only
+/// moves when an external simulation calls advanceTo, and QGCTimers fire from within advanceTo in deadline order. A
+/// lockstep run therefore goes as fast as the handlers allow and fires timers in the same order on every run.
+///
+/// Code runs on the process wide instance. Separate clocks are only meant for tests.
+class QGCClock
+{
+public:
+    QGCClock(void);
+
+    static QGCClock* instance(void);
+
+    /// Switches to lockstep mode. Must be called before any QGCTimer is created on the clock.
+    ///     @param startMsecs Simulation time to start at, in ms since epoch
+    void setLockstep(qint64 startMsecs);
+
+    bool lockstep(void) const { return _lockstep; }
+
+    /// Lockstep mode: simulation time the clock started at, in ms since epoch
+    qint64 startMSecsSinceEpoch(void) const { return _startMsecs; }
+
+    /// Current time in ms since epoch
+    qint64 currentMSecsSinceEpoch(void) const;
+
+    /// Monotonic ms since the clock started
+    qint64 elapsed(void) const;
+
+    /// Monotonic us since the clock started, for measuring short intervals
+    qint64 elapsedUSecs(void) const;
+
+    /// Monotonic us of the wall clock since the clock started, in lockstep mode as well. For measuring how long the
+    /// process itself takes, which simulation time does not show.
+    qint64 wallElapsedUSecs(void) const;
+
+    /// Moves simulation time forward, firing every timer which becomes due on the way. Timers which live on other
+    /// threads are fired through their thread's event loop and advanceTo waits until the handler is done or the timer
+    /// is destroyed. Timers on a thread which has finished are dropped. Lockstep mode only, from a single thread.
+    void advanceTo(qint64 msecs);
+
+private:
+    friend class QGCTimer;
+
+    typedef QPair<qint64, quint64> Key;    ///< Deadline, then order of scheduling for equal deadlines
+
+    void    _schedule   (QGCTimer* timer, qint64 deadline);
+    void    _unschedule (QGCTimer* timer);
+    void    _fired      (QGCTimer* timer);
+
+    bool                    _lockstep;
+    qint64                  _startMsecs;
+    QAtomicInteger<qint64>  _now;           ///< Simulation time in lockstep mode
+    QElapsedTimer           _elapsedTimer;
+
+    QMutex                  _mutex;         ///< Guards the schedule and the lockstep state of all timers on the clock
+    QMap<Key, QGCTimer*>    _scheduled;
+    quint64                 _nextSequence;
+    QGCTimer*               _firing;        ///< Timer advanceTo waits for, NULL once it is done
+    QWaitCondition          _firingDone;
+};
+
+/// Replacement for QTimer which runs on QGCClock. Uses a QTimer internally unless the clock is in lockstep mode.
+class QGCTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param clock Clock to run on, NULL for the process wide clock
+    QGCTimer(QObject* parent = NULL, QGCClock* clock = NULL);
+    ~QGCTimer();
+
+    void setInterval    (int msecs) { _interval = msecs; }
+    int  interval       (void) const { return _interval; }
+    void setSingleShot  (bool singleShot) { _singleShot = singleShot; }
+    bool isSingleShot   (void) const { return _singleShot; }
+    bool isActive       (void) const;
+
+    /// Only affects the wall clock backend
+    void setTimerType   (Qt::TimerType type) { if (_timer) _timer->setTimerType(type); }
+
+    /// Calls functor once after msecs on the clock, unless context is destroyed first
+    template <typename Functor>
+    static void singleShot(int msecs, QObject* context, Functor functor)
+    {
+        if (!QGCClock::instance()->lockstep()) {
+            QTimer::singleShot(msecs, context, functor);
+            return;
+        }
+
+        QGCTimer* timer = new QGCTimer(context);
+        timer->setSingleShot(true);
+        connect(timer, &QGCTimer::timeout, context, functor);
+        connect(timer, &QGCTimer::timeout, timer, &QObject::deleteLater);
+        timer->start(msecs);
+    }
+
+public slots:
+    void start(int msecs);
+    void start(void);
+    void stop(void);
+
+signals:
+    void timeout(void);
+
+private slots:
+    void _fire(void);
+
+private:
+    QGCClock*       _clock;
+    QTimer*         _timer;         ///< Wall clock backend, NULL in lockstep mode
+    int             _interval;
+    bool            _singleShot;
+
+    // Lockstep mode, guarded by the clock's mutex
+    bool            _scheduled;     ///< Waiting in the clock
+    QGCClock::Key   _key;
+    qint64          _deadline;
+
+    friend class QGCClock;
+};
@@ -12,8 +12,8 @@
 ///     @author Don Gagne <don@thegagnes.com>
 
 #include "QGCLoggingCategory.h"
+#include "SettingsStore.h"
 
-#include <QSettings>
 
 // Add Global logging categories (not class specific) here using QGC_LOGGING_CATEGORY
 QGC_LOGGING_CATEGORY(FirmwareUpgradeLog,        "FirmwareUpgradeLog")
@@ -45,18 +45,12 @@ QStringList QGCLoggingCategoryRegister::registeredCategories(void)
 
 void QGCLoggingCategoryRegister::setCategoryLoggingOn(const QString& category, bool enable)
 {
-    QSettings settings;
-
-    settings.beginGroup(_filterRulesSettingsGroup);
-    settings.setValue(category, enable);
+    SettingsStore::instance()->setValue(_filterRulesSettingsGroup, category, enable);
 }
 
 bool QGCLoggingCategoryRegister::categoryLoggingOn(const QString& category)
 {
-    QSettings settings;
-
-    settings.beginGroup(_filterRulesSettingsGroup);
-    return settings.value(category, false).toBool();
+    return SettingsStore::instance()->value(_filterRulesSettingsGroup, category, false).toBool();
 }
 
 void QGCLoggingCategoryRegister::setFilterRulesFromSettings(const QString& commandLineLoggingOptions)
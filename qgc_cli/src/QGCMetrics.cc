@@ -0,0 +1,407 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCMetrics.h"
+
+#include <QMutexLocker>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+
+#include <cmath>
+#include <limits>
+
+QGCMetric::QGCMetric(Type type, const QString& name, const QGCMetricLabels& labels)
+    : _type(type)
+    , _name(name)
+    , _labels(labels)
+    , _refCount(0)
+{
+
+}
+
+QGCMetricCounter::QGCMetricCounter(const QString& name, const QGCMetricLabels& labels)
+    : QGCMetric(TypeCounter, name, labels)
+    , _value(0)
+{
+
+}
+
+QGCMetricGauge::QGCMetricGauge(const QString& name, const QGCMetricLabels& labels)
+    : QGCMetric(TypeGauge, name, labels)
+    , _value(0)
+{
+
+}
+
+QGCMetricHistogram::QGCMetricHistogram(const QString& name, const QGCMetricLabels& labels)
+    : QGCMetric(TypeHistogram, name, labels)
+    , _sum(0)
+    , _max(0)
+{
+    for (int i=0; i<_bucketCount; i++) {
+        _rgBuckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+static inline int _highestBit(quint64 value)
+{
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+int QGCMetricHistogram::_bucketIndex(qint64 value)
+{
+    if (value < _subBucketCount) {
+        return value < 0 ? 0 : (int)value;
+    }
+
+    int exponent = _highestBit((quint64)value);
+    if (exponent >= _maxExponent) {
+        return _bucketCount - 1;
+    }
+
+    // The bits below the leading one select the sub-bucket
+    int shift = exponent - _subBucketBits;
+    return ((shift + 1) << _subBucketBits) + (int)((value >> shift) & (_subBucketCount - 1));
+}
+
+qint64 QGCMetricHistogram::_bucketLower(int index)
+{
+    if (index < _subBucketCount) {
+        return index;
+    }
+
+    int shift = (index >> _subBucketBits) - 1;
+    return (qint64)(_subBucketCount + (index & (_subBucketCount - 1))) << shift;
+}
+
+qint64 QGCMetricHistogram::_bucketUpper(int index)
+{
+    return index == _bucketCount - 1 ? std::numeric_limits<qint64>::max() : _bucketLower(index + 1) - 1;
+}
+
+qint64 QGCMetricHistogram::bucketLowerBound(qint64 value)
+{
+    return _bucketLower(_bucketIndex(value));
+}
+
+void QGCMetricHistogram::record(qint64 value)
+{
+    _rgBuckets[_bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    qint64 max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+QGCMetricHistogram::Summary QGCMetricHistogram::summary(void) const
+{
+    quint64 rgCounts[_bucketCount];
+    Summary summary;
+
+    summary.count = 0;
+    for (int i=0; i<_bucketCount; i++) {
+        rgCounts[i] = _rgBuckets[i].load(std::memory_order_relaxed);
+        summary.count += rgCounts[i];
+    }
+    summary.sum = _sum.load(std::memory_order_relaxed);
+    summary.max = _max.load(std::memory_order_relaxed);
+
+    // A percentile is reported as the top of its bucket, which never overstates the maximum
+    const double    rgQuantiles[] = { 0.5, 0.9, 0.99 };
+    qint64*         rgResults[] = { &summary.p50, &summary.p90, &summary.p99 };
+    quint64         seen = 0;
+    int             bucket = 0;
+
+    for (int i=0; i<3; i++) {
+        quint64 rank = qMax((quint64)std::ceil(rgQuantiles[i] * summary.count), (quint64)1);
+        while (bucket < _bucketCount - 1 && seen + rgCounts[bucket] < rank) {
+            seen += rgCounts[bucket++];
+        }
+        *rgResults[i] = summary.count ? qMin(_bucketUpper(bucket), summary.max) : 0;
+    }
+
+    return summary;
+}
+
+QGCMetrics::QGCMetrics(void)
+{
+
+}
+
+QGCMetrics* QGCMetrics::instance(void)
+{
+    static QGCMetrics metrics;
+    return &metrics;
+}
+
+QString QGCMetrics::_labelText(const QGCMetricLabels& labels)
+{
+    QString text;
+
+    for (int i=0; i<labels.count(); i++) {
+        QString value = labels[i].second;
+        value.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+        value.replace(QLatin1Char('"'), QLatin1String("\\\""));
+        value.replace(QLatin1Char('\n'), QLatin1String("\\n"));
+
+        if (i) {
+            text += QLatin1Char(',');
+        }
+        text += labels[i].first + QStringLiteral("=\"") + value + QLatin1Char('"');
+    }
+
+    return text;
+}
+
+QGCMetric* QGCMetrics::_get(QGCMetric::Type type, const QString& name, const QString& help, const QGCMetricLabels& labels)
+{
+    QMutexLocker locker(&_mutex);
+
+    if (!_families.contains(name)) {
+        Family_t family;
+        family.type = type;
+        family.help = help;
+        _families[name] = family;
+    }
+
+    Family_t& family = _families[name];
+    if (family.type != type) {
+        qWarning() << "QGCMetrics: metric registered with two types" << name;
+        return NULL;
+    }
+
+    QString     labelText = _labelText(labels);
+    QGCMetric*  metric = family.metrics.value(labelText, NULL);
+
+    if (!metric) {
+        switch (type) {
+        case QGCMetric::TypeCounter:
+            metric = new QGCMetricCounter(name, labels);
+            break;
+        case QGCMetric::TypeGauge:
+            metric = new QGCMetricGauge(name, labels);
+            break;
+        case QGCMetric::TypeHistogram:
+            metric = new QGCMetricHistogram(name, labels);
+            break;
+        }
+        metric->_labelText = labelText;
+        family.metrics[labelText] = metric;
+    }
+
+    metric->_refCount++;
+    return metric;
+}
+
+QGCMetricCounter* QGCMetrics::counter(const QString& name, const QString& help, const QGCMetricLabels& labels)
+{
+    return static_cast<QGCMetricCounter*>(_get(QGCMetric::TypeCounter, name, help, labels));
+}
+
+QGCMetricGauge* QGCMetrics::gauge(const QString& name, const QString& help, const QGCMetricLabels& labels)
+{
+    return static_cast<QGCMetricGauge*>(_get(QGCMetric::TypeGauge, name, help, labels));
+}
+
+QGCMetricHistogram* QGCMetrics::histogram(const QString& name, const QString& help, const QGCMetricLabels& labels)
+{
+    return static_cast<QGCMetricHistogram*>(_get(QGCMetric::TypeHistogram, name, help, labels));
+}
+
+void QGCMetrics::release(QGCMetric* metric)
+{
+    if (!metric) {
+        return;
+    }
+
+    QMutexLocker locker(&_mutex);
+
+    if (--metric->_refCount > 0) {
+        return;
+    }
+
+    Family_t& family = _families[metric->_name];
+    family.metrics.remove(metric->_labelText);
+    if (family.metrics.isEmpty()) {
+        _families.remove(metric->_name);
+    }
+    delete metric;
+}
+
+int QGCMetrics::count(void) const
+{
+    QMutexLocker locker(&_mutex);
+
+    int count = 0;
+    foreach (const Family_t& family, _families) {
+        count += family.metrics.count();
+    }
+    return count;
+}
+
+QByteArray QGCMetrics::jsonLine(qint64 time) const
+{
+    QMutexLocker    locker(&_mutex);
+    QJsonArray      metricsArray;
+
+    foreach (const Family_t& family, _families) {
+        foreach (const QGCMetric* metric, family.metrics) {
+            QJsonObject labelsObject;
+            for (int i=0; i<metric->labels().count(); i++) {
+                labelsObject[metric->labels()[i].first] = metric->labels()[i].second;
+            }
+
+            QJsonObject metricObject;
+            metricObject["name"] = metric->name();
+            metricObject["labels"] = labelsObject;
+
+            switch (metric->type()) {
+            case QGCMetric::TypeCounter:
+                metricObject["value"] = (double)static_cast<const QGCMetricCounter*>(metric)->value();
+                break;
+            case QGCMetric::TypeGauge:
+                metricObject["value"] = static_cast<const QGCMetricGauge*>(metric)->value();
+                break;
+            case QGCMetric::TypeHistogram:
+            {
+                QGCMetricHistogram::Summary summary = static_cast<const QGCMetricHistogram*>(metric)->summary();
+                metricObject["count"] = (double)summary.count;
+                metricObject["sum"] = (double)summary.sum;
+                metricObject["max"] = (double)summary.max;
+                metricObject["p50"] = (double)summary.p50;
+                metricObject["p90"] = (double)summary.p90;
+                metricObject["p99"] = (double)summary.p99;
+                break;
+            }
+            }
+
+            metricsArray.append(metricObject);
+        }
+    }
+
+    QJsonObject root;
+    root["time"] = (double)time;
+    root["metrics"] = metricsArray;
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QByteArray QGCMetrics::csvHeader(void)
+{
+    return QByteArrayLiteral("time,name,labels,value,count,sum,max,p50,p90,p99\n");
+}
+
+QByteArray QGCMetrics::csvLines(qint64 time) const
+{
+    QMutexLocker    locker(&_mutex);
+    QByteArray      lines;
+
+    foreach (const Family_t& family, _families) {
+        foreach (const QGCMetric* metric, family.metrics) {
+            // Labels as name=value;name=value, quoted if that needs it
+            QStringList labels;
+            for (int i=0; i<metric->labels().count(); i++) {
+                labels.append(metric->labels()[i].first + QLatin1Char('=') + metric->labels()[i].second);
+            }
+            QString labelField = labels.join(QLatin1Char(';'));
+            if (labelField.contains(QLatin1Char(',')) || labelField.contains(QLatin1Char('"'))) {
+                labelField = QLatin1Char('"') + labelField.replace(QLatin1Char('"'), QLatin1String("\"\"")) + QLatin1Char('"');
+            }
+
+            QByteArray line = QByteArray::number(time) + ',' + metric->name().toUtf8() + ',' + labelField.toUtf8() + ',';
+
+            switch (metric->type()) {
+            case QGCMetric::TypeCounter:
+                line += QByteArray::number(static_cast<const QGCMetricCounter*>(metric)->value()) + ",,,,,,";
+                break;
+            case QGCMetric::TypeGauge:
+                line += QByteArray::number(static_cast<const QGCMetricGauge*>(metric)->value()) + ",,,,,,";
+                break;
+            case QGCMetric::TypeHistogram:
+            {
+                QGCMetricHistogram::Summary summary = static_cast<const QGCMetricHistogram*>(metric)->summary();
+                line += ',' + QByteArray::number(summary.count) +
+                        ',' + QByteArray::number(summary.sum) +
+                        ',' + QByteArray::number(summary.max) +
+                        ',' + QByteArray::number(summary.p50) +
+                        ',' + QByteArray::number(summary.p90) +
+                        ',' + QByteArray::number(summary.p99);
+                break;
+            }
+            }
+
+            lines += line + '\n';
+        }
+    }
+
+    return lines;
+}
+
+/// Labels in braces after a metric name, nothing without labels
+static QByteArray _braced(const QByteArray& labels)
+{
+    return labels.isEmpty() ? QByteArray() : QByteArray("{") + labels + QByteArray("}");
+}
+
+QByteArray QGCMetrics::prometheusText(void) const
+{
+    QMutexLocker    locker(&_mutex);
+    QByteArray      text;
+
+    for (QMap<QString, Family_t>::const_iterator iter = _families.constBegin(); iter != _families.constEnd(); ++iter) {
+        const QByteArray    name = iter.key().toUtf8();
+        const Family_t&     family = iter.value();
+
+        static const char* rgTypeNames[] = { "counter", "gauge", "summary" };
+        text += "# HELP " + name + ' ' + family.help.toUtf8() + '\n';
+        text += "# TYPE " + name + ' ' + rgTypeNames[family.type] + '\n';
+
+        foreach (const QGCMetric* metric, family.metrics) {
+            const QByteArray labels = metric->_labelText.toUtf8();
+
+            switch (metric->type()) {
+            case QGCMetric::TypeCounter:
+                text += name + _braced(labels) + ' ' +
+                        QByteArray::number(static_cast<const QGCMetricCounter*>(metric)->value()) + '\n';
+                break;
+            case QGCMetric::TypeGauge:
+                text += name + _braced(labels) + ' ' +
+                        QByteArray::number(static_cast<const QGCMetricGauge*>(metric)->value()) + '\n';
+                break;
+            case QGCMetric::TypeHistogram:
+            {
+                QGCMetricHistogram::Summary summary = static_cast<const QGCMetricHistogram*>(metric)->summary();
+                const QByteArray    separator = labels.isEmpty() ? QByteArray() : QByteArray(",");
+                const char*         rgQuantiles[] = { "0.5", "0.9", "0.99" };
+                const qint64        rgValues[] = { summary.p50, summary.p90, summary.p99 };
+
+                for (int i=0; i<3; i++) {
+                    text += name + '{' + labels + separator + "quantile=\"" + rgQuantiles[i] + "\"} " + QByteArray::number(rgValues[i]) + '\n';
+                }
+                text += name + "_sum" + _braced(labels) + ' ' + QByteArray::number(summary.sum) + '\n';
+                text += name + "_count" + _braced(labels) + ' ' + QByteArray::number(summary.count) + '\n';
+                break;
+            }
+            }
+        }
+    }
+
+    return text;
+}
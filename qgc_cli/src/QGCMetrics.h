@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QMap>
+#include <QMutex>
+#include <QByteArray>
+
+#include <atomic>
+
+/// Label name/value pairs which tell apart the metrics of one name, e.g. {{"vehicle", "3"}}
+typedef QList<QPair<QString, QString> > QGCMetricLabels;
+
+/// A named value of the metrics registry. Metrics are created and released through QGCMetrics, updates are relaxed
+/// atomics and can be made on any thread without locking.
+class QGCMetric
+{
+public:
+    enum Type {
+        TypeCounter,
+        TypeGauge,
+        TypeHistogram
+    };
+
+    virtual ~QGCMetric() {}
+
+    Type                    type    (void) const { return _type; }
+    const QString&          name    (void) const { return _name; }
+    const QGCMetricLabels&  labels  (void) const { return _labels; }
+
+protected:
+    QGCMetric(Type type, const QString& name, const QGCMetricLabels& labels);
+
+private:
+    friend class QGCMetrics;
+
+    Type            _type;
+    QString         _name;
+    QGCMetricLabels _labels;
+    QString         _labelText;     ///< Labels in Prometheus form, also the key within the name
+    int             _refCount;
+};
+
+/// Monotonic count of events
+class QGCMetricCounter : public QGCMetric
+{
+public:
+    void    add     (quint64 count = 1) { _value.fetch_add(count, std::memory_order_relaxed); }
+    quint64 value   (void) const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    friend class QGCMetrics;
+    QGCMetricCounter(const QString& name, const QGCMetricLabels& labels);
+
+    std::atomic<quint64> _value;
+};
+
+/// Current value of something which goes up and down
+class QGCMetricGauge : public QGCMetric
+{
+public:
+    void    set     (double value) { _value.store(value, std::memory_order_relaxed); }
+    double  value   (void) const { return _value.load(std::memory_order_relaxed); }
+
+private:
+    friend class QGCMetrics;
+    QGCMetricGauge(const QString& name, const QGCMetricLabels& labels);
+
+    std::atomic<double> _value;
+};
+
+/// Distribution of non-negative integer samples, e.g. latencies in us. Buckets are log-linear in the way of HDR
+/// histograms: each power of two is split into _subBucketCount buckets, so a percentile is within 1/_subBucketCount
+/// of the true value. Samples of _maxExponent bits or more land in the last bucket. Recording is one bucket increment,
+/// a sum and, when it grows, the maximum.
+class QGCMetricHistogram : public QGCMetric
+{
+public:
+    struct Summary {
+        quint64 count;
+        qint64  sum;
+        qint64  max;
+        qint64  p50;
+        qint64  p90;
+        qint64  p99;
+    };
+
+    void record(qint64 value);
+
+    /// Counts of the buckets are read one by one while writers go on, so a summary taken during updates may be off by
+    /// the samples recorded while it was taken.
+    Summary summary(void) const;
+
+    /// @return Smallest value which lands in the bucket of value, for testing the bucket layout
+    static qint64 bucketLowerBound(qint64 value);
+
+private:
+    friend class QGCMetrics;
+    QGCMetricHistogram(const QString& name, const QGCMetricLabels& labels);
+
+    static int      _bucketIndex    (qint64 value);
+    static qint64   _bucketLower    (int index);
+    static qint64   _bucketUpper    (int index);
+
+    static const int _subBucketBits     = 4;
+    static const int _subBucketCount    = 1 << _subBucketBits;
+    static const int _maxExponent       = 36;
+    static const int _bucketCount       = (_maxExponent - _subBucketBits + 1) * _subBucketCount;
+
+    std::atomic<quint64>    _rgBuckets[_bucketCount];
+    std::atomic<qint64>     _sum;
+    std::atomic<qint64>     _max;
+};
+
+/// Process wide registry of counters, gauges and histograms for profiling. Components get their metrics once, keep the
+/// pointers for the hot path and release them when they go away. Asking for a name and label set which is already
+/// registered returns the same metric, so components can share one, e.g. a histogram across all vehicles. Names
+/// follow the Prometheus conventions: a unit suffix, and _total for counters.
+///
+/// The registry renders all metrics as a JSON line, CSV lines or the Prometheus text format, for the agent to export.
+class QGCMetrics
+{
+public:
+    static QGCMetrics* instance(void);
+
+    QGCMetricCounter*   counter     (const QString& name, const QString& help, const QGCMetricLabels& labels = QGCMetricLabels());
+    QGCMetricGauge*     gauge       (const QString& name, const QString& help, const QGCMetricLabels& labels = QGCMetricLabels());
+    QGCMetricHistogram* histogram   (const QString& name, const QString& help, const QGCMetricLabels& labels = QGCMetricLabels());
+
+    /// Releases a metric from counter, gauge or histogram. It is deleted when the last user released it.
+    void release(QGCMetric* metric);
+
+    /// @return Number of registered metrics
+    int count(void) const;
+
+    /// All metrics as one JSON object on one line, with the time in ms since epoch
+    QByteArray jsonLine(qint64 time) const;
+
+    /// Column names of csvLines
+    static QByteArray csvHeader(void);
+
+    /// All metrics as CSV, one line per metric, with the time in ms since epoch
+    QByteArray csvLines(qint64 time) const;
+
+    /// All metrics in the Prometheus text exposition format, histograms as summaries
+    QByteArray prometheusText(void) const;
+
+private:
+    QGCMetrics(void);
+
+    typedef struct {
+        QGCMetric::Type             type;
+        QString                     help;
+        QMap<QString, QGCMetric*>   metrics;    ///< By label text
+    } Family_t;
+
+    QGCMetric* _get(QGCMetric::Type type, const QString& name, const QString& help, const QGCMetricLabels& labels);
+
+    static QString _labelText(const QGCMetricLabels& labels);
+
+    mutable QMutex              _mutex;
+    QMap<QString, Family_t>     _families;      ///< By name
+};
@@ -12,8 +12,8 @@
 ///     @author Don Gagne <don@thegagnes.com>
 
 #include "QGroundControlQmlGlobal.h"
+#include "SettingsStore.h"
 
-#include <QSettings>
 #include <QLineF>
 #include <QPointF>
 
@@ -78,30 +78,22 @@ void QGroundControlQmlGlobal::setToolbox(QGCToolbox* toolbox)
 
 void QGroundControlQmlGlobal::saveGlobalSetting (const QString& key, const QString& value)
 {
-    QSettings settings;
-    settings.beginGroup(kQmlGlobalKeyName);
-    settings.setValue(key, value);
+    SettingsStore::instance()->setValue(kQmlGlobalKeyName, key, value);
 }
 
 QString QGroundControlQmlGlobal::loadGlobalSetting (const QString& key, const QString& defaultValue)
 {
-    QSettings settings;
-    settings.beginGroup(kQmlGlobalKeyName);
-    return settings.value(key, defaultValue).toString();
+    return SettingsStore::instance()->value(kQmlGlobalKeyName, key, defaultValue).toString();
 }
 
 void QGroundControlQmlGlobal::saveBoolGlobalSetting (const QString& key, bool value)
 {
-    QSettings settings;
-    settings.beginGroup(kQmlGlobalKeyName);
-    settings.setValue(key, value);
+    SettingsStore::instance()->setValue(kQmlGlobalKeyName, key, value);
 }
 
 bool QGroundControlQmlGlobal::loadBoolGlobalSetting (const QString& key, bool defaultValue)
 {
-    QSettings settings;
-    settings.beginGroup(kQmlGlobalKeyName);
-    return settings.value(key, defaultValue).toBool();
+    return SettingsStore::instance()->value(kQmlGlobalKeyName, key, defaultValue).toBool();
 }
 
 void QGroundControlQmlGlobal::startPX4MockLink(bool sendStatusText)
@@ -209,32 +201,27 @@ void QGroundControlQmlGlobal::setSkipSetupPage(bool skip)
 
 QGeoCoordinate QGroundControlQmlGlobal::flightMapPosition(void)
 {
-    QSettings       settings;
+    SettingsStore*  settings = SettingsStore::instance();
     QGeoCoordinate  coord;
 
-    settings.beginGroup(_flightMapPositionSettingsGroup);
-    coord.setLatitude(settings.value(_flightMapPositionLatitudeSettingsKey, 0).toDouble());
-    coord.setLongitude(settings.value(_flightMapPositionLongitudeSettingsKey, 0).toDouble());
+    coord.setLatitude(settings->value(_flightMapPositionSettingsGroup, _flightMapPositionLatitudeSettingsKey, 0).toDouble());
+    coord.setLongitude(settings->value(_flightMapPositionSettingsGroup, _flightMapPositionLongitudeSettingsKey, 0).toDouble());
 
     return coord;
 }
 
 double QGroundControlQmlGlobal::flightMapZoom(void)
 {
-    QSettings settings;
-
-    settings.beginGroup(_flightMapPositionSettingsGroup);
-    return settings.value(_flightMapZoomSettingsKey, 2).toDouble();
+    return SettingsStore::instance()->value(_flightMapPositionSettingsGroup, _flightMapZoomSettingsKey, 2).toDouble();
 }
 
 void QGroundControlQmlGlobal::setFlightMapPosition(QGeoCoordinate& coordinate)
 {
     if (coordinate != flightMapPosition()) {
-        QSettings settings;
+        SettingsStore* settings = SettingsStore::instance();
 
-        settings.beginGroup(_flightMapPositionSettingsGroup);
-        settings.setValue(_flightMapPositionLatitudeSettingsKey, coordinate.latitude());
-        settings.setValue(_flightMapPositionLongitudeSettingsKey, coordinate.longitude());
+        settings->setValue(_flightMapPositionSettingsGroup, _flightMapPositionLatitudeSettingsKey, coordinate.latitude());
+        settings->setValue(_flightMapPositionSettingsGroup, _flightMapPositionLongitudeSettingsKey, coordinate.longitude());
         emit flightMapPositionChanged(coordinate);
     }
 }
@@ -242,10 +229,7 @@ void QGroundControlQmlGlobal::setFlightMapPosition(QGeoCoordinate& coordinate)
 void QGroundControlQmlGlobal::setFlightMapZoom(double zoom)
 {
     if (zoom != flightMapZoom()) {
-        QSettings settings;
-
-        settings.beginGroup(_flightMapPositionSettingsGroup);
-        settings.setValue(_flightMapZoomSettingsKey, zoom);
+        SettingsStore::instance()->setValue(_flightMapPositionSettingsGroup, _flightMapZoomSettingsKey, zoom);
         emit flightMapZoomChanged(zoom);
     }
 }
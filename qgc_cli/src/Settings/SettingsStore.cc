@@ -0,0 +1,228 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SettingsStore.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QDir>
+#include <QThread>
+
+QGC_LOGGING_CATEGORY(SettingsStoreLog, "SettingsStoreLog")
+
+SettingsStore::SettingsStore(void)
+    : _readOnly(false)
+    , _loaded(false)
+    , _flushDelay(_defaultFlushDelayMSecs)
+    , _flushTimer(this)
+{
+    // The first value may be asked for on any thread, the flush timer has to run on the main thread
+    if (QCoreApplication::instance()) {
+        moveToThread(QCoreApplication::instance()->thread());
+    }
+
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(_flushDelay);
+    connect(&_flushTimer, &QTimer::timeout, this, &SettingsStore::_flush);
+}
+
+SettingsStore* SettingsStore::instance(void)
+{
+    static SettingsStore store;
+    return &store;
+}
+
+void SettingsStore::setInstance(const QString& instance)
+{
+    if (_loaded) {
+        qWarning() << "SettingsStore::setInstance called after settings were loaded";
+    }
+    _instance = instance;
+}
+
+void SettingsStore::setReadOnly(bool readOnly)
+{
+    QMutexLocker locker(&_mutex);
+    _readOnly = readOnly;
+    if (_readOnly) {
+        _dirty.clear();
+        _removed.clear();
+    }
+}
+
+void SettingsStore::setFlushDelay(int msecs)
+{
+    QMutexLocker locker(&_mutex);
+    _flushDelay = msecs;
+    _flushTimer.setInterval(msecs);
+}
+
+QSettings::Format SettingsStore::format(void)
+{
+    // QSettings() opens the application's settings in the default format
+    return QSettings::defaultFormat();
+}
+
+QString SettingsStore::fileName(void) const
+{
+    QString sharedFileName = QSettings().fileName();
+    if (_instance.isEmpty()) {
+        return sharedFileName;
+    }
+
+    QFileInfo   sharedFile(sharedFileName);
+    QString     instanceFileName = QStringLiteral("%1-%2").arg(sharedFile.completeBaseName()).arg(_instance);
+    if (!sharedFile.suffix().isEmpty()) {
+        instanceFileName += QStringLiteral(".") + sharedFile.suffix();
+    }
+    return sharedFile.dir().filePath(instanceFileName);
+}
+
+QString SettingsStore::_key(const QString& group, const QString& key)
+{
+    if (group.isEmpty()) {
+        return key;
+    }
+    return key.isEmpty() ? group : QStringLiteral("%1/%2").arg(group).arg(key);
+}
+
+void SettingsStore::_loadFile(const QString& fileName)
+{
+    QSettings settings(fileName, format());
+    foreach (const QString& key, settings.allKeys()) {
+        _values[key] = settings.value(key);
+    }
+}
+
+void SettingsStore::_load(void)
+{
+    if (_loaded) {
+        return;
+    }
+    _loaded = true;
+
+    _loadFile(QSettings().fileName());
+    if (!_instance.isEmpty()) {
+        _loadFile(fileName());
+    }
+    qCDebug(SettingsStoreLog) << "Loaded settings:instance:readOnly" << _values.count() << _instance << _readOnly;
+}
+
+QVariant SettingsStore::value(const QString& group, const QString& key, const QVariant& defaultValue)
+{
+    QMutexLocker locker(&_mutex);
+
+    _load();
+    return _values.value(_key(group, key), defaultValue);
+}
+
+bool SettingsStore::contains(const QString& group, const QString& key)
+{
+    QMutexLocker locker(&_mutex);
+
+    _load();
+    return _values.contains(_key(group, key));
+}
+
+void SettingsStore::setValue(const QString& group, const QString& key, const QVariant& value)
+{
+    QMutexLocker locker(&_mutex);
+
+    _load();
+
+    QString fullKey = _key(group, key);
+    QHash<QString, QVariant>::iterator iter = _values.find(fullKey);
+    if (iter != _values.end() && iter.value() == value) {
+        return;
+    }
+    _values[fullKey] = value;
+
+    if (_readOnly) {
+        return;
+    }
+
+    _dirty.insert(fullKey);
+    _changed(locker);
+}
+
+void SettingsStore::remove(const QString& group, const QString& key)
+{
+    QMutexLocker locker(&_mutex);
+
+    _load();
+
+    // Same as QSettings::remove, an empty key removes everything within the group
+    QString fullKey = _key(group, key);
+    QString prefix = fullKey.isEmpty() ? QString() : fullKey + QStringLiteral("/");
+    QHash<QString, QVariant>::iterator iter = _values.begin();
+    while (iter != _values.end()) {
+        if (iter.key() == fullKey || iter.key().startsWith(prefix)) {
+            _dirty.remove(iter.key());
+            iter = _values.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+
+    if (_readOnly) {
+        return;
+    }
+
+    _removed.insert(fullKey);
+    _changed(locker);
+}
+
+void SettingsStore::_changed(QMutexLocker& locker)
+{
+    if (_flushDelay == 0) {
+        locker.unlock();
+        _flush();
+    } else if (QThread::currentThread() == thread()) {
+        _flushTimer.start();
+    } else {
+        QMetaObject::invokeMethod(&_flushTimer, "start", Qt::QueuedConnection);
+    }
+}
+
+void SettingsStore::flush(void)
+{
+    // The timer can only be stopped on its own thread. If it still fires it finds nothing left to write.
+    if (QThread::currentThread() == thread()) {
+        _flushTimer.stop();
+    }
+    _flush();
+}
+
+void SettingsStore::_flush(void)
+{
+    QMutexLocker locker(&_mutex);
+
+    if ((_dirty.isEmpty() && _removed.isEmpty()) || _readOnly) {
+        return;
+    }
+
+    // A single sync per batch. QSettings writes the file under a lock file and replaces it atomically, so other
+    // processes reading the same file never see a partial write. Removals go first so values set after them stay.
+    QSettings settings(fileName(), format());
+    foreach (const QString& key, _removed) {
+        settings.remove(key);
+    }
+    foreach (const QString& key, _dirty) {
+        settings.setValue(key, _values[key]);
+    }
+    settings.sync();
+
+    if (settings.status() != QSettings::NoError) {
+        qWarning() << "SettingsStore write failed" << settings.fileName() << settings.status();
+    } else {
+        qCDebug(SettingsStoreLog) << "Flushed:removed" << _dirty.count() << _removed.count() << "settings to" << settings.fileName();
+    }
+    _dirty.clear();
+    _removed.clear();
+}
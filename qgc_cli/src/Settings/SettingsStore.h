@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#ifndef SettingsStore_H
+#define SettingsStore_H
+
+#include "QGCLoggingCategory.h"
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QTimer>
+#include <QVariant>
+#include <QSettings>
+
+Q_DECLARE_LOGGING_CATEGORY(SettingsStoreLog)
+
+/// In memory layer between SettingsFacts and QSettings.
+///
+/// All values are read from disk once. Changes are kept in memory and written back in a single batch once no further
+/// changes have come in for the flush delay. When an instance is set, for example when many agent processes run on the
+/// same machine, values are read from the shared settings file overlaid with the instance's own file and changes are
+/// only written to the instance file. In read only mode nothing is ever written to disk.
+///
+/// Values and changes may come from any thread. The store and its flush timer live on the main thread.
+class SettingsStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SettingsStore* instance(void);
+
+    /// Configuration, must be set before the first value is read
+    void setInstance    (const QString& instance);
+    void setReadOnly    (bool readOnly);
+    /// Delay after the last change before changes are written, 0 writes each change immediately. Main thread only.
+    void setFlushDelay  (int msecs);
+
+    QString instanceName(void) const { return _instance; }
+    bool    readOnly    (void) const { return _readOnly; }
+
+    /// @return Path of the file changes are written to
+    QString fileName(void) const;
+
+    /// @return Format of the settings file, the same as the application's default QSettings
+    static QSettings::Format format(void);
+
+    QVariant    value       (const QString& group, const QString& key, const QVariant& defaultValue = QVariant());
+    void        setValue    (const QString& group, const QString& key, const QVariant& value);
+    bool        contains    (const QString& group, const QString& key);
+
+    /// Removes key from group, or the whole group with all its keys and sub groups when key is empty
+    void remove(const QString& group, const QString& key = QString());
+
+    /// Writes all pending changes now. Can be called from any thread.
+    void flush(void);
+
+private slots:
+    void _flush(void);
+
+private:
+    SettingsStore(void);
+
+    void _load(void);
+    void _loadFile(const QString& fileName);
+    void _changed(QMutexLocker& locker);
+    static QString _key(const QString& group, const QString& key);
+
+    QString                     _instance;
+    bool                        _readOnly;
+    bool                        _loaded;
+    QMutex                      _mutex;
+    QHash<QString, QVariant>    _values;    ///< Keyed by group/key, same as QSettings
+    QSet<QString>               _dirty;     ///< Keys to write
+    QSet<QString>               _removed;   ///< Keys to remove from the file
+    int                         _flushDelay;
+    QTimer                      _flushTimer;
+
+    static const int _defaultFlushDelayMSecs = 1000;
+};
+
+#endif
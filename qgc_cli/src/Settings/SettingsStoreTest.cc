@@ -0,0 +1,167 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SettingsStoreTest.h"
+#include "SettingsStore.h"
+
+#include <QThread>
+
+static const char* _testGroup = "SettingsStoreTest";
+
+/// Changes a value from its own thread
+class SettingsStoreWriter : public QThread
+{
+public:
+    SettingsStoreWriter(const QString& key, const QVariant& value, bool flush)
+        : _key(key)
+        , _value(value)
+        , _flush(flush)
+    {
+    }
+
+protected:
+    void run(void) final
+    {
+        SettingsStore::instance()->setValue(_testGroup, _key, _value);
+        if (_flush) {
+            SettingsStore::instance()->flush();
+        }
+    }
+
+private:
+    QString     _key;
+    QVariant    _value;
+    bool        _flush;
+};
+
+/// @return Value of key as written to the settings file
+static QVariant _fileValue(const QString& key)
+{
+    QSettings settings(SettingsStore::instance()->fileName(), SettingsStore::format());
+    return settings.value(QStringLiteral("%1/%2").arg(_testGroup).arg(key));
+}
+
+void SettingsStoreTest::cleanup(void)
+{
+    // Unit tests run with changes written right away
+    SettingsStore* store = SettingsStore::instance();
+    store->setReadOnly(false);
+    store->setFlushDelay(0);
+    store->remove(_testGroup);
+
+    UnitTest::cleanup();
+}
+
+void SettingsStoreTest::_roundTrip(void)
+{
+    SettingsStore* store = SettingsStore::instance();
+
+    QCOMPARE(store->contains(_testGroup, "int"), false);
+    QCOMPARE(store->value(_testGroup, "int", 42).toInt(), 42);
+
+    store->setValue(_testGroup, "int", 7);
+    store->setValue(_testGroup, "string", QStringLiteral("seven"));
+    QCOMPARE(store->contains(_testGroup, "int"), true);
+    QCOMPARE(store->value(_testGroup, "int", 42).toInt(), 7);
+    QCOMPARE(store->value(_testGroup, "string").toString(), QStringLiteral("seven"));
+
+    // The store writes to the same file, in the same format, QSettings reads
+    QCOMPARE(SettingsStore::format(), QSettings().format());
+    QCOMPARE(_fileValue("int").toInt(), 7);
+    QCOMPARE(_fileValue("string").toString(), QStringLiteral("seven"));
+}
+
+void SettingsStoreTest::_remove(void)
+{
+    SettingsStore* store = SettingsStore::instance();
+
+    store->setValue(_testGroup, "a", 1);
+    store->setValue(_testGroup, "b", 2);
+    store->setValue(QStringLiteral("%1/sub").arg(_testGroup), "c", 3);
+
+    // Single key
+    store->remove(_testGroup, "a");
+    QCOMPARE(store->contains(_testGroup, "a"), false);
+    QCOMPARE(store->contains(_testGroup, "b"), true);
+    QVERIFY(!_fileValue("a").isValid());
+    QCOMPARE(_fileValue("b").toInt(), 2);
+
+    // Whole group including sub groups
+    store->remove(_testGroup);
+    QCOMPARE(store->contains(_testGroup, "b"), false);
+    QCOMPARE(store->contains(QStringLiteral("%1/sub").arg(_testGroup), "c"), false);
+    QVERIFY(!_fileValue("b").isValid());
+    QVERIFY(!_fileValue("sub/c").isValid());
+
+    // A value set after a removal stays
+    store->setFlushDelay(1000);
+    store->remove(_testGroup);
+    store->setValue(_testGroup, "a", 4);
+    store->flush();
+    QCOMPARE(_fileValue("a").toInt(), 4);
+}
+
+void SettingsStoreTest::_delayedFlush(void)
+{
+    SettingsStore* store = SettingsStore::instance();
+
+    store->setFlushDelay(100);
+    store->setValue(_testGroup, "delayed", 1);
+    QCOMPARE(store->value(_testGroup, "delayed").toInt(), 1);
+    QVERIFY(!_fileValue("delayed").isValid());
+
+    // Further changes restart the delay and go out in the same batch
+    QTest::qWait(50);
+    store->setValue(_testGroup, "delayed", 2);
+    QVERIFY(!_fileValue("delayed").isValid());
+    QTRY_COMPARE_WITH_TIMEOUT(_fileValue("delayed").toInt(), 2, 1000);
+
+    // Explicit flush writes right away
+    store->setFlushDelay(10000);
+    store->setValue(_testGroup, "delayed", 3);
+    QCOMPARE(_fileValue("delayed").toInt(), 2);
+    store->flush();
+    QCOMPARE(_fileValue("delayed").toInt(), 3);
+}
+
+void SettingsStoreTest::_changeFromThread(void)
+{
+    SettingsStore* store = SettingsStore::instance();
+
+    // The flush timer is started on the main thread for a change made on another thread
+    store->setFlushDelay(100);
+    SettingsStoreWriter delayedWriter("thread", 1, false /* flush */);
+    delayedWriter.start();
+    QVERIFY(delayedWriter.wait(5000));
+    QCOMPARE(store->value(_testGroup, "thread").toInt(), 1);
+    QVERIFY(!_fileValue("thread").isValid());
+    QTRY_COMPARE_WITH_TIMEOUT(_fileValue("thread").toInt(), 1, 1000);
+
+    // Flush from another thread writes right away, the pending timer later finds nothing to write
+    store->setFlushDelay(10000);
+    SettingsStoreWriter flushWriter("thread", 2, true /* flush */);
+    flushWriter.start();
+    QVERIFY(flushWriter.wait(5000));
+    QCOMPARE(_fileValue("thread").toInt(), 2);
+}
+
+void SettingsStoreTest::_readOnly(void)
+{
+    SettingsStore* store = SettingsStore::instance();
+
+    store->setValue(_testGroup, "readOnly", 1);
+    store->setReadOnly(true);
+
+    // Changes are seen in memory but never written
+    store->setValue(_testGroup, "readOnly", 2);
+    store->remove(_testGroup, "other");
+    QCOMPARE(store->value(_testGroup, "readOnly").toInt(), 2);
+    store->flush();
+    QCOMPARE(_fileValue("readOnly").toInt(), 1);
+}
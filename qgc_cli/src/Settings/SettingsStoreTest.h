@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for SettingsStore
+class SettingsStoreTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup(void);
+
+    void _roundTrip(void);
+    void _remove(void);
+    void _delayedFlush(void);
+    void _changeFromThread(void);
+    void _readOnly(void);
+};
@@ -10,12 +10,12 @@
 #include "MAVLinkLogManager.h"
 #include "QGCApplication.h"
 #include "SettingsManager.h"
+#include "SettingsStore.h"
 
 #include <QQmlContext>
 #include <QQmlProperty>
 #include <QQmlEngine>
 #include <QtQml>
-#include <QSettings>
 #include <QHttpPart>
 #include <QNetworkReply>
 #include <QFile>
@@ -311,18 +311,17 @@ MAVLinkLogManager::MAVLinkLogManager(QGCApplication* app, QGCToolbox* toolbox)
     , _publicLog(false)
 {
     //-- Get saved settings
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    setEmailAddress(settings.value(kEmailAddressKey, QString()).toString());
-    setDescription(settings.value(kDescriptionsKey, QString(kDefaultDescr)).toString());
-    setUploadURL(settings.value(kPx4URLKey, QString(kDefaultPx4URL)).toString());
-    setVideoURL(settings.value(kVideoURLKey, QString()).toString());
-    setEnableAutoUpload(settings.value(kEnableAutoUploadKey, true).toBool());
-    setEnableAutoStart(settings.value(kEnableAutoStartKey, false).toBool());
-    setDeleteAfterUpload(settings.value(kEnableDeletetKey, false).toBool());
-    setWindSpeed(settings.value(kWindSpeedKey, -1).toInt());
-    setRating(settings.value(kRateKey, "notset").toString());
-    setPublicLog(settings.value(kPublicLogKey, true).toBool());
+    SettingsStore* settings = SettingsStore::instance();
+    setEmailAddress(settings->value(kMAVLinkLogGroup, kEmailAddressKey, QString()).toString());
+    setDescription(settings->value(kMAVLinkLogGroup, kDescriptionsKey, QString(kDefaultDescr)).toString());
+    setUploadURL(settings->value(kMAVLinkLogGroup, kPx4URLKey, QString(kDefaultPx4URL)).toString());
+    setVideoURL(settings->value(kMAVLinkLogGroup, kVideoURLKey, QString()).toString());
+    setEnableAutoUpload(settings->value(kMAVLinkLogGroup, kEnableAutoUploadKey, true).toBool());
+    setEnableAutoStart(settings->value(kMAVLinkLogGroup, kEnableAutoStartKey, false).toBool());
+    setDeleteAfterUpload(settings->value(kMAVLinkLogGroup, kEnableDeletetKey, false).toBool());
+    setWindSpeed(settings->value(kMAVLinkLogGroup, kWindSpeedKey, -1).toInt());
+    setRating(settings->value(kMAVLinkLogGroup, kRateKey, "notset").toString());
+    setPublicLog(settings->value(kMAVLinkLogGroup, kPublicLogKey, true).toBool());
 }
 
 //-----------------------------------------------------------------------------
@@ -366,9 +365,7 @@ void
 MAVLinkLogManager::setEmailAddress(QString email)
 {
     _emailAddress = email;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kEmailAddressKey, email);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kEmailAddressKey, email);
     emit emailAddressChanged();
 }
 
@@ -377,9 +374,7 @@ void
 MAVLinkLogManager::setDescription(QString description)
 {
     _description = description;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kDescriptionsKey, description);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kDescriptionsKey, description);
     emit descriptionChanged();
 }
 
@@ -391,9 +386,7 @@ MAVLinkLogManager::setUploadURL(QString url)
     if(_uploadURL.isEmpty()) {
         _uploadURL = kDefaultPx4URL;
     }
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kPx4URLKey, _uploadURL);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kPx4URLKey, _uploadURL);
     emit uploadURLChanged();
 }
 
@@ -410,9 +403,7 @@ void
 MAVLinkLogManager::setVideoURL(QString url)
 {
     _videoURL = url;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kVideoURLKey, url);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kVideoURLKey, url);
     emit videoURLChanged();
 }
 
@@ -421,9 +412,7 @@ void
 MAVLinkLogManager::setEnableAutoUpload(bool enable)
 {
     _enableAutoUpload = enable;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kEnableAutoUploadKey, enable);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kEnableAutoUploadKey, enable);
     emit enableAutoUploadChanged();
 }
 
@@ -432,9 +421,7 @@ void
 MAVLinkLogManager::setEnableAutoStart(bool enable)
 {
     _enableAutoStart = enable;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kEnableAutoStartKey, enable);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kEnableAutoStartKey, enable);
     emit enableAutoStartChanged();
 }
 
@@ -443,9 +430,7 @@ void
 MAVLinkLogManager::setDeleteAfterUpload(bool enable)
 {
     _deleteAfterUpload = enable;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kEnableDeletetKey, enable);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kEnableDeletetKey, enable);
     emit deleteAfterUploadChanged();
 }
 
@@ -454,9 +439,7 @@ void
 MAVLinkLogManager::setWindSpeed(int speed)
 {
     _windSpeed = speed;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kWindSpeedKey, speed);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kWindSpeedKey, speed);
     emit windSpeedChanged();
 }
 
@@ -465,9 +448,7 @@ void
 MAVLinkLogManager::setRating(QString rate)
 {
     _rating = rate;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kRateKey, rate);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kRateKey, rate);
     emit ratingChanged();
 }
 
@@ -476,9 +457,7 @@ void
 MAVLinkLogManager::setPublicLog(bool pub)
 {
     _publicLog = pub;
-    QSettings settings;
-    settings.beginGroup(kMAVLinkLogGroup);
-    settings.setValue(kPublicLogKey, pub);
+    SettingsStore::instance()->setValue(kMAVLinkLogGroup, kPublicLogKey, pub);
     emit publicLogChanged();
 }
 
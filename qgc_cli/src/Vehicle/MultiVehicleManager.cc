@@ -16,6 +16,7 @@
 #include "QGroundControlQmlGlobal.h"
 #include "ParameterManager.h"
 #include "SettingsManager.h"
+#include "SettingsStore.h"
 //#include "QGCCorePlugin.h"
 //#include "QGCOptions.h"
 
@@ -35,18 +36,17 @@ MultiVehicleManager::MultiVehicleManager(QGCApplication* app, QGCToolbox* toolbo
     , _parameterReadyVehicleAvailable(false)
     , _activeVehicle(NULL)
     , _offlineEditingVehicle(NULL)
+    , _maxVehicles(_defaultMaxVehicles)
     , _firmwarePluginManager(NULL)
     , _joystickManager(NULL)
     , _mavlinkProtocol(NULL)
     , _gcsHeartbeatEnabled(true)
 {
-    QSettings settings;
-
-    _gcsHeartbeatEnabled = settings.value(_gcsHeartbeatEnabledKey, true).toBool();
+    _gcsHeartbeatEnabled = SettingsStore::instance()->value(QString(), _gcsHeartbeatEnabledKey, true).toBool();
 
     _gcsHeartbeatTimer.setInterval(_gcsHeartbeatRateMSecs);
     _gcsHeartbeatTimer.setSingleShot(false);
-    connect(&_gcsHeartbeatTimer, &QTimer::timeout, this, &MultiVehicleManager::_sendGCSHeartbeat);
+    connect(&_gcsHeartbeatTimer, &QGCTimer::timeout, this, &MultiVehicleManager::_sendGCSHeartbeat);
     if (_gcsHeartbeatEnabled) {
         _gcsHeartbeatTimer.start();
     }
@@ -88,11 +88,12 @@ void MultiVehicleManager::_vehicleHeartbeatInfo(LinkInterface* link, int vehicle
         return;
     }
 
-//    if (_vehicles.count() > 0 && !qgcApp()->toolbox()->corePlugin()->options()->multiVehicleEnabled()) {
-    if (_vehicles.count() >= MAVLINK_COMM_NUM_BUFFERS) {
+    if (_ignoreVehicleIds.contains(vehicleId) || getVehicleById(vehicleId) || vehicleId == 0) {
         return;
     }
-    if (_ignoreVehicleIds.contains(vehicleId) || getVehicleById(vehicleId) || vehicleId == 0) {
+//    if (_vehicles.count() > 0 && !qgcApp()->toolbox()->corePlugin()->options()->multiVehicleEnabled()) {
+    if (_vehicles.count() >= _maxVehicles) {
+        qCDebug(MultiVehicleManagerLog()) << "Ignoring heartbeat, vehicle limit reached" << _maxVehicles << vehicleId;
         return;
     }
 
@@ -300,14 +301,12 @@ void MultiVehicleManager::_vehicleParametersReadyChanged(bool parametersReady)
 
 void MultiVehicleManager::saveSetting(const QString &name, const QString& value)
 {
-    QSettings settings;
-    settings.setValue(name, value);
+    SettingsStore::instance()->setValue(QString(), name, value);
 }
 
 QString MultiVehicleManager::loadSetting(const QString &name, const QString& defaultValue)
 {
-    QSettings settings;
-    return settings.value(name, defaultValue).toString();
+    return SettingsStore::instance()->value(QString(), name, defaultValue).toString();
 }
 
 Vehicle* MultiVehicleManager::getVehicleById(int vehicleId)
@@ -328,8 +327,7 @@ void MultiVehicleManager::setGcsHeartbeatEnabled(bool gcsHeartBeatEnabled)
         _gcsHeartbeatEnabled = gcsHeartBeatEnabled;
         emit gcsHeartBeatEnabledChanged(gcsHeartBeatEnabled);
 
-        QSettings settings;
-        settings.setValue(_gcsHeartbeatEnabledKey, gcsHeartBeatEnabled);
+        SettingsStore::instance()->setValue(QString(), _gcsHeartbeatEnabledKey, gcsHeartBeatEnabled);
 
         if (gcsHeartBeatEnabled) {
             _gcsHeartbeatTimer.start();
@@ -360,7 +358,7 @@ void MultiVehicleManager::_sendGCSHeartbeat(void)
             uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
             int len = mavlink_msg_to_send_buffer(buffer, &message);
 
-            link->writeBytesSafe((const char*)buffer, len);
+            link->writeFramesSafe((const char*)buffer, len, 1);
         }
     }
 }
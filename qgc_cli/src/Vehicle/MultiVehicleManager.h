@@ -19,6 +19,7 @@
 #include "QmlObjectListModel.h"
 #include "QGCToolbox.h"
 #include "QGCLoggingCategory.h"
+#include "QGCClock.h"
 
 class FirmwarePluginManager;
 class FollowMe;
@@ -69,6 +70,10 @@ public:
 
     Vehicle* offlineEditingVehicle(void) { return _offlineEditingVehicle; }
 
+    /// Maximum number of vehicles which will be created. Heartbeats from further vehicles are ignored.
+    int  maxVehicles   (void) const { return _maxVehicles; }
+    void setMaxVehicles(int maxVehicles) { _maxVehicles = maxVehicles; }
+
     /// Determines if the link is in use by a Vehicle
     ///     @param link Link to test against
     ///     @param skipVehicle Don't consider this Vehicle as part of the test
@@ -108,6 +113,7 @@ private:
     Vehicle*        _vehicleBeingSetActive;         ///< Vehicle being set active in queued phases
 
     QList<int>  _ignoreVehicleIds;          ///< List of vehicle id for which we ignore further communication
+    int         _maxVehicles;
 
     QmlObjectListModel  _vehicles;
 
@@ -115,9 +121,10 @@ private:
     JoystickManager*            _joystickManager;
     MAVLinkProtocol*            _mavlinkProtocol;
 
-    QTimer              _gcsHeartbeatTimer;             ///< Timer to emit heartbeats
+    QGCTimer            _gcsHeartbeatTimer;             ///< Timer to emit heartbeats
     bool                _gcsHeartbeatEnabled;           ///< Enabled/disable heartbeat emission
     static const int    _gcsHeartbeatRateMSecs = 1000;  ///< Heartbeat rate
+    static const int    _defaultMaxVehicles = 254;      ///< All valid mavlink system ids other than our own
     static const char*  _gcsHeartbeatEnabledKey;
 };
 
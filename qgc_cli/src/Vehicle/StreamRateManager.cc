@@ -0,0 +1,438 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "StreamRateManager.h"
+#include "Vehicle.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtMath>
+
+QGC_LOGGING_CATEGORY(StreamRateManagerLog, "StreamRateManagerLog")
+
+/// Members of the ArduPilot stream groups. Whatever is in here and not subscribed is turned off while the manager is
+/// active. Messages which only go out on request, like HOME_POSITION, are left alone.
+const StreamRateManager::StreamMessage_t StreamRateManager::_rgStreamMessages[] = {
+    { MAV_DATA_STREAM_RAW_SENSORS,      MAVLINK_MSG_ID_RAW_IMU },
+    { MAV_DATA_STREAM_RAW_SENSORS,      MAVLINK_MSG_ID_SCALED_IMU2 },
+    { MAV_DATA_STREAM_RAW_SENSORS,      MAVLINK_MSG_ID_SCALED_IMU3 },
+    { MAV_DATA_STREAM_RAW_SENSORS,      MAVLINK_MSG_ID_SCALED_PRESSURE },
+    { MAV_DATA_STREAM_RAW_SENSORS,      MAVLINK_MSG_ID_SCALED_PRESSURE2 },
+    { MAV_DATA_STREAM_RAW_SENSORS,      MAVLINK_MSG_ID_SCALED_PRESSURE3 },
+    { MAV_DATA_STREAM_RAW_SENSORS,      MAVLINK_MSG_ID_SENSOR_OFFSETS },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_SYS_STATUS },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_POWER_STATUS },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_MEMINFO },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_MISSION_CURRENT },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_GPS_RAW_INT },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_GPS_RTK },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_GPS2_RAW },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_NAV_CONTROLLER_OUTPUT },
+    { MAV_DATA_STREAM_EXTENDED_STATUS,  MAVLINK_MSG_ID_FENCE_STATUS },
+    { MAV_DATA_STREAM_RC_CHANNELS,      MAVLINK_MSG_ID_SERVO_OUTPUT_RAW },
+    { MAV_DATA_STREAM_RC_CHANNELS,      MAVLINK_MSG_ID_RC_CHANNELS_RAW },
+    { MAV_DATA_STREAM_RC_CHANNELS,      MAVLINK_MSG_ID_RC_CHANNELS },
+    { MAV_DATA_STREAM_POSITION,         MAVLINK_MSG_ID_GLOBAL_POSITION_INT },
+    { MAV_DATA_STREAM_POSITION,         MAVLINK_MSG_ID_LOCAL_POSITION_NED },
+    { MAV_DATA_STREAM_EXTRA1,           MAVLINK_MSG_ID_ATTITUDE },
+    { MAV_DATA_STREAM_EXTRA1,           MAVLINK_MSG_ID_SIMSTATE },
+    { MAV_DATA_STREAM_EXTRA1,           MAVLINK_MSG_ID_PID_TUNING },
+    { MAV_DATA_STREAM_EXTRA2,           MAVLINK_MSG_ID_VFR_HUD },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_AHRS },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_AHRS2 },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_AHRS3 },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_HWSTATUS },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_SYSTEM_TIME },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_RANGEFINDER },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_DISTANCE_SENSOR },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_BATTERY2 },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_MOUNT_STATUS },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_OPTICAL_FLOW },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_EKF_STATUS_REPORT },
+    { MAV_DATA_STREAM_EXTRA3,           MAVLINK_MSG_ID_VIBRATION },
+};
+
+const int StreamRateManager::_streamMessageCount = sizeof(_rgStreamMessages) / sizeof(_rgStreamMessages[0]);
+
+/// Stream groups in the order the firmware plugin requests them
+static const MAV_DATA_STREAM _rgStreams[] = {
+    MAV_DATA_STREAM_RAW_SENSORS,
+    MAV_DATA_STREAM_EXTENDED_STATUS,
+    MAV_DATA_STREAM_RC_CHANNELS,
+    MAV_DATA_STREAM_POSITION,
+    MAV_DATA_STREAM_EXTRA1,
+    MAV_DATA_STREAM_EXTRA2,
+    MAV_DATA_STREAM_EXTRA3,
+};
+
+static const int _streamCount = sizeof(_rgStreams) / sizeof(_rgStreams[0]);
+
+StreamRateManager::StreamRateManager(Vehicle* vehicle)
+    : QObject(vehicle)
+    , _vehicle(vehicle)
+    , _mode(ModeProbe)
+    , _probePending(false)
+    , _intervalPending(false)
+    , _pendingMsgId(-1)
+    , _pendingInterval(0)
+    , _lastBootMSecs(-1)
+{
+    _applyTimer.setSingleShot(true);
+    _applyTimer.setInterval(applyDelayMSecs);
+    connect(&_applyTimer, &QGCTimer::timeout, this, &StreamRateManager::_apply);
+
+    connect(_vehicle, &Vehicle::mavCommandResult,        this, &StreamRateManager::_mavCommandResult);
+    connect(_vehicle, &Vehicle::connectionLostChanged,   this, &StreamRateManager::_connectionLostChanged);
+    connect(_vehicle, &Vehicle::mavlinkMessageReceived,  this, &StreamRateManager::_mavlinkMessageReceived);
+}
+
+void StreamRateManager::subscribe(QObject* owner, int msgId, float rateHz)
+{
+    if (rateHz <= 0) {
+        unsubscribe(owner, msgId);
+        return;
+    }
+
+    _subscriptions[msgId][owner] = rateHz;
+
+    if (!_owners.contains(owner)) {
+        _owners.insert(owner);
+        connect(owner, &QObject::destroyed, this, &StreamRateManager::_ownerDestroyed);
+    }
+
+    _scheduleApply();
+}
+
+void StreamRateManager::unsubscribe(QObject* owner, int msgId)
+{
+    if (!_subscriptions.contains(msgId)) {
+        return;
+    }
+
+    QMap<QObject*, float>& rates = _subscriptions[msgId];
+    if (rates.remove(owner)) {
+        if (rates.isEmpty()) {
+            _subscriptions.remove(msgId);
+        }
+        _scheduleApply();
+    }
+}
+
+void StreamRateManager::unsubscribeAll(QObject* owner)
+{
+    if (!_owners.remove(owner)) {
+        return;
+    }
+    disconnect(owner, &QObject::destroyed, this, &StreamRateManager::_ownerDestroyed);
+
+    _removeSubscriptions(owner);
+}
+
+void StreamRateManager::_ownerDestroyed(QObject* owner)
+{
+    // The owner may be gone already when it lived on another thread, so it is only used as a key
+    if (_owners.remove(owner)) {
+        _removeSubscriptions(owner);
+    }
+}
+
+void StreamRateManager::_removeSubscriptions(QObject* owner)
+{
+    QMutableMapIterator<int, QMap<QObject*, float> > iter(_subscriptions);
+    while (iter.hasNext()) {
+        iter.next();
+        iter.value().remove(owner);
+        if (iter.value().isEmpty()) {
+            iter.remove();
+        }
+    }
+
+    _scheduleApply();
+}
+
+float StreamRateManager::rate(int msgId) const
+{
+    float maxRate = 0;
+
+    if (_subscriptions.contains(msgId)) {
+        foreach (float rate, _subscriptions[msgId]) {
+            maxRate = qMax(maxRate, rate);
+        }
+    }
+
+    return maxRate;
+}
+
+qint32 StreamRateManager::messageInterval(int msgId) const
+{
+    if (!active()) {
+        return 0;
+    }
+
+    float msgRate = rate(msgId);
+    if (msgRate > 0) {
+        return qMax(1, qRound(1000000.0f / msgRate));
+    }
+
+    for (int i=0; i<_streamMessageCount; i++) {
+        if (_rgStreamMessages[i].msgId == msgId) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int StreamRateManager::streamRate(MAV_DATA_STREAM stream) const
+{
+    if (!active()) {
+        return -1;
+    }
+
+    float maxRate = 0;
+    for (int i=0; i<_streamMessageCount; i++) {
+        if (_rgStreamMessages[i].stream == stream) {
+            maxRate = qMax(maxRate, rate(_rgStreamMessages[i].msgId));
+        }
+    }
+
+    return qCeil(maxRate);
+}
+
+void StreamRateManager::_scheduleApply(void)
+{
+    if (!_applyTimer.isActive()) {
+        _applyTimer.start();
+    }
+}
+
+void StreamRateManager::_apply(void)
+{
+    if (_mode == ModeLegacy) {
+        _applyLegacy();
+    } else {
+        _applyIntervals();
+    }
+}
+
+void StreamRateManager::_applyIntervals(void)
+{
+    if (_intervalPending) {
+        // Applied again once the vehicle answered the pending command
+        return;
+    }
+
+    // Stream messages and subscriptions, and whatever was set before in case it needs to go back to the default
+    QMap<int, qint32> intervals;
+    for (int i=0; i<_streamMessageCount; i++) {
+        intervals[_rgStreamMessages[i].msgId] = messageInterval(_rgStreamMessages[i].msgId);
+    }
+    foreach (int msgId, _subscriptions.keys()) {
+        intervals[msgId] = messageInterval(msgId);
+    }
+    foreach (int msgId, _sentIntervals.keys()) {
+        intervals[msgId] = messageInterval(msgId);
+    }
+
+    bool cancelled = false;
+
+    QMapIterator<int, qint32> iter(intervals);
+    while (iter.hasNext()) {
+        iter.next();
+
+        int     msgId = iter.key();
+        qint32  interval = iter.value();
+
+        // Nothing to send for messages the manager never set and does not set now, or the vehicle did not accept
+        if (_sentIntervals.value(msgId, 0) == interval || (_failedIntervals.contains(msgId) && _failedIntervals[msgId] == interval)) {
+            continue;
+        }
+
+        // Stream requests of the firmware plugin which are still being repeated would undo the intervals
+        if (!cancelled && active()) {
+            _vehicle->cancelMessageMultiple(MAVLINK_MSG_ID_REQUEST_DATA_STREAM);
+            cancelled = true;
+        }
+
+        // One command at a time, the next one goes out with the result of this one. The first one is the probe, until
+        // it is known whether the vehicle supports them at all.
+        _probePending = _mode == ModeProbe;
+        _sendInterval(msgId, interval);
+        return;
+    }
+}
+
+void StreamRateManager::_sendInterval(int msgId, qint32 interval)
+{
+    qCDebug(StreamRateManagerLog) << "Message interval" << _vehicle->id() << msgId << interval;
+
+    _intervalPending = true;
+    _pendingMsgId = msgId;
+    _pendingInterval = interval;
+
+    _vehicle->sendMavCommand(_vehicle->defaultComponentId(),
+                             MAV_CMD_SET_MESSAGE_INTERVAL,
+                             false,                             // No error shown if fails
+                             msgId,
+                             interval);
+}
+
+void StreamRateManager::_applyLegacy(void)
+{
+    bool restore = !active();
+    if (restore && _sentStreamRates.isEmpty()) {
+        return;
+    }
+
+    int rgRates[_streamCount];
+    bool changed = restore;
+    for (int i=0; i<_streamCount; i++) {
+        rgRates[i] = restore ? _legacyDefaultRate(_rgStreams[i]) : streamRate(_rgStreams[i]);
+        if (_sentStreamRates.value(_rgStreams[i], -1) != rgRates[i]) {
+            changed = true;
+        }
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    // All groups go out again in place of whatever stream requests are still being repeated
+    _vehicle->cancelMessageMultiple(MAVLINK_MSG_ID_REQUEST_DATA_STREAM);
+    _sentStreamRates.clear();
+
+    for (int i=0; i<_streamCount; i++) {
+        qCDebug(StreamRateManagerLog) << "Stream rate" << _vehicle->id() << _rgStreams[i] << rgRates[i];
+
+        _vehicle->requestDataStream(_rgStreams[i], rgRates[i]);
+        if (!restore) {
+            _sentStreamRates[_rgStreams[i]] = rgRates[i];
+        }
+    }
+}
+
+void StreamRateManager::_mavCommandResult(int vehicleId, int component, int command, int result, bool noResponse)
+{
+    Q_UNUSED(component);
+
+    if (vehicleId != _vehicle->id() || command != MAV_CMD_SET_MESSAGE_INTERVAL) {
+        return;
+    }
+
+    if (!_intervalPending) {
+        return;
+    }
+    _intervalPending = false;
+
+    if (_probePending) {
+        _probePending = false;
+
+        if (result != MAV_RESULT_ACCEPTED) {
+            qCDebug(StreamRateManagerLog) << "Vehicle did not accept MAV_CMD_SET_MESSAGE_INTERVAL, using stream groups" << vehicleId << result << noResponse;
+            _mode = ModeLegacy;
+            _sentIntervals.clear();
+            _apply();
+            return;
+        }
+        _mode = ModeInterval;
+    }
+
+    if (_pendingMsgId >= 0) {
+        if (result == MAV_RESULT_ACCEPTED) {
+            if (_pendingInterval == 0) {
+                _sentIntervals.remove(_pendingMsgId);
+            } else {
+                _sentIntervals[_pendingMsgId] = _pendingInterval;
+            }
+            _failedIntervals.remove(_pendingMsgId);
+        } else {
+            qCDebug(StreamRateManagerLog) << "MAV_CMD_SET_MESSAGE_INTERVAL failed" << vehicleId << _pendingMsgId << result << noResponse;
+            _failedIntervals[_pendingMsgId] = _pendingInterval;
+        }
+    }
+
+    _apply();
+}
+
+void StreamRateManager::_connectionLostChanged(bool connectionLost)
+{
+    if (!connectionLost) {
+        // The vehicle may have rebooted while it was not heard
+        _resendAll();
+    }
+}
+
+void StreamRateManager::_mavlinkMessageReceived(const mavlink_message_t& message)
+{
+    if (message.compid != _vehicle->defaultComponentId()) {
+        return;
+    }
+
+    qint64 bootMSecs;
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_GLOBAL_POSITION_INT:
+        bootMSecs = mavlink_msg_global_position_int_get_time_boot_ms(&message);
+        break;
+    case MAVLINK_MSG_ID_ATTITUDE:
+        bootMSecs = mavlink_msg_attitude_get_time_boot_ms(&message);
+        break;
+    case MAVLINK_MSG_ID_SYSTEM_TIME:
+        bootMSecs = mavlink_msg_system_time_get_time_boot_ms(&message);
+        break;
+    default:
+        return;
+    }
+
+    if (_lastBootMSecs - bootMSecs > rebootSlackMSecs) {
+        // A rebooted vehicle is back to its own rates
+        qCDebug(StreamRateManagerLog) << "Vehicle rebooted" << _vehicle->id() << _lastBootMSecs << bootMSecs;
+        _lastBootMSecs = bootMSecs;
+        _resendAll();
+    } else {
+        _lastBootMSecs = qMax(_lastBootMSecs, bootMSecs);
+    }
+}
+
+/// Marks what the vehicle was sent as unknown, so all rates the manager set or sets now go out again
+void StreamRateManager::_resendAll(void)
+{
+    foreach (int msgId, _sentIntervals.keys()) {
+        _sentIntervals[msgId] = _rateUnknown;
+    }
+    foreach (int stream, _sentStreamRates.keys()) {
+        _sentStreamRates[stream] = _rateUnknown;
+    }
+    _failedIntervals.clear();
+
+    // The result of a command still pending may be from before the reboot
+    _pendingMsgId = -1;
+
+    _scheduleApply();
+}
+
+int StreamRateManager::_legacyDefaultRate(MAV_DATA_STREAM stream)
+{
+    switch (stream) {
+    case MAV_DATA_STREAM_RAW_SENSORS:
+        return MAV_DATA_STREAM_RAW_SENSORS_RATE;
+    case MAV_DATA_STREAM_EXTENDED_STATUS:
+        return MAV_DATA_STREAM_EXTENDED_STATUS_RATE;
+    case MAV_DATA_STREAM_RC_CHANNELS:
+        return MAV_DATA_STREAM_RC_CHANNELS_RATE;
+    case MAV_DATA_STREAM_POSITION:
+        return MAV_DATA_STREAM_POSITION_RATE;
+    case MAV_DATA_STREAM_EXTRA1:
+        return MAV_DATA_STREAM_EXTRA1_RATE;
+    case MAV_DATA_STREAM_EXTRA2:
+        return MAV_DATA_STREAM_EXTRA2_RATE;
+    case MAV_DATA_STREAM_EXTRA3:
+        return MAV_DATA_STREAM_EXTRA3_RATE;
+    default:
+        return 0;
+    }
+}
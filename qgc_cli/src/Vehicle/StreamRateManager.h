@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QMap>
+#include <QSet>
+#include <QLoggingCategory>
+
+#include "QGCMAVLink.h"
+#include "QGCClock.h"
+
+Q_DECLARE_LOGGING_CATEGORY(StreamRateManagerLog)
+
+class Vehicle;
+
+/// Negotiates the telemetry rates of a vehicle from what its components actually consume. Components subscribe to the
+/// messages they read with the rate they need, the manager then asks the vehicle for the highest rate of each message
+/// and turns off the stream messages nobody subscribed to, so they cost neither link bandwidth nor parsing.
+///
+/// While there are no subscriptions the manager stays out of the way and the firmware plugin's stream setup applies.
+/// Rates are set per message with MAV_CMD_SET_MESSAGE_INTERVAL, one command at a time so other commands are not held up
+/// behind them. The first command is a probe: if the vehicle does not accept it, the manager falls back to
+/// REQUEST_DATA_STREAM and sets each stream group to the highest rate subscribed within it, turning off the groups
+/// without subscriptions. Everything is sent again when the connection comes back or the vehicle rebooted.
+class StreamRateManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    StreamRateManager(Vehicle* vehicle);
+
+    /// Subscribes owner to msgId at rateHz, replacing a previous rate of owner for msgId. The subscriptions go away with
+    /// owner, which may live on another thread. Must be called on the vehicle's thread. Changes are sent to the vehicle
+    /// together, after applyDelayMSecs.
+    void subscribe(QObject* owner, int msgId, float rateHz);
+
+    void unsubscribe    (QObject* owner, int msgId);
+    void unsubscribeAll (QObject* owner);
+
+    /// @return true: there are subscriptions, the manager sets the rates
+    bool active(void) const { return !_subscriptions.isEmpty(); }
+
+    /// @return true: the vehicle did not accept MAV_CMD_SET_MESSAGE_INTERVAL, stream groups are used instead
+    bool legacy(void) const { return _mode == ModeLegacy; }
+
+    /// @return Highest subscribed rate of msgId in Hz, 0 if nobody subscribed to it
+    float rate(int msgId) const;
+
+    /// @return Interval of msgId in us as sent with MAV_CMD_SET_MESSAGE_INTERVAL: -1 to turn the message off, 0 for the
+    ///         firmware default when the manager does not set the rate of msgId
+    qint32 messageInterval(int msgId) const;
+
+    /// @return Rate in Hz of the stream group as sent with REQUEST_DATA_STREAM, 0 to turn the group off, -1 when the
+    ///         manager does not set the rate of the group
+    int streamRate(MAV_DATA_STREAM stream) const;
+
+    static const int applyDelayMSecs = 200;
+
+    /// A time since boot which goes back by more than this means the vehicle rebooted
+    static const qint64 rebootSlackMSecs = 1000;
+
+private slots:
+    void _apply             (void);
+    void _mavCommandResult  (int vehicleId, int component, int command, int result, bool noResponse);
+    void _ownerDestroyed    (QObject* owner);
+    void _connectionLostChanged     (bool connectionLost);
+    void _mavlinkMessageReceived    (const mavlink_message_t& message);
+
+private:
+    typedef enum {
+        ModeProbe,      ///< Support for MAV_CMD_SET_MESSAGE_INTERVAL is not known yet
+        ModeInterval,
+        ModeLegacy
+    } Mode_t;
+
+    typedef struct {
+        MAV_DATA_STREAM stream;
+        int             msgId;
+    } StreamMessage_t;
+
+    void _removeSubscriptions(QObject* owner);
+    void _scheduleApply     (void);
+    void _applyIntervals    (void);
+    void _applyLegacy       (void);
+    void _sendInterval      (int msgId, qint32 interval);
+    void _resendAll         (void);
+
+    static int _legacyDefaultRate(MAV_DATA_STREAM stream);
+
+    static const int _rateUnknown = -2;     ///< Sent interval or stream rate which matches nothing, so it goes out again
+
+    Vehicle*                        _vehicle;
+    Mode_t                          _mode;
+    bool                            _probePending;
+    bool                            _intervalPending;   ///< MAV_CMD_SET_MESSAGE_INTERVAL waiting for its result
+    int                             _pendingMsgId;      ///< msgId of the pending command, -1 when its result is stale
+    qint32                          _pendingInterval;
+    QMap<int, QMap<QObject*, float> > _subscriptions;   ///< Rates in Hz by owner, by msgId
+    QSet<QObject*>                  _owners;
+    QMap<int, qint32>               _sentIntervals;     ///< Last interval the vehicle accepted by msgId
+    QMap<int, qint32>               _failedIntervals;   ///< Interval the vehicle did not accept by msgId, not sent again
+    QMap<int, int>                  _sentStreamRates;   ///< Last rate sent by MAV_DATA_STREAM
+    qint64                          _lastBootMSecs;     ///< Highest time since boot heard from the vehicle, -1 for none
+    QGCTimer                        _applyTimer;
+
+    static const StreamMessage_t    _rgStreamMessages[];
+    static const int                _streamMessageCount;
+};
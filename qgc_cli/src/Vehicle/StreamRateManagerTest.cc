@@ -0,0 +1,102 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "StreamRateManagerTest.h"
+#include "StreamRateManager.h"
+#include "MockLink.h"
+
+void StreamRateManagerTest::_subscriptionRates(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_ARDUPILOTMEGA);
+
+    StreamRateManager* manager = _vehicle->streamRateManager();
+    QVERIFY(manager);
+
+    // Nothing is managed without subscriptions
+    QCOMPARE(manager->active(), false);
+    QCOMPARE(manager->messageInterval(MAVLINK_MSG_ID_VIBRATION), 0);
+    QCOMPARE(manager->streamRate(MAV_DATA_STREAM_POSITION), -1);
+
+    QObject     ownerA;
+    QObject*    ownerB = new QObject;
+
+    // The highest rate of a message wins
+    manager->subscribe(&ownerA, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 2);
+    manager->subscribe(ownerB, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 10);
+    QCOMPARE(manager->active(), true);
+    QCOMPARE(manager->rate(MAVLINK_MSG_ID_GLOBAL_POSITION_INT), 10.0f);
+    QCOMPARE(manager->messageInterval(MAVLINK_MSG_ID_GLOBAL_POSITION_INT), 100000);
+
+    // Stream messages nobody subscribed to are turned off, others are left alone
+    QCOMPARE(manager->messageInterval(MAVLINK_MSG_ID_VIBRATION), -1);
+    QCOMPARE(manager->messageInterval(MAVLINK_MSG_ID_RC_CHANNELS), -1);
+    QCOMPARE(manager->messageInterval(MAVLINK_MSG_ID_HEARTBEAT), 0);
+
+    // Stream groups get the highest rate within them, rounded up
+    manager->subscribe(ownerB, MAVLINK_MSG_ID_SYS_STATUS, 0.5f);
+    QCOMPARE(manager->streamRate(MAV_DATA_STREAM_POSITION), 10);
+    QCOMPARE(manager->streamRate(MAV_DATA_STREAM_EXTENDED_STATUS), 1);
+    QCOMPARE(manager->streamRate(MAV_DATA_STREAM_RC_CHANNELS), 0);
+    QCOMPARE(manager->streamRate(MAV_DATA_STREAM_EXTRA3), 0);
+
+    manager->unsubscribe(ownerB, MAVLINK_MSG_ID_GLOBAL_POSITION_INT);
+    QCOMPARE(manager->messageInterval(MAVLINK_MSG_ID_GLOBAL_POSITION_INT), 500000);
+
+    // Subscriptions go away with their owner
+    delete ownerB;
+    QCOMPARE(manager->rate(MAVLINK_MSG_ID_SYS_STATUS), 0.0f);
+    QCOMPARE(manager->messageInterval(MAVLINK_MSG_ID_SYS_STATUS), -1);
+
+    manager->unsubscribeAll(&ownerA);
+    QCOMPARE(manager->active(), false);
+    QCOMPARE(manager->messageInterval(MAVLINK_MSG_ID_GLOBAL_POSITION_INT), 0);
+}
+
+void StreamRateManagerTest::_messageIntervals(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_ARDUPILOTMEGA);
+
+    StreamRateManager*  manager = _vehicle->streamRateManager();
+    QObject             owner;
+
+    manager->subscribe(&owner, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 10);
+    manager->subscribe(&owner, MAVLINK_MSG_ID_SYS_STATUS, 1);
+
+    // MockLink accepts MAV_CMD_SET_MESSAGE_INTERVAL, so the probe goes through and the rest follows
+    QTRY_COMPARE_WITH_TIMEOUT(_mockLink->messageInterval(MAVLINK_MSG_ID_VIBRATION), -1, 10000);
+    QCOMPARE(manager->legacy(), false);
+    QCOMPARE(_mockLink->messageInterval(MAVLINK_MSG_ID_GLOBAL_POSITION_INT), 100000);
+    QCOMPARE(_mockLink->messageInterval(MAVLINK_MSG_ID_SYS_STATUS), 1000000);
+    QCOMPARE(_mockLink->messageInterval(MAVLINK_MSG_ID_ATTITUDE), -1);
+
+    // Without subscriptions everything goes back to the firmware defaults
+    manager->unsubscribeAll(&owner);
+    QTRY_COMPARE_WITH_TIMEOUT(_mockLink->messageInterval(MAVLINK_MSG_ID_VIBRATION), 0, 10000);
+    QTRY_COMPARE_WITH_TIMEOUT(_mockLink->messageInterval(MAVLINK_MSG_ID_GLOBAL_POSITION_INT), 0, 10000);
+}
+
+void StreamRateManagerTest::_reboot(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_ARDUPILOTMEGA);
+
+    StreamRateManager*  manager = _vehicle->streamRateManager();
+    QObject             owner;
+
+    manager->subscribe(&owner, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 10);
+    QTRY_COMPARE_WITH_TIMEOUT(_mockLink->messageInterval(MAVLINK_MSG_ID_VIBRATION), -1, 10000);
+
+    // The rebooted vehicle is back to its defaults until the time since boot going back tells the manager
+    QTRY_VERIFY_WITH_TIMEOUT(QGCClock::instance()->elapsed() > 2 * StreamRateManager::rebootSlackMSecs, 10000);
+    _mockLink->simulateReboot();
+    QCOMPARE(_mockLink->messageInterval(MAVLINK_MSG_ID_VIBRATION), 0);
+
+    QTRY_COMPARE_WITH_TIMEOUT(_mockLink->messageInterval(MAVLINK_MSG_ID_VIBRATION), -1, 10000);
+    QCOMPARE(_mockLink->messageInterval(MAVLINK_MSG_ID_GLOBAL_POSITION_INT), 100000);
+    QCOMPARE(_mockLink->messageInterval(MAVLINK_MSG_ID_ATTITUDE), -1);
+}
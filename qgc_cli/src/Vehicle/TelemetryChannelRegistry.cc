@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryChannelRegistry.h"
+
+TelemetryChannelRegistry::TelemetryChannelRegistry(void)
+    : _nextSubscriptionId(0)
+    , _subscriberCount(0)
+{
+
+}
+
+TelemetryChannelRegistry* TelemetryChannelRegistry::instance(void)
+{
+    static TelemetryChannelRegistry registry;
+    return &registry;
+}
+
+int TelemetryChannelRegistry::registerChannel(const QString& message, const QString& field, const QString& unit)
+{
+    QMutexLocker locker(&_channelMutex);
+
+    QString key = message + QStringLiteral(".") + field;
+    QHash<QString, int>::const_iterator iter = _channelIds.constFind(key);
+    if (iter != _channelIds.constEnd()) {
+        return iter.value();
+    }
+
+    int channel = _channels.count();
+    _channels.append(Channel{ message, field, unit });
+    _channelIds[key] = channel;
+    return channel;
+}
+
+int TelemetryChannelRegistry::channelCount(void) const
+{
+    QMutexLocker locker(&_channelMutex);
+    return _channels.count();
+}
+
+QString TelemetryChannelRegistry::message(int channel) const
+{
+    QMutexLocker locker(&_channelMutex);
+    return channel >= 0 && channel < _channels.count() ? _channels[channel].message : QString();
+}
+
+QString TelemetryChannelRegistry::field(int channel) const
+{
+    QMutexLocker locker(&_channelMutex);
+    return channel >= 0 && channel < _channels.count() ? _channels[channel].field : QString();
+}
+
+QString TelemetryChannelRegistry::unit(int channel) const
+{
+    QMutexLocker locker(&_channelMutex);
+    return channel >= 0 && channel < _channels.count() ? _channels[channel].unit : QString();
+}
+
+QString TelemetryChannelRegistry::name(int channel) const
+{
+    QMutexLocker locker(&_channelMutex);
+    if (channel < 0 || channel >= _channels.count()) {
+        return QString();
+    }
+    const Channel& entry = _channels[channel];
+    return entry.message.isEmpty() ? entry.field : QStringLiteral("%1.%2").arg(entry.message).arg(entry.field);
+}
+
+int TelemetryChannelRegistry::subscribe(Callback callback)
+{
+    QWriteLocker locker(&_subscriberLock);
+    int id = _nextSubscriptionId++;
+    _subscribers.append(Subscriber{ id, callback });
+    _subscriberCount.store(_subscribers.count());
+    return id;
+}
+
+void TelemetryChannelRegistry::unsubscribe(int subscription)
+{
+    QWriteLocker locker(&_subscriberLock);
+    for (int i=0; i<_subscribers.count(); i++) {
+        if (_subscribers[i].id == subscription) {
+            _subscribers.remove(i);
+            break;
+        }
+    }
+    _subscriberCount.store(_subscribers.count());
+}
+
+void TelemetryChannelRegistry::publish(const TelemetrySample* samples, int count)
+{
+    if (count <= 0 || !hasSubscribers()) {
+        return;
+    }
+
+    QReadLocker locker(&_subscriberLock);
+    for (int i=0; i<_subscribers.count(); i++) {
+        _subscribers[i].callback(samples, count);
+    }
+}
@@ -0,0 +1,87 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+
+#include <functional>
+
+/// Numeric telemetry value for a registered channel
+struct TelemetrySample {
+    int     vehicleId;
+    int     channel;    ///< Channel id from TelemetryChannelRegistry::registerChannel
+    double  value;
+    quint64 msecs;      ///< Unix time in milliseconds
+};
+
+/// Process wide registry of telemetry channels. Each (message, field) pair is assigned a small integer id once, samples
+/// are then published by id and the channel name and unit are only looked up when they are actually displayed.
+///
+/// Publishers should check hasSubscribers prior to building samples so there is no cost when nothing is listening.
+/// Subscribers receive all samples from a single message in one batch.
+class TelemetryChannelRegistry
+{
+public:
+    typedef std::function<void(const TelemetrySample* samples, int count)> Callback;
+
+    static TelemetryChannelRegistry* instance(void);
+
+    /// Returns the channel id for the pair, registering it on first use. Safe to call from any thread.
+    ///     @param message Message name, for example "SYS_STATUS". May be empty for derived values.
+    ///     @param field Field name within the message
+    ///     @param unit Display unit
+    int registerChannel(const QString& message, const QString& field, const QString& unit);
+
+    int     channelCount(void) const;
+    QString message     (int channel) const;
+    QString field       (int channel) const;
+    QString unit        (int channel) const;
+
+    /// @return Display name of the channel: "MESSAGE.field", or just field if there is no message
+    QString name(int channel) const;
+
+    /// Adds a subscriber. The callback is called on the publishing thread and must not subscribe or unsubscribe.
+    /// @return Subscription id to pass to unsubscribe
+    int     subscribe   (Callback callback);
+    void    unsubscribe (int subscription);
+
+    bool hasSubscribers(void) const { return _subscriberCount.load() != 0; }
+
+    /// Delivers a batch of samples to all subscribers
+    void publish(const TelemetrySample* samples, int count);
+
+private:
+    TelemetryChannelRegistry(void);
+
+    struct Channel {
+        QString message;
+        QString field;
+        QString unit;
+    };
+
+    struct Subscriber {
+        int         id;
+        Callback    callback;
+    };
+
+    mutable QMutex          _channelMutex;
+    QVector<Channel>        _channels;
+    QHash<QString, int>     _channelIds;    ///< "message.field" to channel id
+
+    QReadWriteLock          _subscriberLock;
+    QVector<Subscriber>     _subscribers;
+    int                     _nextSubscriptionId;
+    QAtomicInt              _subscriberCount;
+};
@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryChannelRegistryTest.h"
+#include "TelemetryChannelRegistry.h"
+#include "MockLink.h"
+
+void TelemetryChannelRegistryTest::_registration(void)
+{
+    TelemetryChannelRegistry* registry = TelemetryChannelRegistry::instance();
+
+    // A pair is registered once, later registrations return the same id
+    int channel = registry->registerChannel("TEST_MESSAGE", "field1", "m");
+    QCOMPARE(registry->registerChannel("TEST_MESSAGE", "field1", "m"), channel);
+    QVERIFY(registry->registerChannel("TEST_MESSAGE", "field2", "m") != channel);
+    QVERIFY(registry->channelCount() > channel);
+
+    QCOMPARE(registry->message(channel), QStringLiteral("TEST_MESSAGE"));
+    QCOMPARE(registry->field(channel), QStringLiteral("field1"));
+    QCOMPARE(registry->unit(channel), QStringLiteral("m"));
+    QCOMPARE(registry->name(channel), QStringLiteral("TEST_MESSAGE.field1"));
+
+    // Derived values have no message
+    int derived = registry->registerChannel(QString(), "test derived", "rad");
+    QCOMPARE(registry->name(derived), QStringLiteral("test derived"));
+
+    // Unknown ids have no name
+    QCOMPARE(registry->name(-1), QString());
+    QCOMPARE(registry->unit(registry->channelCount()), QString());
+}
+
+void TelemetryChannelRegistryTest::_subscriptions(void)
+{
+    TelemetryChannelRegistry*   registry = TelemetryChannelRegistry::instance();
+    int                         channel = registry->registerChannel("TEST_MESSAGE", "field1", "m");
+    QList<TelemetrySample>      received;
+
+    QCOMPARE(registry->hasSubscribers(), false);
+    int subscription = registry->subscribe([&received](const TelemetrySample* samples, int count) {
+        for (int i=0; i<count; i++) {
+            received.append(samples[i]);
+        }
+    });
+    QCOMPARE(registry->hasSubscribers(), true);
+
+    // A batch is delivered as is
+    const TelemetrySample rgSamples[] = {
+        { 1, channel, 1.5, 1000 },
+        { 2, channel, -2.0, 2000 },
+    };
+    registry->publish(rgSamples, 2);
+    QCOMPARE(received.count(), 2);
+    QCOMPARE(received[0].vehicleId, 1);
+    QCOMPARE(received[0].channel, channel);
+    QCOMPARE(received[0].value, 1.5);
+    QCOMPARE(received[1].msecs, (quint64)2000);
+
+    // Nothing is delivered after unsubscribing
+    registry->unsubscribe(subscription);
+    QCOMPARE(registry->hasSubscribers(), false);
+    registry->publish(rgSamples, 2);
+    QCOMPARE(received.count(), 2);
+}
+
+void TelemetryChannelRegistryTest::_vehicleSamples(void)
+{
+    _connectMockLink(MAV_AUTOPILOT_ARDUPILOTMEGA);
+
+    TelemetryChannelRegistry*   registry = TelemetryChannelRegistry::instance();
+    int                         baseModeChannel = registry->registerChannel("HEARTBEAT", "base_mode", "bits");
+    QList<TelemetrySample>      received;
+
+    int subscription = registry->subscribe([&received, baseModeChannel](const TelemetrySample* samples, int count) {
+        for (int i=0; i<count; i++) {
+            if (samples[i].channel == baseModeChannel) {
+                received.append(samples[i]);
+            }
+        }
+    });
+
+    // The UAS publishes the heartbeats of MockLink once someone listens
+    QTRY_VERIFY_WITH_TIMEOUT(!received.isEmpty(), 5000);
+    QCOMPARE(received[0].vehicleId, _vehicle->id());
+    QVERIFY(received[0].msecs > 0);
+
+    registry->unsubscribe(subscription);
+}
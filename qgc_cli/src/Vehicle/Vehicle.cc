@@ -16,6 +16,7 @@
 #include "UAS.h"
 //#include "JoystickManager.h"
 #include "MissionManager.h"
+#include "StreamRateManager.h"
 #include "MissionController.h"
 #include "PlanMasterController.h"
 #include "GeoFenceManager.h"
@@ -29,7 +30,9 @@
 #include "MissionCommandTree.h"
 #include "QGroundControlQmlGlobal.h"
 #include "SettingsManager.h"
+#include "SettingsStore.h"
 #include "QGCQGeoCoordinate.h"
+#include "VehicleTelemetryStore.h"
 
 QGC_LOGGING_CATEGORY(VehicleLog, "VehicleLog")
 
@@ -102,6 +105,13 @@ Vehicle::Vehicle(LinkInterface*             link,
     , _onboardControlSensorsUnhealthy(0)
     , _gpsRawIntMessageAvailable(false)
     , _globalPositionIntMessageAvailable(false)
+    , _telemetryStore(NULL)
+    , _metricMessagesReceived(NULL)
+    , _metricMessagesLost(NULL)
+    , _metricCommandRtt(NULL)
+    , _metricCommandTimeouts(NULL)
+    , _metricLinkFailovers(NULL)
+    , _stateChanged(false)
     , _defaultCruiseSpeed(_settingsManager->appSettings()->offlineEditingCruiseSpeed()->rawValue().toDouble())
     , _defaultHoverSpeed(_settingsManager->appSettings()->offlineEditingHoverSpeed()->rawValue().toDouble())
     , _telemetryRRSSI(0)
@@ -115,6 +125,8 @@ Vehicle::Vehicle(LinkInterface*             link,
     , _supportsMissionItemInt(false)
     , _connectionLost(false)
     , _connectionLostEnabled(true)
+    , _redundantCommands(false)
+    , _linkFailoverSince(-1)
     , _initialPlanRequestComplete(false)
     , _missionManager(NULL)
     , _missionManagerInitialRequestSent(false)
@@ -123,10 +135,12 @@ Vehicle::Vehicle(LinkInterface*             link,
     , _rallyPointManager(NULL)
     , _rallyPointManagerInitialRequestSent(false)
     , _parameterManager(NULL)
+    , _streamRateManager(NULL)
     , _armed(false)
     , _base_mode(0)
     , _custom_mode(0)
     , _nextSendMessageMultipleIndex(0)
+    , _flightStartMsecs(0)
     , _firmwarePluginManager(firmwarePluginManager)
     , _joystickManager(joystickManager)
     , _flowImageIndex(0)
@@ -162,6 +176,8 @@ Vehicle::Vehicle(LinkInterface*             link,
     , _vibrationFactGroup(this)
     , _temperatureFactGroup(this)
 {
+    _state.reset();
+
     _addLink(link);
 
 //    connect(_joystickManager, &JoystickManager::activeJoystickChanged, this, &Vehicle::_activeJoystickChanged);
@@ -169,6 +185,7 @@ Vehicle::Vehicle(LinkInterface*             link,
     _mavlink = qgcApp()->toolbox()->mavlinkProtocol();
 
     connect(_mavlink, &MAVLinkProtocol::messageReceived,     this, &Vehicle::_mavlinkMessageReceived);
+    connect(_mavlink, &MAVLinkProtocol::vehicleHeartbeatInfo, this, &Vehicle::_heartbeatInfo);
 
     connect(this, &Vehicle::_sendMessageOnLinkOnThread, this, &Vehicle::_sendMessageOnLink, Qt::QueuedConnection);
     connect(this, &Vehicle::flightModeChanged,          this, &Vehicle::_handleFlightModeChanged);
@@ -182,11 +199,13 @@ Vehicle::Vehicle(LinkInterface*             link,
     _commonInit();
     _autopilotPlugin = _firmwarePlugin->autopilotPlugin(this);
 
+    _streamRateManager = new StreamRateManager(this);
+
     // connect this vehicle to the follow me handle manager
 //    connect(this, &Vehicle::flightModeChanged,qgcApp()->toolbox()->followMe(), &FollowMe::followMeHandleManager);
 
     // PreArm Error self-destruct timer
-    connect(&_prearmErrorTimer, &QTimer::timeout, this, &Vehicle::_prearmErrorTimeout);
+    connect(&_prearmErrorTimer, &QGCTimer::timeout, this, &Vehicle::_prearmErrorTimeout);
     _prearmErrorTimer.setInterval(_prearmErrorTimeoutMSecs);
     _prearmErrorTimer.setSingleShot(true);
 
@@ -194,12 +213,19 @@ Vehicle::Vehicle(LinkInterface*             link,
     _connectionLostTimer.setInterval(_connectionLostTimeoutMSecs);
     _connectionLostTimer.setSingleShot(false);
     _connectionLostTimer.start();
-    connect(&_connectionLostTimer, &QTimer::timeout, this, &Vehicle::_connectionLostTimeout);
+    connect(&_connectionLostTimer, &QGCTimer::timeout, this, &Vehicle::_connectionLostTimeout);
+
+    // Link health is checked while there is a redundant link to fail over to
+    _linkHealthTimer.setInterval(_linkHealthCheckMSecs);
+    _linkHealthTimer.setSingleShot(false);
+    connect(&_linkHealthTimer, &QGCTimer::timeout, this, &Vehicle::_checkLinkHealth);
 
     // Send MAV_CMD ack timer
     _mavCommandAckTimer.setSingleShot(true);
     _mavCommandAckTimer.setInterval(_mavCommandAckTimeoutMSecs);
-    connect(&_mavCommandAckTimer, &QTimer::timeout, this, &Vehicle::_sendMavCommandAgain);
+    connect(&_mavCommandAckTimer, &QGCTimer::timeout, this, &Vehicle::_sendMavCommandAgain);
+
+    _createMetrics();
 
     _mav = uas();
 
@@ -221,10 +247,10 @@ Vehicle::Vehicle(LinkInterface*             link,
     _firmwarePlugin->initializeVehicle(this);
 
     _sendMultipleTimer.start(_sendMessageMultipleIntraMessageDelay);
-    connect(&_sendMultipleTimer, &QTimer::timeout, this, &Vehicle::_sendMessageMultipleNext);
+    connect(&_sendMultipleTimer, &QGCTimer::timeout, this, &Vehicle::_sendMessageMultipleNext);
 
     _mapTrajectoryTimer.setInterval(_mapTrajectoryMsecsBetweenPoints);
-    connect(&_mapTrajectoryTimer, &QTimer::timeout, this, &Vehicle::_addNewMapTrajectoryPoint);
+    connect(&_mapTrajectoryTimer, &QGCTimer::timeout, this, &Vehicle::_addNewMapTrajectoryPoint);
 }
 
 // Disconnected Vehicle for offline editing
@@ -267,12 +293,21 @@ Vehicle::Vehicle(MAV_AUTOPILOT              firmwareType,
     , _onboardControlSensorsUnhealthy(0)
     , _gpsRawIntMessageAvailable(false)
     , _globalPositionIntMessageAvailable(false)
+    , _telemetryStore(NULL)
+    , _metricMessagesReceived(NULL)
+    , _metricMessagesLost(NULL)
+    , _metricCommandRtt(NULL)
+    , _metricCommandTimeouts(NULL)
+    , _metricLinkFailovers(NULL)
+    , _stateChanged(false)
     , _defaultCruiseSpeed(_settingsManager->appSettings()->offlineEditingCruiseSpeed()->rawValue().toDouble())
     , _defaultHoverSpeed(_settingsManager->appSettings()->offlineEditingHoverSpeed()->rawValue().toDouble())
     , _vehicleCapabilitiesKnown(true)
     , _supportsMissionItemInt(false)
     , _connectionLost(false)
     , _connectionLostEnabled(true)
+    , _redundantCommands(false)
+    , _linkFailoverSince(-1)
     , _initialPlanRequestComplete(false)
     , _missionManager(NULL)
     , _missionManagerInitialRequestSent(false)
@@ -281,10 +316,12 @@ Vehicle::Vehicle(MAV_AUTOPILOT              firmwareType,
     , _rallyPointManager(NULL)
     , _rallyPointManagerInitialRequestSent(false)
     , _parameterManager(NULL)
+    , _streamRateManager(NULL)
     , _armed(false)
     , _base_mode(0)
     , _custom_mode(0)
     , _nextSendMessageMultipleIndex(0)
+    , _flightStartMsecs(0)
     , _firmwarePluginManager(firmwarePluginManager)
     , _joystickManager(NULL)
     , _flowImageIndex(0)
@@ -319,6 +356,8 @@ Vehicle::Vehicle(MAV_AUTOPILOT              firmwareType,
     , _windFactGroup(this)
     , _vibrationFactGroup(this)
 {
+    _state.reset();
+
     _commonInit();
     _firmwarePlugin->initializeVehicle(this);
 }
@@ -399,6 +438,50 @@ Vehicle::~Vehicle()
     delete _mav;
     _mav = NULL;
 
+    delete _telemetryStore;
+    _telemetryStore = NULL;
+
+    _releaseMetrics();
+}
+
+void Vehicle::_createMetrics(void)
+{
+    QGCMetrics*     metrics = QGCMetrics::instance();
+    QGCMetricLabels labels = { { QStringLiteral("vehicle"), QString::number(_id) } };
+
+    _metricMessagesReceived = metrics->counter("vehicle_messages_received_total", "Messages received from the vehicle", labels);
+    _metricMessagesLost = metrics->counter("vehicle_messages_lost_total", "Messages lost from the vehicle by sequence number", labels);
+    _metricCommandRtt = metrics->histogram("vehicle_command_rtt_ms", "Time from the last send of a command to its COMMAND_ACK", labels);
+    _metricCommandTimeouts = metrics->counter("vehicle_command_timeouts_total", "Commands given up on without a COMMAND_ACK", labels);
+    _metricLinkFailovers = metrics->counter("vehicle_link_failovers_total", "Priority link switches for link health", labels);
+}
+
+void Vehicle::_releaseMetrics(void)
+{
+    QGCMetrics* metrics = QGCMetrics::instance();
+
+    metrics->release(_metricMessagesReceived);
+    metrics->release(_metricMessagesLost);
+    metrics->release(_metricCommandRtt);
+    metrics->release(_metricCommandTimeouts);
+    metrics->release(_metricLinkFailovers);
+    foreach (QGCMetricCounter* counter, _metricMessageCounters) {
+        metrics->release(counter);
+    }
+    _metricMessageCounters.clear();
+}
+
+QGCMetricCounter* Vehicle::_messageCounter(uint32_t msgid)
+{
+    QGCMetricCounter* counter = _metricMessageCounters.value(msgid, NULL);
+
+    if (!counter) {
+        QGCMetricLabels labels = { { QStringLiteral("vehicle"), QString::number(_id) }, { QStringLiteral("msgid"), QString::number(msgid) } };
+        counter = QGCMetrics::instance()->counter("vehicle_message_rx_total", "Messages received from the vehicle by message id", labels);
+        _metricMessageCounters[msgid] = counter;
+    }
+
+    return counter;
 }
 
 void Vehicle::_offlineFirmwareTypeSettingChanged(QVariant value)
@@ -462,6 +545,20 @@ void Vehicle::resetCounters()
     _heardFrom          = false;
 }
 
+/// Heartbeats are reported for every link, also when MAVLinkProtocol drops the frame as already heard on another one.
+/// A redundant link is added here, even if all its frames arrive after the ones of the first link.
+void Vehicle::_heartbeatInfo(LinkInterface* link, int vehicleId, int componentId, int vehicleMavlinkVersion, int vehicleFirmwareType, int vehicleType)
+{
+    Q_UNUSED(componentId);
+    Q_UNUSED(vehicleMavlinkVersion);
+    Q_UNUSED(vehicleFirmwareType);
+    Q_UNUSED(vehicleType);
+
+    if (vehicleId == _id && !_containsLink(link)) {
+        _addLink(link);
+    }
+}
+
 void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message)
 {
     if (message.sysid != _id && message.sysid != 0) {
@@ -477,6 +574,8 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
 
     //-- Check link status
     _messagesReceived++;
+    _metricMessagesReceived->add();
+    _messageCounter(message.msgid)->add();
     emit messagesReceivedChanged();
     if(!_heardFrom) {
         if(message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
@@ -496,6 +595,7 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
             }
             _messageSeq = message.seq + 1;
             _messagesLost += packet_lost_count;
+            _metricMessagesLost->add(packet_lost_count);
             if(packet_lost_count)
                 emit messagesLostChanged();
         }
@@ -551,7 +651,7 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         _handleExtendedSysState(message);
         break;
     case MAVLINK_MSG_ID_COMMAND_ACK:
-        _handleCommandAck(message);
+        _handleCommandAck(link, message);
         break;
     case MAVLINK_MSG_ID_AUTOPILOT_VERSION:
         _handleAutopilotVersion(link, message);
@@ -597,6 +697,10 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         _handleCameraImageCaptured(message);
         break;
 
+    case MAVLINK_MSG_ID_PING:
+        _handlePing(link, message);
+        break;
+
     case MAVLINK_MSG_ID_SERIAL_CONTROL:
     {
         mavlink_serial_control_t ser;
@@ -616,9 +720,37 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     emit mavlinkMessageReceived(message);
 
     _uas->receiveMessage(message);
+
+    // The handlers update Facts through the typed setters, their change signals go out once per message
+    flushDirtyFacts();
+
+    if (_stateChanged) {
+        _stateChanged = false;
+        _stateLock.write(_state);
+    }
 }
 
 
+void Vehicle::_handlePing(LinkInterface* link, mavlink_message_t& message)
+{
+    mavlink_ping_t      ping;
+    mavlink_message_t   msg;
+
+    mavlink_msg_ping_decode(&message, &ping);
+    if (ping.target_system == 0 && ping.target_component == 0) {
+        // Mavlink defines a ping request as a PING with target_system = 0 and target_component = 0, so send the response
+        mavlink_msg_ping_pack_chan(_mavlink->getSystemId(),
+                                   _mavlink->getComponentId(),
+                                   link->mavlinkChannel(),
+                                   &msg,
+                                   ping.time_usec,
+                                   ping.seq,
+                                   message.sysid,
+                                   message.compid);
+        sendMessageOnLink(link, msg);
+    }
+}
+
 void Vehicle::_handleCameraFeedback(const mavlink_message_t& message)
 {
     mavlink_camera_feedback_t feedback;
@@ -648,9 +780,16 @@ void Vehicle::_handleVfrHud(mavlink_message_t& message)
     mavlink_vfr_hud_t vfrHud;
     mavlink_msg_vfr_hud_decode(&message, &vfrHud);
 
-    _airSpeedFact.setRawValue(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
-    _groundSpeedFact.setRawValue(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
-    _climbRateFact.setRawValue(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
+    _airSpeedFact.setRawDouble(qIsNaN(vfrHud.airspeed) ? 0 : vfrHud.airspeed);
+    _groundSpeedFact.setRawDouble(qIsNaN(vfrHud.groundspeed) ? 0 : vfrHud.groundspeed);
+    _climbRateFact.setRawDouble(qIsNaN(vfrHud.climb) ? 0 : vfrHud.climb);
+
+    if (_telemetryStore) {
+        qint64 now = QGCClock::instance()->currentMSecsSinceEpoch();
+        _telemetryStore->append(VehicleTelemetryStore::AirSpeed,    now, _airSpeedFact.rawValue().toDouble());
+        _telemetryStore->append(VehicleTelemetryStore::GroundSpeed, now, _groundSpeedFact.rawValue().toDouble());
+        _telemetryStore->append(VehicleTelemetryStore::ClimbRate,   now, _climbRateFact.rawValue().toDouble());
+    }
 }
 
 void Vehicle::_handleGpsRawInt(mavlink_message_t& message)
@@ -667,15 +806,41 @@ void Vehicle::_handleGpsRawInt(mavlink_message_t& message)
             _coordinate.setLongitude(gpsRawInt.lon / (double)1E7);
             _coordinate.setAltitude(gpsRawInt.alt  / 1000.0);
             emit coordinateChanged(_coordinate);
-            _altitudeAMSLFact.setRawValue(gpsRawInt.alt / 1000.0);
+            _altitudeAMSLFact.setRawDouble(gpsRawInt.alt / 1000.0);
         }
     }
 
-    _gpsFactGroup.count()->setRawValue(gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible);
-    _gpsFactGroup.hdop()->setRawValue(gpsRawInt.eph == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.eph / 100.0);
-    _gpsFactGroup.vdop()->setRawValue(gpsRawInt.epv == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.epv / 100.0);
-    _gpsFactGroup.courseOverGround()->setRawValue(gpsRawInt.cog == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.cog / 100.0);
-    _gpsFactGroup.lock()->setRawValue(gpsRawInt.fix_type);
+    _gpsFactGroup.count()->setRawInt(gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible);
+    _gpsFactGroup.hdop()->setRawDouble(gpsRawInt.eph == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.eph / 100.0);
+    _gpsFactGroup.vdop()->setRawDouble(gpsRawInt.epv == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.epv / 100.0);
+    _gpsFactGroup.courseOverGround()->setRawDouble(gpsRawInt.cog == UINT16_MAX ? std::numeric_limits<double>::quiet_NaN() : gpsRawInt.cog / 100.0);
+    _gpsFactGroup.lock()->setRawInt(gpsRawInt.fix_type);
+
+    qint64 stateTime = QGCClock::instance()->elapsed();
+    _state.gpsFixType = gpsRawInt.fix_type;
+    _state.satellitesVisible = gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible;
+    _state.gpsTime = stateTime;
+    if (gpsRawInt.fix_type >= GPS_FIX_TYPE_3D_FIX && !_globalPositionIntMessageAvailable) {
+        _state.latitude = _coordinate.latitude();
+        _state.longitude = _coordinate.longitude();
+        _state.altitudeAMSL = _coordinate.altitude();
+        _state.positionTime = stateTime;
+    }
+    _stateChanged = true;
+
+    if (_telemetryStore) {
+        qint64 now = QGCClock::instance()->currentMSecsSinceEpoch();
+        _telemetryStore->append(VehicleTelemetryStore::GpsCount,            now, _gpsFactGroup.count()->rawValue().toInt());
+        _telemetryStore->append(VehicleTelemetryStore::GpsLock,             now, gpsRawInt.fix_type);
+        _telemetryStore->append(VehicleTelemetryStore::GpsHdop,             now, _gpsFactGroup.hdop()->rawValue().toDouble());
+        _telemetryStore->append(VehicleTelemetryStore::GpsVdop,             now, _gpsFactGroup.vdop()->rawValue().toDouble());
+        _telemetryStore->append(VehicleTelemetryStore::GpsCourseOverGround, now, _gpsFactGroup.courseOverGround()->rawValue().toDouble());
+        if (gpsRawInt.fix_type >= GPS_FIX_TYPE_3D_FIX && !_globalPositionIntMessageAvailable) {
+            _telemetryStore->append(VehicleTelemetryStore::Latitude,        now, _coordinate.latitude());
+            _telemetryStore->append(VehicleTelemetryStore::Longitude,       now, _coordinate.longitude());
+            _telemetryStore->append(VehicleTelemetryStore::AltitudeAMSL,    now, _coordinate.altitude());
+        }
+    }
 }
 
 void Vehicle::_handleGlobalPositionInt(mavlink_message_t& message)
@@ -694,8 +859,26 @@ void Vehicle::_handleGlobalPositionInt(mavlink_message_t& message)
     _coordinate.setLongitude(globalPositionInt.lon / (double)1E7);
     _coordinate.setAltitude(globalPositionInt.alt  / 1000.0);
     emit coordinateChanged(_coordinate);
-    _altitudeRelativeFact.setRawValue(globalPositionInt.relative_alt / 1000.0);
-    _altitudeAMSLFact.setRawValue(globalPositionInt.alt / 1000.0);
+    _altitudeRelativeFact.setRawDouble(globalPositionInt.relative_alt / 1000.0);
+    _altitudeAMSLFact.setRawDouble(globalPositionInt.alt / 1000.0);
+
+    _state.latitude = _coordinate.latitude();
+    _state.longitude = _coordinate.longitude();
+    _state.altitudeAMSL = _coordinate.altitude();
+    _state.altitudeRelative = globalPositionInt.relative_alt / 1000.0;
+    _state.vx = globalPositionInt.vx / 100.0f;
+    _state.vy = globalPositionInt.vy / 100.0f;
+    _state.vz = globalPositionInt.vz / 100.0f;
+    _state.positionTime = QGCClock::instance()->elapsed();
+    _stateChanged = true;
+
+    if (_telemetryStore) {
+        qint64 now = QGCClock::instance()->currentMSecsSinceEpoch();
+        _telemetryStore->append(VehicleTelemetryStore::Latitude,            now, _coordinate.latitude());
+        _telemetryStore->append(VehicleTelemetryStore::Longitude,           now, _coordinate.longitude());
+        _telemetryStore->append(VehicleTelemetryStore::AltitudeAMSL,        now, _coordinate.altitude());
+        _telemetryStore->append(VehicleTelemetryStore::AltitudeRelative,    now, globalPositionInt.relative_alt / 1000.0);
+    }
 }
 
 void Vehicle::_handleAltitude(mavlink_message_t& message)
@@ -705,9 +888,23 @@ void Vehicle::_handleAltitude(mavlink_message_t& message)
 
     // If data from GPS is available it takes precedence over ALTITUDE message
     if (!_globalPositionIntMessageAvailable) {
-        _altitudeRelativeFact.setRawValue(altitude.altitude_relative);
+        _altitudeRelativeFact.setRawDouble(altitude.altitude_relative);
         if (!_gpsRawIntMessageAvailable) {
-            _altitudeAMSLFact.setRawValue(altitude.altitude_amsl);
+            _altitudeAMSLFact.setRawDouble(altitude.altitude_amsl);
+        }
+
+        _state.altitudeRelative = altitude.altitude_relative;
+        if (!_gpsRawIntMessageAvailable) {
+            _state.altitudeAMSL = altitude.altitude_amsl;
+        }
+        _stateChanged = true;
+
+        if (_telemetryStore) {
+            qint64 now = QGCClock::instance()->currentMSecsSinceEpoch();
+            _telemetryStore->append(VehicleTelemetryStore::AltitudeRelative, now, altitude.altitude_relative);
+            if (!_gpsRawIntMessageAvailable) {
+                _telemetryStore->append(VehicleTelemetryStore::AltitudeAMSL, now, altitude.altitude_amsl);
+            }
         }
     }
 }
@@ -789,7 +986,7 @@ void Vehicle::_handleHilActuatorControls(mavlink_message_t &message)
                                     hil.mode);
 }
 
-void Vehicle::_handleCommandAck(mavlink_message_t& message)
+void Vehicle::_handleCommandAck(LinkInterface* link, mavlink_message_t& message)
 {
     bool showError = false;
 
@@ -805,6 +1002,12 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
 
     if (_mavCommandQueue.count() && ack.command == _mavCommandQueue[0].command) {
         _mavCommandAckTimer.stop();
+        qint64 roundTrip = QGCClock::instance()->elapsed() - _mavCommandQueue[0].sentTime;
+        if (_metricCommandRtt) {
+            _metricCommandRtt->record(roundTrip);
+        }
+        // With redundant commands this is the link the ack came back on first
+        link->health().roundTrip(roundTrip);
         showError = _mavCommandQueue[0].showError;
         _mavCommandQueue.removeFirst();
     }
@@ -865,12 +1068,22 @@ void Vehicle::_handleVibration(mavlink_message_t& message)
     mavlink_vibration_t vibration;
     mavlink_msg_vibration_decode(&message, &vibration);
 
-    _vibrationFactGroup.xAxis()->setRawValue(vibration.vibration_x);
-    _vibrationFactGroup.yAxis()->setRawValue(vibration.vibration_y);
-    _vibrationFactGroup.zAxis()->setRawValue(vibration.vibration_z);
-    _vibrationFactGroup.clipCount1()->setRawValue(vibration.clipping_0);
-    _vibrationFactGroup.clipCount2()->setRawValue(vibration.clipping_1);
-    _vibrationFactGroup.clipCount3()->setRawValue(vibration.clipping_2);
+    _vibrationFactGroup.xAxis()->setRawDouble(vibration.vibration_x);
+    _vibrationFactGroup.yAxis()->setRawDouble(vibration.vibration_y);
+    _vibrationFactGroup.zAxis()->setRawDouble(vibration.vibration_z);
+    _vibrationFactGroup.clipCount1()->setRawInt(vibration.clipping_0);
+    _vibrationFactGroup.clipCount2()->setRawInt(vibration.clipping_1);
+    _vibrationFactGroup.clipCount3()->setRawInt(vibration.clipping_2);
+
+    if (_telemetryStore) {
+        qint64 now = QGCClock::instance()->currentMSecsSinceEpoch();
+        _telemetryStore->append(VehicleTelemetryStore::VibrationX,  now, vibration.vibration_x);
+        _telemetryStore->append(VehicleTelemetryStore::VibrationY,  now, vibration.vibration_y);
+        _telemetryStore->append(VehicleTelemetryStore::VibrationZ,  now, vibration.vibration_z);
+        _telemetryStore->append(VehicleTelemetryStore::ClipCount1,  now, (qint32)vibration.clipping_0);
+        _telemetryStore->append(VehicleTelemetryStore::ClipCount2,  now, (qint32)vibration.clipping_1);
+        _telemetryStore->append(VehicleTelemetryStore::ClipCount3,  now, (qint32)vibration.clipping_2);
+    }
 }
 
 void Vehicle::_handleWindCov(mavlink_message_t& message)
@@ -881,9 +1094,11 @@ void Vehicle::_handleWindCov(mavlink_message_t& message)
     float direction = qRadiansToDegrees(qAtan2(wind.wind_y, wind.wind_x));
     float speed = qSqrt(qPow(wind.wind_x, 2) + qPow(wind.wind_y, 2));
 
-    _windFactGroup.direction()->setRawValue(direction);
-    _windFactGroup.speed()->setRawValue(speed);
-    _windFactGroup.verticalSpeed()->setRawValue(0);
+    _windFactGroup.direction()->setRawDouble(direction);
+    _windFactGroup.speed()->setRawDouble(speed);
+    _windFactGroup.verticalSpeed()->setRawDouble(0);
+
+    _storeWind(direction, speed, 0);
 }
 
 void Vehicle::_handleWind(mavlink_message_t& message)
@@ -891,9 +1106,21 @@ void Vehicle::_handleWind(mavlink_message_t& message)
     mavlink_wind_t wind;
     mavlink_msg_wind_decode(&message, &wind);
 
-    _windFactGroup.direction()->setRawValue(wind.direction);
-    _windFactGroup.speed()->setRawValue(wind.speed);
-    _windFactGroup.verticalSpeed()->setRawValue(wind.speed_z);
+    _windFactGroup.direction()->setRawDouble(wind.direction);
+    _windFactGroup.speed()->setRawDouble(wind.speed);
+    _windFactGroup.verticalSpeed()->setRawDouble(wind.speed_z);
+
+    _storeWind(wind.direction, wind.speed, wind.speed_z);
+}
+
+void Vehicle::_storeWind(double direction, double speed, double verticalSpeed)
+{
+    if (_telemetryStore) {
+        qint64 now = QGCClock::instance()->currentMSecsSinceEpoch();
+        _telemetryStore->append(VehicleTelemetryStore::WindDirection,       now, direction);
+        _telemetryStore->append(VehicleTelemetryStore::WindSpeed,           now, speed);
+        _telemetryStore->append(VehicleTelemetryStore::WindVerticalSpeed,   now, verticalSpeed);
+    }
 }
 
 void Vehicle::_handleSysStatus(mavlink_message_t& message)
@@ -902,17 +1129,29 @@ void Vehicle::_handleSysStatus(mavlink_message_t& message)
     mavlink_msg_sys_status_decode(&message, &sysStatus);
 
     if (sysStatus.current_battery == -1) {
-        _batteryFactGroup.current()->setRawValue(VehicleBatteryFactGroup::_currentUnavailable);
+        _batteryFactGroup.current()->setRawDouble(VehicleBatteryFactGroup::_currentUnavailable);
     } else {
         // Current is in Amps, current_battery is 10 * milliamperes (1 = 10 milliampere)
-        _batteryFactGroup.current()->setRawValue((float)sysStatus.current_battery / 100.0f);
+        _batteryFactGroup.current()->setRawDouble((float)sysStatus.current_battery / 100.0f);
     }
     if (sysStatus.voltage_battery == UINT16_MAX) {
-        _batteryFactGroup.voltage()->setRawValue(VehicleBatteryFactGroup::_voltageUnavailable);
+        _batteryFactGroup.voltage()->setRawDouble(VehicleBatteryFactGroup::_voltageUnavailable);
     } else {
-        _batteryFactGroup.voltage()->setRawValue((double)sysStatus.voltage_battery / 1000.0);
+        _batteryFactGroup.voltage()->setRawDouble((double)sysStatus.voltage_battery / 1000.0);
+    }
+    _batteryFactGroup.percentRemaining()->setRawInt(sysStatus.battery_remaining);
+
+    _state.batteryVoltage = sysStatus.voltage_battery == UINT16_MAX ? std::numeric_limits<float>::quiet_NaN() : sysStatus.voltage_battery / 1000.0f;
+    _state.batteryRemaining = sysStatus.battery_remaining;
+    _state.batteryTime = QGCClock::instance()->elapsed();
+    _stateChanged = true;
+
+    if (_telemetryStore) {
+        qint64 now = QGCClock::instance()->currentMSecsSinceEpoch();
+        _telemetryStore->append(VehicleTelemetryStore::BatteryCurrent,          now, _batteryFactGroup.current()->rawValue().toDouble());
+        _telemetryStore->append(VehicleTelemetryStore::BatteryVoltage,          now, _batteryFactGroup.voltage()->rawValue().toDouble());
+        _telemetryStore->append(VehicleTelemetryStore::BatteryPercentRemaining, now, (qint32)sysStatus.battery_remaining);
     }
-    _batteryFactGroup.percentRemaining()->setRawValue(sysStatus.battery_remaining);
 
     if (sysStatus.battery_remaining > 0) {
         if (sysStatus.battery_remaining < _settingsManager->appSettings()->batteryPercentRemainingAnnounce()->rawValue().toInt() &&
@@ -939,14 +1178,14 @@ void Vehicle::_handleBatteryStatus(mavlink_message_t& message)
     mavlink_msg_battery_status_decode(&message, &bat_status);
 
     if (bat_status.temperature == INT16_MAX) {
-        _batteryFactGroup.temperature()->setRawValue(VehicleBatteryFactGroup::_temperatureUnavailable);
+        _batteryFactGroup.temperature()->setRawDouble(VehicleBatteryFactGroup::_temperatureUnavailable);
     } else {
-        _batteryFactGroup.temperature()->setRawValue((double)bat_status.temperature / 100.0);
+        _batteryFactGroup.temperature()->setRawDouble((double)bat_status.temperature / 100.0);
     }
     if (bat_status.current_consumed == -1) {
-        _batteryFactGroup.mahConsumed()->setRawValue(VehicleBatteryFactGroup::_mahConsumedUnavailable);
+        _batteryFactGroup.mahConsumed()->setRawInt(VehicleBatteryFactGroup::_mahConsumedUnavailable);
     } else {
-        _batteryFactGroup.mahConsumed()->setRawValue(bat_status.current_consumed);
+        _batteryFactGroup.mahConsumed()->setRawInt(bat_status.current_consumed);
     }
 
     int cellCount = 0;
@@ -959,7 +1198,21 @@ void Vehicle::_handleBatteryStatus(mavlink_message_t& message)
         cellCount = -1;
     }
 
-    _batteryFactGroup.cellCount()->setRawValue(cellCount);
+    _batteryFactGroup.cellCount()->setRawInt(cellCount);
+
+    if (_telemetryStore) {
+        qint64 now = QGCClock::instance()->currentMSecsSinceEpoch();
+        _telemetryStore->append(VehicleTelemetryStore::BatteryTemperature,  now, _batteryFactGroup.temperature()->rawValue().toDouble());
+        _telemetryStore->append(VehicleTelemetryStore::BatteryMahConsumed,  now, _batteryFactGroup.mahConsumed()->rawValue().toInt());
+        _telemetryStore->append(VehicleTelemetryStore::BatteryCellCount,    now, cellCount);
+    }
+}
+
+void Vehicle::enableTelemetryStore(int retention)
+{
+    if (!_telemetryStore) {
+        _telemetryStore = new VehicleTelemetryStore(retention);
+    }
 }
 
 void Vehicle::_setHomePosition(QGeoCoordinate& homeCoord)
@@ -1020,6 +1273,12 @@ void Vehicle::_handleHeartbeat(mavlink_message_t& message)
             emit flightModeChanged(flightMode());
         }
     }
+
+    _state.armed = _armed;
+    _state.baseMode = _base_mode;
+    _state.customMode = _custom_mode;
+    _state.heartbeatTime = QGCClock::instance()->elapsed();
+    _stateChanged = true;
 }
 
 void Vehicle::_handleRadioStatus(mavlink_message_t& message)
@@ -1170,19 +1429,19 @@ void Vehicle::_handleRCChannelsRaw(mavlink_message_t& message)
 void Vehicle::_handleScaledPressure(mavlink_message_t& message) {
     mavlink_scaled_pressure_t pressure;
     mavlink_msg_scaled_pressure_decode(&message, &pressure);
-    _temperatureFactGroup.temperature1()->setRawValue(pressure.temperature / 100.0);
+    _temperatureFactGroup.temperature1()->setRawDouble(pressure.temperature / 100.0);
 }
 
 void Vehicle::_handleScaledPressure2(mavlink_message_t& message) {
     mavlink_scaled_pressure2_t pressure;
     mavlink_msg_scaled_pressure2_decode(&message, &pressure);
-    _temperatureFactGroup.temperature2()->setRawValue(pressure.temperature / 100.0);
+    _temperatureFactGroup.temperature2()->setRawDouble(pressure.temperature / 100.0);
 }
 
 void Vehicle::_handleScaledPressure3(mavlink_message_t& message) {
     mavlink_scaled_pressure3_t pressure;
     mavlink_msg_scaled_pressure3_decode(&message, &pressure);
-    _temperatureFactGroup.temperature3()->setRawValue(pressure.temperature / 100.0);
+    _temperatureFactGroup.temperature3()->setRawDouble(pressure.temperature / 100.0);
 }
 
 bool Vehicle::_containsLink(LinkInterface* link)
@@ -1196,6 +1455,9 @@ void Vehicle::_addLink(LinkInterface* link)
         qCDebug(VehicleLog) << "_addLink:" << QString("%1").arg((ulong)link, 0, 16);
         _links += link;
         _updatePriorityLink();
+        if (_links.count() > 1 && !_linkHealthTimer.isActive()) {
+            _linkHealthTimer.start();
+        }
         connect(qgcApp()->toolbox()->linkManager(), &LinkManager::linkInactive, this, &Vehicle::_linkInactiveOrDeleted);
         connect(qgcApp()->toolbox()->linkManager(), &LinkManager::linkDeleted, this, &Vehicle::_linkInactiveOrDeleted);
     }
@@ -1207,6 +1469,10 @@ void Vehicle::_linkInactiveOrDeleted(LinkInterface* link)
 
     _links.removeOne(link);
     _updatePriorityLink();
+    if (_links.count() < 2) {
+        _linkHealthTimer.stop();
+        _linkFailoverSince = -1;
+    }
 
     if (_links.count() == 0 && !_allLinksInactiveSent) {
         qCDebug(VehicleLog) << "All links inactive";
@@ -1247,7 +1513,7 @@ void Vehicle::_sendMessageOnLink(LinkInterface* link, mavlink_message_t message)
     uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
     int len = mavlink_msg_to_send_buffer(buffer, &message);
 
-    link->writeBytesSafe((const char*)buffer, len);
+    link->writeFramesSafe((const char*)buffer, len, 1);
     _messagesSent++;
     emit messagesSentChanged();
 }
@@ -1281,7 +1547,8 @@ void Vehicle::_updatePriorityLink(void)
     }
 #endif
 
-    if (!newPriorityLink && !_priorityLink.data() && _links.count()) {
+    // A priority link which went away is only held on to while there is no other one
+    if (!newPriorityLink && (!_priorityLink.data() || !_links.contains(_priorityLink.data())) && _links.count()) {
         newPriorityLink = _links[0];
     }
 
@@ -1290,25 +1557,95 @@ void Vehicle::_updatePriorityLink(void)
     }
 }
 
-void Vehicle::_updateAttitude(UASInterface*, double roll, double pitch, double yaw, quint64)
+/// Moves the priority link to a healthier link. The other link has to score _linkFailoverMargin more than the priority
+/// link for _linkFailoverHoldMSecs, so links of about the same health don't take turns. A priority link which is not
+/// heard at all any more is left right away for any link which is.
+void Vehicle::_checkLinkHealth(void)
 {
-    if (qIsInf(roll)) {
-        _rollFact.setRawValue(0);
-    } else {
-        _rollFact.setRawValue(roll * (180.0 / M_PI));
+    LinkInterface* priorityLink = _priorityLink.data();
+    if (!priorityLink || _links.count() < 2) {
+        return;
     }
-    if (qIsInf(pitch)) {
-        _pitchFact.setRawValue(0);
-    } else {
-        _pitchFact.setRawValue(pitch * (180.0 / M_PI));
+
+    qint64          now = QGCClock::instance()->elapsed();
+    int             priorityScore = priorityLink->isConnected() ? priorityLink->health().score(now) : 0;
+    LinkInterface*  bestLink = NULL;
+    int             bestScore = 0;
+
+    for (int i=0; i<_links.count(); i++) {
+        LinkInterface* link = _links[i];
+        if (link != priorityLink && link->isConnected()) {
+            int score = link->health().score(now);
+            if (score > bestScore) {
+                bestLink = link;
+                bestScore = score;
+            }
+        }
+    }
+
+    if (!bestLink || (priorityScore > 0 && bestScore < priorityScore + _linkFailoverMargin)) {
+        _linkFailoverSince = -1;
+        return;
+    }
+
+    if (_linkFailoverSince < 0) {
+        _linkFailoverSince = now;
+    }
+    if (priorityScore > 0 && now - _linkFailoverSince < _linkFailoverHoldMSecs) {
+        return;
+    }
+
+    qCDebug(VehicleLog) << "Priority link failover" << priorityLink->getName() << priorityScore << "to" << bestLink->getName() << bestScore;
+
+    _priorityLink = qgcApp()->toolbox()->linkManager()->sharedLinkInterfacePointerForLink(bestLink);
+    _linkFailoverSince = -1;
+    if (_metricLinkFailovers) {
+        _metricLinkFailovers->add();
     }
+}
+
+QList<LinkInterface*> Vehicle::commandLinks(bool retry)
+{
+    QList<LinkInterface*> links;
+
+    LinkInterface* priorityLink = _priorityLink.data();
+    if (priorityLink) {
+        links.append(priorityLink);
+    }
+
+    if (_redundantCommands && retry) {
+        qint64 now = QGCClock::instance()->elapsed();
+        for (int i=0; i<_links.count(); i++) {
+            LinkInterface* link = _links[i];
+            if (link != priorityLink && link->isConnected() && link->health().healthy(now)) {
+                links.append(link);
+            }
+        }
+    }
+
+    return links;
+}
+
+void Vehicle::_updateAttitude(UASInterface*, double roll, double pitch, double yaw, quint64)
+{
+    roll = qIsInf(roll) ? 0 : roll * (180.0 / M_PI);
+    pitch = qIsInf(pitch) ? 0 : pitch * (180.0 / M_PI);
     if (qIsInf(yaw)) {
-        _headingFact.setRawValue(0);
+        yaw = 0;
     } else {
         yaw = yaw * (180.0 / M_PI);
         if (yaw < 0) yaw += 360;
-        _headingFact.setRawValue(yaw);
     }
+
+    _rollFact.setRawDouble(roll);
+    _pitchFact.setRawDouble(pitch);
+    _headingFact.setRawDouble(yaw);
+
+    _state.roll = roll;
+    _state.pitch = pitch;
+    _state.heading = yaw;
+    _state.attitudeTime = QGCClock::instance()->elapsed();
+    _stateChanged = true;
 }
 
 void Vehicle::_updateAttitude(UASInterface* uas, int, double roll, double pitch, double yaw, quint64 timestamp)
@@ -1473,13 +1810,12 @@ int Vehicle::manualControlReservedButtonCount(void)
 
 void Vehicle::_loadSettings(void)
 {
-    QSettings settings;
-
-    settings.beginGroup(QString(_settingsGroup).arg(_id));
+    SettingsStore*  settings = SettingsStore::instance();
+    QString         group = QString(_settingsGroup).arg(_id);
 
     bool convertOk;
 
-    _joystickMode = (JoystickMode_t)settings.value(_joystickModeSettingsKey, JoystickModeRC).toInt(&convertOk);
+    _joystickMode = (JoystickMode_t)settings->value(group, _joystickModeSettingsKey, JoystickModeRC).toInt(&convertOk);
     if (!convertOk) {
         _joystickMode = JoystickModeRC;
     }
@@ -1492,11 +1828,7 @@ void Vehicle::_loadSettings(void)
 
 void Vehicle::_saveSettings(void)
 {
-    QSettings settings;
-
-    settings.beginGroup(QString(_settingsGroup).arg(_id));
-
-    settings.setValue(_joystickModeSettingsKey, _joystickMode);
+    SettingsStore::instance()->setValue(QString(_settingsGroup).arg(_id), _joystickModeSettingsKey, _joystickMode);
 
     // The joystick enabled setting should only be changed if a joystick is present
     // since the checkbox can only be clicked if one is present
@@ -1715,6 +2047,22 @@ void Vehicle::sendMessageMultiple(mavlink_message_t message)
     _sendMessageMultipleList.append(info);
 }
 
+void Vehicle::cancelMessageMultiple(uint32_t msgId)
+{
+    for (int i=_sendMessageMultipleList.count()-1; i>=0; i--) {
+        if (_sendMessageMultipleList[i].message.msgid == msgId) {
+            _sendMessageMultipleList.removeAt(i);
+            if (i < _nextSendMessageMultipleIndex) {
+                _nextSendMessageMultipleIndex--;
+            }
+        }
+    }
+
+    if (_nextSendMessageMultipleIndex >= _sendMessageMultipleList.count()) {
+        _nextSendMessageMultipleIndex = 0;
+    }
+}
+
 void Vehicle::_missionManagerError(int errorCode, const QString& errorMsg)
 {
     Q_UNUSED(errorCode);
@@ -1747,7 +2095,7 @@ void Vehicle::_addNewMapTrajectoryPoint(void)
     }
     _mapTrajectoryHaveFirstCoordinate = true;
     _mapTrajectoryLastCoordinate = _coordinate;
-    _flightTimeFact.setRawValue((double)_flightTimer.elapsed() / 1000.0);
+    _flightTimeFact.setRawValue((double)(QGCClock::instance()->elapsed() - _flightStartMsecs) / 1000.0);
 }
 
 void Vehicle::_clearTrajectoryPoints(void)
@@ -1765,7 +2113,7 @@ void Vehicle::_mapTrajectoryStart(void)
     _mapTrajectoryHaveFirstCoordinate = false;
     _clearTrajectoryPoints();
     _mapTrajectoryTimer.start();
-    _flightTimer.start();
+    _flightStartMsecs = QGCClock::instance()->elapsed();
     _flightDistanceFact.setRawValue(0);
     _flightTimeFact.setRawValue(0);
 }
@@ -2206,6 +2554,7 @@ void Vehicle::sendMavCommand(int component, MAV_CMD command, bool showError, flo
     entry.component = component;
     entry.command = command;
     entry.showError = showError;
+    entry.sentTime = 0;
     entry.rgParam[0] = param1;
     entry.rgParam[1] = param2;
     entry.rgParam[2] = param3;
@@ -2239,6 +2588,9 @@ void Vehicle::_sendMavCommandAgain(void)
             _startPlanRequest();
         }
 
+        if (_metricCommandTimeouts) {
+            _metricCommandTimeouts->add();
+        }
         emit mavCommandResult(_id, queuedCommand.component, queuedCommand.command, MAV_RESULT_FAILED, true /* noResponsefromVehicle */);
         if (queuedCommand.showError) {
             qgcApp()->showMessage(tr("Vehicle did not respond to command: %1").arg(qgcApp()->toolbox()->missionCommandTree()->friendlyName(queuedCommand.command)));
@@ -2273,6 +2625,7 @@ void Vehicle::_sendMavCommandAgain(void)
     }
 
     _mavCommandAckTimer.start();
+    queuedCommand.sentTime = QGCClock::instance()->elapsed();
 
     mavlink_message_t       msg;
     mavlink_command_long_t  cmd;
@@ -2289,13 +2642,17 @@ void Vehicle::_sendMavCommandAgain(void)
     cmd.param7 = queuedCommand.rgParam[6];
     cmd.target_system = _id;
     cmd.target_component = queuedCommand.component;
-    mavlink_msg_command_long_encode_chan(_mavlink->getSystemId(),
-                                         _mavlink->getComponentId(),
-                                         priorityLink()->mavlinkChannel(),
-                                         &msg,
-                                         &cmd);
 
-    sendMessageOnLink(priorityLink(), msg);
+    // Encoded for each link, every link has its own sequence numbers and signing
+    foreach (LinkInterface* link, commandLinks(_mavCommandRetryCount > 1)) {
+        mavlink_msg_command_long_encode_chan(_mavlink->getSystemId(),
+                                             _mavlink->getComponentId(),
+                                             link->mavlinkChannel(),
+                                             &msg,
+                                             &cmd);
+
+        sendMessageOnLink(link, msg);
+    }
 }
 
 void Vehicle::_sendNextQueuedMavCommand(void)
@@ -25,6 +25,9 @@
 #include "MAVLinkProtocol.h"
 #include "UASMessageHandler.h"
 #include "SettingsFact.h"
+#include "QGCClock.h"
+#include "VehicleStateSnapshot.h"
+#include "QGCMetrics.h"
 
 class UAS;
 class UASInterface;
@@ -32,12 +35,14 @@ class FirmwarePlugin;
 class FirmwarePluginManager;
 class AutoPilotPlugin;
 class MissionManager;
+class StreamRateManager;
 class GeoFenceManager;
 class RallyPointManager;
 class ParameterManager;
 class JoystickManager;
 class UASMessage;
 class SettingsManager;
+class VehicleTelemetryStore;
 
 Q_DECLARE_LOGGING_CATEGORY(VehicleLog)
 
@@ -218,6 +223,8 @@ class Vehicle : public FactGroup
 {
     Q_OBJECT
 
+    friend class QGCBenchmark;
+
 public:
     Vehicle(LinkInterface*          link,
             int                     vehicleId,
@@ -472,6 +479,16 @@ public:
     /// LinkManager::sharedLinkInterfaceForGet to get QSharedPointer for link.
     LinkInterface* priorityLink(void) { return _priorityLink.data(); }
 
+    /// With redundant commands on, retries of commands and guided targets are sent on every healthy link instead of
+    /// only the priority link, so they get through as long as one link does. The first send stays on the priority link,
+    /// an answered command is then acked only once.
+    bool redundantCommands(void) const { return _redundantCommands; }
+    void setRedundantCommands(bool redundantCommands) { _redundantCommands = redundantCommands; }
+
+    /// Returns the links a command or guided target is to be sent on: the priority link, and for a retry with redundant
+    /// commands also every other healthy link
+    QList<LinkInterface*> commandLinks(bool retry);
+
     /// Sends a message to the specified link
     /// @return true: message sent, false: Link no longer connected
     bool sendMessageOnLink(LinkInterface* link, mavlink_message_t message);
@@ -480,6 +497,9 @@ public:
     /// guarantee that it makes it to the vehicle.
     void sendMessageMultiple(mavlink_message_t message);
 
+    /// Stops sending the messages with msgId which sendMessageMultiple has not finished sending yet
+    void cancelMessageMultiple(uint32_t msgId);
+
     /// Provides access to uas from vehicle. Temporary workaround until UAS is fully phased out.
     UAS* uas(void) { return _uas; }
 
@@ -495,6 +515,21 @@ public:
     GeoFenceManager*    geoFenceManager(void)   { return _geoFenceManager; }
     RallyPointManager*  rallyPointManager(void) { return _rallyPointManager; }
 
+    /// Telemetry rates from what the components subscribe to, NULL for the offline editing vehicle
+    StreamRateManager*  streamRateManager(void) { return _streamRateManager; }
+
+    /// Starts recording the history of the vehicle telemetry values. Calling again after the store is created does
+    /// nothing, the store lives as long as the vehicle so readers on other threads can hold on to it.
+    ///     @param retention Number of samples kept per value
+    void enableTelemetryStore(int retention);
+
+    /// @return Telemetry history, NULL if enableTelemetryStore has not been called
+    const VehicleTelemetryStore* telemetryStore(void) const { return _telemetryStore; }
+
+    /// Coherent copy of the latest vehicle state, safe to call from any thread. Updated once per MAVLink message which
+    /// changed it, so all fields of one message are always seen together.
+    VehicleStateSnapshot stateSnapshot(void) const { return _stateLock.read(); }
+
     QGeoCoordinate homePosition(void);
 
     bool armed(void) { return _armed; }
@@ -776,6 +811,7 @@ signals:
 
 private slots:
     void _mavlinkMessageReceived(LinkInterface* link, mavlink_message_t message);
+    void _heartbeatInfo(LinkInterface* link, int vehicleId, int componentId, int vehicleMavlinkVersion, int vehicleFirmwareType, int vehicleType);
     void _linkInactiveOrDeleted(LinkInterface* link);
     void _sendMessageOnLink(LinkInterface* link, mavlink_message_t message);
     void _sendMessageMultipleNext(void);
@@ -822,9 +858,10 @@ private:
     void _handleSysStatus(mavlink_message_t& message);
     void _handleWindCov(mavlink_message_t& message);
     void _handleWind(mavlink_message_t& message);
+    void _storeWind(double direction, double speed, double verticalSpeed);
     void _handleVibration(mavlink_message_t& message);
     void _handleExtendedSysState(mavlink_message_t& message);
-    void _handleCommandAck(mavlink_message_t& message);
+    void _handleCommandAck(LinkInterface* link, mavlink_message_t& message);
     void _handleAutopilotVersion(LinkInterface* link, mavlink_message_t& message);
     void _handleHilActuatorControls(mavlink_message_t& message);
     void _handleGpsRawInt(mavlink_message_t& message);
@@ -836,12 +873,17 @@ private:
     void _handleScaledPressure3(mavlink_message_t& message);
     void _handleCameraFeedback(const mavlink_message_t& message);
     void _handleCameraImageCaptured(const mavlink_message_t& message);
+    void _handlePing(LinkInterface* link, mavlink_message_t& message);
     void _missionManagerError(int errorCode, const QString& errorMsg);
     void _geoFenceManagerError(int errorCode, const QString& errorMsg);
     void _rallyPointManagerError(int errorCode, const QString& errorMsg);
     void _mapTrajectoryStart(void);
     void _mapTrajectoryStop(void);
     void _connectionActive(void);
+    void _checkLinkHealth(void);
+    void _createMetrics(void);
+    void _releaseMetrics(void);
+    QGCMetricCounter* _messageCounter(uint32_t msgid);
     void _say(const QString& text);
     QString _vehicleIdSpeech(void);
     void _handleMavlinkLoggingData(mavlink_message_t& message);
@@ -899,6 +941,18 @@ private:
     uint32_t        _onboardControlSensorsUnhealthy;
     bool            _gpsRawIntMessageAvailable;
     bool            _globalPositionIntMessageAvailable;
+    VehicleTelemetryStore* _telemetryStore;
+
+    // Profiling metrics, see QGCMetrics. Offline editing vehicles have none.
+    QGCMetricCounter*                   _metricMessagesReceived;
+    QGCMetricCounter*                   _metricMessagesLost;
+    QGCMetricHistogram*                 _metricCommandRtt;
+    QGCMetricCounter*                   _metricCommandTimeouts;
+    QGCMetricCounter*                   _metricLinkFailovers;
+    QHash<uint32_t, QGCMetricCounter*>  _metricMessageCounters;     ///< Per message id, created as ids are first seen
+    VehicleStateSnapshot _state;        ///< Working copy, only touched on the vehicle thread
+    bool            _stateChanged;      ///< _state has changes which are not published yet
+    VehicleStateSeqLock _stateLock;
     double          _defaultCruiseSpeed;
     double          _defaultHoverSpeed;
     int             _telemetryRRSSI;
@@ -916,23 +970,32 @@ private:
         MAV_CMD command;
         float   rgParam[7];
         bool    showError;
+        qint64  sentTime;       ///< QGCClock::elapsed of the last send, for the round trip time
     } MavCommandQueueEntry_t;
 
     QList<MavCommandQueueEntry_t>   _mavCommandQueue;
-    QTimer                          _mavCommandAckTimer;
+    QGCTimer                        _mavCommandAckTimer;
     int                             _mavCommandRetryCount;
     static const int                _mavCommandMaxRetryCount = 3;
     static const int                _mavCommandAckTimeoutMSecs = 3000;
 
     QString             _prearmError;
-    QTimer              _prearmErrorTimer;
+    QGCTimer            _prearmErrorTimer;
     static const int    _prearmErrorTimeoutMSecs = 35 * 1000;   ///< Take away prearm error after 35 seconds
 
     // Lost connection handling
     bool                _connectionLost;
     bool                _connectionLostEnabled;
     static const int    _connectionLostTimeoutMSecs = 3500;  // Signal connection lost after 3.5 seconds of missed heartbeat
-    QTimer              _connectionLostTimer;
+    QGCTimer            _connectionLostTimer;
+
+    // Failover between redundant links
+    bool                _redundantCommands;
+    qint64              _linkFailoverSince;                 ///< QGCClock::elapsed a better link was first seen, -1 for none
+    QGCTimer            _linkHealthTimer;                   ///< Runs while the vehicle has more than one link
+    static const int    _linkHealthCheckMSecs = 100;
+    static const int    _linkFailoverMargin = 20;           ///< Score a link needs above the priority link to take over
+    static const int    _linkFailoverHoldMSecs = 300;       ///< Time it needs to stay ahead, unless the priority link is dead
 
     bool                _initialPlanRequestComplete;
 
@@ -947,6 +1010,8 @@ private:
 
     ParameterManager*    _parameterManager;
 
+    StreamRateManager*  _streamRateManager;
+
     bool    _armed;         ///< true: vehicle is armed
     uint8_t _base_mode;     ///< base_mode from HEARTBEAT
     uint32_t _custom_mode;  ///< custom_mode from HEARTBEAT
@@ -962,11 +1027,11 @@ private:
     static const int _sendMessageMultipleRetries = 5;
     static const int _sendMessageMultipleIntraMessageDelay = 500;
 
-    QTimer  _sendMultipleTimer;
+    QGCTimer _sendMultipleTimer;
     int     _nextSendMessageMultipleIndex;
 
-    QTime               _flightTimer;
-    QTimer              _mapTrajectoryTimer;
+    qint64              _flightStartMsecs;
+    QGCTimer            _mapTrajectoryTimer;
     QmlObjectListModel  _mapTrajectoryList;
     QGeoCoordinate      _mapTrajectoryLastCoordinate;
     bool                _mapTrajectoryHaveFirstCoordinate;
@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+/// Vehicle state as of the last MAVLink message that changed it. Plain data, so it can be copied around freely and read
+/// on any thread. Times are QGCClock::elapsed msecs of the last update of that part, -1 if it was never received.
+struct VehicleStateSnapshot {
+    double  latitude;           ///< Degrees
+    double  longitude;          ///< Degrees
+    double  altitudeAMSL;       ///< Meters
+    double  altitudeRelative;   ///< Meters above home
+    float   vx;                 ///< North speed in m/s
+    float   vy;                 ///< East speed in m/s
+    float   vz;                 ///< Down speed in m/s
+    float   roll;               ///< Degrees
+    float   pitch;              ///< Degrees
+    float   heading;            ///< Degrees, 0 to 360
+    bool    armed;
+    quint8  baseMode;           ///< MAV_MODE_FLAG bits from HEARTBEAT
+    quint32 customMode;         ///< Firmware specific mode from HEARTBEAT, see FirmwarePlugin::flightMode
+    float   batteryVoltage;     ///< Volts, NaN if not known
+    qint8   batteryRemaining;   ///< Percent, -1 if not known
+    quint8  gpsFixType;         ///< GPS_FIX_TYPE
+    quint8  satellitesVisible;
+    qint64  positionTime;
+    qint64  attitudeTime;
+    qint64  heartbeatTime;
+    qint64  batteryTime;
+    qint64  gpsTime;
+
+    /// @return true: the position is known including the altitude above home. GPS_RAW_INT alone gives a position
+    ///         without it, which only becomes valid once ALTITUDE provides the relative altitude.
+    bool positionValid(void) const { return positionTime >= 0 && !std::isnan(altitudeRelative); }
+
+    void reset(void)
+    {
+        latitude = longitude = altitudeAMSL = altitudeRelative = std::numeric_limits<double>::quiet_NaN();
+        vx = vy = vz = 0;
+        roll = pitch = heading = 0;
+        armed = false;
+        baseMode = 0;
+        customMode = 0;
+        batteryVoltage = std::numeric_limits<float>::quiet_NaN();
+        batteryRemaining = -1;
+        gpsFixType = 0;
+        satellitesVisible = 0;
+        positionTime = attitudeTime = heartbeatTime = batteryTime = gpsTime = -1;
+    }
+};
+
+/// Publishes a VehicleStateSnapshot from the thread the Vehicle lives on to readers on any thread, as a seqlock. The
+/// writer never waits. A reader copies the state and retries if a write overlapped the copy, so it only spins while
+/// a write is in progress, which is a copy of the struct.
+class VehicleStateSeqLock
+{
+public:
+    VehicleStateSeqLock(void)
+        : _sequence(0)
+    {
+        _state.reset();
+    }
+
+    /// Writer thread only
+    void write(const VehicleStateSnapshot& state)
+    {
+        unsigned sequence = _sequence.load(std::memory_order_relaxed);
+
+        // An odd sequence marks the write in progress
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&_state, &state, sizeof(_state));
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    VehicleStateSnapshot read(void) const
+    {
+        VehicleStateSnapshot state;
+        unsigned before, after;
+
+        do {
+            before = _sequence.load(std::memory_order_acquire);
+            memcpy(&state, &_state, sizeof(state));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = _sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        return state;
+    }
+
+    /// @return Number of writes so far, readers can use it to tell whether anything changed since their last read
+    unsigned version(void) const { return _sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static_assert(std::is_trivially_copyable<VehicleStateSnapshot>::value, "VehicleStateSnapshot must stay plain data");
+
+    std::atomic<unsigned>   _sequence;
+    VehicleStateSnapshot    _state;
+};
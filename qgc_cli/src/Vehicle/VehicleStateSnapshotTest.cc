@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleStateSnapshotTest.h"
+#include "VehicleStateSnapshot.h"
+#include "MultiVehicleManager.h"
+#include "LinkManager.h"
+#include "MockLink.h"
+#include "QGCApplication.h"
+
+void VehicleStateSnapshotTest::_positionValid(void)
+{
+    VehicleStateSnapshot state;
+
+    state.reset();
+    QCOMPARE(state.positionValid(), false);
+
+    // A position without the altitude above home is not usable yet
+    state.latitude = 47.0;
+    state.longitude = 8.0;
+    state.altitudeAMSL = 500.0;
+    state.positionTime = 100;
+    QCOMPARE(state.positionValid(), false);
+
+    state.altitudeRelative = 10.0;
+    QCOMPARE(state.positionValid(), true);
+
+    // The seqlock hands out the same state
+    VehicleStateSeqLock stateLock;
+    QCOMPARE(stateLock.read().positionValid(), false);
+    stateLock.write(state);
+    QCOMPARE(stateLock.version(), 1u);
+    VehicleStateSnapshot copy = stateLock.read();
+    QCOMPARE(copy.positionValid(), true);
+    QCOMPARE(copy.altitudeRelative, 10.0);
+}
+
+void VehicleStateSnapshotTest::_gpsRawIntPosition(void)
+{
+    // Without a telemetry rate MockLink only sends GPS_RAW_INT, which has no altitude above home
+    _connectMockLink(MAV_AUTOPILOT_ARDUPILOTMEGA);
+
+    QTRY_VERIFY_WITH_TIMEOUT(_vehicle->stateSnapshot().positionTime >= 0, 5000);
+    VehicleStateSnapshot state = _vehicle->stateSnapshot();
+    QVERIFY(state.gpsTime >= 0);
+    QCOMPARE(state.gpsFixType, (quint8)GPS_FIX_TYPE_3D_FIX);
+    QVERIFY(!qIsNaN(state.latitude));
+    QVERIFY(qIsNaN(state.altitudeRelative));
+    QCOMPARE(state.positionValid(), false);
+}
+
+void VehicleStateSnapshotTest::_globalPosition(void)
+{
+    MockConfiguration* mockConfig = new MockConfiguration("GLOBAL_POSITION_INT MockLink");
+    mockConfig->setFirmwareType(MAV_AUTOPILOT_ARDUPILOTMEGA);
+    mockConfig->setVehicleType(MAV_TYPE_QUADROTOR);
+    mockConfig->setDynamic(true);
+
+    MockConfiguration::TrafficProfile traffic;
+    traffic.telemetryRate = 10;
+    mockConfig->setTrafficProfile(traffic);
+
+    MultiVehicleManager*    vehicleManager = qgcApp()->toolbox()->multiVehicleManager();
+    LinkManager*            linkManager = qgcApp()->toolbox()->linkManager();
+    QSignalSpy              spyVehicle(vehicleManager, SIGNAL(parameterReadyVehicleAvailableChanged(bool)));
+
+    _mockLink = qobject_cast<MockLink*>(linkManager->createConnectedLink(linkManager->addConfiguration(mockConfig)));
+    QVERIFY(_mockLink);
+    QCOMPARE(spyVehicle.wait(10000), true);
+    _vehicle = vehicleManager->activeVehicle();
+    QVERIFY(_vehicle);
+
+    // GLOBAL_POSITION_INT carries the altitude above home, so its position is valid right away
+    QTRY_VERIFY_WITH_TIMEOUT(_vehicle->stateSnapshot().positionValid(), 5000);
+    VehicleStateSnapshot state = _vehicle->stateSnapshot();
+    QVERIFY(!qIsNaN(state.altitudeRelative));
+    QCOMPARE(state.altitudeRelative, _vehicle->altitudeRelative()->rawValue().toDouble());
+}
@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleTelemetryStore.h"
+
+VehicleTelemetryStore::VehicleTelemetryStore(int retention)
+    : _retention(retention)
+{
+    // All columns are allocated up front so the writer never reallocates underneath a reader
+    for (int i=0; i<DoubleColumnCount; i++) {
+        _doubleColumns.append(new DoubleRing(retention));
+    }
+    for (int i=0; i<IntColumnCount; i++) {
+        _intColumns.append(new IntRing(retention));
+    }
+}
+
+VehicleTelemetryStore::~VehicleTelemetryStore()
+{
+    qDeleteAll(_doubleColumns);
+    qDeleteAll(_intColumns);
+}
@@ -0,0 +1,230 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QVector>
+#include <QAtomicInteger>
+
+#include <atomic>
+
+/// Fixed capacity history of one telemetry value. There is a single writer, the thread the owning Vehicle lives on,
+/// and any number of readers on other threads. Readers never block the writer and never take a lock.
+///
+/// Range queries return pointers directly into the ring. Since the writer keeps going while the range is in use, the
+/// oldest samples of a range can be overwritten once the writer laps the ring. Check isValid after using a range and
+/// discard the results if it returns false.
+template <typename T>
+class TelemetryRingColumn
+{
+public:
+    explicit TelemetryRingColumn(int capacity)
+        : _capacity(qMax(1, capacity))
+        , _slots(_capacity + 1)
+        , _times(_slots)
+        , _values(_slots)
+        , _written(0)
+    {
+    }
+
+    /// A contiguous piece of a range
+    struct Span {
+        const qint64*   times;
+        const T*        values;
+        int             count;
+    };
+
+    /// Samples within a time window. A range can wrap the end of the ring, in which case it is split in two spans.
+    struct Range {
+        Span    first;
+        Span    second;
+        quint64 begin;  ///< Sequence number of the first sample
+        quint64 end;    ///< Sequence number after the last sample
+
+        int count(void) const { return first.count + second.count; }
+    };
+
+    /// Adds a sample, overwriting the oldest one when the ring is full. Writer thread only.
+    void append(qint64 msecs, T value)
+    {
+        quint64 sequence = _written.load();
+        int slot = sequence % _slots;
+        _times[slot] = msecs;
+        _values[slot] = value;
+        _written.storeRelease(sequence + 1);
+    }
+
+    int capacity(void) const { return _capacity; }
+
+    /// @return Number of samples currently held
+    int count(void) const { return qMin<quint64>(_written.loadAcquire(), _capacity); }
+
+    /// @return Total number of samples appended since creation
+    quint64 written(void) const { return _written.loadAcquire(); }
+
+    /// Most recent sample
+    /// @return false: no samples yet
+    bool latest(qint64* msecs, T* value) const
+    {
+        quint64 written = _written.loadAcquire();
+        if (written == 0) {
+            return false;
+        }
+        int slot = (written - 1) % _slots;
+        *msecs = _times[slot];
+        *value = _values[slot];
+        // The writer may have lapped the ring while the sample was read
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return written - 1 + _slots > _written.loadAcquire();
+    }
+
+    /// Samples with fromMsecs <= time <= toMsecs. Timestamps are expected to be non-decreasing.
+    Range range(qint64 fromMsecs, qint64 toMsecs) const
+    {
+        quint64 written = _written.loadAcquire();
+        quint64 oldest = written > (quint64)_capacity ? written - _capacity : 0;
+
+        quint64 begin = _lowerBound(oldest, written, fromMsecs);
+        quint64 end = _upperBound(begin, written, toMsecs);
+        return _makeRange(begin, end);
+    }
+
+    /// All samples currently held
+    Range all(void) const
+    {
+        quint64 written = _written.loadAcquire();
+        return _makeRange(written > (quint64)_capacity ? written - _capacity : 0, written);
+    }
+
+    /// @return true: No sample in the range has been overwritten since the range was returned. While _written is
+    ///         begin + _slots the writer may already be filling the slot of begin, so that counts as overwritten.
+    bool isValid(const Range& range) const
+    {
+        // Keeps the reads of the range from moving past the load of _written
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return range.begin + _slots > _written.loadAcquire();
+    }
+
+private:
+    qint64 _timeAt(quint64 sequence) const { return _times[sequence % _slots]; }
+
+    quint64 _lowerBound(quint64 first, quint64 last, qint64 msecs) const
+    {
+        while (first < last) {
+            quint64 middle = first + ((last - first) / 2);
+            if (_timeAt(middle) < msecs) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        return first;
+    }
+
+    quint64 _upperBound(quint64 first, quint64 last, qint64 msecs) const
+    {
+        while (first < last) {
+            quint64 middle = first + ((last - first) / 2);
+            if (_timeAt(middle) <= msecs) {
+                first = middle + 1;
+            } else {
+                last = middle;
+            }
+        }
+        return first;
+    }
+
+    Range _makeRange(quint64 begin, quint64 end) const
+    {
+        Range range;
+        range.begin = begin;
+        range.end = end;
+
+        int count = end - begin;
+        int firstSlot = begin % _slots;
+        int firstCount = qMin(count, _slots - firstSlot);
+
+        range.first.times = _times.constData() + firstSlot;
+        range.first.values = _values.constData() + firstSlot;
+        range.first.count = firstCount;
+        range.second.times = _times.constData();
+        range.second.values = _values.constData();
+        range.second.count = count - firstCount;
+
+        return range;
+    }
+
+    const int               _capacity;
+    const int               _slots;     ///< One more than _capacity, the slot the writer fills next holds no sample
+    QVector<qint64>         _times;
+    QVector<T>              _values;
+    QAtomicInteger<quint64> _written;   ///< Total samples appended, published with release semantics after each write
+};
+
+/// Optional per vehicle history of the telemetry values which are normally only available as the latest value in the
+/// vehicle FactGroups. Columns are filled directly from the Vehicle mavlink message handlers. Each column keeps the
+/// most recent retention samples with their receive time.
+class VehicleTelemetryStore
+{
+public:
+    VehicleTelemetryStore(int retention);
+    ~VehicleTelemetryStore();
+
+    enum DoubleColumn {
+        Latitude,
+        Longitude,
+        AltitudeAMSL,
+        AltitudeRelative,
+        AirSpeed,
+        GroundSpeed,
+        ClimbRate,
+        GpsHdop,
+        GpsVdop,
+        GpsCourseOverGround,
+        VibrationX,
+        VibrationY,
+        VibrationZ,
+        WindDirection,
+        WindSpeed,
+        WindVerticalSpeed,
+        BatteryVoltage,
+        BatteryCurrent,
+        BatteryTemperature,
+        DoubleColumnCount
+    };
+
+    enum IntColumn {
+        GpsCount,
+        GpsLock,
+        ClipCount1,
+        ClipCount2,
+        ClipCount3,
+        BatteryPercentRemaining,
+        BatteryMahConsumed,
+        BatteryCellCount,
+        IntColumnCount
+    };
+
+    typedef TelemetryRingColumn<double> DoubleRing;
+    typedef TelemetryRingColumn<qint32> IntRing;
+
+    int retention(void) const { return _retention; }
+
+    const DoubleRing&   column(DoubleColumn column) const   { return *_doubleColumns[column]; }
+    const IntRing&      column(IntColumn column) const      { return *_intColumns[column]; }
+
+    /// Writer side, only called from the thread the Vehicle lives on
+    void append(DoubleColumn column, qint64 msecs, double value)    { _doubleColumns[column]->append(msecs, value); }
+    void append(IntColumn column, qint64 msecs, qint32 value)       { _intColumns[column]->append(msecs, value); }
+
+private:
+    int                     _retention;
+    QVector<DoubleRing*>    _doubleColumns;
+    QVector<IntRing*>       _intColumns;
+};
@@ -0,0 +1,125 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "VehicleTelemetryStoreTest.h"
+#include "VehicleTelemetryStore.h"
+
+#include <QThread>
+
+typedef TelemetryRingColumn<qint64> TestRing;
+
+/// Appends samples whose value is twice their time as fast as it can, so a reader can tell a torn sample
+class TelemetryRingWriter : public QThread
+{
+public:
+    TelemetryRingWriter(TestRing* ring, int count)
+        : _ring(ring)
+        , _count(count)
+    {
+    }
+
+protected:
+    void run(void) final
+    {
+        for (int i=0; i<_count; i++) {
+            _ring->append(i, 2 * (qint64)i);
+        }
+    }
+
+private:
+    TestRing*   _ring;
+    int         _count;
+};
+
+void VehicleTelemetryStoreTest::_ringQueries(void)
+{
+    TestRing    ring(4);
+    qint64      msecs;
+    qint64      value;
+
+    QCOMPARE(ring.latest(&msecs, &value), false);
+    QCOMPARE(ring.all().count(), 0);
+
+    for (int i=0; i<3; i++) {
+        ring.append(i * 10, i);
+    }
+    QCOMPARE(ring.count(), 3);
+    QCOMPARE(ring.latest(&msecs, &value), true);
+    QCOMPARE(msecs, (qint64)20);
+    QCOMPARE(value, (qint64)2);
+
+    TestRing::Range range = ring.range(5, 20);
+    QCOMPARE(range.count(), 2);
+    QCOMPARE(range.first.times[0], (qint64)10);
+    QVERIFY(ring.isValid(range));
+
+    // Wrap the ring, the window then spans its end
+    for (int i=3; i<6; i++) {
+        ring.append(i * 10, i);
+    }
+    QCOMPARE(ring.count(), 4);
+    QCOMPARE(ring.written(), (quint64)6);
+
+    range = ring.all();
+    QCOMPARE(range.count(), 4);
+    QCOMPARE(range.first.count, 3);
+    QCOMPARE(range.first.times[0], (qint64)20);
+    QCOMPARE(range.second.times[0], (qint64)50);
+    QVERIFY(ring.isValid(range));
+
+    // Once the oldest sample of a range is the next one to be written over, the range counts as overwritten
+    TestRing::Range old = ring.range(20, 20);
+    QCOMPARE(old.count(), 1);
+    QVERIFY(ring.isValid(old));
+    ring.append(60, 6);
+    QCOMPARE(ring.isValid(old), false);
+}
+
+void VehicleTelemetryStoreTest::_concurrentReader(void)
+{
+    // A small ring so the writer laps the reader all the time
+    TestRing            ring(8);
+    TelemetryRingWriter writer(&ring, 2000000);
+    int                 validLatest = 0;
+    int                 validRanges = 0;
+
+    writer.start();
+    while (!writer.isFinished()) {
+        qint64 msecs;
+        qint64 value;
+        if (ring.latest(&msecs, &value)) {
+            QCOMPARE(value, 2 * msecs);
+            validLatest++;
+        }
+
+        // Copy the samples out first, only then may the range be checked
+        TestRing::Range range = ring.all();
+        QVector<qint64> times;
+        QVector<qint64> values;
+        for (int i=0; i<range.first.count; i++) {
+            times.append(range.first.times[i]);
+            values.append(range.first.values[i]);
+        }
+        for (int i=0; i<range.second.count; i++) {
+            times.append(range.second.times[i]);
+            values.append(range.second.values[i]);
+        }
+        if (ring.isValid(range)) {
+            for (int i=0; i<times.count(); i++) {
+                QCOMPARE(times[i], (qint64)(range.begin + i));
+                QCOMPARE(values[i], 2 * times[i]);
+            }
+            validRanges++;
+        }
+    }
+    writer.wait();
+
+    QVERIFY(validLatest > 0);
+    QVERIFY(validRanges > 0);
+}
@@ -80,7 +80,7 @@ void BluetoothLink::_writeBytes(const QByteArray bytes)
         if(_targetSocket->isWritable())
         {
             if(_targetSocket->write(bytes) > 0) {
-                _logOutputDataRate(bytes.size(), QDateTime::currentMSecsSinceEpoch());
+                _logOutputDataRate(bytes.size(), QGCClock::instance()->currentMSecsSinceEpoch());
             }
             else
                 qWarning() << "Bluetooth write error";
@@ -97,8 +97,8 @@ void BluetoothLink::readBytes()
         QByteArray datagram;
         datagram.resize(_targetSocket->bytesAvailable());
         _targetSocket->read(datagram.data(), datagram.size());
-        emit bytesReceived(this, datagram);
-        _logInputDataRate(datagram.length(), QDateTime::currentMSecsSinceEpoch());
+        _bytesReceived(datagram);
+        _logInputDataRate(datagram.length(), QGCClock::instance()->currentMSecsSinceEpoch());
     }
 }
 
@@ -228,12 +228,12 @@ qint64 BluetoothLink::getConnectionSpeed() const
 
 qint64 BluetoothLink::getCurrentInDataRate() const
 {
-    return 0;
+    return getCurrentInputDataRate();
 }
 
 qint64 BluetoothLink::getCurrentOutDataRate() const
 {
-    return 0;
+    return getCurrentOutputDataRate();
 }
 
 //--------------------------------------------------------------------------
@@ -270,29 +270,25 @@ void BluetoothConfiguration::copyFrom(LinkConfiguration *source)
     _device = usource->device();
 }
 
-void BluetoothConfiguration::saveSettings(QSettings& settings, const QString& root)
+void BluetoothConfiguration::saveSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    settings.setValue("deviceName", _device.name);
+    settings.setValue(root, "deviceName", _device.name);
 #ifdef __ios__
-    settings.setValue("uuid", _device.uuid.toString());
+    settings.setValue(root, "uuid", _device.uuid.toString());
 #else
-    settings.setValue("address",_device.address);
+    settings.setValue(root, "address",_device.address);
 #endif
-    settings.endGroup();
 }
 
-void BluetoothConfiguration::loadSettings(QSettings& settings, const QString& root)
+void BluetoothConfiguration::loadSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    _device.name    = settings.value("deviceName", _device.name).toString();
+    _device.name    = settings.value(root, "deviceName", _device.name).toString();
 #ifdef __ios__
-    QString suuid   = settings.value("uuid", _device.uuid.toString()).toString();
+    QString suuid   = settings.value(root, "uuid", _device.uuid.toString()).toString();
     _device.uuid    = QUuid(suuid);
 #else
-    _device.address = settings.value("address", _device.address).toString();
+    _device.address = settings.value(root, "address", _device.address).toString();
 #endif
-    settings.endGroup();
 }
 
 void BluetoothConfiguration::updateSettings()
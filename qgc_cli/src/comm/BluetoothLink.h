@@ -101,8 +101,8 @@ public:
     /// From LinkConfiguration
     LinkType    type                    () { return LinkConfiguration::TypeBluetooth; }
     void        copyFrom                (LinkConfiguration* source);
-    void        loadSettings            (QSettings& settings, const QString& root);
-    void        saveSettings            (QSettings& settings, const QString& root);
+    void        loadSettings            (SettingsStore& settings, const QString& root);
+    void        saveSettings            (SettingsStore& settings, const QString& root);
     void        updateSettings          ();
     QString     settingsURL             () { return "BluetoothSettings.qml"; }
 
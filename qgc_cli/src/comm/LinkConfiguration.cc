@@ -26,9 +26,8 @@
 #ifdef QGC_ENABLE_BLUETOOTH
 #include "BluetoothLink.h"
 #endif
-#ifdef QT_DEBUG
-//#include "MockLink.h"
-#endif
+#include "MockLink.h"
+#include "MAVLinkSigning.h"
 
 #define LINK_SETTING_ROOT "LinkConfigurations"
 
@@ -37,6 +36,7 @@ LinkConfiguration::LinkConfiguration(const QString& name)
     , _name(name)
     , _dynamic(false)
     , _autoConnect(false)
+    , _signingLinkId(0)
 {
     _name = name;
     if (_name.isEmpty()) {
@@ -50,6 +50,8 @@ LinkConfiguration::LinkConfiguration(LinkConfiguration* copy)
     _name       = copy->name();
     _dynamic    = copy->isDynamic();
     _autoConnect= copy->isAutoConnect();
+    _signingKey = copy->signingKey();
+    _signingLinkId = copy->signingLinkId();
     Q_ASSERT(!_name.isEmpty());
 }
 
@@ -60,6 +62,18 @@ void LinkConfiguration::copyFrom(LinkConfiguration* source)
     _name       = source->name();
     _dynamic    = source->isDynamic();
     _autoConnect= source->isAutoConnect();
+    _signingKey = source->signingKey();
+    _signingLinkId = source->signingLinkId();
+}
+
+void LinkConfiguration::setSigningKey(const QByteArray& key)
+{
+    if (!key.isEmpty() && key.size() != MAVLinkSigning::keyLength) {
+        qWarning() << "Signing key must be" << MAVLinkSigning::keyLength << "bytes, signing not changed for" << _name;
+        return;
+    }
+    _signingKey = key;
+    emit signingChanged();
 }
 
 /*!
@@ -90,6 +104,9 @@ LinkConfiguration* LinkConfiguration::createSettings(int type, const QString& na
         case LinkConfiguration::TypeTcp:
             config = new TCPConfiguration(name);
             break;
+        case LinkConfiguration::TypeMock:
+            config = new MockConfiguration(name);
+            break;
 /*
 #ifdef QGC_ENABLE_BLUETOOTH
     case LinkConfiguration::TypeBluetooth:
@@ -101,11 +118,6 @@ LinkConfiguration* LinkConfiguration::createSettings(int type, const QString& na
             config = new LogReplayLinkConfiguration(name);
             break;
 #endif
-#ifdef QT_DEBUG
-        case LinkConfiguration::TypeMock:
-            config = new MockConfiguration(name);
-            break;
-#endif
 */
     }
     return config;
@@ -130,6 +142,9 @@ LinkConfiguration* LinkConfiguration::duplicateSettings(LinkConfiguration* sourc
         case TypeTcp:
             dupe = new TCPConfiguration(dynamic_cast<TCPConfiguration*>(source));
             break;
+        case TypeMock:
+            dupe = new MockConfiguration(dynamic_cast<MockConfiguration*>(source));
+            break;
 /*
 #ifdef QGC_ENABLE_BLUETOOTH
         case TypeBluetooth:
@@ -141,11 +156,6 @@ LinkConfiguration* LinkConfiguration::duplicateSettings(LinkConfiguration* sourc
             dupe = new LogReplayLinkConfiguration(dynamic_cast<LogReplayLinkConfiguration*>(source));
             break;
 #endif
-#ifdef QT_DEBUG
-        case TypeMock:
-            dupe = new MockConfiguration(dynamic_cast<MockConfiguration*>(source));
-            break;
-#endif
 */
         case TypeLast:
         default:
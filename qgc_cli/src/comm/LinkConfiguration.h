@@ -10,7 +10,8 @@
 #ifndef LINKCONFIGURATION_H
 #define LINKCONFIGURATION_H
 
-#include <QSettings>
+#include "SettingsStore.h"
+#include <QByteArray>
 
 class LinkInterface;
 
@@ -33,6 +34,7 @@ public:
     Q_PROPERTY(bool             autoConnect         READ isAutoConnect  WRITE setAutoConnect    NOTIFY autoConnectChanged)
     Q_PROPERTY(bool             autoConnectAllowed  READ isAutoConnectAllowed                   CONSTANT)
     Q_PROPERTY(QString          settingsURL         READ settingsURL                            CONSTANT)
+    Q_PROPERTY(bool             signingEnabled      READ signingEnabled                         NOTIFY signingChanged)
 
     // Property accessors
 
@@ -50,13 +52,11 @@ public:
 #endif
 //        TypeUdp,        ///< UDP Link
         TypeTcp,        ///< TCP Link
+        TypeMock,       ///< Mock Link for Unitesting and load generation
 /*
 #ifdef QGC_ENABLE_BLUETOOTH
         TypeBluetooth,  ///< Bluetooth Link
 #endif
-#ifdef QT_DEBUG
-        TypeMock,       ///< Mock Link for Unitesting
-#endif
 #ifndef __mobile__
         TypeLogReplay,
 #endif
@@ -88,6 +88,16 @@ public:
     */
     void setAutoConnect(bool autoc = true) { _autoConnect = autoc; emit autoConnectChanged(); }
 
+    /// MAVLink 2 signing key of the link, empty for no signing. Takes effect the next time the link is added to
+    /// LinkManager. The key is a secret, it is never saved with the link settings and has to be given again each run.
+    QByteArray  signingKey(void) const { return _signingKey; }
+    void        setSigningKey(const QByteArray& key);
+    bool        signingEnabled(void) const { return !_signingKey.isEmpty(); }
+
+    /// Id of the link in the signatures it sends, lets the other end tell the streams of several links apart
+    quint8      signingLinkId(void) const { return _signingLinkId; }
+    void        setSigningLinkId(quint8 linkId) { _signingLinkId = linkId; }
+
     /// Virtual Methods
 
     /*!
@@ -109,19 +119,19 @@ public:
      * @brief Load settings
      *
      * Pure virtual method telling the instance to load its configuration.
-     * @param[in] settings The QSettings instance to use
+     * @param[in] settings The settings store to use
      * @param[in] root The root path of the setting.
      */
-    virtual void loadSettings(QSettings& settings, const QString& root) = 0;
+    virtual void loadSettings(SettingsStore& settings, const QString& root) = 0;
 
     /*!
      * @brief Save settings
      *
      * Pure virtual method telling the instance to save its configuration.
-     * @param[in] settings The QSettings instance to use
+     * @param[in] settings The settings store to use
      * @param[in] root The root path of the setting.
      */
-    virtual void saveSettings(QSettings& settings, const QString& root) = 0;
+    virtual void saveSettings(SettingsStore& settings, const QString& root) = 0;
 
     /*!
      * @brief Settings URL
@@ -149,7 +159,7 @@ public:
     /// Helper static methods
 
     /*!
-     * @brief Root path for QSettings
+     * @brief Root group of the link settings in the settings store
      *
      * @return The root path of the settings.
      */
@@ -176,6 +186,7 @@ signals:
     void dynamicChanged     ();
     void autoConnectChanged ();
     void linkChanged        (LinkInterface* link);
+    void signingChanged     ();
 
 protected:
     LinkInterface* _link; ///< Link currently using this configuration (if any)
@@ -183,6 +194,8 @@ private:
     QString _name;
     bool    _dynamic;       ///< A connection added automatically and not persistent (unless it's edited).
     bool    _autoConnect;   ///< This connection is started automatically at boot
+    QByteArray  _signingKey;
+    quint8      _signingLinkId;
 };
 
 typedef QSharedPointer<LinkConfiguration> SharedLinkConfigurationPointer;
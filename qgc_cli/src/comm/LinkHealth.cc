@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkHealth.h"
+
+#include <cmath>
+
+LinkHealth::LinkHealth(void)
+{
+    reset();
+}
+
+void LinkHealth::reset(void)
+{
+    _lastHeard = -1;
+    _lossRatio = 0;
+    _roundTrip = -1;
+}
+
+void LinkHealth::frameReceived(int lost, qint64 time)
+{
+    const double keep = 1.0 - 1.0 / _averageFrames;
+
+    // Every lost frame moves the average towards 1, the received one towards 0
+    if (lost > 0) {
+        _lossRatio = 1.0 - (1.0 - _lossRatio) * std::pow(keep, lost);
+    }
+    _lossRatio *= keep;
+
+    _lastHeard = time;
+}
+
+void LinkHealth::roundTrip(qint64 msecs)
+{
+    if (_roundTrip < 0) {
+        _roundTrip = msecs;
+    } else {
+        _roundTrip += (msecs - _roundTrip) / _averageAcks;
+    }
+}
+
+int LinkHealth::score(qint64 now) const
+{
+    if (_lastHeard < 0) {
+        return 0;
+    }
+
+    qint64 age = now - _lastHeard;
+    double ageFactor = 1.0;
+    if (age >= staleMSecs) {
+        return 0;
+    } else if (age > freshMSecs) {
+        ageFactor = double(staleMSecs - age) / (staleMSecs - freshMSecs);
+    }
+
+    // Half the frames lost is as bad as not hearing the link at all
+    double lossFactor = qMax(0.0, 1.0 - 2.0 * _lossRatio);
+
+    double roundTripFactor = 1.0;
+    if (_roundTrip > _slowRoundTrip) {
+        roundTripFactor = 1.0 - 0.5 * qMin(1.0, (_roundTrip - _slowRoundTrip) / (_maxRoundTrip - _slowRoundTrip));
+    }
+
+    return qRound(100.0 * ageFactor * lossFactor * roundTripFactor);
+}
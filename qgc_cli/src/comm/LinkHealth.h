@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtGlobal>
+
+/// Health of a link from how recently it was heard, the share of frames lost on it and the round trip of the
+/// commands answered over it, as a score from 0 to 100. MAVLinkProtocol reports every frame decoded on the link,
+/// also the ones dropped as already heard on another link, so a redundant link is scored on its own traffic. Vehicle
+/// reports command round trips. Updates and reads are made on the main thread.
+class LinkHealth
+{
+public:
+    LinkHealth(void);
+
+    /// A frame was decoded on the link
+    ///     @param lost Frames missing before this one
+    ///     @param time QGCClock::elapsed the frame was received at
+    void frameReceived(int lost, qint64 time);
+
+    /// A command sent over the link was acked after msecs
+    void roundTrip(qint64 msecs);
+
+    /// @return QGCClock::elapsed of the last frame, -1 if none was received
+    qint64 lastHeard(void) const { return _lastHeard; }
+
+    /// @return Moving average of the share of frames lost, over about the last 32 frames
+    double lossRatio(void) const { return _lossRatio; }
+
+    /// @return Moving average of the command round trip in ms, -1 if no command was acked over the link
+    double roundTripTime(void) const { return _roundTrip; }
+
+    /// @return 0 for a link which was not heard for staleMSecs, up to 100 for a link heard within freshMSecs without
+    ///         loss and with quick command round trips
+    int score(qint64 now) const;
+
+    /// @return true if the score is at least healthyScore
+    bool healthy(qint64 now) const { return score(now) >= healthyScore; }
+
+    void reset(void);
+
+    static const int    healthyScore    = 50;
+    static const qint64 freshMSecs      = 300;
+    static const qint64 staleMSecs      = 1500;
+
+private:
+    static const int    _averageFrames  = 32;   ///< Weight of a new frame in the loss average is 1 / _averageFrames
+    static const int    _averageAcks    = 4;    ///< Weight of a new round trip in its average is 1 / _averageAcks
+    static const qint64 _slowRoundTrip  = 200;  ///< Round trips up to this don't lower the score
+    static const qint64 _maxRoundTrip   = 2000; ///< Round trips from this on halve the score
+
+    qint64  _lastHeard;
+    double  _lossRatio;
+    double  _roundTrip;
+};
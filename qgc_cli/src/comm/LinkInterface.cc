@@ -9,6 +9,7 @@
 
 #include "LinkInterface.h"
 #include "QGCApplication.h"
+#include "MAVLinkSigning.h"
 
 /// mavlink channel to use for this link, as used by mavlink_parse_char. The mavlink channel is only
 /// set into the link when it is added to LinkManager
@@ -25,128 +26,73 @@ LinkInterface::LinkInterface(SharedLinkConfigurationPointer& config)
     , _config(config)
     , _mavlinkChannelSet(false)
     , _active(false)
-    , _enableRateCollection(false)
+    , _enableRateCollection(true)
     , _decodedFirstMavlinkPacket(false)
+    , _writeFrameCount(0)
 {
     _config->setLink(this);
 
-    // Initialize everything for the data rate calculation buffers.
-    _inDataIndex  = 0;
-    _outDataIndex = 0;
+    memset(&_signing, 0, sizeof(_signing));
 
-    // Initialize our data rate buffers.
-    memset(_inDataWriteAmounts, 0, sizeof(_inDataWriteAmounts));
-    memset(_inDataWriteTimes,   0, sizeof(_inDataWriteTimes));
-    memset(_outDataWriteAmounts,0, sizeof(_outDataWriteAmounts));
-    memset(_outDataWriteTimes,  0, sizeof(_outDataWriteTimes));
+    QGCMetrics*     metrics = QGCMetrics::instance();
+    QGCMetricLabels labels = { { QStringLiteral("link"), _config->name() } };
+    _metrics.framesReceived  = metrics->counter("mavlink_frames_received_total", "MAVLink frames decoded on the link", labels);
+    _metrics.framesLost      = metrics->counter("mavlink_frames_lost_total", "MAVLink frames missing from the sequence numbers on the link", labels);
+    _metrics.framesDuplicate = metrics->counter("mavlink_frames_duplicate_total", "MAVLink frames dropped as already heard on another link", labels);
+    _metrics.dispatchLatency = metrics->histogram("mavlink_dispatch_latency_us", "Time from the arrival of the bytes to the dispatch of the frame", labels);
+    _metrics.handlerTime     = metrics->histogram("mavlink_handler_us", "Time spent in the handlers of a frame", labels);
 
     QObject::connect(this, &LinkInterface::_invokeWriteBytes, this, &LinkInterface::_writeBytes);
+    QObject::connect(this, &LinkInterface::_invokeWriteFrames, this, &LinkInterface::_writeFrames);
     qRegisterMetaType<LinkInterface*>("LinkInterface*");
 }
 
-/// This function logs the send times and amounts of datas for input. Data is used for calculating
-/// the transmission rate.
+LinkInterface::~LinkInterface()
+{
+    _config->setLink(NULL);
+
+    QGCMetrics::instance()->release(_metrics.framesReceived);
+    QGCMetrics::instance()->release(_metrics.framesLost);
+    QGCMetrics::instance()->release(_metrics.framesDuplicate);
+    QGCMetrics::instance()->release(_metrics.dispatchLatency);
+    QGCMetrics::instance()->release(_metrics.handlerTime);
+}
+
+/// This function logs the receive times and amounts of datas for input. Totals are always counted, the time
+/// buckets used for the transmission rate only while data rate collection is enabled.
 ///     @param byteCount Number of bytes received
-///     @param time Time in ms send occurred
+///     @param time Time in ms receive occurred
 void LinkInterface::_logInputDataRate(quint64 byteCount, qint64 time) {
-    if(_enableRateCollection)
-        _logDataRateToBuffer(_inDataWriteAmounts, _inDataWriteTimes, &_inDataIndex, byteCount, time);
+    _inputStatistics.log(byteCount, time, _enableRateCollection.load(std::memory_order_relaxed));
 }
 
-/// This function logs the send times and amounts of datas for output. Data is used for calculating
-/// the transmission rate.
+/// This function logs the send times and amounts of datas for output, see _logInputDataRate.
 ///     @param byteCount Number of bytes sent
-///     @param time Time in ms receive occurred
+///     @param time Time in ms send occurred
 void LinkInterface::_logOutputDataRate(quint64 byteCount, qint64 time) {
-    if(_enableRateCollection)
-        _logDataRateToBuffer(_outDataWriteAmounts, _outDataWriteTimes, &_outDataIndex, byteCount, time);
+    bool buckets = _enableRateCollection.load(std::memory_order_relaxed);
+    _outputStatistics.log(byteCount, time, buckets);
+    if (_writeFrameCount) {
+        _outputStatistics.logFrames(_writeFrameCount, time, buckets);
+    }
 }
 
-/**
-     * @brief logDataRateToBuffer Stores transmission times/amounts for statistics
-     *
-     * This function logs the send times and amounts of datas to the given circular buffers.
-     * This data is used for calculating the transmission rate.
-     *
-     * @param bytesBuffer[out] The buffer to write the bytes value into.
-     * @param timeBuffer[out] The buffer to write the time value into
-     * @param writeIndex[out] The write index used for this buffer.
-     * @param bytes The amount of bytes transmit.
-     * @param time The time (in ms) this transmission occurred.
-     */
-void LinkInterface::_logDataRateToBuffer(quint64 *bytesBuffer, qint64 *timeBuffer, int *writeIndex, quint64 bytes, qint64 time)
-{
-    QMutexLocker dataRateLocker(&_dataRateMutex);
-
-    int i = *writeIndex;
-
-    // Now write into the buffer, if there's no room, we just overwrite the first data point.
-    bytesBuffer[i] = bytes;
-    timeBuffer[i] = time;
-
-    // Increment and wrap the write index
-    ++i;
-    if (i == _dataRateBufferSize)
-    {
-        i = 0;
-    }
-    *writeIndex = i;
+void LinkInterface::_logInputFrames(quint32 frames, qint64 time) {
+    _inputStatistics.logFrames(frames, time, _enableRateCollection.load(std::memory_order_relaxed));
 }
 
-/**
-     * @brief getCurrentDataRate Get the current data rate given a data rate buffer.
-     *
-     * This function attempts to use the times and number of bytes transmit into a current data rate
-     * estimation. Since it needs to use timestamps to get the timeperiods over when the data was sent,
-     * this is effectively a global data rate over the last _dataRateBufferSize - 1 data points. Also note
-     * that data points older than NOW - dataRateCurrentTimespan are ignored.
-     *
-     * @param index The first valid sample in the data rate buffer. Refers to the oldest time sample.
-     * @param dataWriteTimes The time, in ms since epoch, that each data sample took place.
-     * @param dataWriteAmounts The amount of data (in bits) that was transferred.
-     * @return The bits per second of data transferrence of the interface over the last [-statsCurrentTimespan, 0] timespan.
-     */
-qint64 LinkInterface::_getCurrentDataRate(int index, const qint64 dataWriteTimes[], const quint64 dataWriteAmounts[]) const
+/// Writes bytes on the link's thread, the frames in them are logged with each successful write
+void LinkInterface::_writeFrames(const QByteArray bytes, int frames)
 {
-    const qint64 now = QDateTime::currentMSecsSinceEpoch();
-
-    // Limit the time we calculate to the recent past
-    const qint64 cutoff = now - _dataRateCurrentTimespan;
-
-    // Grab the mutex for working with the stats variables
-    QMutexLocker dataRateLocker(&_dataRateMutex);
-
-    // Now iterate through the buffer of all received data packets adding up all values
-    // within now and our cutof.
-    qint64 totalBytes = 0;
-    qint64 totalTime = 0;
-    qint64 lastTime = 0;
-    int size = _dataRateBufferSize;
-    while (size-- > 0)
-    {
-        // If this data is within our cutoff time, include it in our calculations.
-        // This also accounts for when the buffer is empty and filled with 0-times.
-        if (dataWriteTimes[index] > cutoff && lastTime > 0) {
-            // Track the total time, using the previous time as our timeperiod.
-            totalTime += dataWriteTimes[index] - lastTime;
-            totalBytes += dataWriteAmounts[index];
-        }
-
-        // Track the last time sample for doing timespan calculations
-        lastTime = dataWriteTimes[index];
-
-        // Increment and wrap the index if necessary.
-        if (++index == _dataRateBufferSize)
-        {
-            index = 0;
-        }
-    }
-
-    // Return the final calculated value in bits / s, converted from bytes/ms.
-    qint64 dataRate = (totalTime != 0)?(qint64)((float)totalBytes * 8.0f / ((float)totalTime / 1000.0f)):0;
+    _writeFrameCount = frames;
+    _writeBytes(bytes);
+    _writeFrameCount = 0;
+}
 
-    // Finally return our calculated data rate.
-    return dataRate;
+void LinkInterface::_bytesReceived(const QByteArray& data)
+{
+    emit bytesArrived(this, data, QGCClock::instance()->wallElapsedUSecs());
+    emit bytesReceived(this, data);
 }
 
 /// Sets the mavlink channel to use for this link
@@ -158,3 +104,31 @@ void LinkInterface::_setMavlinkChannel(uint8_t channel)
     _mavlinkChannelSet = true;
     _mavlinkChannel = channel;
 }
+
+void LinkInterface::_startSigning(void)
+{
+    if (!_mavlinkChannelSet || !_config->signingEnabled()) {
+        return;
+    }
+
+    MAVLinkSigning::initSigning(&_signing, _config->signingKey(), _config->signingLinkId());
+
+    // Signatures only exist in MAVLink 2, so a signing link talks it from the start
+    mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(_mavlinkChannel);
+    mavlinkStatus->signing = &_signing;
+    mavlinkStatus->signing_streams = MAVLinkSigning::streams();
+    mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+}
+
+void LinkInterface::_stopSigning(void)
+{
+    if (!_mavlinkChannelSet) {
+        return;
+    }
+
+    mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(_mavlinkChannel);
+    if (mavlinkStatus->signing == &_signing) {
+        mavlinkStatus->signing = NULL;
+        mavlinkStatus->signing_streams = NULL;
+    }
+}
@@ -20,6 +20,10 @@
 
 #include "QGCMAVLink.h"
 #include "LinkConfiguration.h"
+#include "QGCClock.h"
+#include "LinkStatistics.h"
+#include "LinkHealth.h"
+#include "QGCMetrics.h"
 
 class LinkManager;
 
@@ -35,8 +39,11 @@ class LinkInterface : public QThread
     // Only LinkManager is allowed to create/delete or _connect/_disconnect a link
     friend class LinkManager;
 
+    // MAVLinkProtocol logs the frames it decodes from the link
+    friend class MAVLinkProtocol;
+
 public:    
-    ~LinkInterface() { _config->setLink(NULL); }
+    ~LinkInterface();
 
     Q_PROPERTY(bool active      READ active         WRITE setActive         NOTIFY activeChanged)
 
@@ -96,7 +103,7 @@ public:
      **/
     qint64 getCurrentInputDataRate() const
     {
-        return _getCurrentDataRate(_inDataIndex, _inDataWriteTimes, _inDataWriteAmounts);
+        return _inputStatistics.dataRate(QGCClock::instance()->currentMSecsSinceEpoch(), _dataRateCurrentTimespan);
     }
 
     /**
@@ -109,8 +116,30 @@ public:
      **/
     qint64 getCurrentOutputDataRate() const
     {
-        return _getCurrentDataRate(_outDataIndex, _outDataWriteTimes, _outDataWriteAmounts);
+        return _outputStatistics.dataRate(QGCClock::instance()->currentMSecsSinceEpoch(), _dataRateCurrentTimespan);
     }
+
+    /// Totals and recent history of the received traffic, times are QGCClock::currentMSecsSinceEpoch. Can be read on
+    /// any thread without holding up the link.
+    const LinkStatistics& inputStatistics(void) const { return _inputStatistics; }
+
+    /// Totals and recent history of the sent traffic, see inputStatistics
+    const LinkStatistics& outputStatistics(void) const { return _outputStatistics; }
+
+    /// Registry metrics of the link, labelled with the configuration name and updated by MAVLinkProtocol
+    struct Metrics {
+        QGCMetricCounter*   framesReceived;
+        QGCMetricCounter*   framesLost;         ///< Gaps in the sequence numbers
+        QGCMetricCounter*   framesDuplicate;    ///< Frames dropped as already heard on another link
+        QGCMetricHistogram* dispatchLatency;    ///< us from the arrival of the bytes to the dispatch of the frame
+        QGCMetricHistogram* handlerTime;        ///< us spent in the messageReceived handlers
+    };
+
+    const Metrics& metrics(void) const { return _metrics; }
+
+    /// Health score of the link, used by Vehicle to pick its priority link
+    LinkHealth&         health(void)        { return _health; }
+    const LinkHealth&   health(void) const  { return _health; }
     
     /// mavlink channel to use for this link, as used by mavlink_parse_char. The mavlink channel is only
     /// set into the link when it is added to LinkManager
@@ -142,13 +171,22 @@ public slots:
         emit _invokeWriteBytes(QByteArray(bytes, length));
     }
 
+    /// Writes bytes which hold whole MAVLink frames, see writeBytesSafe. The frames are counted in outputStatistics.
+    ///     @param frames Number of frames in bytes
+    void writeFramesSafe(const char *bytes, int length, int frames)
+    {
+        emit _invokeWriteFrames(QByteArray(bytes, length), frames);
+    }
+
 private slots:
     virtual void _writeBytes(const QByteArray) = 0;
+    void _writeFrames(const QByteArray bytes, int frames);
     
 signals:
     void autoconnectChanged(bool autoconnect);
     void activeChanged(bool active);
     void _invokeWriteBytes(QByteArray);
+    void _invokeWriteFrames(QByteArray, int);
 
     /// Signalled when a link suddenly goes away due to it being removed by for example pulling the cable to the connection.
     void connectionRemoved(LinkInterface* link);
@@ -165,6 +203,10 @@ signals:
      */
     void bytesReceived(LinkInterface* link, QByteArray data);
 
+    /// Same as bytesReceived, with the time the link read the bytes as QGCClock::wallElapsedUSecs. The time travels
+    /// with the bytes, so the queued hop to the receiving thread counts towards the latency of the frames.
+    void bytesArrived(LinkInterface* link, QByteArray data, qint64 arrivalUSecs);
+
     /**
      * @brief This signal is emitted instantly when the link is connected
      **/
@@ -189,50 +231,25 @@ protected:
     // Links are only created by LinkManager so constructor is not public
     LinkInterface(SharedLinkConfigurationPointer& config);
 
-    /// This function logs the send times and amounts of datas for input. Data is used for calculating
-    /// the transmission rate.
+    /// This function logs the receive times and amounts of datas for input. Totals are always counted, the time
+    /// buckets used for the transmission rate only while data rate collection is enabled.
     ///     @param byteCount Number of bytes received
-    ///     @param time Time in ms send occurred
+    ///     @param time Time in ms receive occurred
     void _logInputDataRate(quint64 byteCount, qint64 time);
     
-    /// This function logs the send times and amounts of datas for output. Data is used for calculating
-    /// the transmission rate.
+    /// This function logs the send times and amounts of datas for output, see _logInputDataRate. The MAVLink frames
+    /// of the write in progress are logged along with the bytes.
     ///     @param byteCount Number of bytes sent
-    ///     @param time Time in ms receive occurred
+    ///     @param time Time in ms send occurred
     void _logOutputDataRate(quint64 byteCount, qint64 time);
 
+    /// Signals bytes the link has just read, stamped with their arrival time. Links call this instead of emitting
+    /// bytesReceived themselves.
+    void _bytesReceived(const QByteArray& data);
+
     SharedLinkConfigurationPointer _config;
     
 private:
-    /**
-     * @brief logDataRateToBuffer Stores transmission times/amounts for statistics
-     *
-     * This function logs the send times and amounts of datas to the given circular buffers.
-     * This data is used for calculating the transmission rate.
-     *
-     * @param bytesBuffer[out] The buffer to write the bytes value into.
-     * @param timeBuffer[out] The buffer to write the time value into
-     * @param writeIndex[out] The write index used for this buffer.
-     * @param bytes The amount of bytes transmit.
-     * @param time The time (in ms) this transmission occurred.
-     */
-    void _logDataRateToBuffer(quint64 *bytesBuffer, qint64 *timeBuffer, int *writeIndex, quint64 bytes, qint64 time);
-
-    /**
-     * @brief getCurrentDataRate Get the current data rate given a data rate buffer.
-     *
-     * This function attempts to use the times and number of bytes transmit into a current data rate
-     * estimation. Since it needs to use timestamps to get the timeperiods over when the data was sent,
-     * this is effectively a global data rate over the last _dataRateBufferSize - 1 data points. Also note
-     * that data points older than NOW - dataRateCurrentTimespan are ignored.
-     *
-     * @param index The first valid sample in the data rate buffer. Refers to the oldest time sample.
-     * @param dataWriteTimes The time, in ms since epoch, that each data sample took place.
-     * @param dataWriteAmounts The amount of data (in bits) that was transferred.
-     * @return The bits per second of data transferrence of the interface over the last [-statsCurrentTimespan, 0] timespan.
-     */
-    qint64 _getCurrentDataRate(int index, const qint64 dataWriteTimes[], const quint64 dataWriteAmounts[]) const;
-
     /**
      * @brief Connect this interface logically
      *
@@ -244,31 +261,32 @@ private:
     
     /// Sets the mavlink channel to use for this link
     void _setMavlinkChannel(uint8_t channel);
+
+    /// Turns on MAVLink 2 signing on the mavlink channel if the configuration has a key
+    void _startSigning(void);
+
+    /// Detaches the signing state from the mavlink channel before the channel is released
+    void _stopSigning(void);
+
+    /// Logs MAVLink frames decoded from the received bytes, called by MAVLinkProtocol
+    ///     @param time Time in ms the frames were decoded
+    void _logInputFrames(quint32 frames, qint64 time);
     
     bool _mavlinkChannelSet;    ///< true: _mavlinkChannel has been set
     uint8_t _mavlinkChannel;    ///< mavlink channel to use for this link, as used by mavlink_parse_char
-    
-    static const int _dataRateBufferSize = 20; ///< Specify how many data points to capture for data rate calculations.
+    mavlink_signing_t _signing; ///< Key, link id and outgoing timestamp when signing, the channel status points here
     
     static const qint64 _dataRateCurrentTimespan = 500; ///< Set the maximum age of samples to use for data calculations (ms).
     
-    // Implement a simple circular buffer for storing when and how much data was received.
-    // Used for calculating the incoming data rate. Use with *StatsBuffer() functions.
-    int     _inDataIndex;
-    quint64 _inDataWriteAmounts[_dataRateBufferSize]; // In bytes
-    qint64  _inDataWriteTimes[_dataRateBufferSize]; // in ms
-    
-    // Implement a simple circular buffer for storing when and how much data was transmit.
-    // Used for calculating the outgoing data rate. Use with *StatsBuffer() functions.
-    int     _outDataIndex;
-    quint64 _outDataWriteAmounts[_dataRateBufferSize]; // In bytes
-    qint64  _outDataWriteTimes[_dataRateBufferSize]; // in ms
-    
-    mutable QMutex _dataRateMutex; // Mutex for accessing the data rate member variables
+    LinkStatistics _inputStatistics;
+    LinkStatistics _outputStatistics;
+    Metrics        _metrics;
+    LinkHealth     _health;
 
     bool _active;                       ///< true: link is actively receiving mavlink messages
-    bool _enableRateCollection;
+    std::atomic<bool> _enableRateCollection;
     bool _decodedFirstMavlinkPacket;    ///< true: link has correctly decoded it's first mavlink packet
+    int _writeFrameCount;               ///< MAVLink frames in the write in progress, only used on the link's thread
 };
 
 typedef QSharedPointer<LinkInterface> SharedLinkInterfacePointer;
@@ -20,7 +20,9 @@
 #include "QGCApplication.h"
 //#include "UDPLink.h"
 #include "TCPLink.h"
+#include "MockLink.h"
 #include "SettingsManager.h"
+#include "MAVLinkChannelPool.h"
 #ifdef QGC_ENABLE_BLUETOOTH
 #include "BluetoothLink.h"
 #endif
@@ -60,12 +62,6 @@ LinkManager::LinkManager(QGCApplication* app, QGCToolbox* toolbox)
     _activeLinkCheckTimer.setSingleShot(false);
     connect(&_activeLinkCheckTimer, &QTimer::timeout, this, &LinkManager::_activeLinkCheck);
 #endif
-
-    _mavlinkChannelsUsed[0] = true;
-    // Find a mavlink channel to use for this link, Channel 0 is reserved for internal use.
-    for (int mavlinkChannel=1; mavlinkChannel<MAVLINK_COMM_NUM_BUFFERS; mavlinkChannel++) {
-        _mavlinkChannelsUsed[mavlinkChannel] = false;
-    }
 }
 
 LinkManager::~LinkManager()
@@ -126,6 +122,9 @@ LinkInterface* LinkManager::createConnectedLink(SharedLinkConfigurationPointer&
     case LinkConfiguration::TypeTcp:
         pLink = new TCPLink(config);
         break;
+    case LinkConfiguration::TypeMock:
+        pLink = new MockLink(config);
+        break;
 /*
 #ifdef QGC_ENABLE_BLUETOOTH
     case LinkConfiguration::TypeBluetooth:
@@ -137,11 +136,6 @@ LinkInterface* LinkManager::createConnectedLink(SharedLinkConfigurationPointer&
         pLink = new LogReplayLink(config);
         break;
 #endif
-#ifdef QT_DEBUG
-    case LinkConfiguration::TypeMock:
-        pLink = new MockLink(config);
-        break;
-#endif
 */
     case LinkConfiguration::TypeLast:
     default:
@@ -186,6 +180,7 @@ void LinkManager::_addLink(LinkInterface* link)
         int mavlinkChannel = _reserveMavlinkChannel();
         if (mavlinkChannel != 0) {
             link->_setMavlinkChannel(mavlinkChannel);
+            link->_startSigning();
         } else {
             qWarning() << "Ran out of mavlink channels";
             return;
@@ -196,7 +191,7 @@ void LinkManager::_addLink(LinkInterface* link)
     }
 
     connect(link, &LinkInterface::communicationError,   _app,               &QGCApplication::criticalMessageBoxOnMainThread);
-    connect(link, &LinkInterface::bytesReceived,        _mavlinkProtocol,   &MAVLinkProtocol::receiveBytes);
+    connect(link, &LinkInterface::bytesArrived,         _mavlinkProtocol,   &MAVLinkProtocol::receiveBytesArrived);
 
     _mavlinkProtocol->resetMetadataForLink(link);
 
@@ -261,6 +256,7 @@ void LinkManager::_deleteLink(LinkInterface* link)
     }
 
     // Free up the mavlink channel associated with this link
+    link->_stopSigning();
     _freeMavlinkChannel(link->mavlinkChannel());
 
     for (int i=0; i<_sharedLinks.count(); i++) {
@@ -327,7 +323,7 @@ void LinkManager::suspendConfigurationUpdates(bool suspend)
 
 void LinkManager::saveLinkConfigurationList()
 {
-    QSettings settings;
+    SettingsStore& settings = *SettingsStore::instance();
     settings.remove(LinkConfiguration::settingsRoot());
     int trueCount = 0;
     for (int i = 0; i < _sharedConfigurations.count(); i++) {
@@ -336,9 +332,10 @@ void LinkManager::saveLinkConfigurationList()
             if (!linkConfig->isDynamic()) {
                 QString root = LinkConfiguration::settingsRoot();
                 root += QString("/Link%1").arg(trueCount++);
-                settings.setValue(root + "/name", linkConfig->name());
-                settings.setValue(root + "/type", linkConfig->type());
-                settings.setValue(root + "/auto", linkConfig->isAutoConnect());
+                settings.setValue(root, "name", linkConfig->name());
+                settings.setValue(root, "type", linkConfig->type());
+                settings.setValue(root, "auto", linkConfig->isAutoConnect());
+                settings.setValue(root, "signingLinkId", linkConfig->signingLinkId());
                 // Have the instance save its own values
                 linkConfig->saveSettings(settings, root);
             }
@@ -347,29 +344,29 @@ void LinkManager::saveLinkConfigurationList()
         }
     }
     QString root(LinkConfiguration::settingsRoot());
-    settings.setValue(root + "/count", trueCount);
+    settings.setValue(root, "count", trueCount);
     emit linkConfigurationsChanged();
 }
 
 void LinkManager::loadLinkConfigurationList()
 {
     bool linksChanged = false;
-    QSettings settings;
+    SettingsStore& settings = *SettingsStore::instance();
     // Is the group even there?
-    if(settings.contains(LinkConfiguration::settingsRoot() + "/count")) {
+    if(settings.contains(LinkConfiguration::settingsRoot(), "count")) {
         // Find out how many configurations we have
-        int count = settings.value(LinkConfiguration::settingsRoot() + "/count").toInt();
+        int count = settings.value(LinkConfiguration::settingsRoot(), "count").toInt();
         for(int i = 0; i < count; i++) {
             QString root(LinkConfiguration::settingsRoot());
             root += QString("/Link%1").arg(i);
-            if(settings.contains(root + "/type")) {
-                int type = settings.value(root + "/type").toInt();
+            if(settings.contains(root, "type")) {
+                int type = settings.value(root, "type").toInt();
                 if((LinkConfiguration::LinkType)type < LinkConfiguration::TypeLast) {
-                    if(settings.contains(root + "/name")) {
-                        QString name = settings.value(root + "/name").toString();
+                    if(settings.contains(root, "name")) {
+                        QString name = settings.value(root, "name").toString();
                         if(!name.isEmpty()) {
                             LinkConfiguration* pLink = NULL;
-                            bool autoConnect = settings.value(root + "/auto").toBool();
+                            bool autoConnect = settings.value(root, "auto").toBool();
                             switch((LinkConfiguration::LinkType)type) {
 #ifndef NO_SERIAL_LINK
                             case LinkConfiguration::TypeSerial:
@@ -382,6 +379,9 @@ void LinkManager::loadLinkConfigurationList()
                             case LinkConfiguration::TypeTcp:
                                 pLink = (LinkConfiguration*)new TCPConfiguration(name);
                                 break;
+                            case LinkConfiguration::TypeMock:
+                                pLink = (LinkConfiguration*)new MockConfiguration(name);
+                                break;
 /*
 #ifdef QGC_ENABLE_BLUETOOTH
                             case LinkConfiguration::TypeBluetooth:
@@ -393,11 +393,6 @@ void LinkManager::loadLinkConfigurationList()
                                 pLink = (LinkConfiguration*)new LogReplayLinkConfiguration(name);
                                 break;
 #endif
-#ifdef QT_DEBUG
-                            case LinkConfiguration::TypeMock:
-                                pLink = (LinkConfiguration*)new MockConfiguration(name);
-                                break;
-#endif
 */
                             default:
                             case LinkConfiguration::TypeLast:
@@ -406,6 +401,7 @@ void LinkManager::loadLinkConfigurationList()
                             if(pLink) {
                                 //-- Have the instance load its own values
                                 pLink->setAutoConnect(autoConnect);
+                                pLink->setSigningLinkId(settings.value(root, "signingLinkId", 0).toUInt());
                                 pLink->loadSettings(settings, root);
                                 addConfiguration(pLink);
                                 linksChanged = true;
@@ -645,9 +641,7 @@ QStringList LinkManager::linkTypeStrings(void) const
 #ifdef QGC_ENABLE_BLUETOOTH
         list += "Bluetooth";
 #endif
-#ifdef QT_DEBUG
         list += "Mock Link";
-#endif
 #ifndef __mobile__
         list += "Log Replay";
 #endif
@@ -951,22 +945,18 @@ void LinkManager::startAutoConnectedLinks(void)
 
 int LinkManager::_reserveMavlinkChannel(void)
 {
-    // Find a mavlink channel to use for this link, Channel 0 is reserved for internal use.
-    for (int mavlinkChannel=1; mavlinkChannel<MAVLINK_COMM_NUM_BUFFERS; mavlinkChannel++) {
-        if (!_mavlinkChannelsUsed[mavlinkChannel]) {
-            mavlink_reset_channel_status(mavlinkChannel);
-            // Start the channel on Mav 1 protocol
-            mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-            mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-            _mavlinkChannelsUsed[mavlinkChannel] = true;
-            return mavlinkChannel;
-        }
+    // Channel 0 is reserved for internal use and is never handed out
+    int mavlinkChannel = MAVLinkChannelPool::instance()->reserve();
+    if (mavlinkChannel != 0) {
+        // Start the channel on Mav 1 protocol
+        mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+        mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
     }
 
-    return 0;   // All channels reserved
+    return mavlinkChannel;
 }
 
 void LinkManager::_freeMavlinkChannel(int channel)
 {
-    _mavlinkChannelsUsed[channel] = false;
+    MAVLinkChannelPool::instance()->release(channel);
 }
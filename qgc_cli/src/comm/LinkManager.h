@@ -209,7 +209,6 @@ private:
     bool    _connectionsSuspended;                      ///< true: all new connections should not be allowed
     QString _connectionsSuspendedReason;                ///< User visible reason for suspension
     QTimer  _portListTimer;
-    bool _mavlinkChannelsUsed[MAVLINK_COMM_NUM_BUFFERS];
 
     AutoConnectSettings*    _autoConnectSettings;
     MAVLinkProtocol*        _mavlinkProtocol;
@@ -0,0 +1,105 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkStatistics.h"
+
+LinkStatistics::LinkStatistics(void)
+{
+    reset();
+}
+
+void LinkStatistics::reset(void)
+{
+    _reset(_bytes);
+    _reset(_frames);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void LinkStatistics::_reset(Counter& counter)
+{
+    counter.total.store(0, std::memory_order_relaxed);
+    for (int i=0; i<bucketCount; i++) {
+        counter.rgBuckets[i].index.store(-1, std::memory_order_relaxed);
+        counter.rgBuckets[i].count.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LinkStatistics::_add(Counter& counter, quint64 count, qint64 time, bool buckets)
+{
+    counter.total.fetch_add(count, std::memory_order_relaxed);
+
+    if (!buckets || time < 0) {
+        return;
+    }
+
+    qint64  index = time / bucketMSecs;
+    Bucket& bucket = counter.rgBuckets[index % bucketCount];
+
+    if (bucket.index.load(std::memory_order_relaxed) != index) {
+        // Readers skip the bucket while it is recycled, see _read
+        bucket.index.store(-1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bucket.count.store(0, std::memory_order_relaxed);
+        bucket.index.store(index, std::memory_order_release);
+    }
+
+    bucket.count.fetch_add(count, std::memory_order_relaxed);
+}
+
+quint64 LinkStatistics::_read(const Counter& counter, qint64 index)
+{
+    if (index < 0) {
+        return 0;
+    }
+
+    const Bucket& bucket = counter.rgBuckets[index % bucketCount];
+
+    qint64 before = bucket.index.load(std::memory_order_acquire);
+    quint64 count = bucket.count.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    qint64 after = bucket.index.load(std::memory_order_relaxed);
+
+    // A bucket of another time, or one recycled while it was read, had no traffic in this one
+    if (before != index || after != index) {
+        return 0;
+    }
+
+    return count;
+}
+
+void LinkStatistics::histogram(qint64 now, int count, quint64* rgBytes, quint32* rgFrames) const
+{
+    Q_ASSERT(count < bucketCount);
+
+    qint64 first = now / bucketMSecs - count;
+
+    for (int i=0; i<count; i++) {
+        if (rgBytes) {
+            rgBytes[i] = _read(_bytes, first + i);
+        }
+        if (rgFrames) {
+            rgFrames[i] = (quint32)_read(_frames, first + i);
+        }
+    }
+}
+
+qint64 LinkStatistics::dataRate(qint64 now, qint64 spanMSecs) const
+{
+    int count = qBound(1, (int)(spanMSecs / bucketMSecs), bucketCount - 1);
+    quint64 rgBytes[bucketCount];
+
+    histogram(now, count, rgBytes, NULL);
+
+    quint64 totalBytes = 0;
+    for (int i=0; i<count; i++) {
+        totalBytes += rgBytes[i];
+    }
+
+    return (qint64)(totalBytes * 8 * 1000 / (count * bucketMSecs));
+}
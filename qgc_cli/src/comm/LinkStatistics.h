@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtGlobal>
+
+#include <atomic>
+
+/// Traffic counters of one direction of a link. The link thread logs the bytes of every read or write, the MAVLink
+/// frames in them are logged by whoever decodes or encodes them. Writers use relaxed atomics and never wait, readers on
+/// any thread aggregate on demand. Besides the running totals, traffic is kept in rings of time buckets of bucketMSecs
+/// each, covering the last bucketCount * bucketMSecs.
+///
+/// Bytes and frames are counted separately, there should be one writer for each of them. That is the case as each link
+/// reads and writes on its own thread and MAVLinkProtocol decodes on its own. A second writer could lose the counts it
+/// adds while the other one recycles a bucket.
+class LinkStatistics
+{
+public:
+    LinkStatistics(void);
+
+    static const int    bucketCount = 64;
+    static const qint64 bucketMSecs = 100;
+
+    /// Byte writer only
+    ///     @param time Time in ms the transfer occurred
+    void log(quint64 bytes, qint64 time, bool buckets = true) { _add(_bytes, bytes, time, buckets); }
+
+    /// Frame writer only
+    ///     @param frames Number of MAVLink frames decoded or sent
+    ///     @param time Time in ms the frames were decoded or sent
+    void logFrames(quint32 frames, qint64 time, bool buckets = true) { _add(_frames, frames, time, buckets); }
+
+    quint64 totalBytes(void) const  { return _bytes.total.load(std::memory_order_relaxed); }
+    quint64 totalFrames(void) const { return _frames.total.load(std::memory_order_relaxed); }
+
+    /// Traffic of the last complete buckets before now, oldest first. Buckets without traffic are 0.
+    ///     @param count Number of buckets, at most bucketCount - 1
+    void histogram(qint64 now, int count, quint64* rgBytes, quint32* rgFrames) const;
+
+    /// @return Bits per second over the complete buckets of the last spanMSecs before now
+    qint64 dataRate(qint64 now, qint64 spanMSecs) const;
+
+    /// While nothing is logged
+    void reset(void);
+
+private:
+    struct Bucket {
+        std::atomic<qint64>     index;  ///< time / bucketMSecs the count is for, -1 while recycled or never used
+        std::atomic<quint64>    count;
+    };
+
+    struct Counter {
+        std::atomic<quint64>    total;
+        Bucket                  rgBuckets[bucketCount];
+    };
+
+    static void     _reset  (Counter& counter);
+    static void     _add    (Counter& counter, quint64 count, qint64 time, bool buckets);
+    static quint64  _read   (const Counter& counter, qint64 index);
+
+    Counter _bytes;
+    Counter _frames;
+};
@@ -42,18 +42,14 @@ void LogReplayLinkConfiguration::copyFrom(LinkConfiguration *source)
     }
 }
 
-void LogReplayLinkConfiguration::saveSettings(QSettings& settings, const QString& root)
+void LogReplayLinkConfiguration::saveSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    settings.setValue(_logFilenameKey, _logFilename);
-    settings.endGroup();
+    settings.setValue(root, _logFilenameKey, _logFilename);
 }
 
-void LogReplayLinkConfiguration::loadSettings(QSettings& settings, const QString& root)
+void LogReplayLinkConfiguration::loadSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    _logFilename = settings.value(_logFilenameKey, "").toString();
-    settings.endGroup();
+    _logFilename = settings.value(root, _logFilenameKey, "").toString();
 }
 
 void LogReplayLinkConfiguration::updateSettings(void)
@@ -350,7 +346,7 @@ void LogReplayLink::_readNextLogEntry(void)
         while (timeToNextExecutionMSecs < 3) {
             // Read the next mavlink message from the log
             qint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
-            emit bytesReceived(this, bytes);
+            _bytesReceived(bytes);
             emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
             
             if (_logFile.atEnd()) {
@@ -377,7 +373,7 @@ void LogReplayLink::_readNextLogEntry(void)
         const int len = 100;
         QByteArray chunk = _logFile.read(len);
         
-        emit bytesReceived(this, chunk);
+        _bytesReceived(chunk);
         emit playbackPercentCompleteChanged(((float)_logFile.pos() / (float)_logFileSize) * 100);
         
         // Check if reached end of file before reading next timestamp
@@ -37,8 +37,8 @@ public:
     // Virtuals from LinkConfiguration
     LinkType    type                    () { return LinkConfiguration::TypeLogReplay; }
     void        copyFrom                (LinkConfiguration* source);
-    void        loadSettings            (QSettings& settings, const QString& root);
-    void        saveSettings            (QSettings& settings, const QString& root);
+    void        loadSettings            (SettingsStore& settings, const QString& root);
+    void        saveSettings            (SettingsStore& settings, const QString& root);
     void        updateSettings          ();
     QString     settingsURL             () { return "LogReplaySettings.qml"; }
 signals:
@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkCRC.h"
+#include "QGCMAVLink.h"
+
+uint16_t crc_calculate(const uint8_t* pBuffer, uint16_t length)
+{
+    return MAVLinkCRC::accumulate(X25_INIT_CRC, pBuffer, length);
+}
+
+void crc_accumulate_buffer(uint16_t* crcAccum, const char* pBuffer, uint16_t length)
+{
+    *crcAccum = MAVLinkCRC::accumulate(*crcAccum, (const uint8_t*)pBuffer, length);
+}
+
+MAVLinkCRC::Tables::Tables(void)
+{
+    // The first table is the library's single byte step, so the two can't drift apart
+    for (int i=0; i<256; i++) {
+        uint16_t crc = 0;
+        crc_accumulate((uint8_t)i, &crc);
+        rgTable[0][i] = crc;
+    }
+
+    for (int k=1; k<8; k++) {
+        for (int i=0; i<256; i++) {
+            uint16_t crc = rgTable[k - 1][i];
+            rgTable[k][i] = (crc >> 8) ^ rgTable[0][crc & 0xff];
+        }
+    }
+}
+
+const MAVLinkCRC::Tables& MAVLinkCRC::_tables(void)
+{
+    static Tables tables;
+    return tables;
+}
+
+uint16_t MAVLinkCRC::accumulate(uint16_t crc, const uint8_t* data, int length)
+{
+    const uint16_t (*rgTable)[256] = _tables().rgTable;
+
+    // The current checksum folds into the first two bytes, the other six only need their own tables
+    while (length >= 8) {
+        crc = rgTable[7][(data[0] ^ crc) & 0xff] ^
+              rgTable[6][data[1] ^ (crc >> 8)] ^
+              rgTable[5][data[2]] ^
+              rgTable[4][data[3]] ^
+              rgTable[3][data[4]] ^
+              rgTable[2][data[5]] ^
+              rgTable[1][data[6]] ^
+              rgTable[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0) {
+        crc = (crc >> 8) ^ rgTable[0][(crc ^ *data++) & 0xff];
+    }
+
+    return crc;
+}
+
+uint16_t MAVLinkCRC::accumulateReference(uint16_t crc, const uint8_t* data, int length)
+{
+    while (length-- > 0) {
+        crc_accumulate(*data++, &crc);
+    }
+    return crc;
+}
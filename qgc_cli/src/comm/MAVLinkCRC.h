@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+/// The X.25 checksum of MAVLink frames (CRC-16/MCRF4XX) over whole buffers. The mavlink library hashes one byte at a
+/// time, this consumes eight bytes per step through slice-by-8 tables, with the same result. The library's
+/// crc_calculate and crc_accumulate_buffer, used when a message is finalized, are routed here (see QGCMAVLink.h). The
+/// parser still accumulates byte by byte as it frames, a parser with the whole frame at hand can use accumulate.
+class MAVLinkCRC
+{
+public:
+    /// @param crc Checksum so far, X25_INIT_CRC to start a new one
+    /// @return Checksum with the buffer added
+    static uint16_t accumulate(uint16_t crc, const uint8_t* data, int length);
+
+    /// Byte at a time like the library's crc_accumulate, the reference for accumulate
+    static uint16_t accumulateReference(uint16_t crc, const uint8_t* data, int length);
+
+private:
+    /// rgTable[k][b] is the checksum of byte b followed by k zero bytes, starting from 0
+    struct Tables {
+        Tables(void);
+        uint16_t rgTable[8][256];
+    };
+
+    static const Tables& _tables(void);
+};
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkChannelPool.h"
+
+#include <string.h>
+
+mavlink_status_t* mavlink_get_channel_status(uint8_t chan)
+{
+    return MAVLinkChannelPool::instance()->status(chan);
+}
+
+mavlink_message_t* mavlink_get_channel_buffer(uint8_t chan)
+{
+    return MAVLinkChannelPool::instance()->buffer(chan);
+}
+
+MAVLinkChannelPool::MAVLinkChannelPool(void)
+    : _reservedCount(0)
+{
+    for (int i=0; i<maxChannels; i++) {
+        _states[i].store(NULL);
+        _reserved[i] = false;
+    }
+    _reserved[0] = true;
+}
+
+MAVLinkChannelPool* MAVLinkChannelPool::instance(void)
+{
+    static MAVLinkChannelPool pool;
+    return &pool;
+}
+
+/// Returns the state for the channel, allocating it on first use. The state is never freed, so pointers handed out to
+/// the mavlink library stay valid even if the channel is released while a link thread is still parsing.
+MAVLinkChannelPool::ChannelState* MAVLinkChannelPool::_state(uint8_t channel)
+{
+    ChannelState* state = _states[channel].loadAcquire();
+    if (state) {
+        return state;
+    }
+
+    ChannelState* newState = new ChannelState;
+    memset(newState, 0, sizeof(ChannelState));
+    if (_states[channel].testAndSetOrdered(NULL, newState)) {
+        return newState;
+    }
+
+    // Another thread got there first
+    delete newState;
+    return _states[channel].loadAcquire();
+}
+
+int MAVLinkChannelPool::reserve(void)
+{
+    QMutexLocker locker(&_reserveMutex);
+
+    for (int channel=1; channel<maxChannels; channel++) {
+        if (!_reserved[channel]) {
+            memset(_state(channel), 0, sizeof(ChannelState));
+            _reserved[channel] = true;
+            _reservedCount++;
+            return channel;
+        }
+    }
+
+    return 0;   // All channels reserved
+}
+
+void MAVLinkChannelPool::release(int channel)
+{
+    QMutexLocker locker(&_reserveMutex);
+
+    if (channel > 0 && channel < maxChannels && _reserved[channel]) {
+        _reserved[channel] = false;
+        _reservedCount--;
+    }
+}
+
+int MAVLinkChannelPool::reservedCount(void) const
+{
+    QMutexLocker locker(&_reserveMutex);
+    return _reservedCount;
+}
@@ -0,0 +1,62 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+#include <QAtomicPointer>
+#include <QMutex>
+
+/// Owns the parser and status state for all mavlink channels. The mavlink library normally keeps this in static
+/// arrays sized by MAVLINK_COMM_NUM_BUFFERS, which limits the number of links a single process can have open. Here the
+/// state for a channel is allocated the first time the channel is used and is reused when the channel is released and
+/// reserved again, so memory grows with the number of links actually in use.
+///
+/// The library's mavlink_get_channel_status and mavlink_get_channel_buffer are routed here (see QGCMAVLink.h).
+class MAVLinkChannelPool
+{
+public:
+    /// Channels are passed around as a uint8_t by the mavlink api
+    static const int maxChannels = 256;
+
+    static MAVLinkChannelPool* instance(void);
+
+    /// Reserves a channel and resets its parser and status state. Channel 0 is reserved for internal use and is
+    /// never returned.
+    /// @return Mavlink channel index, 0 for no channels available
+    int reserve(void);
+
+    /// Frees the specified channel for re-use
+    void release(int channel);
+
+    /// @return Number of channels currently reserved, not including channel 0
+    int reservedCount(void) const;
+
+    mavlink_status_t*   status(uint8_t channel) { return &_state(channel)->status; }
+    mavlink_message_t*  buffer(uint8_t channel) { return &_state(channel)->buffer; }
+
+    /// @return Memory used by the state of a single channel
+    static size_t channelStateSize(void) { return sizeof(ChannelState); }
+
+private:
+    MAVLinkChannelPool(void);
+
+    struct ChannelState {
+        mavlink_status_t    status;
+        mavlink_message_t   buffer;
+    };
+
+    ChannelState* _state(uint8_t channel);
+
+    QAtomicPointer<ChannelState>    _states[maxChannels];
+    mutable QMutex                  _reserveMutex;
+    bool                            _reserved[maxChannels];
+    int                             _reservedCount;
+};
@@ -0,0 +1,66 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkDuplicateFilter.h"
+
+MAVLinkDuplicateFilter::MAVLinkDuplicateFilter(void)
+    : _window(defaultWindow)
+{
+    reset();
+}
+
+void MAVLinkDuplicateFilter::reset(void)
+{
+    for (int i=0; i<_setCount; i++) {
+        for (int j=0; j<_ways; j++) {
+            _rgSlots[i][j].key = 0;
+            _rgSlots[i][j].time = -1;
+            _rgSlots[i][j].channel = 0;
+        }
+    }
+}
+
+bool MAVLinkDuplicateFilter::isDuplicate(uint8_t channel, const mavlink_message_t& message, qint64 time)
+{
+    if (_window <= 0) {
+        return false;
+    }
+
+    // Source, sequence number, message id and checksum fill the 64 bits exactly
+    quint64 key = ((quint64)message.sysid << 56) |
+                  ((quint64)message.compid << 48) |
+                  ((quint64)message.seq << 40) |
+                  ((quint64)(message.msgid & 0xFFFFFF) << 16) |
+                  message.checksum;
+    Slot*   rgSet = _rgSlots[(key * 0x9E3779B97F4A7C15ULL) >> (64 - _setBits)];
+    Slot*   victim = &rgSet[0];
+
+    for (int i=0; i<_ways; i++) {
+        Slot& slot = rgSet[i];
+
+        if (slot.time >= 0 && slot.key == key && time - slot.time <= _window) {
+            if (slot.channel != channel) {
+                // Later copies are measured against the first one
+                return true;
+            }
+            victim = &slot;
+            break;
+        }
+        if (slot.time < victim->time) {
+            victim = &slot;
+        }
+    }
+
+    Slot& slot = *victim;
+    slot.key = key;
+    slot.time = time;
+    slot.channel = channel;
+
+    return false;
+}
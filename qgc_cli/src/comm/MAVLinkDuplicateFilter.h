@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+/// Spots frames heard again on another link, as happens with redundant radios, so they are dispatched only once. A
+/// frame is identified by its source, sequence number, message id and checksum, and remembered for window ms in a
+/// two way set associative table. When three recent frames share a set the oldest one is forgotten, which can only
+/// let a duplicate through, never drop a frame which was not seen before.
+class MAVLinkDuplicateFilter
+{
+public:
+    MAVLinkDuplicateFilter(void);
+
+    /// Duplicates are looked for within this many ms, 0 turns the filter off
+    void    setWindow   (qint64 window) { _window = window; }
+    qint64  window      (void) const    { return _window; }
+
+    /// @return true if the same frame was heard on another channel in the last window ms. A frame which is not a
+    ///         duplicate is remembered.
+    ///     @param time Time in ms the frame was received
+    bool isDuplicate(uint8_t channel, const mavlink_message_t& message, qint64 time);
+
+    /// Forgets all frames
+    void reset(void);
+
+    static const qint64 defaultWindow = 500;
+
+private:
+    struct Slot {
+        quint64 key;
+        qint64  time;       ///< -1 for an empty slot
+        uint8_t channel;
+    };
+
+    static const int _setBits = 12;
+    static const int _setCount = 1 << _setBits;
+    static const int _ways = 2;
+
+    qint64  _window;
+    Slot    _rgSlots[_setCount][_ways];
+};
@@ -0,0 +1,67 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageTable.h"
+
+#include <QtGlobal>
+
+const mavlink_msg_entry_t* mavlink_get_msg_entry(uint32_t msgid)
+{
+    return MAVLinkMessageTable::instance()->entry(msgid);
+}
+
+const mavlink_msg_entry_t MAVLinkMessageTable::_entries[] = MAVLINK_MESSAGE_CRCS;
+const int MAVLinkMessageTable::_entryCount = sizeof(MAVLinkMessageTable::_entries) / sizeof(MAVLinkMessageTable::_entries[0]);
+
+MAVLinkMessageTable::MAVLinkMessageTable(void)
+    : _sparseBegin(_entryCount)
+{
+    Q_ASSERT(_entryCount < _noEntry);
+
+    for (uint32_t i=0; i<denseCount; i++) {
+        _dense[i] = _noEntry;
+    }
+
+    // The generated table is sorted by id, so the sparse ids are its tail
+    for (int i=0; i<_entryCount; i++) {
+        Q_ASSERT(i == 0 || _entries[i - 1].msgid < _entries[i].msgid);
+
+        if (_entries[i].msgid < denseCount) {
+            _dense[_entries[i].msgid] = i;
+        } else if (_sparseBegin == _entryCount) {
+            _sparseBegin = i;
+        }
+    }
+}
+
+MAVLinkMessageTable* MAVLinkMessageTable::instance(void)
+{
+    static MAVLinkMessageTable table;
+    return &table;
+}
+
+const mavlink_msg_entry_t* MAVLinkMessageTable::_sparseEntry(uint32_t msgid) const
+{
+    int low = _sparseBegin;
+    int high = _entryCount;
+
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (_entries[mid].msgid < msgid) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < _entryCount && _entries[low].msgid == msgid) {
+        return &_entries[low];
+    }
+    return NULL;
+}
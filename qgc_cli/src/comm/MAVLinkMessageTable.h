@@ -0,0 +1,55 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+/// Lookup of the crc_extra, length and target offsets of a message id. The mavlink library does a bisection search
+/// of MAVLINK_MESSAGE_CRCS for every frame parsed. Here ids below denseCount, which is nearly all of every dialect, are
+/// a single index into a table built from MAVLINK_MESSAGE_CRCS the first time it is used. The few larger ids are
+/// searched for in the tail of the table which only holds those.
+///
+/// The library's mavlink_get_msg_entry is routed here (see QGCMAVLink.h).
+class MAVLinkMessageTable
+{
+public:
+    /// Message ids below this are looked up directly
+    static const uint32_t denseCount = 512;
+
+    static MAVLinkMessageTable* instance(void);
+
+    /// @return Entry for the message id, NULL if the dialect does not know it
+    const mavlink_msg_entry_t* entry(uint32_t msgid) const
+    {
+        if (msgid < denseCount) {
+            uint16_t index = _dense[msgid];
+            return index == _noEntry ? NULL : &_entries[index];
+        }
+        return _sparseEntry(msgid);
+    }
+
+    /// @return Number of messages in the dialect
+    int count(void) const { return _entryCount; }
+
+    /// @return Number of messages with an id of denseCount or more
+    int sparseCount(void) const { return _entryCount - _sparseBegin; }
+
+private:
+    MAVLinkMessageTable(void);
+
+    const mavlink_msg_entry_t* _sparseEntry(uint32_t msgid) const;
+
+    static const uint16_t               _noEntry = 0xFFFF;
+    static const mavlink_msg_entry_t    _entries[];
+    static const int                    _entryCount;
+
+    uint16_t    _dense[denseCount];     ///< Index into _entries by message id, _noEntry for unknown ids
+    int         _sparseBegin;           ///< Index of the first entry with an id of denseCount or more
+};
@@ -20,7 +20,6 @@
 #include <QDebug>
 #include <QTime>
 #include <QCoreApplication>
-#include <QSettings>
 #include <QStandardPaths>
 #include <QtEndian>
 #include <QMetaType>
@@ -37,7 +36,9 @@
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 #include "MultiVehicleManager.h"
+#include "QGCClock.h"
 #include "SettingsManager.h"
+#include "SettingsStore.h"
 
 Q_DECLARE_METATYPE(mavlink_message_t)
 
@@ -45,6 +46,7 @@ QGC_LOGGING_CATEGORY(MAVLinkProtocolLog, "MAVLinkProtocolLog")
 
 const char* MAVLinkProtocol::_tempLogFileTemplate = "FlightDataXXXXXX"; ///< Template for temporary log file
 const char* MAVLinkProtocol::_logFileExtension = "mavlink";             ///< Extension for log files
+const char* MAVLinkProtocol::_settingsGroup = "QGC_MAVLINK_PROTOCOL";
 
 /**
  * The default constructor will create a new MAVLink object sending heartbeats at
@@ -89,15 +91,6 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
    // All the *Counter variables are not initialized here, as they should be initialized
    // on a per-link basis before those links are used. @see resetMetadataForLink().
 
-   // Initialize the list for tracking dropped messages to invalid.
-   for (int i = 0; i < 256; i++)
-   {
-       for (int j = 0; j < 256; j++)
-       {
-           lastIndex[i][j] = -1;
-       }
-   }
-
    connect(this, &MAVLinkProtocol::protocolStatusMessage,   _app, &QGCApplication::criticalMessageBoxOnMainThread);
    connect(this, &MAVLinkProtocol::saveTelemetryLog,        _app, &QGCApplication::saveTelemetryLogOnMainThread);
    connect(this, &MAVLinkProtocol::checkTelemetrySavePath,  _app, &QGCApplication::checkTelemetrySavePathOnMainThread);
@@ -111,12 +104,11 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
 void MAVLinkProtocol::loadSettings()
 {
     // Load defaults from settings
-    QSettings settings;
-    settings.beginGroup("QGC_MAVLINK_PROTOCOL");
-    enableVersionCheck(settings.value("VERSION_CHECK_ENABLED", m_enable_version_check).toBool());
+    SettingsStore* settings = SettingsStore::instance();
+    enableVersionCheck(settings->value(_settingsGroup, "VERSION_CHECK_ENABLED", m_enable_version_check).toBool());
 
     // Only set system id if it was valid
-    int temp = settings.value("GCS_SYSTEM_ID", systemId).toInt();
+    int temp = settings->value(_settingsGroup, "GCS_SYSTEM_ID", systemId).toInt();
     if (temp > 0 && temp < 256)
     {
         systemId = temp;
@@ -126,10 +118,9 @@ void MAVLinkProtocol::loadSettings()
 void MAVLinkProtocol::storeSettings()
 {
     // Store settings
-    QSettings settings;
-    settings.beginGroup("QGC_MAVLINK_PROTOCOL");
-    settings.setValue("VERSION_CHECK_ENABLED", m_enable_version_check);
-    settings.setValue("GCS_SYSTEM_ID", systemId);
+    SettingsStore* settings = SettingsStore::instance();
+    settings->setValue(_settingsGroup, "VERSION_CHECK_ENABLED", m_enable_version_check);
+    settings->setValue(_settingsGroup, "GCS_SYSTEM_ID", systemId);
     // Parameter interface settings
 }
 
@@ -141,6 +132,7 @@ void MAVLinkProtocol::resetMetadataForLink(const LinkInterface *link)
     totalErrorCounter[channel] = 0;
     currReceiveCounter[channel] = 0;
     currLossCounter[channel] = 0;
+    _sequenceTracker.resetChannel(channel);
 }
 
 /**
@@ -151,6 +143,11 @@ void MAVLinkProtocol::resetMetadataForLink(const LinkInterface *link)
  * @see LinkInterface
  **/
 void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
+{
+    receiveBytesArrived(link, b, QGCClock::instance()->wallElapsedUSecs());
+}
+
+void MAVLinkProtocol::receiveBytesArrived(LinkInterface* link, QByteArray b, qint64 arrivalUSecs)
 {
     // Since receiveBytes signals cross threads we can end up with signals in the queue
     // that come through after the link is disconnected. For these we just drop the data
@@ -165,6 +162,13 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
 
     int mavlinkChannel = link->mavlinkChannel();
 
+    // Latency of the frames is taken from when the link read the bytes, so it includes the queued hop from its thread
+    const LinkInterface::Metrics& metrics = link->metrics();
+    QGCClock* clock = QGCClock::instance();
+    qint64 arrivalTime = clock->elapsed();
+
+    quint32 frameCount = 0;
+
     static int nonmavlinkCount = 0;
     static bool checkedUserNonMavlink = false;
     static bool warnedUserNonMavlink = false;
@@ -202,14 +206,18 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
                 link->setDecodedFirstMavlinkPacket(true);
             }
 
+            // A frame already dispatched from another link still counts for this one, but is neither logged nor
+            // dispatched again
+            bool duplicate = _duplicateFilter.isDuplicate(mavlinkChannel, message, arrivalTime);
+
             // Log data
-            if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
+            if (!duplicate && !_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
                 uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)];
 
                 // Write the uint64 time in microseconds in big endian format before the message.
                 // This timestamp is saved in UTC time. We are only saving in ms precision because
                 // getting more than this isn't possible with Qt without a ton of extra code.
-                quint64 time = (quint64)QDateTime::currentMSecsSinceEpoch() * 1000;
+                quint64 time = (quint64)QGCClock::instance()->currentMSecsSinceEpoch() * 1000;
                 qToBigEndian(time, buf);
 
                 // Then write the message to the buffer
@@ -247,35 +255,25 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
             }
 
             // Increase receive counter
+            frameCount++;
+            metrics.framesReceived->add();
             totalReceiveCounter[mavlinkChannel]++;
             currReceiveCounter[mavlinkChannel]++;
 
-            // Determine what the next expected sequence number is, accounting for
-            // never having seen a message for this system/component pair.
-            int lastSeq = lastIndex[message.sysid][message.compid];
-            int expectedSeq = (lastSeq == -1) ? message.seq : (lastSeq + 1);
+            // Sequence numbers are tracked per channel, so a vehicle heard over two links has no loss on either
+            // from the frames which only went over the other one
+            int lostMessages = _sequenceTracker.update(mavlinkChannel, message.sysid, message.compid, message.seq);
+            link->health().frameReceived(lostMessages, arrivalTime);
 
             // And if we didn't encounter that sequence number, record the error
-            if (message.seq != expectedSeq)
+            if (lostMessages)
             {
-
-                // Determine how many messages were skipped
-                int lostMessages = message.seq - expectedSeq;
-
-                // Out of order messages or wraparound can cause this, but we just ignore these conditions for simplicity
-                if (lostMessages < 0)
-                {
-                    lostMessages = 0;
-                }
-
                 // And log how many were lost for all time and just this timestep
+                metrics.framesLost->add(lostMessages);
                 totalLossCounter[mavlinkChannel] += lostMessages;
                 currLossCounter[mavlinkChannel] += lostMessages;
             }
 
-            // And update the last sequence number for this system/component pair
-            lastIndex[message.sysid][message.compid] = expectedSeq;
-
             // Update on every 32th packet
             if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0)
             {
@@ -289,12 +287,24 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
                 emit receiveLossTotalChanged(message.sysid, totalLossCounter[mavlinkChannel]);
             }
 
+            if (duplicate) {
+                metrics.framesDuplicate->add();
+                continue;
+            }
+
             // The packet is emitted as a whole, as it is only 255 - 261 bytes short
             // kind of inefficient, but no issue for a groundstation pc.
             // It buys as reentrancy for the whole code over all threads
+            qint64 dispatchUSecs = clock->wallElapsedUSecs();
+            metrics.dispatchLatency->record(dispatchUSecs - arrivalUSecs);
             emit messageReceived(link, message);
+            metrics.handlerTime->record(clock->wallElapsedUSecs() - dispatchUSecs);
         }
     }
+
+    if (frameCount) {
+        link->_logInputFrames(frameCount, clock->currentMSecsSinceEpoch());
+    }
 }
 
 /**
@@ -21,6 +21,9 @@
 
 #include "LinkInterface.h"
 #include "QGCMAVLink.h"
+#include "MAVLinkChannelPool.h"
+#include "MAVLinkSequenceTracker.h"
+#include "MAVLinkDuplicateFilter.h"
 #include "QGC.h"
 #include "QGCTemporaryFile.h"
 #include "QGCToolbox.h"
@@ -86,6 +89,9 @@ public:
      * Reset the counters for all metadata for this link.
      */
     virtual void resetMetadataForLink(const LinkInterface *link);
+
+    /// Frames heard again on another link within this many ms are dropped before dispatch, 0 dispatches them all
+    void setDuplicateWindow(qint64 window) { _duplicateFilter.setWindow(window); }
     
     /// Suspend/Restart logging during replay.
     void suspendLogForReplay(bool suspend);
@@ -96,6 +102,9 @@ public:
 public slots:
     /** @brief Receive bytes from a communication interface */
     void receiveBytes(LinkInterface* link, QByteArray b);
+
+    /// Same as receiveBytes for bytes the link read at arrivalUSecs, see LinkInterface::bytesArrived
+    void receiveBytesArrived(LinkInterface* link, QByteArray b, qint64 arrivalUSecs);
     
     /** @brief Set the system id of this application */
     void setSystemId(int id);
@@ -117,12 +126,13 @@ public slots:
 protected:
     bool m_enable_version_check; ///< Enable checking of version match of MAV and QGC
     QMutex receiveMutex;        ///< Mutex to protect receiveBytes function
-    int lastIndex[256][256];    ///< Store the last received sequence ID for each system/componenet pair
-    int totalReceiveCounter[MAVLINK_COMM_NUM_BUFFERS];    ///< The total number of successfully received messages
-    int totalLossCounter[MAVLINK_COMM_NUM_BUFFERS];       ///< Total messages lost during transmission.
-    int totalErrorCounter[MAVLINK_COMM_NUM_BUFFERS];      ///< Total count of all parsing errors. Generally <= totalLossCounter.
-    int currReceiveCounter[MAVLINK_COMM_NUM_BUFFERS];     ///< Received messages during this sample time window. Used for calculating loss %.
-    int currLossCounter[MAVLINK_COMM_NUM_BUFFERS];        ///< Lost messages during this sample time window. Used for calculating loss %.
+    MAVLinkSequenceTracker _sequenceTracker;    ///< Last received sequence ID for each channel/system/component
+    MAVLinkDuplicateFilter _duplicateFilter;    ///< Frames recently dispatched, to drop copies from other links
+    int totalReceiveCounter[MAVLinkChannelPool::maxChannels];  ///< The total number of successfully received messages
+    int totalLossCounter[MAVLinkChannelPool::maxChannels];     ///< Total messages lost during transmission.
+    int totalErrorCounter[MAVLinkChannelPool::maxChannels];    ///< Total count of all parsing errors. Generally <= totalLossCounter.
+    int currReceiveCounter[MAVLinkChannelPool::maxChannels];   ///< Received messages during this sample time window. Used for calculating loss %.
+    int currLossCounter[MAVLinkChannelPool::maxChannels];      ///< Lost messages during this sample time window. Used for calculating loss %.
     bool versionMismatchIgnore;
     int systemId;
 
@@ -177,6 +187,7 @@ private:
     QGCTemporaryFile    _tempLogFile;            ///< File to log to
     static const char*  _tempLogFileTemplate;    ///< Template for temporary log file
     static const char*  _logFileExtension;       ///< Extension for log files
+    static const char*  _settingsGroup;          ///< Settings group of the protocol settings
 
     LinkManager*            _linkMgr;
     MultiVehicleManager*    _multiVehicleManager;
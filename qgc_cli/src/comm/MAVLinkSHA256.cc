@@ -0,0 +1,265 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkSHA256.h"
+
+#include <atomic>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define QGC_SHA256_X86
+    #include <cpuid.h>
+    #include <immintrin.h>
+#endif
+
+typedef void (*CompressFunc)(uint32_t state[8], const uint8_t* blocks, int blockCount);
+
+static const uint32_t _rgK[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t _rotateRight(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+static void _compressPortable(uint32_t state[8], const uint8_t* blocks, int blockCount)
+{
+    for (int block=0; block<blockCount; block++, blocks+=64) {
+        uint32_t w[64];
+
+        for (int i=0; i<16; i++) {
+            w[i] = ((uint32_t)blocks[i * 4] << 24) | ((uint32_t)blocks[i * 4 + 1] << 16) | ((uint32_t)blocks[i * 4 + 2] << 8) | blocks[i * 4 + 3];
+        }
+        for (int i=16; i<64; i++) {
+            uint32_t s0 = _rotateRight(w[i - 15], 7) ^ _rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = _rotateRight(w[i - 2], 17) ^ _rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int i=0; i<64; i++) {
+            uint32_t t1 = h + (_rotateRight(e, 6) ^ _rotateRight(e, 11) ^ _rotateRight(e, 25)) + ((e & f) ^ (~e & g)) + _rgK[i] + w[i];
+            uint32_t t2 = (_rotateRight(a, 2) ^ _rotateRight(a, 13) ^ _rotateRight(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#ifdef QGC_SHA256_X86
+
+/// Compression with the SHA extensions. The state is kept as the ABEF and CDGH halves sha256rnds2 works on, the
+/// message schedule advances four words at a time with sha256msg1/sha256msg2.
+__attribute__((target("sha,sse4.1")))
+static void _compressSHANI(uint32_t state[8], const uint8_t* blocks, int blockCount)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xB1);     // CDAB
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1B);  // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);                                       // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);                                            // CDGH
+
+    for (int block=0; block<blockCount; block++, blocks+=64) {
+        __m128i abefSave = state0;
+        __m128i cdghSave = state1;
+        __m128i rgMsg[4];
+
+        for (int group=0; group<16; group++) {
+            __m128i msg;
+            if (group < 4) {
+                msg = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(blocks + group * 16)), byteSwap);
+            } else {
+                // W[t..t+3] from W[t-16..t-1], which are the four groups before
+                msg = _mm_sha256msg1_epu32(rgMsg[group & 3], rgMsg[(group + 1) & 3]);
+                msg = _mm_add_epi32(msg, _mm_alignr_epi8(rgMsg[(group + 3) & 3], rgMsg[(group + 2) & 3], 4));
+                msg = _mm_sha256msg2_epu32(msg, rgMsg[(group + 3) & 3]);
+            }
+            rgMsg[group & 3] = msg;
+
+            __m128i wk = _mm_add_epi32(msg, _mm_loadu_si128((const __m128i*)&_rgK[group * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E));
+        }
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);                                          // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);                                       // DCHG
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(tmp, state1, 0xF0));     // DCBA
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(state1, tmp, 8));        // HGFE
+}
+
+static bool _cpuHasSHA(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1)) {
+        return false;
+    }
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return false;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1 << 29)) != 0;
+}
+
+#endif
+
+static std::atomic<CompressFunc> _compress(NULL);
+
+static CompressFunc _selectCompress(bool hardware)
+{
+#ifdef QGC_SHA256_X86
+    if (hardware && MAVLinkSHA256::hardwareAvailable()) {
+        return _compressSHANI;
+    }
+#else
+    (void)hardware;
+#endif
+    return _compressPortable;
+}
+
+static inline CompressFunc _compressFunc(void)
+{
+    CompressFunc compress = _compress.load(std::memory_order_relaxed);
+    if (!compress) {
+        compress = _selectCompress(true);
+        _compress.store(compress, std::memory_order_relaxed);
+    }
+    return compress;
+}
+
+bool MAVLinkSHA256::hardwareAvailable(void)
+{
+#ifdef QGC_SHA256_X86
+    static const bool available = _cpuHasSHA();
+    return available;
+#else
+    return false;
+#endif
+}
+
+bool MAVLinkSHA256::hardwareEnabled(void)
+{
+    return _compressFunc() != _compressPortable;
+}
+
+void MAVLinkSHA256::setHardwareEnabled(bool enabled)
+{
+    _compress.store(_selectCompress(enabled), std::memory_order_relaxed);
+}
+
+void mavlink_sha256_init(mavlink_sha256_ctx* m)
+{
+    m->state[0] = 0x6a09e667;
+    m->state[1] = 0xbb67ae85;
+    m->state[2] = 0x3c6ef372;
+    m->state[3] = 0xa54ff53a;
+    m->state[4] = 0x510e527f;
+    m->state[5] = 0x9b05688c;
+    m->state[6] = 0x1f83d9ab;
+    m->state[7] = 0x5be0cd19;
+    m->length = 0;
+}
+
+void mavlink_sha256_update(mavlink_sha256_ctx* m, const void* v, uint32_t len)
+{
+    const uint8_t*  p = (const uint8_t*)v;
+    uint32_t        offset = m->length % 64;
+    CompressFunc    compress = _compressFunc();
+
+    m->length += len;
+
+    if (offset) {
+        uint32_t fill = 64 - offset;
+        if (len < fill) {
+            memcpy(m->buffer + offset, p, len);
+            return;
+        }
+        memcpy(m->buffer + offset, p, fill);
+        compress(m->state, m->buffer, 1);
+        p += fill;
+        len -= fill;
+    }
+
+    // Whole blocks are hashed in place
+    if (len >= 64) {
+        compress(m->state, p, len / 64);
+        p += len & ~63u;
+        len %= 64;
+    }
+
+    memcpy(m->buffer, p, len);
+}
+
+static void _final(mavlink_sha256_ctx* m)
+{
+    uint64_t    bits = m->length * 8;
+    uint32_t    offset = m->length % 64;
+    uint8_t     padding[72];
+    uint32_t    padLength = (offset < 56 ? 56 : 120) - offset;
+
+    memset(padding, 0, sizeof(padding));
+    padding[0] = 0x80;
+    for (int i=0; i<8; i++) {
+        padding[padLength + i] = (uint8_t)(bits >> (56 - 8 * i));
+    }
+
+    mavlink_sha256_update(m, padding, padLength + 8);
+}
+
+void mavlink_sha256_final_48(mavlink_sha256_ctx* m, uint8_t result[6])
+{
+    _final(m);
+
+    result[0] = m->state[0] >> 24;
+    result[1] = m->state[0] >> 16;
+    result[2] = m->state[0] >> 8;
+    result[3] = m->state[0];
+    result[4] = m->state[1] >> 24;
+    result[5] = m->state[1] >> 16;
+}
+
+void MAVLinkSHA256::hash(const void* data, int length, uint8_t digest[32])
+{
+    mavlink_sha256_ctx ctx;
+
+    mavlink_sha256_init(&ctx);
+    mavlink_sha256_update(&ctx, data, length);
+    _final(&ctx);
+
+    for (int i=0; i<8; i++) {
+        digest[i * 4]       = ctx.state[i] >> 24;
+        digest[i * 4 + 1]   = ctx.state[i] >> 16;
+        digest[i * 4 + 2]   = ctx.state[i] >> 8;
+        digest[i * 4 + 3]   = ctx.state[i];
+    }
+}
@@ -0,0 +1,44 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+
+/// SHA-256 for MAVLink 2 signing. The mavlink library lets the implementation provide its own with the API of
+/// mavlink_sha256.h (HAVE_MAVLINK_SHA256, see QGCMAVLink.h). The compression function uses the x86 SHA extensions when
+/// the CPU has them and falls back to portable code otherwise, the choice is made on first use.
+
+typedef struct {
+    uint32_t    state[8];
+    uint64_t    length;         ///< Bytes hashed so far
+    uint8_t     buffer[64];     ///< Partial block
+} mavlink_sha256_ctx;
+
+void mavlink_sha256_init(mavlink_sha256_ctx* m);
+void mavlink_sha256_update(mavlink_sha256_ctx* m, const void* v, uint32_t len);
+
+/// First 48 bits of the hash, which is all a MAVLink signature carries
+void mavlink_sha256_final_48(mavlink_sha256_ctx* m, uint8_t result[6]);
+
+class MAVLinkSHA256
+{
+public:
+    /// @return true: the CPU has the SHA extensions
+    static bool hardwareAvailable(void);
+
+    /// @return true: hashes are computed with the SHA extensions
+    static bool hardwareEnabled(void);
+
+    /// Switches between the SHA extensions, if available, and the portable code. Used to compare the two.
+    static void setHardwareEnabled(bool enabled);
+
+    /// Full hash of a buffer
+    static void hash(const void* data, int length, uint8_t digest[32]);
+};
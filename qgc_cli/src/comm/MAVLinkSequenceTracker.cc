@@ -0,0 +1,83 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkSequenceTracker.h"
+
+MAVLinkSequenceTracker::MAVLinkSequenceTracker(void)
+    : _count(0)
+{
+    _rehash(_initialCapacity);
+}
+
+/// Returns the slot holding the key, or the empty slot it goes into
+int MAVLinkSequenceTracker::_slot(quint32 key) const
+{
+    int mask = _entries.count() - 1;
+    int slot = (int)((key * 2654435761u) >> 8) & mask;
+
+    while (_entries[slot].key != 0 && _entries[slot].key != key) {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+void MAVLinkSequenceTracker::_rehash(int capacity)
+{
+    QVector<Entry> oldEntries = _entries;
+
+    Entry empty = { 0, 0 };
+    _entries.fill(empty, capacity);
+
+    for (int i=0; i<oldEntries.count(); i++) {
+        if (oldEntries[i].key != 0) {
+            _entries[_slot(oldEntries[i].key)] = oldEntries[i];
+        }
+    }
+}
+
+int MAVLinkSequenceTracker::update(uint8_t channel, uint8_t sysid, uint8_t compid, uint8_t seq)
+{
+    quint32 key = _key(channel, sysid, compid);
+    int     slot = _slot(key);
+    Entry&  entry = _entries[slot];
+
+    if (entry.key == 0) {
+        entry.key = key;
+        entry.lastSeq = seq;
+        if (++_count * 2 > _entries.count()) {
+            _rehash(_entries.count() * 2);
+        }
+        return 0;
+    }
+
+    // Sequence numbers wrap at 256
+    int lost = (uint8_t)(seq - (uint8_t)(entry.lastSeq + 1));
+    entry.lastSeq = seq;
+
+    return lost > maxGap ? 0 : lost;
+}
+
+void MAVLinkSequenceTracker::resetChannel(uint8_t channel)
+{
+    int removed = 0;
+
+    for (int i=0; i<_entries.count(); i++) {
+        if (_entries[i].key != 0 && (((_entries[i].key - 1) >> 16) & 0xFF) == channel) {
+            _entries[i].key = 0;
+            removed++;
+        }
+    }
+
+    // Removing entries breaks up the probe sequences of the others, so they are placed again
+    if (removed) {
+        _count -= removed;
+        _rehash(_entries.count());
+    }
+}
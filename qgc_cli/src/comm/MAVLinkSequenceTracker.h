@@ -0,0 +1,54 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtGlobal>
+#include <QVector>
+
+/// Last sequence number of every source heard on every mavlink channel, to count the frames lost in between. A
+/// vehicle heard over two links has a sequence per link, so the links don't count each other's frames as lost.
+///
+/// Sources are kept in an open addressing hash table keyed by channel, system id and component id, which only grows
+/// with the sources actually heard instead of a 256 x 256 array per key.
+class MAVLinkSequenceTracker
+{
+public:
+    MAVLinkSequenceTracker(void);
+
+    /// Records the sequence number of a frame
+    ///     @return Number of frames lost between the last one from the source on the channel and this one, 0 for the
+    ///             first frame. A gap of more than maxGap is taken as a reordered frame or a restarted source and
+    ///             counts as 0.
+    int update(uint8_t channel, uint8_t sysid, uint8_t compid, uint8_t seq);
+
+    /// Forgets all sources of the channel, for a link which is reset or goes away
+    void resetChannel(uint8_t channel);
+
+    /// @return Number of sources tracked
+    int count(void) const { return _count; }
+
+    static const int maxGap = 128;
+
+private:
+    struct Entry {
+        quint32 key;        ///< channel, sysid and compid plus 1, 0 for an empty entry
+        uint8_t lastSeq;
+    };
+
+    static quint32 _key(uint8_t channel, uint8_t sysid, uint8_t compid) { return ((channel << 16) | (sysid << 8) | compid) + 1; }
+
+    int     _slot   (quint32 key) const;
+    void    _rehash (int capacity);
+
+    static const int _initialCapacity = 64;
+
+    QVector<Entry>  _entries;   ///< Capacity is a power of two, at most half used
+    int             _count;
+};
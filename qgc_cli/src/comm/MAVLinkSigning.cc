@@ -0,0 +1,53 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkSigning.h"
+#include "QGCClock.h"
+
+#include <string.h>
+
+QByteArray MAVLinkSigning::keyFromPassphrase(const QString& passphrase)
+{
+    QByteArray  utf8 = passphrase.toUtf8();
+    uint8_t     digest[keyLength];
+
+    MAVLinkSHA256::hash(utf8.constData(), utf8.size(), digest);
+    return QByteArray((const char*)digest, keyLength);
+}
+
+uint64_t MAVLinkSigning::currentTimestamp(void)
+{
+    qint64 msecs = QGCClock::instance()->currentMSecsSinceEpoch() - (qint64)_timestampEpochMSecs;
+    return msecs > 0 ? (uint64_t)msecs * 100 : 0;
+}
+
+void MAVLinkSigning::initSigning(mavlink_signing_t* signing, const QByteArray& key, uint8_t linkId)
+{
+    Q_ASSERT(key.size() == keyLength);
+
+    memset(signing, 0, sizeof(*signing));
+    memcpy(signing->secret_key, key.constData(), keyLength);
+    signing->link_id = linkId;
+    signing->flags = MAVLINK_SIGNING_FLAG_SIGN_OUTGOING;
+    signing->timestamp = currentTimestamp();
+    signing->accept_unsigned_callback = _acceptUnsigned;
+}
+
+mavlink_signing_streams_t* MAVLinkSigning::streams(void)
+{
+    static mavlink_signing_streams_t signingStreams;
+    return &signingStreams;
+}
+
+/// Radios inject their own status into the stream, they can't sign it
+bool MAVLinkSigning::_acceptUnsigned(const mavlink_status_t* status, uint32_t msgid)
+{
+    Q_UNUSED(status);
+    return msgid == MAVLINK_MSG_ID_RADIO_STATUS;
+}
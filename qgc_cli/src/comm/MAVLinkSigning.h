@@ -0,0 +1,42 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+#include <QByteArray>
+#include <QString>
+
+/// MAVLink 2 signing support shared by all links. Each link keeps its own mavlink_signing_t (key, link id and the
+/// timestamp of its outgoing messages, see LinkInterface), while the record of the last timestamp of every incoming
+/// stream is one table for all links, so a message replayed on another link is still refused.
+class MAVLinkSigning
+{
+public:
+    static const int keyLength = 32;
+
+    /// @return Secret key for a passphrase, the SHA-256 of it as other MAVLink tools derive it
+    static QByteArray keyFromPassphrase(const QString& passphrase);
+
+    /// @return Current signing timestamp, in 10 microsecond units since 1 January 2015 GMT
+    static uint64_t currentTimestamp(void);
+
+    /// Sets up signing state for a key and link id, signing outgoing messages and accepting unsigned ones only where
+    /// _acceptUnsigned allows
+    static void initSigning(mavlink_signing_t* signing, const QByteArray& key, uint8_t linkId);
+
+    /// Incoming stream timestamps of all links
+    static mavlink_signing_streams_t* streams(void);
+
+private:
+    static bool _acceptUnsigned(const mavlink_status_t* status, uint32_t msgid);
+
+    static const quint64 _timestampEpochMSecs = 1420070400000ULL;   ///< 1 January 2015 GMT
+};
@@ -11,14 +11,15 @@
 #include "MockLink.h"
 #include "QGCLoggingCategory.h"
 #include "QGCApplication.h"
+#include "QGCClock.h"
 
 #ifdef UNITTEST_BUILD
     #include "UnitTest.h"
 #endif
 
-#include <QTimer>
 #include <QDebug>
 #include <QFile>
+#include <QtMath>
 
 #include <string.h>
 
@@ -68,12 +69,26 @@ MockLink::MockLink(SharedLinkConfigurationPointer& config)
     , _currentParamRequestListParamIndex(-1)
     , _logDownloadCurrentOffset(0)
     , _logDownloadBytesRemaining(0)
+    , _lossState(0)
+    , _pingSequence(0)
+    , _messagesSent(0)
+    , _bytesSent(0)
+    , _messagesDropped(0)
+    , _pingsSent(0)
+    , _pingReplies(0)
+    , _bootMSecs(0)
 {
     MockConfiguration* mockConfig = qobject_cast<MockConfiguration*>(_config.data());
     _firmwareType = mockConfig->firmwareType();
     _vehicleType = mockConfig->vehicleType();
     _sendStatusText = mockConfig->sendStatusText();
     _failureMode = mockConfig->failureMode();
+    _trafficProfile = mockConfig->trafficProfile();
+
+    if (_trafficProfile.systemId != 0) {
+        _vehicleSystemId = _trafficProfile.systemId;
+    }
+    _lossState = (_vehicleSystemId * 2654435761u) | 1;
 
     union px4_custom_mode   px4_cm;
 
@@ -131,23 +146,36 @@ void MockLink::_disconnect(void)
 
 void MockLink::run(void)
 {
-    QTimer  timer1HzTasks;
-    QTimer  timer10HzTasks;
-    QTimer  timer500HzTasks;
-
-    QObject::connect(&timer1HzTasks,  &QTimer::timeout, this, &MockLink::_run1HzTasks);
-    QObject::connect(&timer10HzTasks, &QTimer::timeout, this, &MockLink::_run10HzTasks);
-    QObject::connect(&timer500HzTasks, &QTimer::timeout, this, &MockLink::_run500HzTasks);
+    QGCTimer    timer1HzTasks;
+    QGCTimer    timer10HzTasks;
+    QGCTimer    timer500HzTasks;
+    QGCTimer    timerTelemetry;
+    QGCTimer    timerPing;
+
+    QObject::connect(&timer1HzTasks,  &QGCTimer::timeout, this, &MockLink::_run1HzTasks);
+    QObject::connect(&timer10HzTasks, &QGCTimer::timeout, this, &MockLink::_run10HzTasks);
+    QObject::connect(&timer500HzTasks, &QGCTimer::timeout, this, &MockLink::_run500HzTasks);
+    QObject::connect(&timerTelemetry, &QGCTimer::timeout, this, &MockLink::_sendTelemetry);
+    QObject::connect(&timerPing, &QGCTimer::timeout, this, &MockLink::_sendPing);
 
     timer1HzTasks.start(1000);
     timer10HzTasks.start(100);
     timer500HzTasks.start(2);
+    if (_trafficProfile.telemetryRate > 0) {
+        timerTelemetry.setTimerType(Qt::PreciseTimer);
+        timerTelemetry.start(qMax(1, 1000 / _trafficProfile.telemetryRate));
+    }
+    if (_trafficProfile.pingRate > 0) {
+        timerPing.start(qMax(1, 1000 / _trafficProfile.pingRate));
+    }
 
     exec();
 
-    QObject::disconnect(&timer1HzTasks,  &QTimer::timeout, this, &MockLink::_run1HzTasks);
-    QObject::disconnect(&timer10HzTasks, &QTimer::timeout, this, &MockLink::_run10HzTasks);
-    QObject::disconnect(&timer500HzTasks, &QTimer::timeout, this, &MockLink::_run500HzTasks);
+    QObject::disconnect(&timer1HzTasks,  &QGCTimer::timeout, this, &MockLink::_run1HzTasks);
+    QObject::disconnect(&timer10HzTasks, &QGCTimer::timeout, this, &MockLink::_run10HzTasks);
+    QObject::disconnect(&timer500HzTasks, &QGCTimer::timeout, this, &MockLink::_run500HzTasks);
+    QObject::disconnect(&timerTelemetry, &QGCTimer::timeout, this, &MockLink::_sendTelemetry);
+    QObject::disconnect(&timerPing, &QGCTimer::timeout, this, &MockLink::_sendPing);
 
     _missionItemHandler.shutdown();
 }
@@ -155,8 +183,10 @@ void MockLink::run(void)
 void MockLink::_run1HzTasks(void)
 {
     if (_mavlinkStarted && _connected) {
-        _sendVibration();
-        if (!qgcApp()->runningUnitTests()) {
+        if (_messageEnabled(MAVLINK_MSG_ID_VIBRATION)) {
+            _sendVibration();
+        }
+        if (!qgcApp()->runningUnitTests() && _messageEnabled(MAVLINK_MSG_ID_RC_CHANNELS)) {
             // Sending RC Channels during unit test breaks RC tests which does it's own RC simulation
             _sendRCChannels();
         }
@@ -180,7 +210,7 @@ void MockLink::_run10HzTasks(void)
         if (_sendGPSPositionDelayCount > 0) {
             // We delay gps position for better testing
             _sendGPSPositionDelayCount--;
-        } else {
+        } else if (_messageEnabled(MAVLINK_MSG_ID_GPS_RAW_INT)) {
             _sendGpsRawInt();
         }
     }
@@ -192,6 +222,7 @@ void MockLink::_run500HzTasks(void)
         _paramRequestListWorker();
         _logDownloadWorker();
     }
+    _delayedBytesWorker();
 }
 
 void MockLink::_loadParams(void)
@@ -265,6 +296,23 @@ void MockLink::_loadParams(void)
         _mapParamName2Value[_vehicleComponentId][paramName] = paramValue;
         _mapParamName2MavParamType[paramName] = static_cast<MAV_PARAM_TYPE>(paramType);
     }
+
+    _addSyntheticParams();
+}
+
+/// Pads the parameter set up to the traffic profile size, so param load cost can be scaled independently of the firmware
+void MockLink::_addSyntheticParams(void)
+{
+    QMap<QString, QVariant>& params = _mapParamName2Value[_vehicleComponentId];
+
+    for (int i=0; params.count() < _trafficProfile.paramCount; i++) {
+        QString paramName = QString("MOCK_LOAD_%1").arg(i, 5, 10, QChar('0'));
+        if (params.contains(paramName)) {
+            continue;
+        }
+        params[paramName] = QVariant((float)i);
+        _mapParamName2MavParamType[paramName] = MAV_PARAM_TYPE_REAL32;
+    }
 }
 
 void MockLink::_sendHeartBeat(void)
@@ -305,11 +353,49 @@ void MockLink::_sendVibration(void)
 
 void MockLink::respondWithMavlinkMessage(const mavlink_message_t& msg)
 {
+    if (_dropMessage()) {
+        _messagesDropped.ref();
+        return;
+    }
+
     uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
 
     int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
     QByteArray bytes((char *)buffer, cBuffer);
-    emit bytesReceived(this, bytes);
+
+    _messagesSent.ref();
+    _bytesSent.fetchAndAddRelaxed(cBuffer);
+
+    if (_trafficProfile.latencyMsecs > 0) {
+        _delayedBytes.enqueue(qMakePair(QGCClock::instance()->elapsed() + _trafficProfile.latencyMsecs, bytes));
+        return;
+    }
+
+    _bytesReceived(bytes);
+}
+
+bool MockLink::_dropMessage(void)
+{
+    if (_trafficProfile.lossPercent <= 0) {
+        return false;
+    }
+
+    // xorshift32, cheap and the same sequence on every run for a given vehicle id
+    _lossState ^= _lossState << 13;
+    _lossState ^= _lossState >> 17;
+    _lossState ^= _lossState << 5;
+
+    return (int)(_lossState % 100) < _trafficProfile.lossPercent;
+}
+
+/// Releases delayed bytes once they are due. Runs from the 500Hz task, so added latency has a resolution of 2 msecs.
+void MockLink::_delayedBytesWorker(void)
+{
+    qint64 now = QGCClock::instance()->elapsed();
+
+    while (!_delayedBytes.isEmpty() && _delayedBytes.head().first <= now) {
+        _bytesReceived(_delayedBytes.dequeue().second);
+    }
 }
 
 /// @brief Called when QGC wants to write bytes to the MAV
@@ -408,6 +494,10 @@ void MockLink::_handleIncomingMavlinkBytes(const uint8_t* bytes, int cBytes)
             _handleLogRequestData(msg);
             break;
 
+        case MAVLINK_MSG_ID_PING:
+            _handlePing(msg);
+            break;
+
         default:
             break;
         }
@@ -819,6 +909,17 @@ void MockLink::_handleCommandLong(const mavlink_message_t& msg)
         commandResult = MAV_RESULT_ACCEPTED;
         _respondWithAutopilotVersion();
         break;
+    case MAV_CMD_SET_MESSAGE_INTERVAL:
+    {
+        QMutexLocker locker(&_messageIntervalMutex);
+        if (request.param2 == 0.0f) {
+            _messageIntervals.remove((int)request.param1);
+        } else {
+            _messageIntervals[(int)request.param1] = (int)request.param2;
+        }
+        commandResult = MAV_RESULT_ACCEPTED;
+    }
+        break;
     case MAV_CMD_USER_1:
         // Test command which always returns MAV_RESULT_ACCEPTED
         commandResult = MAV_RESULT_ACCEPTED;
@@ -864,6 +965,19 @@ void MockLink::_handleCommandLong(const mavlink_message_t& msg)
     respondWithMavlinkMessage(commandAck);
 }
 
+int MockLink::messageInterval(int msgId)
+{
+    QMutexLocker locker(&_messageIntervalMutex);
+    return _messageIntervals.value(msgId, 0);
+}
+
+void MockLink::simulateReboot(void)
+{
+    QMutexLocker locker(&_messageIntervalMutex);
+    _messageIntervals.clear();
+    _bootMSecs = QGCClock::instance()->elapsed();
+}
+
 void MockLink::_respondWithAutopilotVersion(void)
 {
     mavlink_message_t msg;
@@ -1000,6 +1114,7 @@ MockConfiguration::MockConfiguration(MockConfiguration* source)
     _vehicleType =      source->_vehicleType;
     _sendStatusText =   source->_sendStatusText;
     _failureMode =      source->_failureMode;
+    _trafficProfile =   source->_trafficProfile;
 }
 
 void MockConfiguration::copyFrom(LinkConfiguration *source)
@@ -1016,27 +1131,23 @@ void MockConfiguration::copyFrom(LinkConfiguration *source)
     _vehicleType =      usource->_vehicleType;
     _sendStatusText =   usource->_sendStatusText;
     _failureMode =      usource->_failureMode;
+    _trafficProfile =   usource->_trafficProfile;
 }
 
-void MockConfiguration::saveSettings(QSettings& settings, const QString& root)
+void MockConfiguration::saveSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    settings.setValue(_firmwareTypeKey, (int)_firmwareType);
-    settings.setValue(_vehicleTypeKey, (int)_vehicleType);
-    settings.setValue(_sendStatusTextKey, _sendStatusText);
-    settings.setValue(_failureModeKey, (int)_failureMode);
-    settings.sync();
-    settings.endGroup();
+    settings.setValue(root, _firmwareTypeKey, (int)_firmwareType);
+    settings.setValue(root, _vehicleTypeKey, (int)_vehicleType);
+    settings.setValue(root, _sendStatusTextKey, _sendStatusText);
+    settings.setValue(root, _failureModeKey, (int)_failureMode);
 }
 
-void MockConfiguration::loadSettings(QSettings& settings, const QString& root)
+void MockConfiguration::loadSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    _firmwareType = (MAV_AUTOPILOT)settings.value(_firmwareTypeKey, (int)MAV_AUTOPILOT_PX4).toInt();
-    _vehicleType = (MAV_TYPE)settings.value(_vehicleTypeKey, (int)MAV_TYPE_QUADROTOR).toInt();
-    _sendStatusText = settings.value(_sendStatusTextKey, false).toBool();
-    _failureMode = (FailureMode_t)settings.value(_failureModeKey, (int)FailNone).toInt();
-    settings.endGroup();
+    _firmwareType = (MAV_AUTOPILOT)settings.value(root, _firmwareTypeKey, (int)MAV_AUTOPILOT_PX4).toInt();
+    _vehicleType = (MAV_TYPE)settings.value(root, _vehicleTypeKey, (int)MAV_TYPE_QUADROTOR).toInt();
+    _sendStatusText = settings.value(root, _sendStatusTextKey, false).toBool();
+    _failureMode = (FailureMode_t)settings.value(root, _failureModeKey, (int)FailNone).toInt();
 }
 
 void MockConfiguration::updateSettings()
@@ -1263,3 +1374,118 @@ void MockLink::_logDownloadWorker(void)
         }
     }
 }
+
+void MockLink::_sendTelemetry(void)
+{
+    if (!_mavlinkStarted || !_connected) {
+        return;
+    }
+
+    // Every vehicle flies its own slow 10m circle so the GCS sees real position changes. Vehicles are spaced ~20m apart.
+    const double    radius =        10.0;
+    const double    rate =          0.1;    // rad/sec
+    qint64          timeBootMs;
+    {
+        QMutexLocker locker(&_messageIntervalMutex);
+        timeBootMs = QGCClock::instance()->elapsed() - _bootMSecs;
+    }
+    double          angle =         rate * timeBootMs / 1000.0;
+    double          latitude =      _vehicleLatitude + (_vehicleSystemId * 20.0 + radius * qCos(angle)) / 111320.0;
+    double          longitude =     _vehicleLongitude + radius * qSin(angle) / (111320.0 * qCos(qDegreesToRadians(latitude)));
+    double          yaw =           remainder(angle + M_PI_2, 2 * M_PI);
+    double          heading =       qRadiansToDegrees(yaw < 0 ? yaw + 2 * M_PI : yaw);
+    double          velocityNorth = -radius * rate * qSin(angle);
+    double          velocityEast =  radius * rate * qCos(angle);
+    mavlink_message_t msg;
+
+    if (_messageEnabled(MAVLINK_MSG_ID_GLOBAL_POSITION_INT)) {
+        mavlink_msg_global_position_int_pack_chan(_vehicleSystemId,
+                                                  _vehicleComponentId,
+                                                  _mavlinkChannel,
+                                                  &msg,
+                                                  (uint32_t)timeBootMs,                 // time_boot_ms
+                                                  (int32_t)(latitude * 1E7),            // lat
+                                                  (int32_t)(longitude * 1E7),           // lon
+                                                  (int32_t)(_vehicleAltitude * 1000),   // alt
+                                                  (int32_t)(_vehicleAltitude * 1000),   // relative_alt
+                                                  (int16_t)(velocityNorth * 100),       // vx
+                                                  (int16_t)(velocityEast * 100),        // vy
+                                                  0,                                    // vz
+                                                  (uint16_t)(heading * 100));           // hdg
+        respondWithMavlinkMessage(msg);
+    }
+
+    if (_messageEnabled(MAVLINK_MSG_ID_ATTITUDE)) {
+        mavlink_msg_attitude_pack_chan(_vehicleSystemId,
+                                       _vehicleComponentId,
+                                       _mavlinkChannel,
+                                       &msg,
+                                       (uint32_t)timeBootMs,    // time_boot_ms
+                                       0.0f,                    // roll
+                                       0.0f,                    // pitch
+                                       (float)yaw,              // yaw
+                                       0.0f,                    // rollspeed
+                                       0.0f,                    // pitchspeed
+                                       (float)rate);            // yawspeed
+        respondWithMavlinkMessage(msg);
+    }
+}
+
+/// Sends a ping request to all systems. The GCS reply comes back through its normal message handling, so the round trip
+/// covers the parse and dispatch queues of the GCS as well as the link.
+void MockLink::_sendPing(void)
+{
+    if (!_mavlinkStarted || !_connected) {
+        return;
+    }
+
+    mavlink_message_t msg;
+
+    mavlink_msg_ping_pack_chan(_vehicleSystemId,
+                               _vehicleComponentId,
+                               _mavlinkChannel,
+                               &msg,
+                               QGCClock::instance()->elapsedUSecs(),    // time_usec
+                               _pingSequence++,                         // seq
+                               0,                                       // target_system, 0 for a request
+                               0);                                      // target_component
+    _pingsSent.ref();
+    respondWithMavlinkMessage(msg);
+}
+
+void MockLink::_handlePing(const mavlink_message_t& msg)
+{
+    mavlink_ping_t ping;
+    mavlink_msg_ping_decode(&msg, &ping);
+
+    if (ping.target_system != _vehicleSystemId || ping.target_component != _vehicleComponentId) {
+        return;
+    }
+
+    _pingReplies.ref();
+
+    QMutexLocker locker(&_pingMutex);
+    _pingRoundTrips.append(QGCClock::instance()->elapsedUSecs() - (qint64)ping.time_usec);
+}
+
+MockLink::TrafficStats MockLink::trafficStats(void) const
+{
+    TrafficStats stats;
+
+    stats.messagesSent =    _messagesSent.load();
+    stats.bytesSent =       _bytesSent.load();
+    stats.messagesDropped = _messagesDropped.load();
+    stats.pingsSent =       _pingsSent.load();
+    stats.pingReplies =     _pingReplies.load();
+
+    return stats;
+}
+
+QVector<qint64> MockLink::takePingRoundTrips(void)
+{
+    QMutexLocker locker(&_pingMutex);
+
+    QVector<qint64> roundTrips;
+    roundTrips.swap(_pingRoundTrips);
+    return roundTrips;
+}
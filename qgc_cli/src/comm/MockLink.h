@@ -12,6 +12,10 @@
 #define MOCKLINK_H
 
 #include <QMap>
+#include <QQueue>
+#include <QMutex>
+#include <QVector>
+#include <QAtomicInteger>
 #include <QLoggingCategory>
 
 #include "MockLinkMissionItemHandler.h"
@@ -60,11 +64,25 @@ public:
     FailureMode_t failureMode(void) { return _failureMode; }
     void setFailureMode(FailureMode_t failureMode) { _failureMode = failureMode; }
 
+    /// Traffic shaping used when MockLink runs as a load generator. The defaults leave MockLink as it is for unit tests.
+    struct TrafficProfile {
+        TrafficProfile(void) : systemId(0), telemetryRate(0), pingRate(0), lossPercent(0), latencyMsecs(0), paramCount(0) { }
+
+        int systemId;       ///< Vehicle system id, 0 to allocate the next free one
+        int telemetryRate;  ///< GLOBAL_POSITION_INT and ATTITUDE messages per second, 0 for none
+        int pingRate;       ///< PING requests per second, used to measure the round trip through the GCS, 0 for none
+        int lossPercent;    ///< Percentage of outgoing messages which are dropped
+        int latencyMsecs;   ///< Delay added to every outgoing message
+        int paramCount;     ///< Synthetic parameters are added until the vehicle has this many, 0 for the file set only
+    };
+    const TrafficProfile& trafficProfile(void) const { return _trafficProfile; }
+    void setTrafficProfile(const TrafficProfile& trafficProfile) { _trafficProfile = trafficProfile; }
+
     // Overrides from LinkConfiguration
     LinkType    type            (void) { return LinkConfiguration::TypeMock; }
     void        copyFrom        (LinkConfiguration* source);
-    void        loadSettings    (QSettings& settings, const QString& root);
-    void        saveSettings    (QSettings& settings, const QString& root);
+    void        loadSettings    (SettingsStore& settings, const QString& root);
+    void        saveSettings    (SettingsStore& settings, const QString& root);
     void        updateSettings  (void);
     QString     settingsURL     () { return "MockLinkSettings.qml"; }
 
@@ -78,6 +96,7 @@ private:
     MAV_TYPE        _vehicleType;
     bool            _sendStatusText;
     FailureMode_t   _failureMode;
+    TrafficProfile  _trafficProfile;
 
     static const char* _firmwareTypeKey;
     static const char* _vehicleTypeKey;
@@ -113,6 +132,23 @@ public:
 
     MockLinkFileServer* getFileServer(void) { return _fileServer; }
 
+    /// Starts the link without going through LinkManager. The traffic is then only available through bytesReceived and
+    /// writeBytesSafe, which lets a load generator forward the vehicle to another process.
+    bool startDetached(void) { return _connect(); }
+
+    /// Traffic counters for load generation, safe to read from any thread
+    struct TrafficStats {
+        quint64 messagesSent;
+        quint64 bytesSent;
+        quint64 messagesDropped;
+        quint64 pingsSent;
+        quint64 pingReplies;
+    };
+    TrafficStats trafficStats(void) const;
+
+    /// @return Ping round trip times in usecs measured since the previous call
+    QVector<qint64> takePingRoundTrips(void);
+
     // Virtuals from LinkInterface
     virtual QString getName(void) const { return _name; }
     virtual void requestReset(void){ }
@@ -141,6 +177,13 @@ public:
     /// Reset the state of the MissionItemHandler to no items, no transactions in progress.
     void resetMissionItemHandler(void) { _missionItemHandler.reset(); }
 
+    /// @return Interval in us set for msgId with MAV_CMD_SET_MESSAGE_INTERVAL, 0 for the default rate. Only turning a
+    ///         message off with -1 is simulated, messages which are on keep their own rate.
+    int messageInterval(int msgId);
+
+    /// Simulates a reboot of the vehicle: the time since boot starts over and all message intervals are back to default
+    void simulateReboot(void);
+
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile(void) { return _logDownloadFilename; }
 
@@ -157,6 +200,8 @@ private slots:
     void _run1HzTasks(void);
     void _run10HzTasks(void);
     void _run500HzTasks(void);
+    void _sendTelemetry(void);
+    void _sendPing(void);
 
 private:
     // From LinkInterface
@@ -182,6 +227,7 @@ private:
     void _handlePreFlightCalibration(const mavlink_command_long_t& request);
     void _handleLogRequestList(const mavlink_message_t& msg);
     void _handleLogRequestData(const mavlink_message_t& msg);
+    void _handlePing(const mavlink_message_t& msg);
     float _floatUnionForParam(int componentId, const QString& paramName);
     void _setParamFloatUnionIntoMap(int componentId, const QString& paramName, float paramFloat);
     void _sendHomePosition(void);
@@ -192,6 +238,10 @@ private:
     void _sendRCChannels(void);
     void _paramRequestListWorker(void);
     void _logDownloadWorker(void);
+    void _delayedBytesWorker(void);
+    void _addSyntheticParams(void);
+    bool _dropMessage(void);
+    bool _messageEnabled(int msgId) { return messageInterval(msgId) != -1; }
 
     static MockLink* _startMockLink(MockConfiguration* mockConfig);
 
@@ -236,6 +286,23 @@ private:
     uint32_t    _logDownloadCurrentOffset;  ///< Current offset we are sending from
     uint32_t    _logDownloadBytesRemaining; ///< Number of bytes still to send, 0 = send inactive
 
+    MockConfiguration::TrafficProfile _trafficProfile;
+
+    QQueue<QPair<qint64, QByteArray> >  _delayedBytes;     ///< Outgoing bytes held back for latency, with the time they are due
+    quint32                             _lossState;        ///< Random state for message loss, seeded per vehicle so runs repeat
+    uint32_t                            _pingSequence;
+
+    QAtomicInteger<quint64> _messagesSent;
+    QAtomicInteger<quint64> _bytesSent;
+    QAtomicInteger<quint64> _messagesDropped;
+    QAtomicInteger<quint64> _pingsSent;
+    QAtomicInteger<quint64> _pingReplies;
+    QMutex                  _pingMutex;
+    QVector<qint64>         _pingRoundTrips;
+    QMutex                  _messageIntervalMutex;
+    QMap<int, int>          _messageIntervals;      ///< From MAV_CMD_SET_MESSAGE_INTERVAL by msgId
+    qint64                  _bootMSecs;             ///< QGCClock::elapsed the vehicle booted at
+
     static float        _vehicleLatitude;
     static float        _vehicleLongitude;
     static float        _vehicleAltitude;
@@ -18,10 +18,20 @@
 #define QGCMAVLINK_H
 
 #define MAVLINK_USE_MESSAGE_INFO
-#define MAVLINK_EXTERNAL_RX_STATUS  // Single m_mavlink_status instance is in QGCApplication.cc
+#define MAVLINK_GET_CHANNEL_STATUS  // Channel state is allocated per channel by MAVLinkChannelPool instead of the
+#define MAVLINK_GET_CHANNEL_BUFFER  // MAVLINK_COMM_NUM_BUFFERS sized static arrays in mavlink_helpers.h
+#define MAVLINK_GET_MSG_ENTRY       // Direct lookup by MAVLinkMessageTable instead of a bisection search per frame
+#define HAVE_CRC_ACCUMULATE_BUFFER  // Slice-by-8 checksum of whole buffers by MAVLinkCRC
+#define HAVE_MAVLINK_SHA256         // Signing hashes with the SHA extensions where the CPU has them
+#define MAVLINK_MAX_SIGNING_STREAMS 256 // Signed system/component/link triples, the default 16 is too few for a swarm
 #include <stddef.h>                 // Hack workaround for Mav 2.0 header problem with respect to offsetof usage
 #include <mavlink_types.h>
-extern mavlink_status_t m_mavlink_status[MAVLINK_COMM_NUM_BUFFERS];
+#include "MAVLinkSHA256.h"
+mavlink_status_t*           mavlink_get_channel_status(uint8_t chan);
+mavlink_message_t*          mavlink_get_channel_buffer(uint8_t chan);
+const mavlink_msg_entry_t*  mavlink_get_msg_entry(uint32_t msgid);
+uint16_t                    crc_calculate(const uint8_t* pBuffer, uint16_t length);
+void                        crc_accumulate_buffer(uint16_t* crcAccum, const char* pBuffer, uint16_t length);
 #include <mavlink.h>
 
 class QGCMAVLink {
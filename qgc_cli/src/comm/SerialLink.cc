@@ -10,7 +10,6 @@
 
 #include <QTimer>
 #include <QDebug>
-#include <QSettings>
 #include <QMutexLocker>
 
 #ifdef __android__
@@ -88,7 +87,7 @@ bool SerialLink::_isBootloader()
 void SerialLink::_writeBytes(const QByteArray data)
 {
     if(_port && _port->isOpen()) {
-        _logOutputDataRate(data.size(), QDateTime::currentMSecsSinceEpoch());
+        _logOutputDataRate(data.size(), QGCClock::instance()->currentMSecsSinceEpoch());
         _port->write(data);
     } else {
         // Error occurred
@@ -244,7 +243,7 @@ void SerialLink::_readBytes(void)
         QByteArray buffer;
         buffer.resize(byteCount);
         _port->read(buffer.data(), buffer.size());
-        emit bytesReceived(this, buffer);
+        _bytesReceived(buffer);
     }
 }
 
@@ -452,30 +451,26 @@ QString SerialConfiguration::cleanPortDisplayname(const QString name)
     return pname;
 }
 
-void SerialConfiguration::saveSettings(QSettings& settings, const QString& root)
+void SerialConfiguration::saveSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    settings.setValue("baud",           _baud);
-    settings.setValue("dataBits",       _dataBits);
-    settings.setValue("flowControl",    _flowControl);
-    settings.setValue("stopBits",       _stopBits);
-    settings.setValue("parity",         _parity);
-    settings.setValue("portName",       _portName);
-    settings.setValue("portDisplayName",_portDisplayName);
-    settings.endGroup();
+    settings.setValue(root, "baud",           _baud);
+    settings.setValue(root, "dataBits",       _dataBits);
+    settings.setValue(root, "flowControl",    _flowControl);
+    settings.setValue(root, "stopBits",       _stopBits);
+    settings.setValue(root, "parity",         _parity);
+    settings.setValue(root, "portName",       _portName);
+    settings.setValue(root, "portDisplayName",_portDisplayName);
 }
 
-void SerialConfiguration::loadSettings(QSettings& settings, const QString& root)
+void SerialConfiguration::loadSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    if(settings.contains("baud"))           _baud           = settings.value("baud").toInt();
-    if(settings.contains("dataBits"))       _dataBits       = settings.value("dataBits").toInt();
-    if(settings.contains("flowControl"))    _flowControl    = settings.value("flowControl").toInt();
-    if(settings.contains("stopBits"))       _stopBits       = settings.value("stopBits").toInt();
-    if(settings.contains("parity"))         _parity         = settings.value("parity").toInt();
-    if(settings.contains("portName"))       _portName       = settings.value("portName").toString();
-    if(settings.contains("portDisplayName"))_portDisplayName= settings.value("portDisplayName").toString();
-    settings.endGroup();
+    if(settings.contains(root, "baud"))           _baud           = settings.value(root, "baud").toInt();
+    if(settings.contains(root, "dataBits"))       _dataBits       = settings.value(root, "dataBits").toInt();
+    if(settings.contains(root, "flowControl"))    _flowControl    = settings.value(root, "flowControl").toInt();
+    if(settings.contains(root, "stopBits"))       _stopBits       = settings.value(root, "stopBits").toInt();
+    if(settings.contains(root, "parity"))         _parity         = settings.value(root, "parity").toInt();
+    if(settings.contains(root, "portName"))       _portName       = settings.value(root, "portName").toString();
+    if(settings.contains(root, "portDisplayName"))_portDisplayName= settings.value(root, "portDisplayName").toString();
 }
 
 QStringList SerialConfiguration::supportedBaudRates()
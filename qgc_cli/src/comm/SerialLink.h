@@ -86,8 +86,8 @@ public:
     /// From LinkConfiguration
     LinkType    type            () { return LinkConfiguration::TypeSerial; }
     void        copyFrom        (LinkConfiguration* source);
-    void        loadSettings    (QSettings& settings, const QString& root);
-    void        saveSettings    (QSettings& settings, const QString& root);
+    void        loadSettings    (SettingsStore& settings, const QString& root);
+    void        saveSettings    (SettingsStore& settings, const QString& root);
     void        updateSettings  ();
     QString     settingsURL     () { return "SerialSettings.qml"; }
 
@@ -11,7 +11,6 @@
 #include <QTimer>
 #include <QList>
 #include <QDebug>
-#include <QMutexLocker>
 #include <iostream>
 #include "TCPLink.h"
 #include "LinkManager.h"
@@ -82,7 +81,7 @@ void TCPLink::_writeBytes(const QByteArray data)
         return;
 
     _socket->write(data);
-    _logOutputDataRate(data.size(), QDateTime::currentMSecsSinceEpoch());
+    _logOutputDataRate(data.size(), QGCClock::instance()->currentMSecsSinceEpoch());
 }
 
 /**
@@ -99,8 +98,8 @@ void TCPLink::readBytes()
         QByteArray buffer;
         buffer.resize(byteCount);
         _socket->read(buffer.data(), buffer.size());
-        emit bytesReceived(this, buffer);
-        _logInputDataRate(byteCount, QDateTime::currentMSecsSinceEpoch());
+        _bytesReceived(buffer);
+        _logInputDataRate(byteCount, QGCClock::instance()->currentMSecsSinceEpoch());
 #ifdef TCPLINK_READWRITE_DEBUG
         writeDebugBytes(buffer.data(), buffer.size());
 #endif
@@ -197,12 +196,12 @@ qint64 TCPLink::getConnectionSpeed() const
 
 qint64 TCPLink::getCurrentInDataRate() const
 {
-    return 0;
+    return getCurrentInputDataRate();
 }
 
 qint64 TCPLink::getCurrentOutDataRate() const
 {
-    return 0;
+    return getCurrentOutputDataRate();
 }
 
 void TCPLink::waitForBytesWritten(int msecs)
@@ -303,21 +302,17 @@ void TCPConfiguration::setHost(const QString host)
     }
 }
 
-void TCPConfiguration::saveSettings(QSettings& settings, const QString& root)
+void TCPConfiguration::saveSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    settings.setValue("port", (int)_port);
-    settings.setValue("host", address().toString());
-    settings.endGroup();
+    settings.setValue(root, "port", (int)_port);
+    settings.setValue(root, "host", address().toString());
 }
 
-void TCPConfiguration::loadSettings(QSettings& settings, const QString& root)
+void TCPConfiguration::loadSettings(SettingsStore& settings, const QString& root)
 {
-    settings.beginGroup(root);
-    _port = (quint16)settings.value("port", QGC_TCP_PORT).toUInt();
-    QString address = settings.value("host", _address.toString()).toString();
+    _port = (quint16)settings.value(root, "port", QGC_TCP_PORT).toUInt();
+    QString address = settings.value(root, "host", _address.toString()).toString();
     _address = address;
-    settings.endGroup();
 }
 
 void TCPConfiguration::updateSettings()
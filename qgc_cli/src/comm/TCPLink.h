@@ -19,7 +19,6 @@
 #include <QString>
 #include <QList>
 #include <QMap>
-#include <QMutex>
 #include <QHostAddress>
 #include <LinkInterface.h>
 #include "QGCConfig.h"
@@ -97,8 +96,8 @@ public:
     /// From LinkConfiguration
     LinkType    type            () { return LinkConfiguration::TypeTcp; }
     void        copyFrom        (LinkConfiguration* source);
-    void        loadSettings    (QSettings& settings, const QString& root);
-    void        saveSettings    (QSettings& settings, const QString& root);
+    void        loadSettings    (SettingsStore& settings, const QString& root);
+    void        saveSettings    (SettingsStore& settings, const QString& root);
     void        updateSettings  ();
     QString     settingsURL     () { return "TcpSettings.qml"; }
 
@@ -176,15 +175,6 @@ private:
     TCPConfiguration* _tcpConfig;
     QTcpSocket*       _socket;
     bool              _socketIsConnected;
-
-    quint64 _bitsSentTotal;
-    quint64 _bitsSentCurrent;
-    quint64 _bitsSentMax;
-    quint64 _bitsReceivedTotal;
-    quint64 _bitsReceivedCurrent;
-    quint64 _bitsReceivedMax;
-    quint64 _connectionStartTime;
-    QMutex  _statisticsMutex;
 };
 
 #endif // TCPLINK_H
@@ -160,7 +160,7 @@ void UDPLink::_writeBytes(const QByteArray data)
                 // "host not there" takes time too regardless of size of data. In fact,
                 // 1 byte or "UDP frame size" bytes are the same as that's the data
                 // unit sent by UDP.
-                _logOutputDataRate(data.size(), QDateTime::currentMSecsSinceEpoch());
+                _logOutputDataRate(data.size(), QGCClock::instance()->currentMSecsSinceEpoch());
             }
         } while (_udpConfig->nextHost(host, port));
         //-- Remove hosts that are no longer there
@@ -186,10 +186,10 @@ void UDPLink::readBytes()
         databuffer.append(datagram);
         //-- Wait a bit before sending it over
         if(databuffer.size() > 10 * 1024) {
-            emit bytesReceived(this, databuffer);
+            _bytesReceived(databuffer);
             databuffer.clear();
         }
-        _logInputDataRate(datagram.length(), QDateTime::currentMSecsSinceEpoch());
+        _logInputDataRate(datagram.length(), QGCClock::instance()->currentMSecsSinceEpoch());
         // TODO This doesn't validade the sender. Anything sending UDP packets to this port gets
         // added to the list and will start receiving datagrams from here. Even a port scanner
         // would trigger this.
@@ -198,7 +198,7 @@ void UDPLink::readBytes()
     }
     //-- Send whatever is left
     if(databuffer.size()) {
-        emit bytesReceived(this, databuffer);
+        _bytesReceived(databuffer);
     }
 }
 
@@ -285,12 +285,12 @@ qint64 UDPLink::getConnectionSpeed() const
 
 qint64 UDPLink::getCurrentInDataRate() const
 {
-    return 0;
+    return getCurrentInputDataRate();
 }
 
 qint64 UDPLink::getCurrentOutDataRate() const
 {
-    return 0;
+    return getCurrentOutputDataRate();
 }
 
 void UDPLink::_registerZeroconf(uint16_t port, const std::string &regType)
@@ -485,44 +485,40 @@ void UDPConfiguration::setLocalPort(quint16 port)
     _localPort = port;
 }
 
-void UDPConfiguration::saveSettings(QSettings& settings, const QString& root)
+void UDPConfiguration::saveSettings(SettingsStore& settings, const QString& root)
 {
     _confMutex.lock();
-    settings.beginGroup(root);
-    settings.setValue("port", (int)_localPort);
-    settings.setValue("hostCount", _hosts.count());
+    settings.setValue(root, "port", (int)_localPort);
+    settings.setValue(root, "hostCount", _hosts.count());
     int index = 0;
     QMap<QString, int>::const_iterator it = _hosts.begin();
     while(it != _hosts.end()) {
         QString hkey = QString("host%1").arg(index);
-        settings.setValue(hkey, it.key());
+        settings.setValue(root, hkey, it.key());
         QString pkey = QString("port%1").arg(index);
-        settings.setValue(pkey, it.value());
+        settings.setValue(root, pkey, it.value());
         it++;
         index++;
     }
-    settings.endGroup();
     _confMutex.unlock();
 }
 
-void UDPConfiguration::loadSettings(QSettings& settings, const QString& root)
+void UDPConfiguration::loadSettings(SettingsStore& settings, const QString& root)
 {
     AutoConnectSettings* acSettings = qgcApp()->toolbox()->settingsManager()->autoConnectSettings();
 
     _confMutex.lock();
     _hosts.clear();
     _confMutex.unlock();
-    settings.beginGroup(root);
-    _localPort = (quint16)settings.value("port", acSettings->udpListenPort()->rawValue().toInt()).toUInt();
-    int hostCount = settings.value("hostCount", 0).toInt();
+    _localPort = (quint16)settings.value(root, "port", acSettings->udpListenPort()->rawValue().toInt()).toUInt();
+    int hostCount = settings.value(root, "hostCount", 0).toInt();
     for(int i = 0; i < hostCount; i++) {
         QString hkey = QString("host%1").arg(i);
         QString pkey = QString("port%1").arg(i);
-        if(settings.contains(hkey) && settings.contains(pkey)) {
-            addHost(settings.value(hkey).toString(), settings.value(pkey).toInt());
+        if(settings.contains(root, hkey) && settings.contains(root, pkey)) {
+            addHost(settings.value(root, hkey).toString(), settings.value(root, pkey).toInt());
         }
     }
-    settings.endGroup();
     _updateHostList();
 }
 
@@ -130,8 +130,8 @@ public:
     /// From LinkConfiguration
     LinkType    type                 () { return LinkConfiguration::TypeUdp; }
     void        copyFrom             (LinkConfiguration* source);
-    void        loadSettings         (QSettings& settings, const QString& root);
-    void        saveSettings         (QSettings& settings, const QString& root);
+    void        loadSettings         (SettingsStore& settings, const QString& root);
+    void        saveSettings         (SettingsStore& settings, const QString& root);
     void        updateSettings       ();
     bool        isAutoConnectAllowed () { return true; }
     QString     settingsURL          () { return "UdpSettings.qml"; }
@@ -0,0 +1,84 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkHealthTest.h"
+#include "LinkHealth.h"
+
+/// Arbitrary time well past 0
+static const qint64 _startTime = 100000;
+
+LinkHealthTest::LinkHealthTest(void)
+{
+
+}
+
+void LinkHealthTest::_age_test(void)
+{
+    LinkHealth health;
+
+    // A link which was never heard is no use
+    QCOMPARE(health.lastHeard(), (qint64)-1);
+    QCOMPARE(health.score(_startTime), 0);
+    QVERIFY(!health.healthy(_startTime));
+
+    health.frameReceived(0, _startTime);
+    QCOMPARE(health.score(_startTime), 100);
+    QCOMPARE(health.score(_startTime + LinkHealth::freshMSecs), 100);
+
+    // The score falls off between fresh and stale
+    int halfway = health.score(_startTime + (LinkHealth::freshMSecs + LinkHealth::staleMSecs) / 2);
+    QVERIFY(halfway > 40 && halfway < 60);
+    QCOMPARE(health.score(_startTime + LinkHealth::staleMSecs), 0);
+
+    health.reset();
+    QCOMPARE(health.score(_startTime), 0);
+}
+
+void LinkHealthTest::_loss_test(void)
+{
+    LinkHealth health;
+
+    for (int i=0; i<100; i++) {
+        health.frameReceived(0, _startTime);
+    }
+    QCOMPARE(health.lossRatio(), 0.0);
+
+    // Every other frame lost brings the average near one half, which is no better than a silent link
+    for (int i=0; i<200; i++) {
+        health.frameReceived(1, _startTime);
+    }
+    QVERIFY(qAbs(health.lossRatio() - 0.5) < 0.05);
+    QVERIFY(!health.healthy(_startTime));
+
+    // A clean stretch brings it back
+    for (int i=0; i<100; i++) {
+        health.frameReceived(0, _startTime);
+    }
+    QVERIFY(health.lossRatio() < 0.05);
+    QVERIFY(health.healthy(_startTime));
+}
+
+void LinkHealthTest::_roundTrip_test(void)
+{
+    LinkHealth health;
+
+    health.frameReceived(0, _startTime);
+    QCOMPARE(health.roundTripTime(), -1.0);
+
+    health.roundTrip(50);
+    QCOMPARE(health.roundTripTime(), 50.0);
+    QCOMPARE(health.score(_startTime), 100);
+
+    // Slow round trips lower the score down to half
+    for (int i=0; i<50; i++) {
+        health.roundTrip(5000);
+    }
+    QVERIFY(health.roundTripTime() > 4900);
+    QCOMPARE(health.score(_startTime), 50);
+}
@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for LinkHealth
+class LinkHealthTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LinkHealthTest(void);
+
+private slots:
+    void _age_test(void);
+    void _loss_test(void);
+    void _roundTrip_test(void);
+};
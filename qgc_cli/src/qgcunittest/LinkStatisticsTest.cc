@@ -0,0 +1,164 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkStatisticsTest.h"
+#include "LinkStatistics.h"
+
+#include <QThread>
+
+/// Arbitrary time well past 0, at the start of a bucket
+static const qint64 _startTime = 1500000000000LL;
+
+LinkStatisticsTest::LinkStatisticsTest(void)
+{
+
+}
+
+void LinkStatisticsTest::_totals_test(void)
+{
+    LinkStatistics statistics;
+
+    statistics.log(10, _startTime);
+    statistics.log(20, _startTime + 1);
+    statistics.log(30, _startTime + 2, false);
+
+    // Frames are counted on their own, one read can hold many of them
+    statistics.logFrames(5, _startTime);
+    statistics.logFrames(3, _startTime + 1);
+    statistics.logFrames(1, _startTime + 2, false);
+
+    QCOMPARE(statistics.totalBytes(), (quint64)60);
+    QCOMPARE(statistics.totalFrames(), (quint64)9);
+
+    // Without buckets the last logs only count in the totals
+    quint64 bytes;
+    quint32 frames;
+    statistics.histogram(_startTime + LinkStatistics::bucketMSecs, 1, &bytes, &frames);
+    QCOMPARE(bytes, (quint64)30);
+    QCOMPARE(frames, (quint32)8);
+
+    statistics.reset();
+    QCOMPARE(statistics.totalBytes(), (quint64)0);
+    statistics.histogram(_startTime + LinkStatistics::bucketMSecs, 1, &bytes, &frames);
+    QCOMPARE(bytes, (quint64)0);
+}
+
+void LinkStatisticsTest::_histogram_test(void)
+{
+    LinkStatistics statistics;
+
+    // Buckets 0 and 2 get traffic, 1 stays empty, 3 is the current one
+    statistics.log(100, _startTime);
+    statistics.log(50, _startTime + LinkStatistics::bucketMSecs - 1);
+    statistics.log(7, _startTime + 2 * LinkStatistics::bucketMSecs);
+    statistics.log(1000, _startTime + 3 * LinkStatistics::bucketMSecs);
+    statistics.logFrames(2, _startTime + 1);
+    statistics.logFrames(1, _startTime + 2 * LinkStatistics::bucketMSecs);
+    statistics.logFrames(4, _startTime + 3 * LinkStatistics::bucketMSecs);
+
+    quint64 rgBytes[4];
+    quint32 rgFrames[4];
+    statistics.histogram(_startTime + 3 * LinkStatistics::bucketMSecs + 50, 4, rgBytes, rgFrames);
+
+    // The current, incomplete bucket is not reported, the one before the first is
+    QCOMPARE(rgBytes[0], (quint64)0);
+    QCOMPARE(rgBytes[1], (quint64)150);
+    QCOMPARE(rgFrames[1], (quint32)2);
+    QCOMPARE(rgBytes[2], (quint64)0);
+    QCOMPARE(rgBytes[3], (quint64)7);
+    QCOMPARE(rgFrames[3], (quint32)1);
+}
+
+/// A bucket reused a full ring later starts from zero, and the old counts are not reported for the new time
+void LinkStatisticsTest::_recycle_test(void)
+{
+    LinkStatistics  statistics;
+    qint64          ring = LinkStatistics::bucketCount * LinkStatistics::bucketMSecs;
+
+    statistics.log(100, _startTime);
+    statistics.log(5, _startTime + ring);
+
+    quint64 bytes;
+    statistics.histogram(_startTime + ring + LinkStatistics::bucketMSecs, 1, &bytes, NULL);
+    QCOMPARE(bytes, (quint64)5);
+
+    // Nothing logged a ring after the last log, so the stale bucket reads as empty
+    statistics.histogram(_startTime + 2 * ring + LinkStatistics::bucketMSecs, 1, &bytes, NULL);
+    QCOMPARE(bytes, (quint64)0);
+}
+
+void LinkStatisticsTest::_dataRate_test(void)
+{
+    LinkStatistics statistics;
+
+    // 1000 bytes every 10 ms is 800000 bits/s
+    for (qint64 time=_startTime; time<_startTime + 1000; time+=10) {
+        statistics.log(1000, time);
+    }
+
+    QCOMPARE(statistics.dataRate(_startTime + 1000, 500), (qint64)800000);
+    QCOMPARE(statistics.dataRate(_startTime + 1000, 1000), (qint64)800000);
+
+    // Half of the span had no traffic
+    QCOMPARE(statistics.dataRate(_startTime + 1500, 1000), (qint64)400000);
+}
+
+namespace {
+
+class WriterThread : public QThread
+{
+public:
+    WriterThread(LinkStatistics* statistics, int count)
+        : _statistics(statistics)
+        , _count(count)
+    {
+
+    }
+
+protected:
+    void run(void)
+    {
+        // Ten logs per bucket, a bucket of 1 byte logs for every bucket index
+        for (int i=0; i<_count; i++) {
+            _statistics->log(1, _startTime + i * (LinkStatistics::bucketMSecs / 10));
+            _statistics->logFrames(1, _startTime + i * (LinkStatistics::bucketMSecs / 10));
+        }
+    }
+
+private:
+    LinkStatistics* _statistics;
+    int             _count;
+};
+
+}
+
+/// Readers polling while the link thread logs never see a bucket with more than it could hold
+void LinkStatisticsTest::_concurrentRead_test(void)
+{
+    const int       count = 2000000;
+    LinkStatistics  statistics;
+    WriterThread    writer(&statistics, count);
+    qint64          endTime = _startTime + (qint64)count * (LinkStatistics::bucketMSecs / 10);
+
+    writer.start();
+    while (!writer.isFinished()) {
+        quint64 rgBytes[LinkStatistics::bucketCount - 1];
+        quint32 rgFrames[LinkStatistics::bucketCount - 1];
+        statistics.histogram(endTime, LinkStatistics::bucketCount - 1, rgBytes, rgFrames);
+        for (int i=0; i<LinkStatistics::bucketCount - 1; i++) {
+            QVERIFY(rgBytes[i] <= 10);
+            QVERIFY(rgFrames[i] <= 10);
+        }
+    }
+    writer.wait();
+
+    QCOMPARE(statistics.totalBytes(), (quint64)count);
+    QCOMPARE(statistics.totalFrames(), (quint64)count);
+    QCOMPARE(statistics.dataRate(endTime, 1000), (qint64)800);
+}
@@ -0,0 +1,28 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for LinkStatistics
+class LinkStatisticsTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LinkStatisticsTest(void);
+
+private slots:
+    void _totals_test(void);
+    void _histogram_test(void);
+    void _recycle_test(void);
+    void _dataRate_test(void);
+    void _concurrentRead_test(void);
+};
@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkCRCTest.h"
+#include "MAVLinkCRC.h"
+#include "MAVLinkChannelPool.h"
+
+#include <QByteArray>
+
+MAVLinkCRCTest::MAVLinkCRCTest(void)
+{
+
+}
+
+/// Published check value of CRC-16/MCRF4XX
+void MAVLinkCRCTest::_checkValue_test(void)
+{
+    const char* check = "123456789";
+
+    QCOMPARE(MAVLinkCRC::accumulate(X25_INIT_CRC, (const uint8_t*)check, 9), (uint16_t)0x6F91);
+    QCOMPARE(crc_calculate((const uint8_t*)check, 9), (uint16_t)0x6F91);
+}
+
+/// Bit exact against the byte at a time checksum for every length across the eight byte steps, every alignment and
+/// a few starting values
+void MAVLinkCRCTest::_reference_test(void)
+{
+    QByteArray buffer(MAVLINK_MAX_PACKET_LEN + 8, 0);
+    quint32 seed = 12345;
+    for (int i=0; i<buffer.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = (char)(seed >> 16);
+    }
+
+    const uint16_t rgStart[] = { X25_INIT_CRC, 0, 0x1234 };
+
+    for (size_t start=0; start<sizeof(rgStart)/sizeof(rgStart[0]); start++) {
+        for (int offset=0; offset<8; offset++) {
+            const uint8_t* data = (const uint8_t*)buffer.constData() + offset;
+            for (int length=0; length<=MAVLINK_MAX_PACKET_LEN; length++) {
+                uint16_t expected = MAVLinkCRC::accumulateReference(rgStart[start], data, length);
+                uint16_t actual = rgStart[start];
+                crc_accumulate_buffer(&actual, (const char*)data, length);
+
+                QCOMPARE(MAVLinkCRC::accumulate(rgStart[start], data, length), expected);
+                QCOMPARE(actual, expected);
+            }
+        }
+    }
+}
+
+/// Messages finalized with the new checksum must make it through the byte at a time parser
+void MAVLinkCRCTest::_roundTrip_test(void)
+{
+    int channel = MAVLinkChannelPool::instance()->reserve();
+    QVERIFY(channel != 0);
+
+    mavlink_message_t message;
+    mavlink_msg_param_value_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, channel, &message, "CRC_TEST_PARAM", 1.5f, MAV_PARAM_TYPE_REAL32, 100, 42);
+
+    for (int version=1; version<=2; version++) {
+        mavlink_set_proto_version(channel, version);
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        mavlink_finalize_message_chan(&message, 1, MAV_COMP_ID_AUTOPILOT1, channel, MAVLINK_MSG_ID_PARAM_VALUE_MIN_LEN, MAVLINK_MSG_ID_PARAM_VALUE_LEN, MAVLINK_MSG_ID_PARAM_VALUE_CRC);
+        int length = mavlink_msg_to_send_buffer(buffer, &message);
+
+        mavlink_message_t received;
+        mavlink_status_t status;
+        int decoded = 0;
+        for (int position=0; position<length; position++) {
+            if (mavlink_parse_char(channel, buffer[position], &received, &status) == MAVLINK_FRAMING_OK) {
+                decoded++;
+            }
+        }
+
+        QCOMPARE(decoded, 1);
+        QCOMPARE(mavlink_msg_param_value_get_param_index(&received), (uint16_t)42);
+    }
+
+    MAVLinkChannelPool::instance()->release(channel);
+}
@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for MAVLinkCRC
+class MAVLinkCRCTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkCRCTest(void);
+
+private slots:
+    void _checkValue_test(void);
+    void _reference_test(void);
+    void _roundTrip_test(void);
+};
@@ -0,0 +1,126 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkChannelPoolTest.h"
+#include "MAVLinkChannelPool.h"
+
+#include <QElapsedTimer>
+#include <QSet>
+#include <QVector>
+
+MAVLinkChannelPoolTest::MAVLinkChannelPoolTest(void)
+{
+
+}
+
+void MAVLinkChannelPoolTest::cleanup(void)
+{
+    _releaseAll();
+    UnitTest::cleanup();
+}
+
+void MAVLinkChannelPoolTest::_reserveAll(void)
+{
+    MAVLinkChannelPool* pool = MAVLinkChannelPool::instance();
+    int channel;
+    while ((channel = pool->reserve()) != 0) {
+        _channels.append(channel);
+    }
+}
+
+void MAVLinkChannelPoolTest::_releaseAll(void)
+{
+    foreach (int channel, _channels) {
+        MAVLinkChannelPool::instance()->release(channel);
+    }
+    _channels.clear();
+}
+
+void MAVLinkChannelPoolTest::_reserveRelease_test(void)
+{
+    MAVLinkChannelPool* pool = MAVLinkChannelPool::instance();
+    int alreadyReserved = pool->reservedCount();
+
+    _reserveAll();
+
+    // Well past the old MAVLINK_COMM_NUM_BUFFERS limit, channel 0 is never handed out and channels are unique
+    QCOMPARE(_channels.count() + alreadyReserved, MAVLinkChannelPool::maxChannels - 1);
+    QVERIFY(!_channels.contains(0));
+    QCOMPARE(_channels.toSet().count(), _channels.count());
+    QCOMPARE(pool->reserve(), 0);
+
+    // Released channels are reused with clean state
+    int channel = _channels.takeLast();
+    mavlink_get_channel_status(channel)->parse_state = MAVLINK_PARSE_STATE_GOT_STX;
+    pool->release(channel);
+    QCOMPARE(pool->reserve(), channel);
+    QCOMPARE((int)mavlink_get_channel_status(channel)->parse_state, (int)MAVLINK_PARSE_STATE_UNINIT);
+    _channels.append(channel);
+}
+
+/// Feeds heartbeats to each reserved channel one byte at a time in round robin fashion so every parser is mid message
+/// at the same time.
+/// @return Number of messages decoded
+int MAVLinkChannelPoolTest::_parseInterleaved(int channelCount, int messagesPerChannel)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    mavlink_message_t message;
+    mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, 0, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    int length = mavlink_msg_to_send_buffer(buffer, &message);
+
+    int decoded = 0;
+    for (int i=0; i<messagesPerChannel; i++) {
+        for (int position=0; position<length; position++) {
+            for (int j=0; j<channelCount; j++) {
+                mavlink_message_t received;
+                mavlink_status_t status;
+                if (mavlink_parse_char(_channels[j], buffer[position], &received, &status) == MAVLINK_FRAMING_OK) {
+                    decoded++;
+                }
+            }
+        }
+    }
+
+    return decoded;
+}
+
+void MAVLinkChannelPoolTest::_interleavedParse_test(void)
+{
+    _reserveAll();
+    QVERIFY(_channels.count() > MAVLINK_COMM_NUM_BUFFERS);
+
+    const int messagesPerChannel = 3;
+    QCOMPARE(_parseInterleaved(_channels.count(), messagesPerChannel), _channels.count() * messagesPerChannel);
+}
+
+/// Reports parse cost and state memory per channel as the number of channels grows. Both should stay flat.
+void MAVLinkChannelPoolTest::_scaling_test(void)
+{
+    _reserveAll();
+
+    const int messagesPerChannel = 100;
+    QVector<int> rgChannelCounts;
+    rgChannelCounts << 4 << 16 << 64 << _channels.count();
+
+    foreach (int channelCount, rgChannelCounts) {
+        if (channelCount > _channels.count()) {
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        int decoded = _parseInterleaved(channelCount, messagesPerChannel);
+        qint64 nsecs = timer.nsecsElapsed();
+
+        QCOMPARE(decoded, channelCount * messagesPerChannel);
+        qDebug() << "channels" << channelCount
+                 << "nsecs/message" << nsecs / decoded
+                 << "state bytes/channel" << MAVLinkChannelPool::channelStateSize();
+    }
+}
@@ -0,0 +1,37 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QList>
+
+/// Unit test for MAVLinkChannelPool
+class MAVLinkChannelPoolTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkChannelPoolTest(void);
+
+private slots:
+    void cleanup(void);
+
+    void _reserveRelease_test(void);
+    void _interleavedParse_test(void);
+    void _scaling_test(void);
+
+private:
+    void _reserveAll(void);
+    void _releaseAll(void);
+    int  _parseInterleaved(int channelCount, int messagesPerChannel);
+
+    QList<int> _channels;
+};
@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkDuplicateFilterTest.h"
+#include "MAVLinkDuplicateFilter.h"
+
+#include <string.h>
+
+MAVLinkDuplicateFilterTest::MAVLinkDuplicateFilterTest(void)
+{
+
+}
+
+/// Only the fields which identify a frame are set, the filter does not look at the rest
+mavlink_message_t MAVLinkDuplicateFilterTest::_message(uint8_t sysid, uint8_t seq, uint32_t msgid, uint16_t checksum)
+{
+    mavlink_message_t message;
+
+    memset(&message, 0, sizeof(message));
+    message.sysid = sysid;
+    message.compid = MAV_COMP_ID_AUTOPILOT1;
+    message.seq = seq;
+    message.msgid = msgid;
+    message.checksum = checksum;
+
+    return message;
+}
+
+void MAVLinkDuplicateFilterTest::_duplicate_test(void)
+{
+    MAVLinkDuplicateFilter  filter;
+    mavlink_message_t       message = _message(1, 10, MAVLINK_MSG_ID_ATTITUDE, 0x1234);
+    qint64                  window = filter.window();
+
+    QVERIFY(!filter.isDuplicate(1, message, 1000));
+
+    // Copies from other links within the window, measured from the first one
+    QVERIFY(filter.isDuplicate(2, message, 1000 + 20));
+    QVERIFY(filter.isDuplicate(3, message, 1000 + window));
+
+    // The same frame on its own link again is a repeat of the sender, not a copy
+    QVERIFY(!filter.isDuplicate(1, message, 1000 + window + 1));
+    QVERIFY(filter.isDuplicate(2, message, 1000 + window + 2));
+
+    // Past the window the sequence number may have come around again
+    QVERIFY(!filter.isDuplicate(2, message, 1000 + 3 * window));
+
+    filter.reset();
+    QVERIFY(!filter.isDuplicate(1, message, 1000 + 3 * window));
+}
+
+void MAVLinkDuplicateFilterTest::_distinct_test(void)
+{
+    MAVLinkDuplicateFilter filter;
+
+    QVERIFY(!filter.isDuplicate(1, _message(1, 10, MAVLINK_MSG_ID_ATTITUDE, 0x1234), 1000));
+
+    // Any difference in source, sequence, message or checksum makes it another frame
+    QVERIFY(!filter.isDuplicate(2, _message(2, 10, MAVLINK_MSG_ID_ATTITUDE, 0x1234), 1000));
+    QVERIFY(!filter.isDuplicate(2, _message(1, 11, MAVLINK_MSG_ID_ATTITUDE, 0x1234), 1000));
+    QVERIFY(!filter.isDuplicate(2, _message(1, 10, MAVLINK_MSG_ID_HEARTBEAT, 0x1234), 1000));
+    QVERIFY(!filter.isDuplicate(2, _message(1, 10, MAVLINK_MSG_ID_ATTITUDE, 0x1235), 1000));
+
+    // A full sequence of frames from a swarm is remembered, apart from the odd slot collision
+    int duplicates = 0;
+    for (int sysid=1; sysid<=8; sysid++) {
+        for (int seq=0; seq<256; seq++) {
+            filter.isDuplicate(1, _message(sysid, seq, MAVLINK_MSG_ID_ATTITUDE, seq * 31), 2000);
+        }
+    }
+    for (int sysid=1; sysid<=8; sysid++) {
+        for (int seq=0; seq<256; seq++) {
+            duplicates += filter.isDuplicate(2, _message(sysid, seq, MAVLINK_MSG_ID_ATTITUDE, seq * 31), 2010) ? 1 : 0;
+        }
+    }
+    QVERIFY(duplicates > 8 * 256 * 3 / 4);
+}
+
+void MAVLinkDuplicateFilterTest::_disabled_test(void)
+{
+    MAVLinkDuplicateFilter  filter;
+    mavlink_message_t       message = _message(1, 10, MAVLINK_MSG_ID_ATTITUDE, 0x1234);
+
+    filter.setWindow(0);
+    QVERIFY(!filter.isDuplicate(1, message, 1000));
+    QVERIFY(!filter.isDuplicate(2, message, 1000));
+}
@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "QGCMAVLink.h"
+
+/// Unit test for MAVLinkDuplicateFilter
+class MAVLinkDuplicateFilterTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkDuplicateFilterTest(void);
+
+private slots:
+    void _duplicate_test(void);
+    void _distinct_test(void);
+    void _disabled_test(void);
+
+private:
+    static mavlink_message_t _message(uint8_t sysid, uint8_t seq, uint32_t msgid, uint16_t checksum);
+};
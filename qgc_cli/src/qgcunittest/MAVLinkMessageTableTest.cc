@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkMessageTableTest.h"
+#include "MAVLinkMessageTable.h"
+#include "MAVLinkChannelPool.h"
+
+#include <QSet>
+
+static const mavlink_msg_entry_t _rgDialectEntries[] = MAVLINK_MESSAGE_CRCS;
+static const int _cDialectEntries = sizeof(_rgDialectEntries) / sizeof(_rgDialectEntries[0]);
+
+MAVLinkMessageTableTest::MAVLinkMessageTableTest(void)
+{
+
+}
+
+/// Every message of the dialect, dense or sparse, must come back with the values of the generated table
+void MAVLinkMessageTableTest::_knownIds_test(void)
+{
+    MAVLinkMessageTable* table = MAVLinkMessageTable::instance();
+
+    QCOMPARE(table->count(), _cDialectEntries);
+    QVERIFY(table->sparseCount() > 0);
+
+    for (int i=0; i<_cDialectEntries; i++) {
+        const mavlink_msg_entry_t* entry = mavlink_get_msg_entry(_rgDialectEntries[i].msgid);
+
+        QVERIFY(entry);
+        QCOMPARE(entry->msgid, _rgDialectEntries[i].msgid);
+        QCOMPARE(entry->crc_extra, _rgDialectEntries[i].crc_extra);
+        QCOMPARE(entry->msg_len, _rgDialectEntries[i].msg_len);
+        QCOMPARE(entry->flags, _rgDialectEntries[i].flags);
+        QCOMPARE(entry->target_system_ofs, _rgDialectEntries[i].target_system_ofs);
+        QCOMPARE(entry->target_component_ofs, _rgDialectEntries[i].target_component_ofs);
+    }
+}
+
+void MAVLinkMessageTableTest::_unknownIds_test(void)
+{
+    QSet<uint32_t> knownIds;
+    for (int i=0; i<_cDialectEntries; i++) {
+        knownIds.insert(_rgDialectEntries[i].msgid);
+    }
+
+    // Every gap below the largest id, the edges of the dense range and ids past the end of the table
+    uint32_t lastId = _rgDialectEntries[_cDialectEntries - 1].msgid;
+    for (uint32_t msgid=0; msgid<=lastId + 1; msgid++) {
+        if (!knownIds.contains(msgid)) {
+            QVERIFY2(!mavlink_get_msg_entry(msgid), qPrintable(QString("msgid %1").arg(msgid)));
+        }
+    }
+    QVERIFY(!mavlink_get_msg_entry(MAVLinkMessageTable::denseCount));
+    QVERIFY(!mavlink_get_msg_entry(0xFFFFFF));
+    QVERIFY(!mavlink_get_msg_entry(0xFFFFFFFF));
+}
+
+/// Messages with dense and sparse ids must make it through the parser, which checks their crc_extra
+void MAVLinkMessageTableTest::_parse_test(void)
+{
+    int channel = MAVLinkChannelPool::instance()->reserve();
+    QVERIFY(channel != 0);
+
+    mavlink_message_t rgMessages[2];
+    mavlink_msg_heartbeat_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, channel, &rgMessages[0], MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    mavlink_msg_device_op_read_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, channel, &rgMessages[1], 255, 0, 1234, 0, 0, 0, "", 0, 0);
+    QVERIFY(rgMessages[1].msgid >= MAVLinkMessageTable::denseCount);
+
+    for (int i=0; i<2; i++) {
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        int length = mavlink_msg_to_send_buffer(buffer, &rgMessages[i]);
+
+        mavlink_message_t received;
+        mavlink_status_t status;
+        int decoded = 0;
+        for (int position=0; position<length; position++) {
+            if (mavlink_parse_char(channel, buffer[position], &received, &status) == MAVLINK_FRAMING_OK) {
+                decoded++;
+            }
+        }
+
+        QCOMPARE(decoded, 1);
+        QCOMPARE(received.msgid, rgMessages[i].msgid);
+    }
+
+    MAVLinkChannelPool::instance()->release(channel);
+}
@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for MAVLinkMessageTable
+class MAVLinkMessageTableTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkMessageTableTest(void);
+
+private slots:
+    void _knownIds_test(void);
+    void _unknownIds_test(void);
+    void _parse_test(void);
+};
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkSequenceTrackerTest.h"
+#include "MAVLinkSequenceTracker.h"
+
+MAVLinkSequenceTrackerTest::MAVLinkSequenceTrackerTest(void)
+{
+
+}
+
+void MAVLinkSequenceTrackerTest::_loss_test(void)
+{
+    MAVLinkSequenceTracker tracker;
+
+    // The first frame of a source has nothing to compare to
+    QCOMPARE(tracker.update(1, 1, 1, 5), 0);
+    QCOMPARE(tracker.update(1, 1, 1, 6), 0);
+    QCOMPARE(tracker.update(1, 1, 1, 10), 3);
+
+    // A jump of more than maxGap is taken as a restart
+    QCOMPARE(tracker.update(1, 1, 1, 253), 0);
+
+    // The sequence wraps at 256, also across a gap
+    QCOMPARE(tracker.update(1, 1, 1, 254), 0);
+    QCOMPARE(tracker.update(1, 1, 1, 255), 0);
+    QCOMPARE(tracker.update(1, 1, 1, 0), 0);
+    QCOMPARE(tracker.update(1, 1, 1, 250), 0);
+    QCOMPARE(tracker.update(1, 1, 1, 3), 8);
+
+    // A frame from the past is not counted as most of the sequence lost, and the sequence goes on from it
+    QCOMPARE(tracker.update(1, 1, 1, 2), 0);
+    QCOMPARE(tracker.update(1, 1, 1, 3), 0);
+
+    QCOMPARE(tracker.count(), 1);
+}
+
+/// A vehicle heard over two links, each of which only carries some of its frames, loses nothing on the one which
+/// carries them all
+void MAVLinkSequenceTrackerTest::_perChannel_test(void)
+{
+    MAVLinkSequenceTracker  tracker;
+    int                     rgLost[3] = { 0, 0, 0 };
+
+    for (int seq=0; seq<100; seq++) {
+        rgLost[1] += tracker.update(1, 1, 1, seq);
+        if (seq % 2 == 0) {
+            rgLost[2] += tracker.update(2, 1, 1, seq);
+        }
+
+        // Another component of the same vehicle on the first link
+        rgLost[0] += tracker.update(1, 1, 2, 200 + seq);
+    }
+
+    QCOMPARE(rgLost[0], 0);
+    QCOMPARE(rgLost[1], 0);
+    QCOMPARE(rgLost[2], 49);
+    QCOMPARE(tracker.count(), 3);
+}
+
+void MAVLinkSequenceTrackerTest::_grow_test(void)
+{
+    MAVLinkSequenceTracker tracker;
+
+    // Far more sources than the initial capacity, spread over channels, systems and components
+    for (int i=0; i<1000; i++) {
+        QCOMPARE(tracker.update(i % 4, (i / 4) % 256, i / 1024 + 1, i % 256), 0);
+    }
+    QCOMPARE(tracker.count(), 1000);
+
+    for (int i=0; i<1000; i++) {
+        QCOMPARE(tracker.update(i % 4, (i / 4) % 256, i / 1024 + 1, (i + 1) % 256), 0);
+    }
+
+    // A reset channel starts over, the others keep their sequence
+    tracker.resetChannel(2);
+    QCOMPARE(tracker.count(), 750);
+
+    for (int i=0; i<1000; i++) {
+        int lost = tracker.update(i % 4, (i / 4) % 256, i / 1024 + 1, (i + 3) % 256);
+        QCOMPARE(lost, i % 4 == 2 ? 0 : 1);
+    }
+    QCOMPARE(tracker.count(), 1000);
+}
@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for MAVLinkSequenceTracker
+class MAVLinkSequenceTrackerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkSequenceTrackerTest(void);
+
+private slots:
+    void _loss_test(void);
+    void _perChannel_test(void);
+    void _grow_test(void);
+};
@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkSigningTest.h"
+#include "MAVLinkSigning.h"
+#include "MAVLinkChannelPool.h"
+
+#include <QVector>
+
+MAVLinkSigningTest::MAVLinkSigningTest(void)
+{
+
+}
+
+void MAVLinkSigningTest::cleanup(void)
+{
+    MAVLinkSHA256::setHardwareEnabled(true);
+    memset(MAVLinkSigning::streams(), 0, sizeof(mavlink_signing_streams_t));
+    UnitTest::cleanup();
+}
+
+/// Published test vectors, with the portable code and with the SHA extensions where the CPU has them
+void MAVLinkSigningTest::_sha256_test(void)
+{
+    struct {
+        QByteArray  message;
+        QByteArray  digest;
+    } rgVectors[] = {
+        { QByteArray(""),       QByteArray::fromHex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855") },
+        { QByteArray("abc"),    QByteArray::fromHex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") },
+        { QByteArray("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+                                QByteArray::fromHex("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1") },
+        { QByteArray(1000, 'a'), QByteArray::fromHex("41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3") },
+    };
+
+    for (int hardware=0; hardware<2; hardware++) {
+        if (hardware && !MAVLinkSHA256::hardwareAvailable()) {
+            break;
+        }
+        MAVLinkSHA256::setHardwareEnabled(hardware);
+        QCOMPARE(MAVLinkSHA256::hardwareEnabled(), (bool)hardware);
+
+        for (size_t i=0; i<sizeof(rgVectors)/sizeof(rgVectors[0]); i++) {
+            uint8_t digest[32];
+            MAVLinkSHA256::hash(rgVectors[i].message.constData(), rgVectors[i].message.size(), digest);
+            QCOMPARE(QByteArray((const char*)digest, 32), rgVectors[i].digest);
+        }
+    }
+
+    QCOMPARE(MAVLinkSigning::keyFromPassphrase("abc"), rgVectors[1].digest);
+}
+
+QByteArray MAVLinkSigningTest::_signedFrame(mavlink_signing_t* signing, uint16_t paramIndex)
+{
+    int channel = MAVLinkChannelPool::instance()->reserve();
+    mavlink_status_t* status = mavlink_get_channel_status(channel);
+
+    mavlink_set_proto_version(channel, 2);
+    status->signing = signing;
+
+    mavlink_message_t message;
+    mavlink_msg_param_value_pack_chan(1, MAV_COMP_ID_AUTOPILOT1, channel, &message, "SIGN_TEST_PARAM", 1.5f, MAV_PARAM_TYPE_REAL32, 100, paramIndex);
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    int length = mavlink_msg_to_send_buffer(buffer, &message);
+
+    status->signing = NULL;
+    MAVLinkChannelPool::instance()->release(channel);
+
+    return QByteArray((const char*)buffer, length);
+}
+
+/// @return Number of messages the parser accepted, the last one in message
+int MAVLinkSigningTest::_parse(mavlink_signing_t* signing, const QByteArray& bytes, mavlink_message_t* message)
+{
+    int channel = MAVLinkChannelPool::instance()->reserve();
+    mavlink_status_t* status = mavlink_get_channel_status(channel);
+
+    status->signing = signing;
+    status->signing_streams = MAVLinkSigning::streams();
+
+    int decoded = 0;
+    mavlink_status_t messageStatus;
+    for (int i=0; i<bytes.size(); i++) {
+        if (mavlink_parse_char(channel, (uint8_t)bytes[i], message, &messageStatus) == MAVLINK_FRAMING_OK) {
+            decoded++;
+        }
+    }
+
+    status->signing = NULL;
+    status->signing_streams = NULL;
+    MAVLinkChannelPool::instance()->release(channel);
+
+    return decoded;
+}
+
+void MAVLinkSigningTest::_signedRoundTrip_test(void)
+{
+    QByteArray          key = MAVLinkSigning::keyFromPassphrase("round trip");
+    mavlink_signing_t   sendSigning;
+    mavlink_signing_t   receiveSigning;
+
+    MAVLinkSigning::initSigning(&sendSigning, key, 3);
+    MAVLinkSigning::initSigning(&receiveSigning, key, 0);
+
+    QByteArray bytes = _signedFrame(&sendSigning, 42);
+    QCOMPARE(bytes.size(), MAVLINK_NUM_NON_PAYLOAD_BYTES + MAVLINK_MSG_ID_PARAM_VALUE_LEN + MAVLINK_SIGNATURE_BLOCK_LEN);
+
+    mavlink_message_t message;
+    QCOMPARE(_parse(&receiveSigning, bytes, &message), 1);
+    QVERIFY(message.incompat_flags & MAVLINK_IFLAG_SIGNED);
+    QCOMPARE(message.signature[0], (uint8_t)3);
+    QCOMPARE(mavlink_msg_param_value_get_param_index(&message), (uint16_t)42);
+}
+
+void MAVLinkSigningTest::_wrongKey_test(void)
+{
+    mavlink_signing_t sendSigning;
+    mavlink_signing_t receiveSigning;
+
+    MAVLinkSigning::initSigning(&sendSigning, MAVLinkSigning::keyFromPassphrase("right"), 0);
+    MAVLinkSigning::initSigning(&receiveSigning, MAVLinkSigning::keyFromPassphrase("wrong"), 0);
+
+    mavlink_message_t message;
+    QCOMPARE(_parse(&receiveSigning, _signedFrame(&sendSigning, 1), &message), 0);
+
+    // Unsigned messages are refused as well, other than the radio status
+    mavlink_signing_t unsignedSigning;
+    memset(&unsignedSigning, 0, sizeof(unsignedSigning));
+    QCOMPARE(_parse(&receiveSigning, _signedFrame(&unsignedSigning, 1), &message), 0);
+}
+
+/// A frame seen once, on any link, is refused when it comes again
+void MAVLinkSigningTest::_replay_test(void)
+{
+    QByteArray          key = MAVLinkSigning::keyFromPassphrase("replay");
+    mavlink_signing_t   sendSigning;
+    mavlink_signing_t   receiveSigning;
+
+    MAVLinkSigning::initSigning(&sendSigning, key, 0);
+    MAVLinkSigning::initSigning(&receiveSigning, key, 0);
+
+    QByteArray first = _signedFrame(&sendSigning, 1);
+    QByteArray second = _signedFrame(&sendSigning, 2);
+
+    mavlink_message_t message;
+    QCOMPARE(_parse(&receiveSigning, first, &message), 1);
+    QCOMPARE(_parse(&receiveSigning, first, &message), 0);
+    QCOMPARE(_parse(&receiveSigning, second, &message), 1);
+    QCOMPARE(_parse(&receiveSigning, first, &message), 0);
+}
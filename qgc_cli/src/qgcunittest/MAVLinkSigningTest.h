@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "QGCMAVLink.h"
+
+/// Unit test for MAVLinkSHA256 and MAVLinkSigning
+class MAVLinkSigningTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkSigningTest(void);
+
+private slots:
+    void cleanup(void);
+
+    void _sha256_test(void);
+    void _signedRoundTrip_test(void);
+    void _wrongKey_test(void);
+    void _replay_test(void);
+
+private:
+    QByteArray _signedFrame(mavlink_signing_t* signing, uint16_t paramIndex);
+    int _parse(mavlink_signing_t* signing, const QByteArray& bytes, mavlink_message_t* message);
+};
@@ -0,0 +1,260 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCClockTest.h"
+#include "QGCClock.h"
+
+#include <QDateTime>
+#include <QSemaphore>
+#include <QThread>
+
+static const qint64 _startMsecs = 1000000;
+
+/// Runs advanceTo on a thread of its own
+class ClockAdvancer : public QThread
+{
+public:
+    ClockAdvancer(QGCClock* clock, qint64 msecs)
+        : _clock(clock)
+        , _msecs(msecs)
+    {
+    }
+
+protected:
+    void run(void) final
+    {
+        _clock->advanceTo(_msecs);
+    }
+
+private:
+    QGCClock*   _clock;
+    qint64      _msecs;
+};
+
+QGCClockTest::QGCClockTest(void)
+{
+
+}
+
+void QGCClockTest::_wallClock_test(void)
+{
+    QGCClock clock;
+
+    QCOMPARE(clock.lockstep(), false);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QVERIFY(qAbs(clock.currentMSecsSinceEpoch() - now) < 1000);
+
+    // advanceTo does nothing on the wall clock
+    clock.advanceTo(now + 100000);
+    QVERIFY(clock.currentMSecsSinceEpoch() < now + 100000);
+
+    QGCTimer timer(NULL, &clock);
+    QSignalSpy spy(&timer, &QGCTimer::timeout);
+    timer.setSingleShot(true);
+    timer.start(10);
+    QCOMPARE(timer.isActive(), true);
+    QVERIFY(spy.wait(1000));
+    QCOMPARE(timer.isActive(), false);
+}
+
+void QGCClockTest::_lockstepOrder_test(void)
+{
+    QGCClock clock;
+    clock.setLockstep(_startMsecs);
+    QCOMPARE(clock.currentMSecsSinceEpoch(), _startMsecs);
+    QCOMPARE(clock.elapsed(), (qint64)0);
+
+    QList<int>      fired;
+    QList<qint64>   firedAt;
+    QGCTimer        timer1(NULL, &clock);
+    QGCTimer        timer2(NULL, &clock);
+    QGCTimer        timer3(NULL, &clock);
+    QGCTimer*       rgTimers[] = { &timer1, &timer2, &timer3 };
+    for (int i=0; i<3; i++) {
+        rgTimers[i]->setSingleShot(true);
+        connect(rgTimers[i], &QGCTimer::timeout, [&fired, &firedAt, &clock, i]() {
+            fired.append(i);
+            firedAt.append(clock.currentMSecsSinceEpoch());
+        });
+    }
+
+    // Deadline order, then scheduling order for equal deadlines
+    timer1.start(30);
+    timer2.start(10);
+    timer3.start(30);
+    QCOMPARE(timer1.isActive(), true);
+
+    clock.advanceTo(_startMsecs + 20);
+    QCOMPARE(fired, QList<int>() << 1);
+    QCOMPARE(firedAt, QList<qint64>() << _startMsecs + 10);
+    QCOMPARE(clock.currentMSecsSinceEpoch(), _startMsecs + 20);
+    QCOMPARE(timer2.isActive(), false);
+
+    clock.advanceTo(_startMsecs + 100);
+    QCOMPARE(fired, QList<int>() << 1 << 0 << 2);
+    QCOMPARE(firedAt[1], _startMsecs + 30);
+    QCOMPARE(firedAt[2], _startMsecs + 30);
+    QCOMPARE(clock.elapsed(), (qint64)100);
+
+    // Time never goes back
+    clock.advanceTo(_startMsecs + 50);
+    QCOMPARE(clock.currentMSecsSinceEpoch(), _startMsecs + 100);
+}
+
+void QGCClockTest::_lockstepPeriodic_test(void)
+{
+    QGCClock clock;
+    clock.setLockstep(_startMsecs);
+
+    QList<qint64>   firedAt;
+    QGCTimer        timer(NULL, &clock);
+    connect(&timer, &QGCTimer::timeout, [&firedAt, &clock]() {
+        firedAt.append(clock.currentMSecsSinceEpoch());
+    });
+
+    // Periods are based on the deadlines, however far a single advance goes
+    timer.start(10);
+    clock.advanceTo(_startMsecs + 35);
+    QCOMPARE(firedAt, QList<qint64>() << _startMsecs + 10 << _startMsecs + 20 << _startMsecs + 30);
+    QCOMPARE(timer.isActive(), true);
+
+    // A handler may stop its own timer
+    connect(&timer, &QGCTimer::timeout, &timer, &QGCTimer::stop);
+    clock.advanceTo(_startMsecs + 100);
+    QCOMPARE(firedAt.count(), 4);
+    QCOMPARE(timer.isActive(), false);
+}
+
+void QGCClockTest::_lockstepStop_test(void)
+{
+    QGCClock clock;
+    clock.setLockstep(_startMsecs);
+
+    int         fireCount = 0;
+    QGCTimer*   timer = new QGCTimer(NULL, &clock);
+    connect(timer, &QGCTimer::timeout, [&fireCount]() { fireCount++; });
+
+    timer->start(10);
+    timer->stop();
+    QCOMPARE(timer->isActive(), false);
+    clock.advanceTo(_startMsecs + 20);
+    QCOMPARE(fireCount, 0);
+
+    // Restarting reschedules from the current time
+    timer->start(10);
+    timer->start(10);
+    clock.advanceTo(_startMsecs + 25);
+    QCOMPARE(fireCount, 0);
+    clock.advanceTo(_startMsecs + 30);
+    QCOMPARE(fireCount, 1);
+
+    // A destroyed timer leaves the clock
+    delete timer;
+    clock.advanceTo(_startMsecs + 100);
+    QCOMPARE(fireCount, 1);
+
+    // Single shot timers run on the process wide clock, which is the wall clock here
+    bool singleShotFired = false;
+    QGCTimer::singleShot(10, this, [&singleShotFired]() { singleShotFired = true; });
+    QTRY_VERIFY_WITH_TIMEOUT(singleShotFired, 1000);
+}
+
+void QGCClockTest::_lockstepOtherThread_test(void)
+{
+    QGCClock clock;
+    clock.setLockstep(_startMsecs);
+
+    QThread thread;
+    thread.start();
+
+    QGCTimer*   timer = new QGCTimer(NULL, &clock);
+    QThread*    firedOn = NULL;
+    timer->setSingleShot(true);
+    timer->moveToThread(&thread);
+    connect(timer, &QGCTimer::timeout, timer, [&firedOn]() {
+        // advanceTo has to wait for a slow handler
+        QThread::msleep(50);
+        firedOn = QThread::currentThread();
+    }, Qt::DirectConnection);
+
+    timer->start(10);
+    clock.advanceTo(_startMsecs + 20);
+    QCOMPARE(firedOn, &thread);
+    QCOMPARE(timer->isActive(), false);
+
+    thread.quit();
+    QVERIFY(thread.wait(5000));
+    delete timer;
+}
+
+void QGCClockTest::_lockstepDestroyedWhilePending_test(void)
+{
+    QGCClock clock;
+    clock.setLockstep(_startMsecs);
+
+    QThread thread;
+    thread.start();
+
+    bool        fired = false;
+    QGCTimer*   timer = new QGCTimer(NULL, &clock);
+    timer->setSingleShot(true);
+    timer->moveToThread(&thread);
+    connect(timer, &QGCTimer::timeout, timer, [&fired]() { fired = true; }, Qt::DirectConnection);
+    timer->start(10);
+
+    // Keep the timer's thread busy so the fire posted by advanceTo waits behind a handler which destroys the timer
+    QObject     context;
+    QSemaphore  entered;
+    QSemaphore  go;
+    context.moveToThread(&thread);
+    QTimer::singleShot(0, &context, [&entered, &go, timer]() {
+        entered.release();
+        go.acquire();
+        delete timer;
+    });
+    entered.acquire();
+
+    ClockAdvancer advancer(&clock, _startMsecs + 20);
+    advancer.start();
+    QVERIFY(!advancer.wait(100));
+
+    // The discarded fire must not keep advanceTo waiting
+    go.release();
+    QVERIFY(advancer.wait(5000));
+    QCOMPARE(fired, false);
+    QCOMPARE(clock.currentMSecsSinceEpoch(), _startMsecs + 20);
+
+    thread.quit();
+    QVERIFY(thread.wait(5000));
+}
+
+void QGCClockTest::_lockstepFinishedThread_test(void)
+{
+    QGCClock clock;
+    clock.setLockstep(_startMsecs);
+
+    QThread thread;
+    thread.start();
+
+    bool        fired = false;
+    QGCTimer*   timer = new QGCTimer(NULL, &clock);
+    timer->moveToThread(&thread);
+    connect(timer, &QGCTimer::timeout, timer, [&fired]() { fired = true; }, Qt::DirectConnection);
+    timer->start(10);
+
+    thread.quit();
+    QVERIFY(thread.wait(5000));
+
+    // Nothing is left to run the timer, advanceTo drops it instead of waiting forever
+    clock.advanceTo(_startMsecs + 100);
+    QCOMPARE(fired, false);
+    QCOMPARE(timer->isActive(), false);
+
+    delete timer;
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for QGCClock and QGCTimer. Lockstep runs on clocks of the test's own, the process wide clock stays on the
+/// wall clock.
+class QGCClockTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCClockTest(void);
+
+private slots:
+    void _wallClock_test(void);
+    void _lockstepOrder_test(void);
+    void _lockstepPeriodic_test(void);
+    void _lockstepStop_test(void);
+    void _lockstepOtherThread_test(void);
+    void _lockstepDestroyedWhilePending_test(void);
+    void _lockstepFinishedThread_test(void);
+};
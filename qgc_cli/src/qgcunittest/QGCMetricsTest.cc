@@ -0,0 +1,166 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCMetricsTest.h"
+#include "QGCMetrics.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+QGCMetricsTest::QGCMetricsTest(void)
+{
+
+}
+
+void QGCMetricsTest::_bucketLayout_test(void)
+{
+    // Small values have buckets of their own
+    for (qint64 value=0; value<32; value++) {
+        QCOMPARE(QGCMetricHistogram::bucketLowerBound(value), value);
+    }
+
+    QCOMPARE(QGCMetricHistogram::bucketLowerBound(33), (qint64)32);
+    QCOMPARE(QGCMetricHistogram::bucketLowerBound(101), (qint64)100);
+    QCOMPARE(QGCMetricHistogram::bucketLowerBound(1000), (qint64)992);
+
+    // Everywhere else a bucket is narrower than 1/16 of its values
+    for (qint64 value=32; value<(1LL << 36); value = value * 3 / 2 + 7) {
+        qint64 lower = QGCMetricHistogram::bucketLowerBound(value);
+        QVERIFY(lower <= value);
+        QVERIFY((value - lower) * 16 < value);
+    }
+}
+
+void QGCMetricsTest::_percentile_test(void)
+{
+    QGCMetricHistogram* histogram = QGCMetrics::instance()->histogram("qgcmetricstest_percentile_us", "Test");
+
+    QGCMetricHistogram::Summary summary = histogram->summary();
+    QCOMPARE(summary.count, (quint64)0);
+    QCOMPARE(summary.p50, (qint64)0);
+
+    for (int i=1; i<=100; i++) {
+        histogram->record(i);
+    }
+
+    // Percentiles are the top of their bucket: 50 is in [50,51], 90 in [88,91], 99 in [96,99]
+    summary = histogram->summary();
+    QCOMPARE(summary.count, (quint64)100);
+    QCOMPARE(summary.sum, (qint64)5050);
+    QCOMPARE(summary.max, (qint64)100);
+    QCOMPARE(summary.p50, (qint64)51);
+    QCOMPARE(summary.p90, (qint64)91);
+    QCOMPARE(summary.p99, (qint64)99);
+
+    QGCMetrics::instance()->release(histogram);
+
+    // Values past the last bucket are reported as the maximum
+    histogram = QGCMetrics::instance()->histogram("qgcmetricstest_percentile_us", "Test");
+    histogram->record(1000000000000LL);
+    summary = histogram->summary();
+    QCOMPARE(summary.count, (quint64)1);
+    QCOMPARE(summary.p99, (qint64)1000000000000LL);
+    QGCMetrics::instance()->release(histogram);
+}
+
+void QGCMetricsTest::_registry_test(void)
+{
+    QGCMetrics*     metrics = QGCMetrics::instance();
+    int             baseCount = metrics->count();
+    QGCMetricLabels labelsA = { { "link", "a" } };
+    QGCMetricLabels labelsB = { { "link", "b" } };
+
+    QGCMetricCounter* counterA1 = metrics->counter("qgcmetricstest_registry_total", "Test", labelsA);
+    QGCMetricCounter* counterA2 = metrics->counter("qgcmetricstest_registry_total", "Test", labelsA);
+    QGCMetricCounter* counterB = metrics->counter("qgcmetricstest_registry_total", "Test", labelsB);
+
+    // Same name and labels share the metric
+    QVERIFY(counterA1);
+    QCOMPARE(counterA1, counterA2);
+    QVERIFY(counterA1 != counterB);
+    QCOMPARE(metrics->count(), baseCount + 2);
+
+    // A name can only have one type
+    QVERIFY(!metrics->gauge("qgcmetricstest_registry_total", "Test", labelsA));
+
+    counterA1->add(2);
+    counterA2->add();
+    QCOMPARE(counterA1->value(), (quint64)3);
+    QCOMPARE(counterB->value(), (quint64)0);
+
+    // The metric stays until its last user released it
+    metrics->release(counterA1);
+    QCOMPARE(metrics->count(), baseCount + 2);
+    metrics->release(counterA2);
+    QCOMPARE(metrics->count(), baseCount + 1);
+    metrics->release(counterB);
+    QCOMPARE(metrics->count(), baseCount);
+
+    // A new metric of a released name starts over
+    counterA1 = metrics->counter("qgcmetricstest_registry_total", "Test", labelsA);
+    QCOMPARE(counterA1->value(), (quint64)0);
+    metrics->release(counterA1);
+}
+
+void QGCMetricsTest::_export_test(void)
+{
+    QGCMetrics*         metrics = QGCMetrics::instance();
+    QGCMetricLabels     labels = { { "link", "a\"b" } };
+    QGCMetricCounter*   counter = metrics->counter("qgcmetricstest_frames_total", "Frames", labels);
+    QGCMetricGauge*     gauge = metrics->gauge("qgcmetricstest_level", "Level");
+    QGCMetricHistogram* histogram = metrics->histogram("qgcmetricstest_latency_us", "Latency");
+
+    counter->add(3);
+    gauge->set(1.5);
+    histogram->record(10);
+    histogram->record(20);
+
+    QByteArray prometheus = metrics->prometheusText();
+    QVERIFY(prometheus.contains("# HELP qgcmetricstest_frames_total Frames\n# TYPE qgcmetricstest_frames_total counter\n"));
+    QVERIFY(prometheus.contains("\nqgcmetricstest_frames_total{link=\"a\\\"b\"} 3\n"));
+    QVERIFY(prometheus.contains("\nqgcmetricstest_level 1.5\n"));
+    QVERIFY(prometheus.contains("# TYPE qgcmetricstest_latency_us summary\n"));
+    QVERIFY(prometheus.contains("\nqgcmetricstest_latency_us{quantile=\"0.5\"} 10\n"));
+    QVERIFY(prometheus.contains("\nqgcmetricstest_latency_us{quantile=\"0.99\"} 20\n"));
+    QVERIFY(prometheus.contains("\nqgcmetricstest_latency_us_sum 30\n"));
+    QVERIFY(prometheus.contains("\nqgcmetricstest_latency_us_count 2\n"));
+
+    QByteArray csv = metrics->csvLines(1000);
+    QVERIFY(csv.contains("1000,qgcmetricstest_frames_total,\"link=a\"\"b\",3,,,,,,\n"));
+    QVERIFY(csv.contains("1000,qgcmetricstest_latency_us,,,2,30,20,10,20,20\n"));
+
+    QByteArray json = metrics->jsonLine(1000);
+    QVERIFY(json.endsWith('\n'));
+    QCOMPARE(json.count('\n'), 1);
+
+    QJsonObject root = QJsonDocument::fromJson(json).object();
+    QCOMPARE(root["time"].toDouble(), 1000.0);
+
+    bool foundCounter = false;
+    bool foundHistogram = false;
+    foreach (const QJsonValue& value, root["metrics"].toArray()) {
+        QJsonObject metricObject = value.toObject();
+        if (metricObject["name"].toString() == "qgcmetricstest_frames_total") {
+            QCOMPARE(metricObject["labels"].toObject()["link"].toString(), QString("a\"b"));
+            QCOMPARE(metricObject["value"].toDouble(), 3.0);
+            foundCounter = true;
+        } else if (metricObject["name"].toString() == "qgcmetricstest_latency_us") {
+            QCOMPARE(metricObject["count"].toDouble(), 2.0);
+            QCOMPARE(metricObject["p90"].toDouble(), 20.0);
+            foundHistogram = true;
+        }
+    }
+    QVERIFY(foundCounter);
+    QVERIFY(foundHistogram);
+
+    metrics->release(counter);
+    metrics->release(gauge);
+    metrics->release(histogram);
+}
@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ *   (c) 2009-2016 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Unit test for QGCMetrics
+class QGCMetricsTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCMetricsTest(void);
+
+private slots:
+    void _bucketLayout_test(void);
+    void _percentile_test(void);
+    void _registry_test(void);
+    void _export_test(void);
+};
@@ -17,10 +17,19 @@
 #include "FlightGearTest.h"
 #include "GeoTest.h"
 #include "LinkManagerTest.h"
+#include "LinkHealthTest.h"
+#include "LinkStatisticsTest.h"
+#include "MAVLinkChannelPoolTest.h"
+#include "MAVLinkCRCTest.h"
+#include "MAVLinkSigningTest.h"
+#include "MAVLinkMessageTableTest.h"
+#include "MAVLinkSequenceTrackerTest.h"
+#include "MAVLinkDuplicateFilterTest.h"
 #include "MessageBoxTest.h"
 #include "MissionItemTest.h"
 #include "SimpleMissionItemTest.h"
 #include "SurveyMissionItemTest.h"
+#include "CoveragePartitionerTest.h"
 #include "MissionControllerTest.h"
 #include "MissionManagerTest.h"
 #include "RadioConfigTest.h"
@@ -32,12 +41,19 @@
 #include "MissionCommandTreeTest.h"
 #include "LogDownloadTest.h"
 #include "SendMavCommandTest.h"
+#include "StreamRateManagerTest.h"
+#include "TelemetryChannelRegistryTest.h"
+#include "VehicleTelemetryStoreTest.h"
+#include "VehicleStateSnapshotTest.h"
+#include "SettingsStoreTest.h"
 #include "VisualMissionItemTest.h"
 #include "CameraSectionTest.h"
 #include "SpeedSectionTest.h"
 #include "PlanMasterControllerTest.h"
 #include "MissionSettingsTest.h"
 #include "QGCMapPolygonTest.h"
+#include "QGCMetricsTest.h"
+#include "QGCClockTest.h"
 #include "QGCAudioWorkerTest.h"
 
 UT_REGISTER_TEST(FactSystemTestGeneric)
@@ -46,6 +62,14 @@ UT_REGISTER_TEST(FileDialogTest)
 UT_REGISTER_TEST(FlightGearUnitTest)
 UT_REGISTER_TEST(GeoTest)
 UT_REGISTER_TEST(LinkManagerTest)
+UT_REGISTER_TEST(LinkHealthTest)
+UT_REGISTER_TEST(LinkStatisticsTest)
+UT_REGISTER_TEST(MAVLinkChannelPoolTest)
+UT_REGISTER_TEST(MAVLinkCRCTest)
+UT_REGISTER_TEST(MAVLinkSigningTest)
+UT_REGISTER_TEST(MAVLinkMessageTableTest)
+UT_REGISTER_TEST(MAVLinkSequenceTrackerTest)
+UT_REGISTER_TEST(MAVLinkDuplicateFilterTest)
 UT_REGISTER_TEST(MessageBoxTest)
 UT_REGISTER_TEST(MissionItemTest)
 UT_REGISTER_TEST(SimpleMissionItemTest)
@@ -57,12 +81,20 @@ UT_REGISTER_TEST(ParameterManagerTest)
 UT_REGISTER_TEST(MissionCommandTreeTest)
 UT_REGISTER_TEST(LogDownloadTest)
 UT_REGISTER_TEST(SendMavCommandTest)
+UT_REGISTER_TEST(StreamRateManagerTest)
+UT_REGISTER_TEST(TelemetryChannelRegistryTest)
+UT_REGISTER_TEST(VehicleTelemetryStoreTest)
+UT_REGISTER_TEST(VehicleStateSnapshotTest)
+UT_REGISTER_TEST(SettingsStoreTest)
 UT_REGISTER_TEST(SurveyMissionItemTest)
+UT_REGISTER_TEST(CoveragePartitionerTest)
 UT_REGISTER_TEST(CameraSectionTest)
 UT_REGISTER_TEST(SpeedSectionTest)
 UT_REGISTER_TEST(PlanMasterControllerTest)
 UT_REGISTER_TEST(MissionSettingsTest)
 UT_REGISTER_TEST(QGCMapPolygonTest)
+UT_REGISTER_TEST(QGCMetricsTest)
+UT_REGISTER_TEST(QGCClockTest)
 UT_REGISTER_TEST(QGCAudioWorkerTest)
 
 // List of unit test which are currently disabled.
@@ -13,9 +13,9 @@
 
 #include <QList>
 #include <QTimer>
-#include <QSettings>
 #include <iostream>
 #include <QDebug>
+#include <QMetaMethod>
 
 #include <cmath>
 #include <qmath.h>
@@ -238,11 +238,20 @@ void UAS::receiveMessage(mavlink_message_t message)
 
             // Send the base_mode and system_status values to the plotter. This uses the ground time
             // so the Ground Time checkbox must be ticked for these values to display
-            quint64 time = getUnixTime();
-            QString name = QString("M%1:HEARTBEAT.%2").arg(message.sysid);
-            emit valueChanged(uasId, name.arg("base_mode"), "bits", state.base_mode, time);
-            emit valueChanged(uasId, name.arg("custom_mode"), "bits", state.custom_mode, time);
-            emit valueChanged(uasId, name.arg("system_status"), "-", state.system_status, time);
+            if (_telemetryWanted()) {
+                static const int rgChannels[] = {
+                    TelemetryChannelRegistry::instance()->registerChannel("HEARTBEAT", "base_mode", "bits"),
+                    TelemetryChannelRegistry::instance()->registerChannel("HEARTBEAT", "custom_mode", "bits"),
+                    TelemetryChannelRegistry::instance()->registerChannel("HEARTBEAT", "system_status", "-"),
+                };
+                quint64 time = getUnixTime();
+                const TelemetrySample rgSamples[] = {
+                    { uasId, rgChannels[0], (double)state.base_mode, time },
+                    { uasId, rgChannels[1], (double)state.custom_mode, time },
+                    { uasId, rgChannels[2], (double)state.system_status, time },
+                };
+                _publishTelemetry(rgSamples, sizeof(rgSamples) / sizeof(rgSamples[0]));
+            }
 
             // We got the mode
             receivedMode = true;
@@ -260,19 +269,34 @@ void UAS::receiveMessage(mavlink_message_t message)
             mavlink_msg_sys_status_decode(&message, &state);
 
             // Prepare for sending data to the realtime plotter, which is every field excluding onboard_control_sensors_present.
-            quint64 time = getUnixTime();
-            QString name = QString("M%1:SYS_STATUS.%2").arg(message.sysid);
-            emit valueChanged(uasId, name.arg("sensors_enabled"), "bits", state.onboard_control_sensors_enabled, time);
-            emit valueChanged(uasId, name.arg("sensors_health"), "bits", state.onboard_control_sensors_health, time);
-            emit valueChanged(uasId, name.arg("errors_comm"), "-", state.errors_comm, time);
-            emit valueChanged(uasId, name.arg("errors_count1"), "-", state.errors_count1, time);
-            emit valueChanged(uasId, name.arg("errors_count2"), "-", state.errors_count2, time);
-            emit valueChanged(uasId, name.arg("errors_count3"), "-", state.errors_count3, time);
-            emit valueChanged(uasId, name.arg("errors_count4"), "-", state.errors_count4, time);
-
-            // Process CPU load.
-            emit valueChanged(uasId, name.arg("load"), "%", state.load/10.0f, time);
-            emit valueChanged(uasId, name.arg("drop_rate_comm"), "%", state.drop_rate_comm/100.0f, time);
+            if (_telemetryWanted()) {
+                TelemetryChannelRegistry* registry = TelemetryChannelRegistry::instance();
+                static const int rgChannels[] = {
+                    registry->registerChannel("SYS_STATUS", "sensors_enabled", "bits"),
+                    registry->registerChannel("SYS_STATUS", "sensors_health", "bits"),
+                    registry->registerChannel("SYS_STATUS", "errors_comm", "-"),
+                    registry->registerChannel("SYS_STATUS", "errors_count1", "-"),
+                    registry->registerChannel("SYS_STATUS", "errors_count2", "-"),
+                    registry->registerChannel("SYS_STATUS", "errors_count3", "-"),
+                    registry->registerChannel("SYS_STATUS", "errors_count4", "-"),
+                    registry->registerChannel("SYS_STATUS", "load", "%"),
+                    registry->registerChannel("SYS_STATUS", "drop_rate_comm", "%"),
+                };
+                quint64 time = getUnixTime();
+                const TelemetrySample rgSamples[] = {
+                    { uasId, rgChannels[0], (double)state.onboard_control_sensors_enabled, time },
+                    { uasId, rgChannels[1], (double)state.onboard_control_sensors_health, time },
+                    { uasId, rgChannels[2], (double)state.errors_comm, time },
+                    { uasId, rgChannels[3], (double)state.errors_count1, time },
+                    { uasId, rgChannels[4], (double)state.errors_count2, time },
+                    { uasId, rgChannels[5], (double)state.errors_count3, time },
+                    { uasId, rgChannels[6], (double)state.errors_count4, time },
+                    // Process CPU load.
+                    { uasId, rgChannels[7], state.load / 10.0, time },
+                    { uasId, rgChannels[8], state.drop_rate_comm / 100.0, time },
+                };
+                _publishTelemetry(rgSamples, sizeof(rgSamples) / sizeof(rgSamples[0]));
+            }
         }
             break;
         case MAVLINK_MSG_ID_ATTITUDE:
@@ -401,6 +425,9 @@ void UAS::receiveMessage(mavlink_message_t message)
             break;
         case MAVLINK_MSG_ID_ATTITUDE_TARGET:
         {
+            if (!_telemetryWanted()) {
+                break;
+            }
             mavlink_attitude_target_t out;
             mavlink_msg_attitude_target_decode(&message, &out);
             float roll, pitch, yaw;
@@ -408,9 +435,17 @@ void UAS::receiveMessage(mavlink_message_t message)
             quint64 time = getUnixTimeFromMs(out.time_boot_ms);
 
             // For plotting emit roll sp, pitch sp and yaw sp values
-            emit valueChanged(uasId, "roll sp", "rad", roll, time);
-            emit valueChanged(uasId, "pitch sp", "rad", pitch, time);
-            emit valueChanged(uasId, "yaw sp", "rad", yaw, time);
+            static const int rgChannels[] = {
+                TelemetryChannelRegistry::instance()->registerChannel(QString(), "roll sp", "rad"),
+                TelemetryChannelRegistry::instance()->registerChannel(QString(), "pitch sp", "rad"),
+                TelemetryChannelRegistry::instance()->registerChannel(QString(), "yaw sp", "rad"),
+            };
+            const TelemetrySample rgSamples[] = {
+                { uasId, rgChannels[0], roll, time },
+                { uasId, rgChannels[1], pitch, time },
+                { uasId, rgChannels[2], yaw, time },
+            };
+            _publishTelemetry(rgSamples, sizeof(rgSamples) / sizeof(rgSamples[0]));
         }
             break;
 
@@ -1743,6 +1778,42 @@ void UAS::_say(const QString& text, int severity)
 //    qgcApp()->toolbox()->audioOutput()->say(text);
 }
 
+/// @return true: Someone is listening to telemetry samples, either through the channel registry or the legacy valueChanged signal
+bool UAS::_telemetryWanted(void)
+{
+    static const QMetaMethod valueChangedSignal = QMetaMethod::fromSignal(&UASInterface::valueChanged);
+    return TelemetryChannelRegistry::instance()->hasSubscribers() || isSignalConnected(valueChangedSignal);
+}
+
+void UAS::_publishTelemetry(const TelemetrySample* samples, int count)
+{
+    TelemetryChannelRegistry* registry = TelemetryChannelRegistry::instance();
+
+    registry->publish(samples, count);
+
+    static const QMetaMethod valueChangedSignal = QMetaMethod::fromSignal(&UASInterface::valueChanged);
+    if (isSignalConnected(valueChangedSignal)) {
+        // Legacy listeners want string names, channels from a message are prefixed with the system id. The names are
+        // built once per channel so the registry is not locked for every sample.
+        for (int i=0; i<count; i++) {
+            const TelemetrySample& sample = samples[i];
+            if (sample.channel >= _legacyTelemetryNames.count()) {
+                _legacyTelemetryNames.resize(sample.channel + 1);
+                _legacyTelemetryUnits.resize(sample.channel + 1);
+            }
+            if (_legacyTelemetryNames[sample.channel].isEmpty()) {
+                QString name = registry->name(sample.channel);
+                if (!registry->message(sample.channel).isEmpty()) {
+                    name = QStringLiteral("M%1:%2").arg(uasId).arg(name);
+                }
+                _legacyTelemetryNames[sample.channel] = name;
+                _legacyTelemetryUnits[sample.channel] = registry->unit(sample.channel);
+            }
+            emit valueChanged(uasId, _legacyTelemetryNames[sample.channel], _legacyTelemetryUnits[sample.channel], sample.value, sample.msecs);
+        }
+    }
+}
+
 void UAS::shutdownVehicle(void)
 {
 /*
@@ -20,6 +20,7 @@
 #include "QGCMAVLink.h"
 #include "Vehicle.h"
 #include "FirmwarePluginManager.h"
+#include "TelemetryChannelRegistry.h"
 
 #ifndef __mobile__
 #include "FileManager.h"
@@ -364,10 +365,14 @@ protected:
 
 private:
     void _say(const QString& text, int severity = 6);
+    bool _telemetryWanted(void);
+    void _publishTelemetry(const TelemetrySample* samples, int count);
 
 private:
     Vehicle*                _vehicle;
     FirmwarePluginManager*  _firmwarePluginManager;
+    QVector<QString>        _legacyTelemetryNames;  ///< valueChanged name by channel id, empty until first emitted
+    QVector<QString>        _legacyTelemetryUnits;  ///< valueChanged unit by channel id
 };
 
 